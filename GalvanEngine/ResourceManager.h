@@ -2,6 +2,13 @@
 #include "Prerequisites.h"
 #include "Texture.h"
 #include "Services/NotificationService.h"
+#include "Services/ResourceCache.h"
+#include "Services/ResourceLoaders.h"
+
+using TextureCache = ResourceCache<Texture, TextureLoader>;
+using FontCache = ResourceCache<sf::Font, FontLoader>;
+using SoundCache = ResourceCache<sf::SoundBuffer, SoundLoader>;
+using ShaderCache = ResourceCache<sf::Shader, ShaderLoader>;
 
 class
     ResourceManager {
@@ -28,41 +35,129 @@ public:
      * @brief Carga una textura desde un archivo y la almacena en el administrador
      * @param fileName Nombre del archivo de la textura
      * @param extension Extensin del archivo de la textura
+     * @return true si la textura est cargada
      */
     bool
         loadTexture(const std::string& fileName, const std::string& extension) {
-        // Verificar que la textura haya cargado
-        if (m_textures.find(fileName) != m_textures.end()) {
-            return true;
-        }
-        EngineUtilities::TSharedPointer<Texture> texture = EngineUtilities::MakeShared<Texture>(fileName, extension);
-        m_textures[fileName] = texture;
+        return m_textures.getState(m_textures.load(fileName, extension)) == RESOURCE_READY;
     }
 
     /**
      * @brief Obtiene una textura cargada por su nombre
      * @param fileName Nombre del archivo de la textura
+     *
+     * Si la textura fue desalojada por el presupuesto se vuelve a cargar desde disco.
      */
     EngineUtilities::TSharedPointer<Texture>
-        getTexture(const std::string& fileName) {
+        getTexture(std::string_view fileName) {
         NotificationService& notifier = NotificationService::getInstance();
 
-        // Verificar que haya una textura xon ese nombre
-        auto it = m_textures.find(fileName);
-        if (it != m_textures.end()) {
-            return it->second;
+        EngineUtilities::TSharedPointer<Texture> texture = m_textures.acquire(fileName);
+        if (!texture.isNull()) {
+            return texture;
         }
 
         std::cout << "Texture not found: " << fileName << std::endl;
-        notifier.addMessage(ConsolErrorType::WARNING, "Texture not found: " + fileName);
-        EngineUtilities::TSharedPointer<Texture> texture = EngineUtilities::MakeShared<Texture>("Default", "png");
-        m_textures["Default"] = texture;
-        return texture;
+        notifier.addMessage(ConsolErrorType::WARNING, "Texture not found: " + std::string(fileName));
+        TextureCache::Handle fallback = m_textures.load("Default", "png");
+        m_textures.pin(fallback, true);
+        return m_textures.acquire(fallback);
+    }
+
+    /**
+     * @brief Evita o permite que una textura sea desalojada
+     * @param fileName Nombre del archivo de la textura
+     * @param pinned true para mantenerla siempre cargada
+     */
+    void
+        pinTexture(std::string_view fileName, bool pinned) {
+        m_textures.pin(m_textures.find(fileName), pinned);
+    }
+
+    /**
+     * @brief Establece el presupuesto de memoria de las texturas
+     * @param bytes Bytes mximos estimados (ancho x alto x 4 por textura)
+     */
+    void
+        setTextureBudget(size_t bytes) {
+        m_textures.setBudget(bytes);
+    }
+
+    /**
+     * @brief Termina las cargas asncronas y desaloja lo que exceda los presupuestos
+     * @param frame Frame que se est simulando; los recursos referenciados quedan marcados con l
+     * @param oldestFrameInFlight Frame ms antiguo que algn hilo todava puede dibujar
+     *
+     * Un recurso solo se desaloja si nadie fuera del administrador lo referencia y si su
+     * ltimo uso es anterior a oldestFrameInFlight, as un snapshot pendiente nunca apunta
+     * a una textura liberada.
+     */
+    void
+        update(uint64_t frame, uint64_t oldestFrameInFlight) {
+        m_textures.update(frame, oldestFrameInFlight);
+        m_fonts.update(frame, oldestFrameInFlight);
+        m_sounds.update(frame, oldestFrameInFlight);
+        m_shaders.update(frame, oldestFrameInFlight);
+    }
+
+    /**
+     * @brief Prepara el reemplazo en sitio de una textura cargada cuyo archivo cambi
+     * @param fileName Nombre del archivo de la textura
+     * @param extension Extensin del archivo modificado
+     * @param newSize Tamao de la imagen nueva, para actualizar la memoria contabilizada
+     * @return La textura a actualizar, o nullptr si no est cargada con esa extensin
+     */
+    Texture*
+        beginTextureReload(std::string_view fileName,
+                           std::string_view extension,
+                           const sf::Vector2u& newSize) {
+        return m_textures.beginReload(fileName, extension, static_cast<size_t>(newSize.x) * newSize.y * 4);
     }
 
-private:
     /**
-     * @brief Contenedor tipo mapa de las texturas almacenadas
+     * @brief Estadsticas de memoria y uso de las texturas
      */
-    std::unordered_map<std::string, EngineUtilities::TSharedPointer<Texture>> m_textures;
+    const ResourceStats&
+        getTextureStats() const {
+        return m_textures.getStats();
+    }
+
+    /**
+     * @brief Suma de las estadsticas de todos los tipos de recurso
+     */
+    ResourceStats
+        getTotalStats() const {
+        ResourceStats total;
+        total.add(m_textures.getStats());
+        total.add(m_fonts.getStats());
+        total.add(m_sounds.getStats());
+        total.add(m_shaders.getStats());
+        return total;
+    }
+
+    TextureCache&
+        getTextures() {
+        return m_textures;
+    }
+
+    FontCache&
+        getFonts() {
+        return m_fonts;
+    }
+
+    SoundCache&
+        getSounds() {
+        return m_sounds;
+    }
+
+    ShaderCache&
+        getShaders() {
+        return m_shaders;
+    }
+
+private:
+    TextureCache m_textures{ 256u * 1024u * 1024u };  // Presupuesto por defecto de 256 MB
+    FontCache m_fonts{ 16u * 1024u * 1024u };
+    SoundCache m_sounds{ 64u * 1024u * 1024u };
+    ShaderCache m_shaders{ 4u * 1024u * 1024u };
 };
@@ -1,6 +1,8 @@
 #pragma once
 #include "Prerequisites.h"
 #include "Component.h"
+#include "Window.h"
+#include "Services/VirtualFileSystem.h"
 
 class
     Texture : public Component {
@@ -18,12 +20,29 @@ public:
     Texture(std::string textureName, std::string extension) : m_textureName(textureName),
         m_extension(extension),
         Component(ComponentType::TEXTURE) {
-        if (!m_texture.loadFromFile(m_textureName + "." + m_extension)) {
+        // Se lee desde los paquetes montados o, si no est empaquetada, desde el disco
+        FileView file;
+        if (!VirtualFileSystem::getInstance().read(m_textureName, m_extension, file) ||
+            !m_texture.loadFromMemory(file.data, file.size)) {
             std::cout << "Error de carga de textura" << std::endl;
           
         }
     }
 
+    /**
+     * @brief Constructor que crea la textura desde una imagen ya decodificada.
+     * @param textureName Nombre del archivo de la textura
+     * @param extension Extensin del archivo de la textura
+     * @param image Imagen decodificada, por ejemplo por una carga asncrona
+     */
+    Texture(std::string textureName, std::string extension, const sf::Image& image) : m_textureName(textureName),
+        m_extension(extension),
+        Component(ComponentType::TEXTURE) {
+        if (!m_texture.loadFromImage(image)) {
+            std::cout << "Error de carga de textura" << std::endl;
+        }
+    }
+
     /**
      * @brief Destructor por defecto de Texture.
      */
@@ -38,6 +57,20 @@ public:
         return m_texture;
     }
 
+    /**
+     * @brief Reemplaza los pixeles de la textura sin cambiar el objeto, los punteros siguen vlidos.
+     * @param image Imagen ya decodificada; si cambia de tamao se recrea la textura de la GPU.
+     * @return true si la textura qued actualizada.
+     */
+    bool
+        reloadFromImage(const sf::Image& image) {
+        if (m_texture.getSize() == image.getSize()) {
+            m_texture.update(image);
+            return true;
+        }
+        return m_texture.loadFromImage(image);
+    }
+
     /*
     * @brief Mtodo puro para actualizar la textura
     * @param deltaTime Tiempo transcurrido desde la ltima actualizacin
@@ -170,6 +170,112 @@ UserInterface::hierarchy(std::vector<EngineUtilities::TSharedPointer<Actor>>& ac
     
 }
 
+void
+UserInterface::hierarchy(const RenderSnapshot& snapshot, std::vector<UiCommand>& commands) {
+    ImGui::Begin("Hierarchy");
+
+    for (size_t i = 0; i < snapshot.items.size(); ++i) {
+        const RenderItem& item = snapshot.items[i];
+
+        ImGui::PushID(static_cast<int>(i));
+        std::string displayName = std::to_string(i) + " - " + snapshot.names[i];
+        bool isSelected = m_hasSelectedActorId && m_selectedActorId == item.actorId;
+        if (ImGui::Selectable(displayName.c_str(), isSelected)) {
+            m_selectedActorId = item.actorId;
+            m_hasSelectedActorId = true;
+        }
+        ImGui::PopID();
+    }
+
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // Las figuras se crean en la simulacin al aplicar el comando
+    UiCommand command;
+    command.type = UiCommandType::CREATE_ACTOR;
+    command.rotation = sf::Vector2f(0.0f, 0.0f);
+    command.scale = sf::Vector2f(1.0f, 1.0f);
+
+    if (ImGui::Button("Create Circle")) {
+        command.shapeType = ShapeType::CIRCLE;
+        command.name = "Circle";
+        command.position = sf::Vector2f(100.0f, 100.0f);
+        commands.push_back(command);
+    }
+
+    if (ImGui::Button("Create Rectangle")) {
+        command.shapeType = ShapeType::RECTANGLE;
+        command.name = "Rectangle";
+        command.position = sf::Vector2f(200.0f, 150.0f);
+        commands.push_back(command);
+    }
+
+    if (ImGui::Button("Create Triangle")) {
+        command.shapeType = ShapeType::TRIANGLE;
+        command.name = "Triangle";
+        command.position = sf::Vector2f(150.0f, 200.0f);
+        commands.push_back(command);
+    }
+
+    ImGui::End();
+}
+
+void
+UserInterface::inspector(const RenderSnapshot& snapshot, std::vector<UiCommand>& commands) {
+    if (!m_hasSelectedActorId) {
+        return;
+    }
+
+    // Busca el actor seleccionado; si ya no existe se limpia la seleccin
+    size_t index = 0;
+    while (index < snapshot.items.size() && snapshot.items[index].actorId != m_selectedActorId) {
+        ++index;
+    }
+    if (index == snapshot.items.size()) {
+        m_hasSelectedActorId = false;
+        return;
+    }
+    const RenderItem& item = snapshot.items[index];
+
+    ImGui::Begin("Inspector");
+
+    char objectName[128];
+    const std::string& name = snapshot.names[index];
+    size_t length = std::min(name.size(), sizeof(objectName) - 1);
+    std::copy(name.begin(), name.begin() + length, objectName);
+    objectName[length] = '\0';
+
+    if (ImGui::InputText("Name", objectName, sizeof(objectName))) {
+        UiCommand command;
+        command.type = UiCommandType::RENAME_ACTOR;
+        command.actorId = item.actorId;
+        command.name = objectName;
+        commands.push_back(command);
+    }
+
+    // Se editan copias del snapshot; los cambios viajan a la simulacin como comando
+    float position[2] = { item.position.x, item.position.y };
+    float rotation[2] = { item.rotation.x, item.rotation.y };
+    float scale[2] = { item.scale.x, item.scale.y };
+    vec2Control("Position", position);
+    vec2Control("Rotation", rotation);
+    vec2Control("Scale", scale);
+
+    if (position[0] != item.position.x || position[1] != item.position.y ||
+        rotation[0] != item.rotation.x || rotation[1] != item.rotation.y ||
+        scale[0] != item.scale.x || scale[1] != item.scale.y) {
+        UiCommand command;
+        command.type = UiCommandType::SET_TRANSFORM;
+        command.actorId = item.actorId;
+        command.position = sf::Vector2f(position[0], position[1]);
+        command.rotation = sf::Vector2f(rotation[0], rotation[1]);
+        command.scale = sf::Vector2f(scale[0], scale[1]);
+        commands.push_back(command);
+    }
+
+    ImGui::End();
+}
+
 /**
    * @brief Verifica si hay un actor seleccionado y, muestra las propiedades de transform
    */
@@ -215,6 +321,34 @@ UserInterface::inspector() {
     ImGui::End();
 }
 
+/**
+   * @brief Muestra los comandos, cambios de estado y tiempo de ordenamiento de la cola de render
+   */
+void
+UserInterface::renderStats(const RenderQueueStats& stats) {
+    ImGui::Begin("Render Stats");
+    ImGui::Text("Commands: %u", stats.commands);
+    ImGui::Text("State changes: %u", stats.stateChanges);
+    ImGui::Text("State changes (unsorted): %u", stats.stateChangesUnsorted);
+    ImGui::Text("State changes avoided: %u", stats.stateChangesAvoided);
+    ImGui::Text("Sort time: %.3f ms", stats.sortTimeMs);
+    ImGui::End();
+}
+
+void
+UserInterface::resourceStats(const ResourceStats& stats) {
+    const float megabyte = 1024.0f * 1024.0f;
+    ImGui::Begin("Resources");
+    ImGui::Text("Textures: %zu (%zu pinned)", stats.residentCount, stats.pinnedCount);
+    ImGui::Text("Resident: %.2f / %.2f MB", stats.residentBytes / megabyte, stats.budgetBytes / megabyte);
+    ImGui::ProgressBar(stats.budgetBytes > 0 ? static_cast<float>(stats.residentBytes) / stats.budgetBytes : 0.0f);
+    ImGui::Text("Hits: %llu  Misses: %llu", static_cast<unsigned long long>(stats.hits),
+                static_cast<unsigned long long>(stats.misses));
+    ImGui::Text("Hit rate: %.1f%%", stats.getHitRate() * 100.0f);
+    ImGui::Text("Evictions: %llu", static_cast<unsigned long long>(stats.evictions));
+    ImGui::End();
+}
+
 void
 UserInterface::vec2Control(const std::string& label, float* values, float resetValue, float columnWidth) {
     ImGuiIO& io = ImGui::GetIO();
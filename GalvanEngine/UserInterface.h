@@ -1,6 +1,7 @@
 #pragma once
 #include "Prerequisites.h"
 #include "Actor.h"
+#include "Render/RenderSnapshot.h"
 #include "Services/NotificationService.h"
 
 class Window;
@@ -63,12 +64,42 @@ public:
     void
         hierarchy(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
 
+    /**
+     * @brief Muestra la jerarqua a partir de un snapshot, para el hilo de render
+     * @param snapshot Estado de la escena publicado por la simulacin
+     * @param commands Recibe las acciones que la simulacin debe aplicar
+     */
+    void
+        hierarchy(const RenderSnapshot& snapshot, std::vector<UiCommand>& commands);
+
     /**
      * @brief Muestra el isnepctor del actor seleccionado
      */
     void
         inspector();
 
+    /**
+     * @brief Muestra el inspector del actor seleccionado a partir de un snapshot
+     * @param snapshot Estado de la escena publicado por la simulacin
+     * @param commands Recibe los cambios de nombre y Transform del actor seleccionado
+     */
+    void
+        inspector(const RenderSnapshot& snapshot, std::vector<UiCommand>& commands);
+
+    /**
+     * @brief Muestra las estadsticas de la cola de render del ltimo frame
+     * @param stats Estadsticas de la RenderQueue
+     */
+    void
+        renderStats(const RenderQueueStats& stats);
+
+    /**
+     * @brief Muestra la memoria y el uso de la cach de recursos
+     * @param stats Estadsticas del ResourceManager
+     */
+    void
+        resourceStats(const ResourceStats& stats);
+
     /**
      *@brief Permite manipular dos valores flotantes en la interfaz grfica.
      * @param label Etiqueta que se mostrar junto al control
@@ -84,4 +115,6 @@ public:
 
 private:
     EngineUtilities::TSharedPointer<Actor> selectedActor;
+    uint32_t m_selectedActorId = 0;     // Actor seleccionado en el modo con hilo de render
+    bool m_hasSelectedActorId = false;
 };
\ No newline at end of file
@@ -3,7 +3,23 @@
 #include "Window.h"
 #include "ShapeFactory.h"
 #include "Actor.h"
+#include "ECS/PathSystem.h"
+#include "ECS/TweenSystem.h"
+#include "ECS/SpriteAnimationSystem.h"
 #include "UserInterface.h"
+#include "Render/StaticLayer.h"
+#include "Render/RenderThread.h"
+#include "Services/AssetWatcher.h"
+#include "Services/VirtualFileSystem.h"
+#include "Services/AssetManifest.h"
+#include "Services/NavigationService.h"
+#include "Services/TimerService.h"
+#include "Services/EventBus.h"
+#include "Services/WorldSnapshot.h"
+#include "Services/InputRecorder.h"
+#include "Services/InputMap.h"
+#include "Services/ReplicationService.h"
+#include "Services/LockstepService.h"
 #include "Services/NotificationService.h"
 #include "Services/ResourceManager.h"
 
@@ -27,6 +43,28 @@ public:
 	int
 		run();
 
+	/**
+	 * @brief Lee las opciones de línea de comandos
+	 *
+	 * --record <log> graba la entrada de la sesión, --replay <log> la repite y --headless
+	 * repite el log sin ventana lo más rápido posible, para comparar tiempos entre versiones.
+	 * --serve <port> replica la escena a los clientes y --connect <host:port> la recibe;
+	 * --host <port> y --join <host:port> sincronizan dos simulaciones en lockstep, con
+	 * --input-delay <ticks> de retraso de entrada; con --headless la sesión de red dura
+	 * --duration <segundos>.
+	 * @param argc Número de argumentos
+	 * @param argv Argumentos recibidos por main
+	 */
+	void
+		parseArguments(int argc, char* argv[]);
+
+	/**
+	 * @brief Simula sin ventana hasta terminar la repetición o la sesión de red
+	 * @return Código de salida: 0 si el hash coincide con el de la grabación
+	 */
+	int
+		runHeadless();
+
 	/**
 	 * @brief Función de inicialización de la aplicación, configura los recursos necesarios
 	 * @return Verdadero si la inicialización fue exitosa, falso si hubo un error
@@ -53,18 +91,70 @@ public:
 		cleanup();
 
 	/**
-	 * @brief Actualiza el movimiento de los actores (por ejemplo, el círculo)
-	 * @param deltaTime El tiempo transcurrido entre un frame y el siguiente
-	 * @param circle Puntero compartido al actor que representa el círculo
+	 * @brief Escribe el estado de la escena en un snapshot y lo publica para el hilo de render
+	 */
+	void
+		publishSnapshot();
+
+	/**
+	 * @brief Aplica los comandos que la interfaz generó en el hilo de render
+	 */
+	void
+		applyUiCommands();
+
+	/**
+	 * @brief Toma las texturas recargadas por el AssetWatcher y las reemplaza entre frames
+	 */
+	void
+		applyAssetReloads();
+
+	/**
+	 * @brief Termina la grabación o repetición de entrada y reporta sus tiempos y hash
+	 */
+	void
+		finishInputSession();
+
+	/**
+	 * @brief Abre el servidor o la conexión de replicación pedidos en la línea de comandos
 	 */
 	void
-		updateMovement(float deltaTime, EngineUtilities::TSharedPointer<Actor> circle);
+		startReplication();
+
+	/**
+	 * @brief Reporta cada segundo el ancho de banda de la replicación por cliente
+	 */
+	void
+		reportReplication(float deltaTime);
+
+	/**
+	 * @brief Mueve a los actores de los jugadores con las acciones MoveX, MoveY y Boost
+	 *
+	 * Sin lockstep la entrada local mueve al Triangle. En lockstep el jugador 0 mueve al
+	 * Triangle y el 1 al Square, siempre con la entrada intercambiada del tick, así las dos
+	 * simulaciones reciben lo mismo.
+	 * @param lockstepTick true si el tick lo avanzó el LockstepService
+	 */
+	void
+		applyPlayerInput(bool lockstepTick);
+
+	/**
+	 * @brief Abre o se une a la sesión de lockstep pedida en la línea de comandos
+	 */
+	void
+		startLockstep();
+
+	/**
+	 * @brief Cierra la sesión de lockstep y reporta ticks, esperas, tráfico y hashes
+	 * @return Verdadero si se compararon hashes y todos coincidieron
+	 */
+	bool
+		finishLockstep();
 
 private:
 	sf::Clock clock;
 	sf::Time deltaTime;
 
-	Window* m_window; // Puntero a la ventana donde se dibujan los elementos
+	Window* m_window = nullptr; // Puntero a la ventana donde se dibujan los elementos
 	                EngineUtilities::TSharedPointer<Actor> Circle;
 	                EngineUtilities::TSharedPointer<Actor> Triangle;
 					EngineUtilities::TSharedPointer<Actor> Square;
@@ -73,9 +163,6 @@ private:
 	// Lista de actores en la escena
 	std::vector< EngineUtilities::TSharedPointer<Actor>> m_actors;
 
-	//Array para la actividad de los puntos
-	Vector2 points[8];
-	int m_currentPoint = 0;
 	int m_currentActor = 0;
 
 	// Texturas para los elementos en escena
@@ -84,4 +171,43 @@ private:
 
 	// Interfaz gráfica de usuario
 	UserInterface m_GUI;
+
+	// Cola de render ordenada por capa, textura y profundidad
+	RenderQueue m_renderQueue;
+
+	// Lotes de los sprites animados; sus vértices viven hasta que la cola dibuja
+	std::vector<RenderBatch> m_spriteBatches;
+
+	// Capa cacheada de los actores estáticos
+	StaticLayer m_staticLayer;
+
+	// Hilo de render que consume los snapshots de la simulación
+	RenderThread m_renderThread;
+	bool m_useRenderThread = true;
+	std::vector<UiCommand> m_uiCommands;
+	uint64_t m_simTick = 0;	// Ticks simulados; numera snapshots, recursos y frames de render
+	float m_simTimeMs = 0.0f;
+
+	// Recarga de texturas al modificarse en disco
+	bool m_hotReload = true;
+	std::vector<AssetReload> m_assetReloads;
+
+	// Grabación y repetición de la entrada
+	std::string m_recordPath;
+	std::string m_replayPath;
+	bool m_headless = false;
+
+	// Replicación de red
+	unsigned short m_servePort = 0;
+	std::string m_connectAddress;
+	unsigned short m_connectPort = 0;
+	float m_headlessSeconds = 10.0f;
+	float m_replicationReportTimer = 0.0f;
+
+	// Lockstep
+	unsigned short m_lockstepHostPort = 0;
+	std::string m_lockstepJoinAddress;
+	unsigned short m_lockstepJoinPort = 0;
+	uint32_t m_inputDelay = 0;		// 0 deja el valor por defecto de LockstepSettings
+	bool m_desyncReported = false;
 };
@@ -3,6 +3,14 @@
 #include "Entity.h"
 #include "ShapeFactory.h"
 #include "Transform.h"
+#include "ECS/Tilemap.h"
+#include "ECS/ParticleSystem.h"
+#include "ECS/Path.h"
+#include "ECS/Steering.h"
+#include "ECS/Collider.h"
+#include "ECS/RigidBody2D.h"
+#include "ECS/SpriteAnimator.h"
+#include "Render/RenderQueue.h"
 
 class
     Actor : Entity {
@@ -34,6 +42,21 @@ public:
     void
         render(Window& window) override;
 
+    /*
+    * @brief Registra los elementos dibujables del actor en la cola de render
+    * @param queue Cola de render del frame
+    */
+    void
+        submit(RenderQueue& queue);
+
+    /*
+    * @brief Agrega los lotes de vértices visibles del actor (bloques de Tilemap, partículas)
+    * @param viewBounds Área visible en coordenadas de mundo
+    * @param out Lotes del frame
+    */
+    void
+        collectBatches(const sf::FloatRect& viewBounds, std::vector<RenderBatch>& out);
+
     /**
      * @brief Destruye el actor y libera los recursos asociados.
      */
@@ -46,12 +69,25 @@ public:
     std::string
         getName() const;
 
+    /**
+     * @brief Identificador único del actor, asignado al construirlo
+     */
+    uint32_t
+        getId() const {
+        return static_cast<uint32_t>(id);
+    }
+
     /**
      * @brief Permite la modificación del nombre del actor
      */
     void
         setName(const std::string& newName);
 
+    /*
+    * @brief Agrega un componente al actor (Path, Steering, ParticleSystem, Tilemap...)
+    */
+    using Entity::addComponent;
+
     /*
     * @brief Obtiene un componente específico del actor
     * @tparam T Tipo de componente que se va a obtener
@@ -61,8 +97,85 @@ public:
     EngineUtilities::TSharedPointer<T>
         getComponent();
 
+    /**
+     * @brief Establece la capa de dibujo del actor (ver RenderLayer)
+     */
+    void
+        setRenderLayer(uint8_t layer) {
+        m_renderLayer = layer;
+    }
+
+    /**
+     * @brief Obtiene la capa de dibujo del actor
+     */
+    uint8_t
+        getRenderLayer() const {
+        return m_renderLayer;
+    }
+
+    /**
+     * @brief Establece la profundidad del actor dentro de su capa, menor se dibuja primero
+     */
+    void
+        setRenderDepth(float depth) {
+        m_renderDepth = depth;
+    }
+
+    /**
+     * @brief Obtiene la profundidad del actor dentro de su capa
+     */
+    float
+        getRenderDepth() const {
+        return m_renderDepth;
+    }
+
+    /**
+     * @brief Marca al actor como estático; se dibuja en la capa cacheada de StaticLayer
+     */
+    void
+        setStatic(bool isStatic) {
+        m_isStatic = isStatic;
+        m_renderDirty = true;
+    }
+
+    /**
+     * @brief Indica si el actor es estático
+     */
+    bool
+        isStatic() const {
+        return m_isStatic;
+    }
+
+    /**
+     * @brief Fuerza que el actor se vuelva a dibujar en la capa estática (p. ej. al cambiar su textura)
+     */
+    void
+        markRenderDirty() {
+        m_renderDirty = true;
+    }
+
+    /**
+     * @brief Devuelve si el actor cambió desde la última consulta y limpia la marca
+     */
+    bool
+        consumeRenderDirty() {
+        bool dirty = m_renderDirty;
+        m_renderDirty = false;
+        return dirty;
+    }
+
 private:
     std::string m_name = "Actor";
+    uint8_t m_renderLayer = RenderLayer::WORLD; // Capa de dibujo
+    float m_renderDepth = 0.0f;                // Profundidad dentro de la capa
+
+    bool m_isStatic = false;     // El actor no se mueve y se dibuja en la capa cacheada
+    bool m_renderDirty = true;   // La figura cambió desde la última vez que se consultó
+    bool m_transformSynced = false;
+    sf::Vector2f m_syncedPosition;  // Último Transform aplicado a la figura
+    sf::Vector2f m_syncedRotation;
+    sf::Vector2f m_syncedScale;
+    std::vector<RenderBatch> m_batches; // Lotes registrados en la cola durante el frame
 };
 
 /*
@@ -0,0 +1,153 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "Window.h"
+
+class PhysicsWorld;
+
+/*
+* @enum ColliderType
+* @brief Forma de colisión; las cajas se guardan como polígonos de cuatro vértices.
+*/
+enum
+    ColliderType {
+    COLLIDER_CIRCLE = 0,
+    COLLIDER_BOX = 1,
+    COLLIDER_POLYGON = 2
+};
+
+/*
+* @enum BodyType
+* @brief Cómo responde un cuerpo a las fuerzas y a los contactos.
+*/
+enum
+    BodyType {
+    BODY_STATIC = 0,    ///< No se mueve; los colliders sin RigidBody2D son estáticos.
+    BODY_DYNAMIC = 1,   ///< Lo mueven las fuerzas, la gravedad y los contactos.
+    BODY_KINEMATIC = 2  ///< Se mueve con la velocidad asignada y empuja a los dinámicos.
+};
+
+/*
+* @struct PhysicsMaterial
+* @brief Propiedades de superficie y densidad de un collider.
+*/
+struct
+    PhysicsMaterial {
+    float density = 1.0f;       ///< Masa por unidad de área.
+    float friction = 0.4f;
+    float restitution = 0.1f;   ///< 0 no rebota, 1 conserva la velocidad normal.
+};
+
+/*
+* @struct ColliderShape
+* @brief Geometría de un collider en coordenadas locales del actor (origen de su figura).
+*/
+struct
+    ColliderShape {
+    static const uint32_t MAX_VERTICES = 8;
+
+    ColliderType type = COLLIDER_CIRCLE;
+    float radius = 0.0f;                    ///< Solo círculos.
+    sf::Vector2f center;                    ///< Centro del círculo.
+    std::vector<sf::Vector2f> vertices;     ///< Polígono convexo, hasta MAX_VERTICES.
+
+    /**
+     * @brief Círculo con el centro indicado.
+     */
+    static ColliderShape
+        circle(float radius, const sf::Vector2f& center = sf::Vector2f());
+
+    /**
+     * @brief Caja alineada a los ejes locales, con la esquina superior izquierda en offset.
+     */
+    static ColliderShape
+        box(const sf::Vector2f& size, const sf::Vector2f& offset = sf::Vector2f());
+
+    /**
+     * @brief Polígono convexo; el orden de los vértices se corrige si hace falta.
+     */
+    static ColliderShape
+        polygon(const std::vector<sf::Vector2f>& points);
+
+    /**
+     * @brief Collider que coincide con una figura creada por ShapeFactory.
+     * @param shapeType Tipo de la figura (CIRCLE, RECTANGLE o TRIANGLE).
+     * @param shape Figura de SFML.
+     * @param scale Escala del Transform del actor.
+     */
+    static ColliderShape
+        fromShape(ShapeType shapeType, const sf::Shape& shape, const sf::Vector2f& scale);
+};
+
+/**
+ * @class Collider
+ * @brief Componente con la forma de colisión de un actor.
+ *
+ * Registra un cuerpo en el PhysicsWorld; sin RigidBody2D el cuerpo es estático. El
+ * componente solo guarda su lugar en el mundo, los datos viven en el PhysicsWorld.
+ */
+class
+    Collider : public Component {
+public:
+    /**
+     * @brief Crea el collider en la posición y rotación del actor.
+     * @param shape Forma en coordenadas locales.
+     * @param origin Posición del actor.
+     * @param angle Rotación del actor en grados.
+     * @param material Densidad y propiedades de superficie.
+     */
+    Collider(const ColliderShape& shape,
+             const sf::Vector2f& origin,
+             float angle = 0.0f,
+             const PhysicsMaterial& material = PhysicsMaterial());
+
+    virtual
+        ~Collider();
+
+    Collider(const Collider&) = delete;
+    Collider& operator=(const Collider&) = delete;
+
+    void
+        update(float deltaTime) override {
+        (void)deltaTime;
+    }
+
+    void
+        render(Window window) override {
+        (void)window;
+    }
+
+    /**
+     * @brief Mueve el cuerpo; útil para colliders estáticos cuyo actor cambió de lugar.
+     */
+    void
+        setTransform(const sf::Vector2f& origin, float angle);
+
+    /**
+     * @brief Posición del actor según la simulación.
+     */
+    sf::Vector2f
+        getOrigin() const;
+
+    /**
+     * @brief Rotación del actor en grados según la simulación.
+     */
+    float
+        getAngle() const;
+
+    /**
+     * @brief Lugar del cuerpo en el PhysicsWorld; lo mantiene el mundo.
+     */
+    uint32_t
+        getSlot() const {
+        return m_slot;
+    }
+
+    void
+        setSlot(uint32_t slot) {
+        m_slot = slot;
+    }
+
+private:
+    uint32_t m_slot = 0;
+};
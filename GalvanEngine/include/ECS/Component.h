@@ -13,7 +13,12 @@ enum
     PHYSICS = 4,
     AUDIOSOURCE = 5,
     SHAPE = 6,
-    TEXTURE = 7
+    TEXTURE = 7,
+    TILEMAP = 8,
+    PARTICLES = 9,
+    PATH = 10,
+    STEERING = 11,
+    COLLIDER = 12
 };
 
 /*
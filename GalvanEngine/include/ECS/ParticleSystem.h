@@ -0,0 +1,259 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "Render/RenderQueue.h"
+#include "Window.h"
+#include "Texture.h"
+
+/*
+* @struct ParticleEmitterSettings
+* @brief Parámetros de emisión y de apariencia de un emisor de partículas.
+*
+* Las curvas se definen con llaves (t, valor), t en [0, 1] a lo largo de la vida de la
+* partícula, y se hornean en tablas al llamar ParticleSystem::setSettings.
+*/
+struct
+    ParticleEmitterSettings {
+    uint32_t maxParticles = 10000;      ///< Capacidad del emisor.
+    float emissionRate = 500.0f;        ///< Partículas por segundo.
+    float lifetimeMin = 0.5f;           ///< Vida mínima en segundos.
+    float lifetimeMax = 1.5f;           ///< Vida máxima en segundos.
+    float speedMin = 50.0f;             ///< Rapidez inicial mínima.
+    float speedMax = 150.0f;            ///< Rapidez inicial máxima.
+    float direction = -90.0f;           ///< Dirección central de emisión en grados.
+    float spread = 360.0f;              ///< Apertura del cono de emisión en grados.
+    float spawnRadius = 0.0f;           ///< Radio del área de aparición alrededor del origen.
+    sf::Vector2f gravity{ 0.0f, 0.0f }; ///< Aceleración constante.
+    float drag = 0.0f;                  ///< Amortiguamiento de la velocidad por segundo.
+    std::vector<std::pair<float, float>> sizeKeys{ { 0.0f, 4.0f }, { 1.0f, 1.0f } };
+    std::vector<std::pair<float, sf::Color>> colorKeys{ { 0.0f, sf::Color::White },
+                                                        { 1.0f, sf::Color(255, 255, 255, 0) } };
+};
+
+/**
+ * @class ParticleSystem
+ * @brief Componente emisor de partículas simuladas en arreglos por campo (SoA).
+ *
+ * Cada partícula vive en arreglos contiguos de posición, velocidad, edad y vida, sin
+ * actores ni asignaciones por partícula. La integración recorre los arreglos de cuatro
+ * en cuatro con SSE cuando está disponible; las partículas muertas se eliminan
+ * intercambiándolas con la última. El emisor produce un solo sf::VertexArray por frame,
+ * que se dibuja con una llamada.
+ *
+ * La integración y la generación de vértices pueden repartirse en el JobSystem.
+ */
+class
+    ParticleSystem : public Component {
+public:
+    /**
+     * @brief Constructor por defecto, registra el componente como PARTICLES.
+     */
+    ParticleSystem() : Component(ComponentType::PARTICLES) {
+        setSettings(ParticleEmitterSettings());
+    }
+
+    /**
+     * @brief Crea un emisor con la configuración indicada.
+     */
+    explicit
+        ParticleSystem(const ParticleEmitterSettings& settings) : Component(ComponentType::PARTICLES) {
+        setSettings(settings);
+    }
+
+    virtual
+        ~ParticleSystem() = default;
+
+    /**
+     * @brief Indica a todos los emisores el frame que se simula y el más antiguo en vuelo.
+     * @param frame Frame que se está simulando; los vértices generados quedan marcados con él.
+     * @param oldestFrameInFlight Frame más antiguo que el render todavía puede dibujar.
+     *
+     * Se llama cada tick antes de actualizar a los actores, con los mismos frames que recibe
+     * ResourceManager::update.
+     */
+    static void
+        beginFrame(uint64_t frame, uint64_t oldestFrameInFlight) {
+        m_frame = frame;
+        m_oldestFrameInFlight = oldestFrameInFlight;
+    }
+
+    /**
+     * @brief Cambia la configuración, hornea las curvas y ajusta la capacidad.
+     */
+    void
+        setSettings(const ParticleEmitterSettings& settings);
+
+    const ParticleEmitterSettings&
+        getSettings() const {
+        return m_settings;
+    }
+
+    /**
+     * @brief Carga la textura de las partículas con el ResourceManager; sin textura se dibujan cuadros de color.
+     * @return true si la textura quedó disponible.
+     */
+    bool
+        setTexture(const std::string& fileName, const std::string& extension);
+
+    /**
+     * @brief Posición de mundo desde donde se emiten las partículas.
+     */
+    void
+        setOrigin(const sf::Vector2f& origin) {
+        m_origin = origin;
+    }
+
+    /**
+     * @brief Activa o detiene la emisión continua; las partículas vivas siguen simulándose.
+     */
+    void
+        setEmitting(bool emitting) {
+        m_emitting = emitting;
+    }
+
+    /**
+     * @brief Reparte la integración y la generación de vértices en el JobSystem.
+     */
+    void
+        setMultithreaded(bool multithreaded) {
+        m_multithreaded = multithreaded;
+    }
+
+    /**
+     * @brief Emite count partículas de inmediato, limitado por la capacidad.
+     */
+    void
+        burst(uint32_t count);
+
+    /**
+     * @brief Elimina todas las partículas vivas.
+     */
+    void
+        clear() {
+        m_alive = 0;
+    }
+
+    /**
+     * @brief Simula el emisor: emite, integra, elimina muertas y genera los vértices.
+     * @param deltaTime Tiempo transcurrido desde la última actualización.
+     */
+    void
+        update(float deltaTime) override;
+
+    /**
+     * @brief Método para renderizar el componente, el dibujo lo realiza el actor.
+     * @param window Contexto del dispositivo para operaciones gráficas.
+     */
+    void
+        render(Window window) override {
+        (void)window;
+    }
+
+    /**
+     * @brief Agrega a out el lote con los vértices del último update.
+     * @param renderLayer Capa de dibujo del lote.
+     * @param depth Profundidad dentro de la capa.
+     * @param out Lotes del frame.
+     */
+    void
+        collectBatches(uint8_t renderLayer, float depth, std::vector<RenderBatch>& out) const;
+
+    /**
+     * @brief Número de partículas vivas.
+     */
+    uint32_t
+        getAliveCount() const {
+        return m_alive;
+    }
+
+    /**
+     * @brief Duración del último update en milisegundos.
+     */
+    float
+        getUpdateTimeMs() const {
+        return m_updateTimeMs;
+    }
+
+private:
+    static const uint32_t CURVE_SAMPLES = 64; ///< Muestras de las tablas de tamaño y color.
+
+    /**
+     * @brief Crea count partículas nuevas al final de los arreglos.
+     */
+    void
+        spawn(uint32_t count);
+
+    /**
+     * @brief Integra posición, velocidad y edad en el rango [begin, end).
+     */
+    void
+        integrate(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Elimina las partículas cuya edad superó su vida.
+     */
+    void
+        removeDead();
+
+    /**
+     * @brief Escribe los vértices del rango [begin, end) en el arreglo indicado.
+     */
+    void
+        buildVertices(size_t begin, size_t end, sf::Vertex* vertices) const;
+
+    /**
+     * @brief Escoge un arreglo de vértices publicado antes del frame más antiguo en vuelo.
+     */
+    std::shared_ptr<sf::VertexArray>
+        acquireMesh();
+
+    /**
+     * @brief Número aleatorio en [0, 1) con xorshift.
+     */
+    float
+        random01() {
+        m_randomState ^= m_randomState << 13;
+        m_randomState ^= m_randomState >> 17;
+        m_randomState ^= m_randomState << 5;
+        return (m_randomState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    ParticleEmitterSettings m_settings;
+    float m_sizeCurve[CURVE_SAMPLES];       ///< Tamaño horneado por fracción de vida.
+    sf::Color m_colorCurve[CURVE_SAMPLES];  ///< Color horneado por fracción de vida.
+
+    // Arreglos por campo, todos con la misma longitud (capacidad)
+    std::vector<float> m_posX;
+    std::vector<float> m_posY;
+    std::vector<float> m_velX;
+    std::vector<float> m_velY;
+    std::vector<float> m_age;
+    std::vector<float> m_invLifetime;       ///< 1 / vida, la fracción de vida es age * invLifetime.
+    uint32_t m_alive = 0;
+
+    sf::Vector2f m_origin;
+    bool m_emitting = true;
+    bool m_multithreaded = false;
+    float m_emissionAccumulator = 0.0f;
+    uint32_t m_randomState = 0x9E3779B9u;
+
+    EngineUtilities::TSharedPointer<Texture> m_texture; ///< Mantiene viva la textura.
+    const sf::Texture* m_textureHandle = nullptr;
+    sf::Vector2f m_textureSize;
+
+    /*
+    * @struct MeshSlot
+    * @brief Arreglo de vértices reutilizable y el frame en que se generó.
+    */
+    struct
+        MeshSlot {
+        std::shared_ptr<sf::VertexArray> vertices;
+        uint64_t frame = 0;
+    };
+
+    std::vector<MeshSlot> m_meshes;             ///< Arreglos reutilizables.
+    std::shared_ptr<sf::VertexArray> m_mesh;    ///< Vértices del último update.
+    static inline uint64_t m_frame = 0;                 ///< Frame que se simula, de beginFrame.
+    static inline uint64_t m_oldestFrameInFlight = 0;   ///< Frame más antiguo que el render dibuja.
+    float m_updateTimeMs = 0.0f;
+};
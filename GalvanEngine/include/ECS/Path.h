@@ -0,0 +1,168 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "Window.h"
+
+/**
+ * @class PathSpline
+ * @brief Ruta inmutable de waypoints, parametrizada por longitud de arco.
+ *
+ * La curva se muestrea una vez al construirla (Catmull-Rom, o segmentos rectos con
+ * samplesPerSegment = 1) y se guarda la distancia acumulada de cada muestra. Así avanzar
+ * sobre la ruta es sumar distancia, sin comprobar la distancia al siguiente waypoint.
+ *
+ * Se comparte con std::shared_ptr<const PathSpline>: miles de seguidores de la misma
+ * ruta guardan una sola copia de los puntos.
+ */
+class
+    PathSpline {
+public:
+    /**
+     * @brief Construye la ruta a partir de sus waypoints.
+     * @param waypoints Puntos de control, al menos dos.
+     * @param closed true si la ruta regresa del último punto al primero.
+     * @param samplesPerSegment Muestras por tramo; 1 deja los tramos rectos.
+     */
+    PathSpline(const std::vector<sf::Vector2f>& waypoints, bool closed, uint32_t samplesPerSegment = 1);
+
+    /**
+     * @brief Posición a cierta distancia del inicio de la ruta.
+     * @param distance Distancia en [0, getLength()].
+     * @param segmentHint Muestra donde se buscó la última vez; se actualiza con la nueva.
+     *
+     * Con la pista, avanzar un poco cada frame cuesta O(1) en lugar de una búsqueda binaria.
+     */
+    sf::Vector2f
+        sample(float distance, uint32_t& segmentHint) const;
+
+    /**
+     * @brief Distancia sobre la ruta del punto más cercano a una posición.
+     */
+    float
+        findClosestDistance(const sf::Vector2f& position) const;
+
+    /**
+     * @brief Índice del waypoint donde empieza el tramo de una muestra.
+     */
+    uint32_t
+        getWaypointForSample(uint32_t sampleIndex) const {
+        return std::min(sampleIndex / m_samplesPerSegment, static_cast<uint32_t>(m_waypoints.size()) - 1);
+    }
+
+    float
+        getLength() const {
+        return m_length;
+    }
+
+    bool
+        isClosed() const {
+        return m_closed;
+    }
+
+    const std::vector<sf::Vector2f>&
+        getWaypoints() const {
+        return m_waypoints;
+    }
+
+private:
+    std::vector<sf::Vector2f> m_waypoints;
+    std::vector<sf::Vector2f> m_samples;    ///< Polilínea muestreada.
+    std::vector<float> m_distances;         ///< Distancia acumulada de cada muestra.
+    uint32_t m_samplesPerSegment = 1;
+    float m_length = 0.0f;
+    bool m_closed = false;
+};
+
+/**
+ * @class Path
+ * @brief Componente que hace que un actor siga una PathSpline compartida.
+ *
+ * El componente solo guarda su lugar en el PathSystem; la distancia recorrida, la rapidez
+ * y la posición resultante viven en los arreglos del sistema, que avanza a todos los
+ * seguidores juntos una vez por frame.
+ */
+class
+    Path : public Component {
+public:
+    /**
+     * @brief Crea un seguidor de la ruta indicada.
+     * @param spline Ruta compartida.
+     * @param speed Rapidez en unidades por segundo; negativa recorre la ruta al revés.
+     * @param loop true para reiniciar al terminar una ruta abierta; las rutas cerradas siempre dan vueltas.
+     */
+    Path(std::shared_ptr<const PathSpline> spline, float speed, bool loop = true);
+
+    virtual
+        ~Path();
+
+    Path(const Path&) = delete;
+    Path& operator=(const Path&) = delete;
+
+    /**
+     * @brief El avance ocurre en PathSystem::update, no por componente.
+     */
+    void
+        update(float deltaTime) override {
+        (void)deltaTime;
+    }
+
+    void
+        render(Window window) override {
+        (void)window;
+    }
+
+    void
+        setSpeed(float speed);
+
+    float
+        getSpeed() const;
+
+    /**
+     * @brief Coloca al seguidor a cierta distancia del inicio de la ruta.
+     */
+    void
+        setDistance(float distance);
+
+    float
+        getDistance() const;
+
+    /**
+     * @brief Posición calculada en el último PathSystem::update.
+     */
+    sf::Vector2f
+        getPosition() const;
+
+    /**
+     * @brief Waypoint donde empieza el tramo que se está recorriendo.
+     */
+    uint32_t
+        getCurrentWaypoint() const;
+
+    /**
+     * @brief true si una ruta abierta sin loop llegó a su final.
+     */
+    bool
+        isFinished() const;
+
+    const std::shared_ptr<const PathSpline>&
+        getSpline() const {
+        return m_spline;
+    }
+
+    /**
+     * @brief Lugar del seguidor en los arreglos del PathSystem; lo mantiene el sistema.
+     */
+    uint32_t
+        getSlot() const {
+        return m_slot;
+    }
+
+    void
+        setSlot(uint32_t slot) {
+        m_slot = slot;
+    }
+
+private:
+    std::shared_ptr<const PathSpline> m_spline;
+    uint32_t m_slot = 0;
+};
@@ -0,0 +1,131 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+class PathSpline;
+class Path;
+class StateWriter;
+class StateReader;
+
+/**
+ * @class PathSystem
+ * @brief Avanza a todos los componentes Path en lote, con sus datos en arreglos por campo (SoA).
+ *
+ * Cada frame la distancia de cuatro seguidores se avanza por instrucción con SSE cuando
+ * está disponible, incluido el ciclo o el tope al final de la ruta, sin ramas por seguidor.
+ * Después cada seguidor evalúa su ruta en la distancia nueva. Los dos pasos se reparten
+ * por bloques en el JobSystem.
+ *
+ * Solo debe usarse desde el hilo de simulación.
+ */
+class
+    PathSystem {
+private:
+    PathSystem() = default;
+    ~PathSystem() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    PathSystem(const PathSystem&) = delete;
+    PathSystem& operator=(const PathSystem&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static PathSystem& getInstance() {
+        static PathSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Registra un seguidor y devuelve su lugar en los arreglos.
+     */
+    uint32_t
+        add(Path* owner, const PathSpline* spline, float speed, bool loop);
+
+    /**
+     * @brief Quita un seguidor; el último ocupa su lugar y se le avisa a su componente.
+     */
+    void
+        remove(uint32_t slot);
+
+    /**
+     * @brief Avanza a todos los seguidores.
+     * @param deltaTime Tiempo transcurrido desde la última actualización
+     */
+    void
+        update(float deltaTime);
+
+    void
+        setSpeed(uint32_t slot, float speed) {
+        m_speeds[slot] = speed;
+    }
+
+    float
+        getSpeed(uint32_t slot) const {
+        return m_speeds[slot];
+    }
+
+    /**
+     * @brief Coloca a un seguidor a cierta distancia y recalcula su posición.
+     */
+    void
+        setDistance(uint32_t slot, float distance);
+
+    float
+        getDistance(uint32_t slot) const {
+        return m_distances[slot];
+    }
+
+    sf::Vector2f
+        getPosition(uint32_t slot) const {
+        return m_positions[slot];
+    }
+
+    uint32_t
+        getWaypoint(uint32_t slot) const;
+
+    bool
+        isFinished(uint32_t slot) const;
+
+    size_t
+        getCount() const {
+        return m_owners.size();
+    }
+
+    /**
+     * @brief Guarda distancias, velocidades y posiciones para WorldSnapshot.
+     */
+    void
+        saveState(StateWriter& writer);
+
+    /**
+     * @brief Restaura lo guardado por saveState.
+     * @return false si los seguidores o sus rutas ya no son los mismos.
+     */
+    bool
+        loadState(StateReader& reader);
+
+private:
+    /**
+     * @brief Suma speed * deltaTime a las distancias y aplica el ciclo o el tope.
+     */
+    void
+        advance(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Evalúa la ruta de cada seguidor en su distancia actual.
+     */
+    void
+        samplePositions(size_t begin, size_t end);
+
+    std::vector<Path*> m_owners;
+    std::vector<const PathSpline*> m_splines;   ///< Las rutas las mantiene vivas cada componente.
+    std::vector<float> m_distances;
+    std::vector<float> m_speeds;
+    std::vector<float> m_lengths;               ///< Copia de la longitud de la ruta, para el paso SSE.
+    std::vector<float> m_loops;                 ///< 1 si el seguidor da vueltas, 0 si se detiene al final.
+    std::vector<uint32_t> m_segments;           ///< Última muestra usada, pista para PathSpline::sample.
+    std::vector<sf::Vector2f> m_positions;
+};
@@ -0,0 +1,365 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Collider.h"
+
+class StateWriter;
+class StateReader;
+
+/*
+* @struct PhysicsStats
+* @brief Contadores del último paso de simulación.
+*/
+struct
+    PhysicsStats {
+    size_t bodies = 0;
+    size_t pairs = 0;       ///< Pares con AABB superpuestos según el sort-and-sweep.
+    size_t contacts = 0;    ///< Pares que sí se tocan.
+    size_t islands = 0;
+    uint32_t steps = 0;     ///< Pasos fijos ejecutados en el último update.
+    size_t bulletHits = 0;  ///< Impactos de cuerpos con detección continua en el último paso.
+    float stepTimeMs = 0.0f;
+};
+
+/*
+* @struct CastHit
+* @brief Primer impacto de un círculo barrido.
+*/
+struct
+    CastHit {
+    Collider* collider = nullptr;
+    uint32_t slot = 0;
+    float fraction = 1.0f;  ///< Fracción del recorrido donde ocurre el impacto, en [0, 1].
+    sf::Vector2f point;     ///< Punto de contacto sobre el cuerpo alcanzado.
+    sf::Vector2f normal;    ///< Normal del cuerpo alcanzado hacia el círculo.
+};
+
+/**
+ * @class PhysicsWorld
+ * @brief Simulación de cuerpos rígidos 2D para los componentes Collider y RigidBody2D.
+ *
+ * Cada paso fijo:
+ * 1. Integra las velocidades con la gravedad y las fuerzas acumuladas.
+ * 2. Fase amplia: sort-and-sweep incremental sobre el eje X. El orden del frame anterior
+ *    casi no cambia, así que un insertion sort lo corrige en tiempo casi lineal.
+ * 3. Fase estrecha: círculo-círculo, polígono-círculo y polígono-polígono por SAT con
+ *    recorte de la arista incidente, hasta dos puntos de contacto.
+ * 4. Los cuerpos dinámicos conectados por contactos se agrupan en islas (union-find) y
+ *    cada isla se resuelve con impulsos secuenciales; las islas se reparten en el JobSystem.
+ *    Los impulsos del paso anterior se reutilizan como punto de partida (warm starting).
+ * 5. Integra las posiciones. Los cuerpos marcados como bala barren su círculo interior
+ *    contra la fase amplia y, si chocan, avanzan en subpasos hasta el impacto; así un
+ *    objeto rápido no atraviesa paredes delgadas sin reducir el paso de todo el mundo.
+ *
+ * El paso es fijo y se acumula el tiempo del frame, así un frame lento no cambia el
+ * resultado. Solo debe usarse desde el hilo de simulación.
+ */
+class
+    PhysicsWorld {
+private:
+    PhysicsWorld() = default;
+    ~PhysicsWorld() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static PhysicsWorld& getInstance() {
+        static PhysicsWorld instance;
+        return instance;
+    }
+
+    /**
+     * @brief Registra un cuerpo estático y devuelve su lugar.
+     */
+    uint32_t
+        add(Collider* owner,
+            const ColliderShape& shape,
+            const sf::Vector2f& origin,
+            float angle,
+            const PhysicsMaterial& material);
+
+    /**
+     * @brief Quita un cuerpo; el último ocupa su lugar y se le avisa a su Collider.
+     */
+    void
+        remove(uint32_t slot);
+
+    /**
+     * @brief Avanza la simulación en pasos fijos.
+     * @param deltaTime Tiempo transcurrido desde la última actualización
+     */
+    void
+        update(float deltaTime);
+
+    /**
+     * @brief Ejecuta un solo paso de simulación.
+     */
+    void
+        step(float timeStep);
+
+    void
+        setGravity(const sf::Vector2f& gravity) {
+        m_gravity = gravity;
+    }
+
+    /**
+     * @brief Duración del paso fijo, por defecto 1/60 s.
+     */
+    void
+        setTimeStep(float timeStep) {
+        m_timeStep = timeStep;
+    }
+
+    void
+        setIterations(uint32_t iterations) {
+        m_iterations = iterations;
+    }
+
+    void
+        setBodyType(uint32_t slot, BodyType type);
+
+    void
+        setTransform(uint32_t slot, const sf::Vector2f& origin, float angle);
+
+    /**
+     * @brief Posición del origen del actor (no del centro de masa).
+     */
+    sf::Vector2f
+        getOrigin(uint32_t slot) const;
+
+    /**
+     * @brief Rotación en grados.
+     */
+    float
+        getAngle(uint32_t slot) const;
+
+    void
+        setVelocity(uint32_t slot, const sf::Vector2f& velocity) {
+        m_bodies[slot].velocity = velocity;
+    }
+
+    sf::Vector2f
+        getVelocity(uint32_t slot) const {
+        return m_bodies[slot].velocity;
+    }
+
+    void
+        setAngularVelocity(uint32_t slot, float radiansPerSecond) {
+        m_bodies[slot].angularVelocity = radiansPerSecond;
+    }
+
+    void
+        applyForce(uint32_t slot, const sf::Vector2f& force) {
+        m_bodies[slot].force += force;
+    }
+
+    void
+        applyImpulse(uint32_t slot, const sf::Vector2f& impulse, const sf::Vector2f& worldPoint);
+
+    /**
+     * @brief Activa la detección continua de colisiones para un cuerpo dinámico.
+     */
+    void
+        setBullet(uint32_t slot, bool bullet) {
+        m_bodies[slot].bullet = bullet;
+    }
+
+    bool
+        isBullet(uint32_t slot) const {
+        return m_bodies[slot].bullet;
+    }
+
+    /**
+     * @brief Barre un círculo de start a end y devuelve el primer cuerpo que toca.
+     * @param ignoreSlot Cuerpo que no se considera, normalmente el que se mueve.
+     *
+     * Los cuerpos que ya se superponen con el círculo en start se ignoran. Sirve también
+     * para actores que se mueven sin RigidBody2D, como los que usan Transform::Seek.
+     */
+    bool
+        castCircle(const sf::Vector2f& start,
+                   const sf::Vector2f& end,
+                   float radius,
+                   CastHit& hit,
+                   uint32_t ignoreSlot = 0xFFFFFFFFu) const;
+
+    float
+        getMass(uint32_t slot) const {
+        return m_bodies[slot].invMass > 0.0f ? 1.0f / m_bodies[slot].invMass : 0.0f;
+    }
+
+    /**
+     * @brief AABB de los cuerpos estáticos, por ejemplo para construir una rejilla de navegación.
+     */
+    void
+        getStaticBounds(std::vector<sf::FloatRect>& bounds) const;
+
+    const PhysicsStats&
+        getStats() const {
+        return m_stats;
+    }
+
+    /**
+     * @brief Guarda el movimiento de los cuerpos y los contactos usados para warm starting.
+     */
+    void
+        saveState(StateWriter& writer);
+
+    /**
+     * @brief Restaura lo guardado por saveState y recalcula la forma de cada cuerpo.
+     * @return false si los cuerpos registrados no son los mismos.
+     */
+    bool
+        loadState(StateReader& reader);
+
+private:
+    /*
+    * @struct Body
+    * @brief Cuerpo rígido; la posición es la del centro de masa.
+    */
+    struct
+        Body {
+        Collider* owner = nullptr;
+        BodyType type = BODY_STATIC;
+        ColliderType shape = COLLIDER_CIRCLE;
+        float radius = 0.0f;
+        uint32_t vertexCount = 0;
+        sf::Vector2f localVertices[ColliderShape::MAX_VERTICES];  ///< Relativos al centro de masa.
+        sf::Vector2f localNormals[ColliderShape::MAX_VERTICES];
+        sf::Vector2f worldVertices[ColliderShape::MAX_VERTICES];  ///< Actualizados tras integrar.
+        sf::Vector2f worldNormals[ColliderShape::MAX_VERTICES];
+        sf::Vector2f localCenter;       ///< Centro de masa relativo al origen del actor.
+        sf::Vector2f position;
+        float angle = 0.0f;             ///< Radianes.
+        sf::Vector2f velocity;
+        float angularVelocity = 0.0f;
+        sf::Vector2f force;
+        float mass = 0.0f;              ///< Masa según la densidad, aunque el cuerpo sea estático.
+        float inertia = 0.0f;
+        float invMass = 0.0f;
+        float invInertia = 0.0f;
+        float friction = 0.4f;
+        float restitution = 0.1f;
+        float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+        float coreRadius = 0.0f;        ///< Círculo inscrito alrededor del centro de masa.
+        bool bullet = false;
+    };
+
+    /*
+    * @struct Contact
+    * @brief Contacto entre dos cuerpos, con la normal de a hacia b.
+    */
+    struct
+        Contact {
+        uint32_t a = 0;
+        uint32_t b = 0;
+        uint32_t pointCount = 0;
+        sf::Vector2f normal;
+        sf::Vector2f points[2];
+        float penetration[2] = { 0.0f, 0.0f };
+        float normalImpulse[2] = { 0.0f, 0.0f };
+        float tangentImpulse[2] = { 0.0f, 0.0f };
+        float normalMass[2] = { 0.0f, 0.0f };
+        float tangentMass[2] = { 0.0f, 0.0f };
+        float bias[2] = { 0.0f, 0.0f };
+        float friction = 0.0f;
+    };
+
+    /**
+     * @brief Recalcula vértices, normales y AABB en coordenadas de mundo.
+     */
+    static void
+        updateWorldShape(Body& body);
+
+    /**
+     * @brief Masa e inercia según la forma, la densidad y el tipo de cuerpo.
+     */
+    static void
+        updateMass(Body& body);
+
+    /**
+     * @brief Corrige el orden por minX y el ancho máximo de los AABB.
+     */
+    void
+        sortByMinX();
+
+    /**
+     * @brief Recoloca un cuerpo que se movió en m_sortedByMinX, que por lo demás sigue ordenado.
+     */
+    void
+        resortBody(uint32_t slot);
+
+    void
+        broadPhase();
+
+    void
+        narrowPhase();
+
+    /**
+     * @brief Agrupa los contactos por isla en m_islandContacts / m_islandStart.
+     */
+    void
+        buildIslands();
+
+    /**
+     * @brief Resuelve con impulsos secuenciales los contactos de una isla.
+     */
+    void
+        solveIsland(uint32_t island, float timeStep);
+
+    bool
+        collide(uint32_t a, uint32_t b, Contact& contact) const;
+
+    /**
+     * @brief Fracción del recorrido en que un círculo barrido toca a un cuerpo.
+     * @return false si no lo toca o si ya se superponían al inicio.
+     */
+    bool
+        castAgainst(const Body& body,
+                    const sf::Vector2f& start,
+                    const sf::Vector2f& delta,
+                    float radius,
+                    float& fraction,
+                    sf::Vector2f& normal) const;
+
+    /**
+     * @brief Integra un cuerpo bala en subpasos que se detienen en cada impacto.
+     */
+    void
+        integrateBullet(uint32_t slot, float timeStep);
+
+    /**
+     * @brief Aplica un impulso de b sobre a en sentido opuesto; ignora los cuerpos sin masa.
+     */
+    static void
+        applyContactImpulse(Body& a, Body& b, const sf::Vector2f& rA, const sf::Vector2f& rB, const sf::Vector2f& impulse);
+
+    uint32_t
+        findRoot(uint32_t body);
+
+    std::vector<Body> m_bodies;
+    std::vector<uint32_t> m_sortedByMinX;       ///< Orden persistente del sort-and-sweep.
+    std::vector<std::pair<uint32_t, uint32_t>> m_pairs;
+    std::vector<Contact> m_contacts;
+    std::vector<Contact> m_previousContacts;    ///< Contactos del paso anterior, ordenados por par.
+    std::vector<uint32_t> m_parent;             ///< Union-find de islas.
+    std::vector<uint32_t> m_islandOf;           ///< Isla de cada raíz del union-find.
+    std::vector<uint32_t> m_islandStart;        ///< Inicio de cada isla en m_islandContacts.
+    std::vector<uint32_t> m_islandContacts;     ///< Contactos ordenados por isla.
+    std::vector<uint32_t> m_bullets;            ///< Cuerpos bala del paso actual.
+
+    sf::Vector2f m_gravity{ 0.0f, 0.0f };       ///< Vista cenital: sin gravedad por defecto.
+    float m_timeStep = 1.0f / 60.0f;
+    float m_accumulator = 0.0f;
+    uint32_t m_iterations = 8;
+    uint32_t m_maxStepsPerUpdate = 4;
+    uint32_t m_maxBulletSubSteps = 4;
+    float m_maxWidth = 0.0f;                    ///< Ancho del AABB más ancho, para acotar las consultas.
+    PhysicsStats m_stats;
+};
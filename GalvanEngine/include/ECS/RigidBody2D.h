@@ -0,0 +1,108 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "ECS/Collider.h"
+#include "ECS/PhysicsWorld.h"
+#include "Window.h"
+
+/**
+ * @class RigidBody2D
+ * @brief Componente que vuelve dinámico (o cinemático) al cuerpo de un Collider.
+ *
+ * La velocidad, las fuerzas y la masa viven en el PhysicsWorld; el componente solo
+ * retiene el Collider del mismo actor y reenvía las llamadas.
+ */
+class
+    RigidBody2D : public Component {
+public:
+    /**
+     * @brief Crea el cuerpo con la forma del collider indicado.
+     * @param collider Collider del mismo actor.
+     * @param type BODY_DYNAMIC o BODY_KINEMATIC.
+     */
+    RigidBody2D(EngineUtilities::TSharedPointer<Collider> collider, BodyType type = BODY_DYNAMIC)
+        : Component(ComponentType::PHYSICS),
+          m_collider(collider) {
+        PhysicsWorld::getInstance().setBodyType(m_collider->getSlot(), type);
+    }
+
+    virtual
+        ~RigidBody2D() {
+        if (!m_collider.isNull()) {
+            PhysicsWorld::getInstance().setBodyType(m_collider->getSlot(), BODY_STATIC);
+        }
+    }
+
+    RigidBody2D(const RigidBody2D&) = delete;
+    RigidBody2D& operator=(const RigidBody2D&) = delete;
+
+    /**
+     * @brief La simulación ocurre en PhysicsWorld::update, no por componente.
+     */
+    void
+        update(float deltaTime) override {
+        (void)deltaTime;
+    }
+
+    void
+        render(Window window) override {
+        (void)window;
+    }
+
+    void
+        setVelocity(const sf::Vector2f& velocity) {
+        PhysicsWorld::getInstance().setVelocity(m_collider->getSlot(), velocity);
+    }
+
+    sf::Vector2f
+        getVelocity() const {
+        return PhysicsWorld::getInstance().getVelocity(m_collider->getSlot());
+    }
+
+    void
+        setAngularVelocity(float radiansPerSecond) {
+        PhysicsWorld::getInstance().setAngularVelocity(m_collider->getSlot(), radiansPerSecond);
+    }
+
+    /**
+     * @brief Aplica una fuerza en el centro de masa durante el siguiente paso.
+     */
+    void
+        applyForce(const sf::Vector2f& force) {
+        PhysicsWorld::getInstance().applyForce(m_collider->getSlot(), force);
+    }
+
+    /**
+     * @brief Cambia la velocidad de inmediato, en el punto del mundo indicado.
+     */
+    void
+        applyImpulse(const sf::Vector2f& impulse, const sf::Vector2f& worldPoint) {
+        PhysicsWorld::getInstance().applyImpulse(m_collider->getSlot(), impulse, worldPoint);
+    }
+
+    /**
+     * @brief Detección continua para cuerpos rápidos que podrían atravesar paredes delgadas.
+     */
+    void
+        setBullet(bool bullet) {
+        PhysicsWorld::getInstance().setBullet(m_collider->getSlot(), bullet);
+    }
+
+    bool
+        isBullet() const {
+        return PhysicsWorld::getInstance().isBullet(m_collider->getSlot());
+    }
+
+    float
+        getMass() const {
+        return PhysicsWorld::getInstance().getMass(m_collider->getSlot());
+    }
+
+    const EngineUtilities::TSharedPointer<Collider>&
+        getCollider() const {
+        return m_collider;
+    }
+
+private:
+    EngineUtilities::TSharedPointer<Collider> m_collider;
+};
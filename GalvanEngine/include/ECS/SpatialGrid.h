@@ -0,0 +1,97 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @class SpatialGrid
+ * @brief Rejilla uniforme de puntos para consultar vecinos cercanos.
+ *
+ * Se reconstruye por completo cada frame con un counting sort: las celdas se dispersan
+ * en una tabla hash de tamaño potencia de dos, así el mundo no necesita límites. Los
+ * índices quedan ordenados por celda en un solo arreglo contiguo, sin listas ni
+ * asignaciones por celda.
+ *
+ * Una consulta visita las 3x3 celdas alrededor de un punto; si el radio de búsqueda no
+ * pasa del tamaño de celda, ningún vecino queda fuera. Las colisiones de la tabla solo
+ * agregan candidatos, que el llamador descarta al medir la distancia.
+ */
+class
+    SpatialGrid {
+public:
+    SpatialGrid() = default;
+    ~SpatialGrid() = default;
+
+    /**
+     * @brief Reconstruye la rejilla con los puntos indicados.
+     * @param x Coordenadas X, una por punto.
+     * @param y Coordenadas Y, una por punto.
+     * @param count Número de puntos.
+     * @param cellSize Tamaño de celda; normalmente el radio de búsqueda.
+     */
+    void
+        build(const float* x, const float* y, size_t count, float cellSize);
+
+    /**
+     * @brief Llama func(index) con cada punto de las 3x3 celdas alrededor de (x, y).
+     */
+    template<typename Func>
+    void
+        forEachNear(float x, float y, Func&& func) const {
+        if (m_items.empty()) {
+            return;
+        }
+        int cellX = toCell(x);
+        int cellY = toCell(y);
+        uint32_t visited[9];
+        int visitedCount = 0;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                uint32_t bucket = hashCell(cellX + dx, cellY + dy);
+                // Dos celdas vecinas pueden caer en la misma cubeta; se visita una vez
+                bool repeated = false;
+                for (int i = 0; i < visitedCount; ++i) {
+                    repeated = repeated || visited[i] == bucket;
+                }
+                if (repeated) {
+                    continue;
+                }
+                visited[visitedCount++] = bucket;
+                for (uint32_t i = m_cellStart[bucket]; i < m_cellStart[bucket + 1]; ++i) {
+                    func(m_items[i]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Índices de los puntos ordenados por cubeta; recorrerlos en este orden
+     * mantiene en caché los vecinos de consultas consecutivas.
+     */
+    const std::vector<uint32_t>&
+        getItems() const {
+        return m_items;
+    }
+
+    float
+        getCellSize() const {
+        return m_cellSize;
+    }
+
+private:
+    int
+        toCell(float value) const {
+        return static_cast<int>(std::floor(value * m_inverseCellSize));
+    }
+
+    uint32_t
+        hashCell(int cellX, int cellY) const {
+        uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellY) * 19349663u;
+        return hash & m_tableMask;
+    }
+
+    float m_cellSize = 1.0f;
+    float m_inverseCellSize = 1.0f;
+    uint32_t m_tableMask = 0;
+    std::vector<uint32_t> m_cellStart;  ///< Inicio de cada cubeta en m_items; tamaño de la tabla + 1.
+    std::vector<uint32_t> m_items;      ///< Índices de los puntos ordenados por cubeta.
+    std::vector<uint32_t> m_itemBucket; ///< Cubeta de cada punto, usada durante build.
+};
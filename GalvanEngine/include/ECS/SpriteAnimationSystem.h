@@ -0,0 +1,193 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/SpriteAnimator.h"
+#include "Render/RenderQueue.h"
+
+class StateWriter;
+class StateReader;
+
+/**
+ * @class SpriteAnimationSystem
+ * @brief Avanza a todos los SpriteAnimator en lote y construye sus lotes de vértices.
+ *
+ * En update cada sprite avanza su tiempo, calcula el cuadro de su clip y produce los
+ * eventos de los cuadros que se mostraron. collectBatches ordena los sprites visibles por
+ * (capa, atlas, profundidad) y escribe cuatro vértices por sprite, con las coordenadas de
+ * textura de su cuadro, en un arreglo nuevo por cada grupo; ninguna sf::Shape se toca.
+ *
+ * Solo debe usarse desde el hilo de simulación.
+ */
+class
+    SpriteAnimationSystem {
+private:
+    SpriteAnimationSystem() = default;
+    ~SpriteAnimationSystem() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    SpriteAnimationSystem(const SpriteAnimationSystem&) = delete;
+    SpriteAnimationSystem& operator=(const SpriteAnimationSystem&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static SpriteAnimationSystem& getInstance() {
+        static SpriteAnimationSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Registra un sprite y devuelve su lugar en los arreglos.
+     */
+    uint32_t
+        add(SpriteAnimator* owner, const SpriteAtlas* atlas);
+
+    /**
+     * @brief Quita un sprite; el último ocupa su lugar y se le avisa a su componente.
+     */
+    void
+        remove(uint32_t slot);
+
+    /**
+     * @brief Avanza los clips de todos los sprites.
+     * @param deltaTime Tiempo transcurrido desde la última actualización
+     */
+    void
+        update(float deltaTime);
+
+    /**
+     * @brief Agrega los lotes de los sprites que tocan el área visible.
+     * @param viewBounds Área visible en coordenadas de mundo
+     * @param out Lotes del frame; sus vértices no se modifican después
+     */
+    void
+        collectBatches(const sf::FloatRect& viewBounds, std::vector<RenderBatch>& out);
+
+    /**
+     * @brief Eventos del último update, en el orden de los arreglos.
+     */
+    const std::vector<SpriteEvent>&
+        getEvents() const {
+        return m_events;
+    }
+
+    /**
+     * @brief Reproduce el clip en el slot; los clips nulos o sin cuadros se ignoran.
+     */
+    void
+        play(uint32_t slot, const AnimationClip* clip, bool restart);
+
+    void
+        setPlaying(uint32_t slot, bool playing) {
+        m_playing[slot] = playing ? 1 : 0;
+    }
+
+    void
+        setSpeed(uint32_t slot, float speed) {
+        m_speeds[slot] = std::max(0.0f, speed);
+    }
+
+    void
+        setFrame(uint32_t slot, uint16_t frame);
+
+    uint16_t
+        getFrame(uint32_t slot) const {
+        return m_frames[slot];
+    }
+
+    bool
+        isFinished(uint32_t slot) const {
+        return m_finished[slot] != 0;
+    }
+
+    void
+        setSize(uint32_t slot, const sf::Vector2f& size) {
+        m_sizes[slot] = size;
+    }
+
+    void
+        setColor(uint32_t slot, const sf::Color& color) {
+        m_colors[slot] = color;
+    }
+
+    void
+        setTransform(uint32_t slot, const sf::Vector2f& position, float rotation, const sf::Vector2f& scale) {
+        m_positions[slot] = position;
+        m_rotations[slot] = rotation;
+        m_scales[slot] = scale;
+    }
+
+    void
+        setRenderOrder(uint32_t slot, uint8_t layer, float depth) {
+        m_layers[slot] = layer;
+        m_depths[slot] = depth;
+    }
+
+    size_t
+        getCount() const {
+        return m_owners.size();
+    }
+
+    /**
+     * @brief Sprites escritos en lotes en el último collectBatches.
+     */
+    size_t
+        getDrawnCount() const {
+        return m_drawnCount;
+    }
+
+    /**
+     * @brief Guarda clip, tiempo y cuadro de cada sprite.
+     */
+    void
+        saveState(StateWriter& writer);
+
+    /**
+     * @brief Restaura lo guardado por saveState.
+     * @return false si los sprites o sus atlas no son los mismos.
+     */
+    bool
+        loadState(StateReader& reader);
+
+private:
+    /**
+     * @brief Pasos del clip antes de repetirse.
+     */
+    static int32_t
+        getCycleLength(const AnimationClip& clip);
+
+    /**
+     * @brief Posición en clip.frames del paso step de un ciclo.
+     */
+    static uint16_t
+        getClipIndex(const AnimationClip& clip, int32_t step);
+
+    std::vector<SpriteAnimator*> m_owners;
+    std::vector<const SpriteAtlas*> m_atlases;  ///< Los atlas los mantiene vivos cada componente.
+    std::vector<const AnimationClip*> m_clips;  ///< nullptr si el sprite muestra un cuadro fijo.
+    std::vector<float> m_times;                 ///< Segundos dentro del ciclo actual del clip.
+    std::vector<int32_t> m_steps;               ///< Último paso mostrado del ciclo; -1 antes del primero.
+    std::vector<float> m_speeds;
+    std::vector<uint8_t> m_playing;
+    std::vector<uint8_t> m_finished;
+    std::vector<uint16_t> m_frames;             ///< Cuadro del atlas que se muestra.
+    std::vector<sf::Vector2f> m_sizes;
+    std::vector<sf::Vector2f> m_positions;
+    std::vector<float> m_rotations;
+    std::vector<sf::Vector2f> m_scales;
+    std::vector<sf::Color> m_colors;
+    std::vector<uint8_t> m_layers;
+    std::vector<float> m_depths;
+
+    std::vector<SpriteEvent> m_events;
+
+    // Buffers de collectBatches, conservan su capacidad entre frames
+    std::vector<uint64_t> m_keys;
+    std::vector<uint32_t> m_order;
+    std::vector<uint64_t> m_tmpKeys;
+    std::vector<uint32_t> m_tmpOrder;
+    std::unordered_map<const SpriteAtlas*, uint16_t> m_atlasIds;
+    size_t m_drawnCount = 0;
+};
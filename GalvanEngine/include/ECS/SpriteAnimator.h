@@ -0,0 +1,232 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "Window.h"
+#include "Texture.h"
+
+/*
+* @enum ClipPlayback
+* @brief Qué hace un clip al llegar a su último cuadro.
+*/
+enum
+    ClipPlayback {
+    CLIP_ONCE = 0,          ///< Se queda en el último cuadro.
+    CLIP_LOOP = 1,
+    CLIP_PING_PONG = 2      ///< Regresa hacia el primer cuadro y vuelve a empezar.
+};
+
+/*
+* @struct AnimationClip
+* @brief Secuencia de cuadros de un atlas con su velocidad y sus eventos.
+*/
+struct
+    AnimationClip {
+    std::string name;
+    std::vector<uint16_t> frames;   ///< Índices de cuadros del atlas.
+    float framesPerSecond = 12.0f;
+    ClipPlayback playback = CLIP_LOOP;
+    std::vector<std::pair<uint16_t, std::string>> events;   ///< (posición en frames, nombre).
+};
+
+/**
+ * @class SpriteAtlas
+ * @brief Textura del ResourceManager dividida en cuadros, con los clips que los usan.
+ *
+ * Se comparte con std::shared_ptr<const SpriteAtlas> entre todos los sprites que lo usan.
+ * Retiene su textura, así el caché de texturas no la desaloja mientras el atlas exista.
+ */
+class
+    SpriteAtlas {
+public:
+    /**
+     * @brief Carga la textura con el ResourceManager y la divide en una rejilla de cuadros.
+     * @param textureName Nombre del archivo de la textura
+     * @param extension Extensión del archivo de la textura
+     * @param frameSize Tamaño de cada cuadro en pixeles; (0, 0) deja un solo cuadro con toda la textura.
+     */
+    SpriteAtlas(const std::string& textureName, const std::string& extension, const sf::Vector2u& frameSize);
+
+    /**
+     * @brief Agrega un cuadro con un rectángulo arbitrario de la textura.
+     * @return Índice del cuadro.
+     */
+    uint16_t
+        addFrame(const sf::IntRect& rect);
+
+    /**
+     * @brief Agrega o reemplaza un clip; los cuadros fuera del atlas se descartan.
+     */
+    void
+        addClip(const AnimationClip& clip);
+
+    /**
+     * @brief Clip con ese nombre, o nullptr si no existe.
+     */
+    const AnimationClip*
+        findClip(const std::string& name) const;
+
+    const sf::IntRect&
+        getFrame(uint16_t index) const {
+        return m_frames[index];
+    }
+
+    size_t
+        getFrameCount() const {
+        return m_frames.size();
+    }
+
+    const sf::Texture*
+        getTexture() const {
+        return m_texture.isNull() ? nullptr : &m_texture->getTexture();
+    }
+
+private:
+    EngineUtilities::TSharedPointer<Texture> m_texture;
+    std::vector<sf::IntRect> m_frames;
+    std::deque<AnimationClip> m_clips;  ///< deque: los punteros a clips siguen válidos al agregar más.
+};
+
+/*
+* @enum SpriteEventType
+* @brief Tipo de evento de animación.
+*/
+enum
+    SpriteEventType {
+    SPRITE_EVENT_MARKER = 0,    ///< Se mostró un cuadro con un evento del clip.
+    SPRITE_EVENT_FINISHED = 1   ///< Un clip CLIP_ONCE llegó a su último cuadro.
+};
+
+class SpriteAnimator;
+
+/*
+* @struct SpriteEvent
+* @brief Evento producido en el último SpriteAnimationSystem::update.
+*
+* name apunta al nombre del evento o del clip dentro del atlas; solo debe leerse antes
+* del siguiente update.
+*/
+struct
+    SpriteEvent {
+    SpriteAnimator* animator = nullptr;
+    SpriteEventType type = SPRITE_EVENT_MARKER;
+    const std::string* name = nullptr;
+};
+
+/**
+ * @class SpriteAnimator
+ * @brief Componente que dibuja a un actor con cuadros animados de un SpriteAtlas.
+ *
+ * Igual que Path, el componente solo guarda su lugar en el SpriteAnimationSystem, que
+ * avanza todos los sprites juntos y escribe sus vértices y coordenadas de textura
+ * directamente en lotes, uno por atlas y capa. Un actor con SpriteAnimator ya no dibuja
+ * su ShapeFactory.
+ */
+class
+    SpriteAnimator : public Component {
+public:
+    /**
+     * @brief Crea un sprite que muestra el primer cuadro del atlas.
+     */
+    SpriteAnimator(std::shared_ptr<const SpriteAtlas> atlas);
+
+    virtual
+        ~SpriteAnimator();
+
+    SpriteAnimator(const SpriteAnimator&) = delete;
+    SpriteAnimator& operator=(const SpriteAnimator&) = delete;
+
+    /**
+     * @brief El avance ocurre en SpriteAnimationSystem::update, no por componente.
+     */
+    void
+        update(float deltaTime) override {
+        (void)deltaTime;
+    }
+
+    void
+        render(Window window) override {
+        (void)window;
+    }
+
+    /**
+     * @brief Reproduce un clip del atlas.
+     * @param restart true para reiniciarlo aunque ya se esté reproduciendo.
+     * @return false si el atlas no tiene ese clip o el clip no tiene cuadros.
+     */
+    bool
+        play(const std::string& clipName, bool restart = false);
+
+    /**
+     * @brief Detiene el clip en el cuadro actual.
+     */
+    void
+        pause();
+
+    void
+        resume();
+
+    /**
+     * @brief Multiplicador de la velocidad del clip; negativo se trata como 0.
+     */
+    void
+        setSpeed(float speed);
+
+    /**
+     * @brief Muestra un cuadro del atlas fijo, sin clip.
+     */
+    void
+        setFrame(uint16_t frame);
+
+    /**
+     * @brief Cuadro del atlas que se muestra.
+     */
+    uint16_t
+        getFrame() const;
+
+    /**
+     * @brief true si un clip CLIP_ONCE llegó a su último cuadro.
+     */
+    bool
+        isFinished() const;
+
+    /**
+     * @brief Tamaño del sprite en unidades de mundo antes de la escala; (0, 0) usa el del cuadro.
+     */
+    void
+        setSize(const sf::Vector2f& size);
+
+    void
+        setColor(const sf::Color& color);
+
+    /**
+     * @brief Copia el Transform del actor; el sprite se centra en position.
+     * @param rotation Grados.
+     */
+    void
+        setTransform(const sf::Vector2f& position, float rotation, const sf::Vector2f& scale);
+
+    void
+        setRenderOrder(uint8_t layer, float depth);
+
+    const std::shared_ptr<const SpriteAtlas>&
+        getAtlas() const {
+        return m_atlas;
+    }
+
+    /**
+     * @brief Lugar del sprite en los arreglos del SpriteAnimationSystem; lo mantiene el sistema.
+     */
+    uint32_t
+        getSlot() const {
+        return m_slot;
+    }
+
+    void
+        setSlot(uint32_t slot) {
+        m_slot = slot;
+    }
+
+private:
+    std::shared_ptr<const SpriteAtlas> m_atlas;
+    uint32_t m_slot = 0;
+};
@@ -0,0 +1,101 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "ECS/SteeringSystem.h"
+#include "Window.h"
+
+/**
+ * @class Steering
+ * @brief Componente que mueve a un actor con los comportamientos del SteeringSystem.
+ *
+ * El componente solo guarda su lugar en el sistema; la posición, la velocidad y los pesos
+ * viven en los arreglos del SteeringSystem, que calcula a todos los agentes juntos.
+ */
+class
+    Steering : public Component {
+public:
+    /**
+     * @brief Registra un agente en la posición indicada.
+     */
+    Steering(const sf::Vector2f& position, const SteeringWeights& weights) : Component(ComponentType::STEERING) {
+        m_slot = SteeringSystem::getInstance().add(this, position, weights);
+    }
+
+    virtual
+        ~Steering() {
+        SteeringSystem::getInstance().remove(m_slot);
+    }
+
+    Steering(const Steering&) = delete;
+    Steering& operator=(const Steering&) = delete;
+
+    /**
+     * @brief El avance ocurre en SteeringSystem::update, no por componente.
+     */
+    void
+        update(float deltaTime) override {
+        (void)deltaTime;
+    }
+
+    void
+        render(Window window) override {
+        (void)window;
+    }
+
+    /**
+     * @brief Objetivo de seek, flee y arrive.
+     */
+    void
+        setTarget(const sf::Vector2f& target) {
+        SteeringSystem::getInstance().setTarget(m_slot, target);
+    }
+
+    /**
+     * @brief Campo que sigue el comportamiento flow, normalmente de NavigationService::getFlowField.
+     */
+    void
+        setFlowField(std::shared_ptr<const FlowField> field) {
+        SteeringSystem::getInstance().setFlowField(m_slot, std::move(field));
+    }
+
+    void
+        setWeights(const SteeringWeights& weights) {
+        SteeringSystem::getInstance().setWeights(m_slot, weights);
+    }
+
+    SteeringWeights
+        getWeights() const {
+        return SteeringSystem::getInstance().getWeights(m_slot);
+    }
+
+    void
+        setPosition(const sf::Vector2f& position) {
+        SteeringSystem::getInstance().setPosition(m_slot, position);
+    }
+
+    sf::Vector2f
+        getPosition() const {
+        return SteeringSystem::getInstance().getPosition(m_slot);
+    }
+
+    sf::Vector2f
+        getVelocity() const {
+        return SteeringSystem::getInstance().getVelocity(m_slot);
+    }
+
+    /**
+     * @brief Lugar del agente en los arreglos del SteeringSystem; lo mantiene el sistema.
+     */
+    uint32_t
+        getSlot() const {
+        return m_slot;
+    }
+
+    void
+        setSlot(uint32_t slot) {
+        m_slot = slot;
+    }
+
+private:
+    uint32_t m_slot = 0;
+};
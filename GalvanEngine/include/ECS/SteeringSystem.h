@@ -0,0 +1,255 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/SpatialGrid.h"
+#include "Services/FlowField.h"
+
+class Steering;
+class StateWriter;
+class StateReader;
+
+/*
+* @struct SteeringWeights
+* @brief Peso de cada comportamiento en la fuerza de un agente; 0 lo desactiva.
+*/
+struct
+    SteeringWeights {
+    float seek = 0.0f;
+    float flee = 0.0f;
+    float arrive = 0.0f;
+    float wander = 0.0f;
+    float separation = 0.0f;
+    float alignment = 0.0f;
+    float cohesion = 0.0f;
+    float flow = 0.0f;          ///< Sigue la dirección del FlowField asignado al agente.
+    float maxSpeed = 200.0f;    ///< Unidades por segundo.
+    float maxForce = 400.0f;    ///< Aceleración máxima.
+};
+
+/*
+* @struct SteeringSettings
+* @brief Radios y parámetros compartidos por todos los agentes.
+*/
+struct
+    SteeringSettings {
+    float neighborRadius = 50.0f;   ///< Radio de alineación y cohesión; también es el tamaño de celda.
+    float separationRadius = 25.0f;
+    float slowingRadius = 100.0f;   ///< Arrive frena dentro de este radio.
+    float panicRadius = 150.0f;     ///< Flee solo actúa dentro de este radio.
+    float wanderDistance = 60.0f;   ///< Distancia del círculo de wander frente al agente.
+    float wanderRadius = 30.0f;
+    float wanderJitter = 3.0f;      ///< Radianes por segundo que puede cambiar el ángulo de wander.
+};
+
+/**
+ * @class SteeringSystem
+ * @brief Comportamientos de steering (seek, flee, arrive, wander, separation, alignment,
+ * cohesion, flow) para todos los componentes Steering en lote.
+ *
+ * Los agentes viven en arreglos por campo (SoA). Cada frame:
+ * 1. Se reconstruye un SpatialGrid con las posiciones.
+ * 2. Por bloques en el JobSystem, cada agente suma a sus vecinos (separación, velocidad
+ *    y posición promedio) y avanza su ángulo de wander; solo escribe en sus propios datos.
+ *    Los agentes se recorren en el orden de celdas de la rejilla para que los vecinos de
+ *    agentes consecutivos sigan en caché.
+ * 3. Por bloques, las fuerzas se combinan, se truncan y se integran de cuatro en cuatro
+ *    agentes con SSE cuando está disponible.
+ *
+ * Transform::Seek sigue siendo la versión escalar para un solo objeto.
+ * Solo debe usarse desde el hilo de simulación.
+ */
+class
+    SteeringSystem {
+private:
+    SteeringSystem() = default;
+    ~SteeringSystem() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    SteeringSystem(const SteeringSystem&) = delete;
+    SteeringSystem& operator=(const SteeringSystem&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static SteeringSystem& getInstance() {
+        static SteeringSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Registra un agente y devuelve su lugar en los arreglos.
+     */
+    uint32_t
+        add(Steering* owner, const sf::Vector2f& position, const SteeringWeights& weights);
+
+    /**
+     * @brief Quita un agente; el último ocupa su lugar y se le avisa a su componente.
+     */
+    void
+        remove(uint32_t slot);
+
+    /**
+     * @brief Calcula las fuerzas e integra a todos los agentes.
+     * @param deltaTime Tiempo transcurrido desde la última actualización
+     */
+    void
+        update(float deltaTime);
+
+    void
+        setSettings(const SteeringSettings& settings) {
+        m_settings = settings;
+    }
+
+    const SteeringSettings&
+        getSettings() const {
+        return m_settings;
+    }
+
+    void
+        setWeights(uint32_t slot, const SteeringWeights& weights);
+
+    SteeringWeights
+        getWeights(uint32_t slot) const;
+
+    void
+        setTarget(uint32_t slot, const sf::Vector2f& target) {
+        m_targetX[slot] = target.x;
+        m_targetY[slot] = target.y;
+    }
+
+    void
+        setPosition(uint32_t slot, const sf::Vector2f& position) {
+        m_posX[slot] = position.x;
+        m_posY[slot] = position.y;
+    }
+
+    sf::Vector2f
+        getPosition(uint32_t slot) const {
+        return sf::Vector2f(m_posX[slot], m_posY[slot]);
+    }
+
+    void
+        setVelocity(uint32_t slot, const sf::Vector2f& velocity) {
+        m_velX[slot] = velocity.x;
+        m_velY[slot] = velocity.y;
+    }
+
+    sf::Vector2f
+        getVelocity(uint32_t slot) const {
+        return sf::Vector2f(m_velX[slot], m_velY[slot]);
+    }
+
+    /**
+     * @brief Campo que sigue el comportamiento flow; varios agentes pueden compartirlo.
+     */
+    void
+        setFlowField(uint32_t slot, std::shared_ptr<const FlowField> field) {
+        m_flowFields[slot] = std::move(field);
+    }
+
+    size_t
+        getCount() const {
+        return m_owners.size();
+    }
+
+    /**
+     * @brief Tiempo de la última actualización en milisegundos.
+     */
+    float
+        getUpdateTimeMs() const {
+        return m_updateTimeMs;
+    }
+
+    /**
+     * @brief Guarda los arreglos por campo y el estado aleatorio de cada agente.
+     */
+    void
+        saveState(StateWriter& writer);
+
+    /**
+     * @brief Restaura lo guardado por saveState; los flow fields no se guardan.
+     * @return false si los agentes registrados no son los mismos.
+     */
+    bool
+        loadState(StateReader& reader);
+
+private:
+    /**
+     * @brief Suma los vecinos y avanza el wander de un rango de agentes.
+     * @param begin Inicio del rango en el orden de la rejilla, no en el de los arreglos.
+     */
+    void
+        gatherNeighbors(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Combina las fuerzas e integra un rango de agentes.
+     */
+    void
+        integrate(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Agrega o quita un elemento de todos los arreglos por campo.
+     */
+    template<typename Func>
+    void
+        forEachArray(Func&& func) {
+        forEachStateArray(func);
+        func(m_separationX);
+        func(m_separationY);
+        func(m_alignX);
+        func(m_alignY);
+        func(m_centerX);
+        func(m_centerY);
+        func(m_wanderX);
+        func(m_wanderY);
+        func(m_flowX);
+        func(m_flowY);
+    }
+
+    /**
+     * @brief Solo los arreglos que pasan de un frame al siguiente; los de vecinos se recalculan.
+     */
+    template<typename Func>
+    void
+        forEachStateArray(Func&& func) {
+        func(m_posX);
+        func(m_posY);
+        func(m_velX);
+        func(m_velY);
+        func(m_targetX);
+        func(m_targetY);
+        func(m_seek);
+        func(m_flee);
+        func(m_arrive);
+        func(m_wander);
+        func(m_separation);
+        func(m_alignment);
+        func(m_cohesion);
+        func(m_flow);
+        func(m_maxSpeed);
+        func(m_maxForce);
+        func(m_wanderAngle);
+    }
+
+    SteeringSettings m_settings;
+    SpatialGrid m_grid;
+    std::vector<Steering*> m_owners;
+    std::vector<uint32_t> m_random;     ///< Estado xorshift de cada agente para wander.
+    std::vector<std::shared_ptr<const FlowField>> m_flowFields;
+
+    // Estado y parámetros por agente
+    std::vector<float> m_posX, m_posY, m_velX, m_velY, m_targetX, m_targetY;
+    std::vector<float> m_seek, m_flee, m_arrive, m_wander, m_separation, m_alignment, m_cohesion, m_flow;
+    std::vector<float> m_maxSpeed, m_maxForce, m_wanderAngle;
+
+    // Resultados del paso de vecinos, consumidos por integrate
+    std::vector<float> m_separationX, m_separationY;    ///< Suma de alejamientos, ponderada por cercanía.
+    std::vector<float> m_alignX, m_alignY;              ///< Velocidad promedio de los vecinos menos la propia.
+    std::vector<float> m_centerX, m_centerY;            ///< Centro de los vecinos menos la posición propia.
+    std::vector<float> m_wanderX, m_wanderY;            ///< Dirección de wander.
+    std::vector<float> m_flowX, m_flowY;                ///< Dirección del flow field en la celda del agente.
+
+    float m_updateTimeMs = 0.0f;
+};
@@ -0,0 +1,220 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "Render/RenderQueue.h"
+#include "Window.h"
+#include "Texture.h"
+
+/**
+ * @class Tilemap
+ * @brief Componente de mapa de tiles con varias capas, dibujado por bloques (chunks).
+ *
+ * El mapa se divide en bloques de CHUNK_SIZE x CHUNK_SIZE tiles. Cada bloque guarda un
+ * sf::VertexArray con sus tiles ya colocados y solo se reconstruye cuando alguno de sus
+ * tiles cambia. Por frame se recorren únicamente los bloques que tocan el área visible,
+ * así que el costo de dibujo depende de la pantalla y no del tamaño del mapa.
+ *
+ * Los bloques reconstruidos se reemplazan por un arreglo nuevo, de modo que un snapshot
+ * que todavía retiene el arreglo anterior puede dibujarlo sin sincronización.
+ */
+class
+    Tilemap : public Component {
+public:
+    static const uint32_t CHUNK_SIZE = 32;     ///< Tiles por lado de cada bloque.
+    static const uint16_t EMPTY_TILE = 0;      ///< Índice de tile vacío; el tileset inicia en 1.
+
+    /**
+     * @brief Constructor por defecto, registra el componente como TILEMAP.
+     */
+    Tilemap() : Component(ComponentType::TILEMAP) {}
+
+    /**
+     * @brief Crea un mapa vacío con una capa.
+     * @param width Ancho del mapa en tiles.
+     * @param height Alto del mapa en tiles.
+     */
+    Tilemap(uint32_t width, uint32_t height);
+
+    virtual
+        ~Tilemap() = default;
+
+    /**
+     * @brief Cambia el tamaño del mapa; se pierden los tiles de todas las capas.
+     * @param width Ancho del mapa en tiles.
+     * @param height Alto del mapa en tiles.
+     */
+    void
+        resize(uint32_t width, uint32_t height);
+
+    /**
+     * @brief Carga el tileset con el ResourceManager.
+     * @param fileName Nombre del archivo de la textura.
+     * @param extension Extensión del archivo de la textura.
+     * @param tileWidth Ancho de cada tile en píxeles.
+     * @param tileHeight Alto de cada tile en píxeles.
+     * @return true si la textura quedó disponible.
+     */
+    bool
+        setTileset(const std::string& fileName,
+                   const std::string& extension,
+                   uint32_t tileWidth,
+                   uint32_t tileHeight);
+
+    /**
+     * @brief Agrega una capa vacía encima de las existentes.
+     * @return Índice de la nueva capa.
+     */
+    uint32_t
+        addLayer();
+
+    /**
+     * @brief Establece un tile y marca su bloque para reconstrucción.
+     * @param layer Capa del tile.
+     * @param x Columna del tile.
+     * @param y Fila del tile.
+     * @param tile Índice en el tileset (1 en adelante) o EMPTY_TILE.
+     */
+    void
+        setTile(uint32_t layer, uint32_t x, uint32_t y, uint16_t tile);
+
+    /**
+     * @brief Obtiene el índice de un tile, EMPTY_TILE si está fuera del mapa.
+     */
+    uint16_t
+        getTile(uint32_t layer, uint32_t x, uint32_t y) const;
+
+    /**
+     * @brief Llena una capa completa con el mismo tile.
+     */
+    void
+        fill(uint32_t layer, uint16_t tile);
+
+    /**
+     * @brief Agrega a out un lote por cada bloque visible, reconstruyendo los que cambiaron.
+     * @param viewBounds Área visible en coordenadas de mundo.
+     * @param transform Transformación del actor dueño del mapa.
+     * @param renderLayer Capa de dibujo de los lotes.
+     * @param depth Profundidad base; cada capa del mapa suma uno.
+     * @param out Lotes del frame.
+     */
+    void
+        collectVisible(const sf::FloatRect& viewBounds,
+                       const sf::Transform& transform,
+                       uint8_t renderLayer,
+                       float depth,
+                       std::vector<RenderBatch>& out);
+
+    /**
+     * @brief Número máximo de bloques con geometría en memoria; los menos usados se liberan.
+     */
+    void
+        setMaxCachedChunks(uint32_t maxChunks) {
+        m_maxCachedChunks = maxChunks;
+    }
+
+    /**
+     * @brief Número de bloques con geometría en memoria.
+     */
+    uint32_t
+        getCachedChunkCount() const {
+        return m_cachedChunks;
+    }
+
+    /**
+     * @brief Número de reconstrucciones de bloques desde que se creó el mapa.
+     */
+    uint64_t
+        getChunkRebuildCount() const {
+        return m_chunkRebuilds;
+    }
+
+    uint32_t
+        getWidth() const {
+        return m_width;
+    }
+
+    uint32_t
+        getHeight() const {
+        return m_height;
+    }
+
+    uint32_t
+        getLayerCount() const {
+        return static_cast<uint32_t>(m_layers.size());
+    }
+
+    /**
+     * @brief Método para actualizar el componente, los bloques se reconstruyen al consultarlos.
+     * @param deltaTime Tiempo transcurrido desde la última actualización.
+     */
+    void
+        update(float deltaTime) override {
+        (void)deltaTime;
+    }
+
+    /**
+     * @brief Método para renderizar el componente, el dibujo lo realiza el actor.
+     * @param window Contexto del dispositivo para operaciones gráficas.
+     */
+    void
+        render(Window window) override {
+        (void)window;
+    }
+
+private:
+    /*
+    * @struct Chunk
+    * @brief Geometría cacheada de un bloque de una capa.
+    */
+    struct
+        Chunk {
+        std::shared_ptr<const sf::VertexArray> vertices; ///< nullptr si no está construido.
+        uint64_t lastUsedFrame = 0;
+        bool dirty = true;
+    };
+
+    /*
+    * @struct Layer
+    * @brief Tiles y bloques de una capa del mapa.
+    */
+    struct
+        Layer {
+        std::vector<uint16_t> tiles;  ///< Índices por fila, width * height.
+        std::vector<Chunk> chunks;    ///< Bloques por fila, chunksX * chunksY.
+    };
+
+    /**
+     * @brief Genera la geometría de un bloque a partir de sus tiles.
+     */
+    void
+        buildChunk(const Layer& layer, uint32_t chunkX, uint32_t chunkY, Chunk& chunk);
+
+    /**
+     * @brief Libera la geometría de los bloques menos usados si se excede el límite.
+     */
+    void
+        evictChunks();
+
+    /**
+     * @brief Marca como sucios todos los bloques de todas las capas.
+     */
+    void
+        invalidateChunks();
+
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_chunksX = 0;
+    uint32_t m_chunksY = 0;
+    std::vector<Layer> m_layers;
+
+    EngineUtilities::TSharedPointer<Texture> m_tileset; ///< Mantiene viva la textura del tileset.
+    const sf::Texture* m_tilesetTexture = nullptr;
+    uint32_t m_tileWidth = 16;
+    uint32_t m_tileHeight = 16;
+    uint32_t m_tilesetColumns = 1;
+
+    uint64_t m_frame = 0;                 ///< Se incrementa en cada collectVisible.
+    uint32_t m_cachedChunks = 0;
+    uint32_t m_maxCachedChunks = 1024;
+    uint64_t m_chunkRebuilds = 0;
+};
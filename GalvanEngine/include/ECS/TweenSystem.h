@@ -0,0 +1,283 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "ShapeFactory.h"
+#include "Transform.h"
+
+/*
+* @enum EaseType
+* @brief Curva que convierte el avance lineal de un tween en el avance animado.
+*/
+enum
+    EaseType {
+    EASE_LINEAR = 0,
+    EASE_IN_QUAD = 1,
+    EASE_OUT_QUAD = 2,
+    EASE_IN_OUT_QUAD = 3,
+    EASE_IN_CUBIC = 4,
+    EASE_OUT_CUBIC = 5,
+    EASE_IN_OUT_CUBIC = 6,
+    EASE_IN_SINE = 7,
+    EASE_OUT_SINE = 8,
+    EASE_IN_OUT_SINE = 9,
+    EASE_OUT_BACK = 10,     ///< Se pasa un poco del final y regresa.
+    EASE_OUT_BOUNCE = 11
+};
+
+/*
+* @enum TweenProperty
+* @brief Propiedad que anima un tween.
+*/
+enum
+    TweenProperty {
+    TWEEN_POSITION = 0,
+    TWEEN_ROTATION = 1,
+    TWEEN_SCALE = 2,
+    TWEEN_FILL_COLOR = 3    ///< Color de relleno de la figura de un ShapeFactory.
+};
+
+/*
+* @enum TweenLoop
+* @brief Qué hace un tween al llegar al final.
+*/
+enum
+    TweenLoop {
+    TWEEN_ONCE = 0,
+    TWEEN_RESTART = 1,      ///< Vuelve a empezar desde el valor inicial.
+    TWEEN_PING_PONG = 2     ///< Alterna entre ir y regresar.
+};
+
+/*
+* @struct TweenHandle
+* @brief Identificador de un tween; la generación detecta tweens ya terminados.
+*/
+struct
+    TweenHandle {
+    static const uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+    uint32_t generation = 0;
+
+    bool
+        isValid() const {
+        return index != INVALID;
+    }
+
+    bool
+        operator==(const TweenHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool
+        operator!=(const TweenHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+/*
+* @struct TweenEvent
+* @brief Tween que terminó en el último update.
+*/
+struct
+    TweenEvent {
+    TweenHandle handle;
+    TweenProperty property = TWEEN_POSITION;
+};
+
+/**
+ * @class TweenSystem
+ * @brief Anima posición, rotación y escala de Transform y el color de relleno de ShapeFactory.
+ *
+ * Los tweens viven en un pool denso con sus datos en arreglos por campo (SoA). Cada frame:
+ * 1. Se avanza el tiempo de todos los tweens y se evalúa su curva.
+ * 2. Se interpolan los cuatro canales de valor, de cuatro en cuatro tweens con SSE.
+ * 3. Se escribe el valor en cada objetivo.
+ * 4. Los tweens terminados salen del pool y sus callbacks se llaman juntos al final, así
+ *    un callback puede crear o cancelar tweens sin alterar el recorrido.
+ *
+ * Cada tween retiene a su objetivo mientras está activo; un tween que se repite sin fin
+ * debe cancelarse cuando su actor deja de usarse. Solo debe usarse desde el hilo de simulación.
+ */
+class
+    TweenSystem {
+private:
+    TweenSystem() = default;
+    ~TweenSystem() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    TweenSystem(const TweenSystem&) = delete;
+    TweenSystem& operator=(const TweenSystem&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static TweenSystem& getInstance() {
+        static TweenSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Anima la posición desde la actual hasta to.
+     * @param duration Duración en segundos.
+     */
+    TweenHandle
+        tweenPosition(EngineUtilities::TSharedPointer<Transform> target,
+                      const sf::Vector2f& to,
+                      float duration,
+                      EaseType ease = EASE_IN_OUT_QUAD);
+
+    TweenHandle
+        tweenRotation(EngineUtilities::TSharedPointer<Transform> target,
+                      const sf::Vector2f& to,
+                      float duration,
+                      EaseType ease = EASE_IN_OUT_QUAD);
+
+    TweenHandle
+        tweenScale(EngineUtilities::TSharedPointer<Transform> target,
+                   const sf::Vector2f& to,
+                   float duration,
+                   EaseType ease = EASE_IN_OUT_QUAD);
+
+    /**
+     * @brief Anima el color de relleno desde el actual hasta to, incluido el alfa.
+     */
+    TweenHandle
+        tweenFillColor(EngineUtilities::TSharedPointer<ShapeFactory> target,
+                       const sf::Color& to,
+                       float duration,
+                       EaseType ease = EASE_LINEAR);
+
+    /**
+     * @brief Repite el tween.
+     * @param loop TWEEN_RESTART o TWEEN_PING_PONG.
+     * @param count Ciclos antes de terminar; 0 lo repite sin fin.
+     */
+    void
+        setLoop(TweenHandle handle, TweenLoop loop, uint32_t count = 0);
+
+    /**
+     * @brief Espera antes de empezar; el objetivo no se modifica durante la espera.
+     */
+    void
+        setDelay(TweenHandle handle, float seconds);
+
+    /**
+     * @brief Función llamada al terminar, después de procesar todos los tweens del frame.
+     */
+    void
+        setOnComplete(TweenHandle handle, std::function<void(TweenHandle)> callback);
+
+    /**
+     * @brief Detiene el tween en su valor actual, sin llamar a su callback.
+     */
+    void
+        cancel(TweenHandle handle);
+
+    bool
+        isActive(TweenHandle handle) const {
+        return handle.index < m_handles.size() && m_handles[handle.index].generation == handle.generation &&
+               m_handles[handle.index].slot != INVALID_SLOT;
+    }
+
+    /**
+     * @brief Avanza todos los tweens.
+     * @param deltaTime Tiempo transcurrido desde la última actualización
+     */
+    void
+        update(float deltaTime);
+
+    /**
+     * @brief Tweens que terminaron en el último update.
+     */
+    const std::vector<TweenEvent>&
+        getCompleted() const {
+        return m_completed;
+    }
+
+    size_t
+        getCount() const {
+        return m_handleOfSlot.size();
+    }
+
+    float
+        getUpdateTimeMs() const {
+        return m_updateTimeMs;
+    }
+
+    /**
+     * @brief Evalúa una curva en t de [0, 1].
+     */
+    static float
+        ease(EaseType type, float t);
+
+private:
+    static const uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+    static const uint32_t CHANNELS = 4;
+
+    /*
+    * @struct HandleEntry
+    * @brief Lugar de un handle en el pool denso.
+    */
+    struct
+        HandleEntry {
+        uint32_t slot = INVALID_SLOT;
+        uint32_t generation = 0;
+    };
+
+    /**
+     * @brief Agrega un tween al pool con los valores inicial y final de sus canales.
+     */
+    TweenHandle
+        add(TweenProperty property, const float from[CHANNELS], const float to[CHANNELS], float duration, EaseType ease);
+
+    /**
+     * @brief Quita un tween del pool; el último ocupa su lugar.
+     */
+    void
+        removeSlot(uint32_t slot);
+
+    /**
+     * @brief Avance de cada tween y su curva; marca los que terminaron.
+     */
+    void
+        advance(float deltaTime);
+
+    /**
+     * @brief value = from + delta * eased para los cuatro canales.
+     */
+    void
+        interpolate();
+
+    /**
+     * @brief Escribe los valores en los objetivos.
+     */
+    void
+        apply();
+
+    std::vector<HandleEntry> m_handles;
+    std::vector<uint32_t> m_freeHandles;
+
+    // Pool denso, un elemento por tween activo
+    std::vector<uint32_t> m_handleOfSlot;
+    std::vector<EngineUtilities::TSharedPointer<Transform>> m_transforms;
+    std::vector<EngineUtilities::TSharedPointer<ShapeFactory>> m_shapes;
+    std::vector<std::function<void(TweenHandle)>> m_callbacks;
+    std::vector<float> m_from[CHANNELS];
+    std::vector<float> m_delta[CHANNELS];       ///< Valor final menos inicial.
+    std::vector<float> m_value[CHANNELS];
+    std::vector<float> m_time;                  ///< Tiempo desde que se creó, incluida la espera.
+    std::vector<float> m_delay;
+    std::vector<float> m_inverseDuration;
+    std::vector<float> m_eased;                 ///< Avance tras la curva.
+    std::vector<uint32_t> m_loopCount;          ///< 0 sin fin.
+    std::vector<uint8_t> m_ease;
+    std::vector<uint8_t> m_property;
+    std::vector<uint8_t> m_loop;
+
+    std::vector<uint32_t> m_finishedSlots;     ///< En orden creciente.
+    std::vector<TweenEvent> m_completed;
+    std::vector<std::pair<TweenHandle, std::function<void(TweenHandle)>>> m_pendingCallbacks;
+    float m_updateTimeMs = 0.0f;
+};
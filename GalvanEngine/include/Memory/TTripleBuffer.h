@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace EngineUtilities {
+	/**
+	 * @brief Clase TTripleBuffer para pasar datos de un productor a un consumidor sin bloqueos.
+	 *
+	 * Mantiene tres instancias de T: una que escribe el productor, una que lee el consumidor
+	 * y una intermedia con el último dato publicado. Publicar y adquirir solo intercambian
+	 * índices con una operación atómica, así que ninguno de los dos lados espera al otro.
+	 * Si el productor publica varias veces antes de que el consumidor adquiera, el consumidor
+	 * solo ve el dato más reciente.
+	 *
+	 * Los buffers se reutilizan, por lo que los contenedores dentro de T conservan su capacidad.
+	 */
+	template<typename T>
+	class TTripleBuffer
+	{
+	public:
+		TTripleBuffer() = default;
+
+		TTripleBuffer(const TTripleBuffer&) = delete;
+		TTripleBuffer& operator=(const TTripleBuffer&) = delete;
+
+		/**
+		 * @brief Buffer donde escribe el productor. Solo debe usarse desde el hilo productor.
+		 */
+		T& getWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+		/**
+		 * @brief Publica el buffer de escritura y toma el intermedio para el siguiente dato.
+		 */
+		void publish()
+		{
+			uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_writeIndex | DIRTY_BIT),
+			                                     std::memory_order_acq_rel);
+			m_writeIndex = previous & INDEX_MASK;
+		}
+
+		/**
+		 * @brief Toma el último dato publicado si hay uno nuevo. Solo desde el hilo consumidor.
+		 *
+		 * @return true si el buffer de lectura cambió, false si sigue siendo el anterior.
+		 */
+		bool acquire()
+		{
+			if ((m_middle.load(std::memory_order_relaxed) & DIRTY_BIT) == 0)
+			{
+				return false;
+			}
+			uint8_t previous = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+			m_readIndex = previous & INDEX_MASK;
+			return true;
+		}
+
+		/**
+		 * @brief Indica si el último dato publicado sigue sin adquirirse. Desde cualquier hilo.
+		 */
+		bool hasPending() const
+		{
+			return (m_middle.load(std::memory_order_acquire) & DIRTY_BIT) != 0;
+		}
+
+		/**
+		 * @brief Buffer que lee el consumidor, válido hasta el siguiente acquire().
+		 */
+		const T& getReadBuffer() const { return m_buffers[m_readIndex]; }
+
+	private:
+		static constexpr uint8_t DIRTY_BIT = 0x4;  ///< Marca de dato nuevo en el buffer intermedio.
+		static constexpr uint8_t INDEX_MASK = 0x3;
+
+		T m_buffers[3];                     ///< Instancias de escritura, intermedia y lectura.
+		std::atomic<uint8_t> m_middle{ 1 }; ///< Índice del buffer intermedio más la marca DIRTY_BIT.
+		uint8_t m_writeIndex = 0;           ///< Propiedad exclusiva del productor.
+		uint8_t m_readIndex = 2;            ///< Propiedad exclusiva del consumidor.
+	};
+}
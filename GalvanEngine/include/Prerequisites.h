@@ -4,12 +4,26 @@
 #include <sstream> 
 #include <vector> 
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <list>
+#include <atomic>
 #include <map>
 #include <fstream> 
 #include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <filesystem>
 
 // Third Parties
 #include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
 #include "Memory/TSharedPointer.h"
 #include "Memory/TStaticPtr.h"
 #include "Memory/TUniquePtr.h"
@@ -59,4 +73,4 @@ enum
     << " Error in data from params [" << errorMSG << "] \n"; \
   std::cerr << os_.str();                                   \
   exit(1);                                                  \
-}     }
\ No newline at end of file
+}
@@ -0,0 +1,205 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+class Window;
+
+/*
+* @enum RenderLayer
+* @brief Capas de dibujo. Una capa menor siempre se dibuja antes que una mayor.
+*/
+enum
+    RenderLayer {
+    BACKGROUND = 0,
+    WORLD = 1,
+    EFFECTS = 2,
+    OVERLAY = 3
+};
+
+/*
+* @struct RenderBatch
+* @brief Arreglo de vértices inmutable con su textura, listo para dibujarse en un solo llamado.
+*
+* Los vértices se comparten con std::shared_ptr (conteo atómico) para que un snapshot pueda
+* retenerlos en el hilo de render mientras la simulación reconstruye un arreglo nuevo.
+*/
+struct
+    RenderBatch {
+    std::shared_ptr<const sf::VertexArray> vertices; ///< Geometría del lote, no se modifica tras publicarse.
+    const sf::Texture* texture = nullptr;           ///< Textura del lote.
+    sf::Transform transform;                        ///< Transformación aplicada al dibujar.
+    uint8_t layer = 0;                              ///< Capa de dibujo.
+    float depth = 0.0f;                             ///< Profundidad dentro de la capa.
+};
+
+/*
+* @struct RenderQueueStats
+* @brief Estadísticas del último frame enviado por la RenderQueue.
+*/
+struct
+    RenderQueueStats {
+    unsigned int commands = 0;              ///< Comandos enviados en el frame.
+    unsigned int stateChanges = 0;          ///< Cambios de textura/material tras ordenar.
+    unsigned int stateChangesUnsorted = 0;  ///< Cambios que habría con el orden de inserción.
+    unsigned int stateChangesAvoided = 0;   ///< Diferencia entre ambos conteos.
+    float sortTimeMs = 0.0f;                ///< Tiempo del radix sort en milisegundos.
+};
+
+/**
+ * @class RenderQueue
+ * @brief Cola de dibujo ordenada por claves de 64 bits.
+ *
+ * Cada comando se registra con una clave compacta (capa, textura, material, profundidad)
+ * y un índice al comando. Una vez por frame las claves se ordenan con un radix sort LSD
+ * y los comandos se envían en ese orden, agrupando los cambios de textura y material.
+ *
+ * Layout de la clave (bit más significativo primero):
+ *   [63..56] capa | [55..40] textura | [39..32] material | [31..0] profundidad
+ */
+class
+    RenderQueue {
+public:
+    RenderQueue() = default;
+    ~RenderQueue() = default;
+
+    /**
+     * @brief Construye una clave de ordenamiento.
+     * @param layer Capa de dibujo.
+     * @param textureId Identificador compacto de la textura (0 = sin textura).
+     * @param material Identificador de shader/blend.
+     * @param depth Profundidad dentro de la capa, menor se dibuja primero.
+     */
+    static uint64_t
+        makeKey(uint8_t layer, uint16_t textureId, uint8_t material, float depth);
+
+    /**
+     * @brief Obtiene el identificador compacto de una textura, asignándolo si es nueva.
+     * @param texture Textura de SFML, puede ser nullptr.
+     */
+    uint16_t
+        getTextureId(const sf::Texture* texture);
+
+    /**
+     * @brief Vacía los comandos del frame. Los identificadores de textura se conservan.
+     */
+    void
+        clear();
+
+    /**
+     * @brief Agrega un comando de dibujo con una clave ya construida.
+     * @param key Clave de ordenamiento.
+     * @param drawable Objeto a dibujar, debe seguir vivo hasta submit().
+     * @param states Estados de render para el dibujo.
+     */
+    void
+        push(uint64_t key,
+             const sf::Drawable& drawable,
+             const sf::RenderStates& states = sf::RenderStates::Default);
+
+    /**
+     * @brief Agrega una figura calculando su clave a partir de su textura.
+     * @param shape Figura a dibujar.
+     * @param layer Capa de dibujo.
+     * @param depth Profundidad dentro de la capa.
+     * @param material Identificador de shader/blend.
+     */
+    void
+        pushShape(const sf::Shape& shape, uint8_t layer, float depth, uint8_t material = 0);
+
+    /**
+     * @brief Agrega un lote de vértices; el lote debe seguir vivo hasta submit().
+     * @param batch Lote a dibujar.
+     * @param material Identificador de shader/blend.
+     */
+    void
+        pushBatch(const RenderBatch& batch, uint8_t material = 0);
+
+    /**
+     * @brief Establece el área visible del frame, usada por los componentes para descartar geometría.
+     * @param bounds Rectángulo visible en coordenadas de mundo.
+     */
+    void
+        setViewBounds(const sf::FloatRect& bounds) {
+        m_viewBounds = bounds;
+    }
+
+    /**
+     * @brief Área visible del frame en coordenadas de mundo.
+     */
+    const sf::FloatRect&
+        getViewBounds() const {
+        return m_viewBounds;
+    }
+
+    /**
+     * @brief Ordena los comandos del frame por su clave.
+     */
+    void
+        sort();
+
+    /**
+     * @brief Envía los comandos ordenados a la ventana.
+     * @param window Ventana donde se dibuja.
+     */
+    void
+        submit(Window& window);
+
+    /**
+     * @brief Envía los comandos ordenados a un render target.
+     * @param target Destino de dibujo.
+     */
+    void
+        submit(sf::RenderTarget& target);
+
+    /**
+     * @brief Estadísticas del último frame.
+     */
+    const RenderQueueStats&
+        getStats() const {
+        return m_stats;
+    }
+
+    /**
+     * @brief Ordena un arreglo de claves y su payload con radix sort LSD de 8 bits.
+     *
+     * Los pases cuyo byte es igual en todas las claves se omiten.
+     * El ordenamiento es estable, por lo que las claves iguales conservan el orden de inserción.
+     * @param keys Claves a ordenar.
+     * @param payload Índices asociados a cada clave.
+     * @param count Número de elementos.
+     * @param tmpKeys Buffer temporal de al menos count claves.
+     * @param tmpPayload Buffer temporal de al menos count índices.
+     */
+    static void
+        radixSort(uint64_t* keys,
+                  uint32_t* payload,
+                  size_t count,
+                  uint64_t* tmpKeys,
+                  uint32_t* tmpPayload);
+
+private:
+    /**
+     * @brief Cuenta los cambios de textura/material en una secuencia de claves.
+     */
+    static unsigned int
+        countStateChanges(const uint64_t* keys, size_t count);
+
+    /*
+    * @struct Command
+    * @brief Comando de dibujo registrado en la cola.
+    */
+    struct
+        Command {
+        const sf::Drawable* drawable;
+        sf::RenderStates states;
+    };
+
+    std::vector<Command> m_commands;    ///< Comandos en orden de inserción.
+    std::vector<uint64_t> m_keys;       ///< Claves, ordenadas tras sort().
+    std::vector<uint32_t> m_payload;    ///< Índices a m_commands, ordenados tras sort().
+    std::vector<uint64_t> m_tmpKeys;    ///< Buffer temporal del radix sort.
+    std::vector<uint32_t> m_tmpPayload; ///< Buffer temporal del radix sort.
+
+    std::unordered_map<const sf::Texture*, uint16_t> m_textureIds; ///< Texturas registradas.
+    RenderQueueStats m_stats;
+    sf::FloatRect m_viewBounds;         ///< Área visible del frame.
+};
@@ -0,0 +1,64 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Render/RenderQueue.h"
+#include "Services/ResourceManager.h"
+
+/*
+* @struct RenderItem
+* @brief Datos mínimos para dibujar un actor desde el hilo de render.
+*/
+struct
+    RenderItem {
+    uint32_t actorId = 0;                   ///< Identificador estable del actor.
+    uint8_t shapeType = ShapeType::EMPTY;   ///< Tipo de figura a crear en el lado de render.
+    uint8_t layer = 0;                      ///< Capa de dibujo.
+    bool isStatic = false;                  ///< Se dibuja en la capa estática cacheada.
+    float depth = 0.0f;                     ///< Profundidad dentro de la capa.
+    sf::Vector2f position;
+    sf::Vector2f rotation;
+    sf::Vector2f scale;
+    const sf::Texture* texture = nullptr;   ///< Textura del ResourceManager, vive más que el frame.
+    sf::Color fillColor = sf::Color::White;
+};
+
+/*
+* @struct RenderSnapshot
+* @brief Estado de la escena que la simulación publica para el hilo de render.
+*/
+struct
+    RenderSnapshot {
+    uint64_t frame = 0;                 ///< Número de frame de simulación.
+    float simTimeMs = 0.0f;             ///< Duración del último update de simulación.
+    unsigned int staticVersion = 0;     ///< Cambia cuando la capa estática debe reconstruirse.
+    std::vector<RenderItem> items;      ///< Un elemento por actor con figura.
+    std::vector<std::string> names;     ///< Nombres de los actores, paralelo a items.
+    std::vector<RenderBatch> batches;   ///< Geometría visible ya construida (bloques de Tilemap).
+    std::map<ConsolErrorType, std::string> messages; ///< Mensajes para la consola.
+    ResourceStats textureStats;         ///< Memoria y uso de las texturas.
+};
+
+/*
+* @enum UiCommandType
+* @brief Acciones de la interfaz que el hilo de render pide a la simulación.
+*/
+enum
+    UiCommandType {
+    CREATE_ACTOR = 0,
+    SET_TRANSFORM = 1,
+    RENAME_ACTOR = 2
+};
+
+/*
+* @struct UiCommand
+* @brief Comando de la interfaz que la simulación aplica al inicio de su siguiente update.
+*/
+struct
+    UiCommand {
+    UiCommandType type = UiCommandType::CREATE_ACTOR;
+    uint32_t actorId = 0;
+    ShapeType shapeType = ShapeType::EMPTY;
+    sf::Vector2f position;
+    sf::Vector2f rotation;
+    sf::Vector2f scale;
+    std::string name;
+};
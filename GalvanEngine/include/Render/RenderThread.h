@@ -0,0 +1,171 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Memory/TTripleBuffer.h"
+#include "Render/RenderSnapshot.h"
+#include "Render/RenderQueue.h"
+#include "Render/StaticLayer.h"
+#include "ShapeFactory.h"
+
+class Window;
+class UserInterface;
+
+/**
+ * @class RenderThread
+ * @brief Hilo dedicado que dibuja la escena y la interfaz a partir de snapshots.
+ *
+ * La simulación escribe un RenderSnapshot en el buffer de escritura y lo publica; el hilo
+ * de render adquiere el último snapshot publicado y emite las llamadas de SFML e ImGui.
+ * El intercambio usa un triple buffer, así que ni la simulación ni el render esperan al
+ * otro y el tiempo de frame pasa a ser max(simulación, render). La simulación solo espera,
+ * con waitForConsumer, a que el render tome el snapshot anterior antes de publicar otro.
+ *
+ * El hilo de render mantiene sus propias figuras por actor; nunca toca los actores de la
+ * simulación. Las acciones de la interfaz regresan a la simulación como UiCommand.
+ */
+class
+    RenderThread {
+public:
+    RenderThread() = default;
+
+    /**
+     * @brief Detiene el hilo si sigue activo.
+     */
+    ~RenderThread();
+
+    /**
+     * @brief Desactiva el contexto de la ventana en el hilo actual y arranca el hilo de render.
+     * @param window Ventana donde se dibuja; debe tener el reenvío de eventos activo.
+     * @param gui Interfaz que se dibuja cada frame.
+     */
+    void
+        start(Window* window, UserInterface* gui);
+
+    /**
+     * @brief Detiene el hilo de render y devuelve el contexto de la ventana al hilo actual.
+     */
+    void
+        stop();
+
+    /**
+     * @brief Indica si el hilo de render está activo.
+     */
+    bool
+        isRunning() const {
+        return m_running.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Snapshot donde la simulación escribe el frame actual.
+     */
+    RenderSnapshot&
+        getWriteSnapshot() {
+        return m_snapshots.getWriteBuffer();
+    }
+
+    /**
+     * @brief Publica el snapshot escrito para que el hilo de render lo consuma.
+     */
+    void
+        publishSnapshot() {
+        m_snapshots.publish();
+    }
+
+    /**
+     * @brief Espera a que el render tome el último snapshot publicado.
+     *
+     * Así la simulación va a lo sumo un frame por delante del render en lugar de publicar
+     * snapshots que nadie llega a dibujar.
+     */
+    void
+        waitForConsumer();
+
+    /**
+     * @brief Pide reemplazar los pixeles de una textura al inicio del siguiente frame de render.
+     * @param texture Textura del ResourceManager; debe seguir viva hasta que se aplique.
+     * @param image Imagen decodificada con el contenido nuevo.
+     */
+    void
+        queueTextureUpload(Texture* texture, const std::shared_ptr<sf::Image>& image);
+
+    /**
+     * @brief Entrega los comandos de la interfaz generados desde el último llamado.
+     * @param commands Vector que recibe los comandos; su contenido anterior se descarta.
+     */
+    void
+        takeCommands(std::vector<UiCommand>& commands);
+
+    /**
+     * @brief Frame de simulación del snapshot que el render dibuja; nunca vuelve a uno anterior.
+     */
+    uint64_t
+        getDrawingFrame() const {
+        return m_drawingFrame.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Duración del último frame de render en milisegundos.
+     */
+    float
+        getRenderTimeMs() const {
+        return m_renderTimeMs.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief Bucle principal del hilo de render.
+     */
+    void
+        run();
+
+    /**
+     * @brief Dibuja un snapshot en la RenderTexture de la ventana.
+     */
+    void
+        drawScene(const RenderSnapshot& snapshot);
+
+    /**
+     * @brief Aplica las subidas de textura pendientes; corre entre frames de render.
+     */
+    void
+        applyTextureUploads();
+
+    /**
+     * @brief Sincroniza la figura del lado de render con un elemento del snapshot.
+     */
+    sf::Shape*
+        syncShape(const RenderItem& item);
+
+    Window* m_window = nullptr;
+    UserInterface* m_gui = nullptr;
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+    std::atomic<float> m_renderTimeMs{ 0.0f };
+    std::atomic<uint64_t> m_drawingFrame{ 0 };
+
+    EngineUtilities::TTripleBuffer<RenderSnapshot> m_snapshots; ///< Snapshots sim -> render.
+
+    std::mutex m_commandMutex;              ///< Protege m_commands.
+    std::vector<UiCommand> m_commands;      ///< Comandos pendientes para la simulación.
+    std::vector<UiCommand> m_frameCommands; ///< Comandos generados en el frame de render.
+    std::vector<sf::Event> m_events;        ///< Eventos reenviados por la ventana.
+
+    std::mutex m_uploadMutex;               ///< Protege m_uploads.
+    std::vector<std::pair<Texture*, std::shared_ptr<sf::Image>>> m_uploads; ///< Recargas de textura pendientes.
+    std::vector<std::pair<Texture*, std::shared_ptr<sf::Image>>> m_frameUploads;
+
+    /*
+    * @struct ShapeSlot
+    * @brief Figura del lado de render asociada a un actor.
+    */
+    struct
+        ShapeSlot {
+        EngineUtilities::TSharedPointer<ShapeFactory> shape;
+        uint64_t lastFrame = 0;
+    };
+
+    std::unordered_map<uint32_t, ShapeSlot> m_shapes; ///< Figuras por actorId.
+    std::vector<sf::Shape*> m_itemShapes;              ///< Figura de cada elemento del snapshot.
+    RenderQueue m_queue;        ///< Cola de render del lado de render.
+    StaticLayer m_staticLayer;  ///< Caché de los elementos estáticos.
+    uint64_t m_drawnFrames = 0;
+};
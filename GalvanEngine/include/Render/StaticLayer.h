@@ -0,0 +1,132 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Render/RenderQueue.h"
+
+class Actor;
+
+/**
+ * @class StaticLayer
+ * @brief Capa cacheada para los actores que no se mueven (fondos, pista, geometría del nivel).
+ *
+ * Los actores marcados con Actor::setStatic se dibujan una sola vez en una sf::RenderTexture.
+ * Cada frame la capa se compone con un único dibujo; la caché solo se reconstruye cuando
+ * alguno de sus actores cambia, cuando cambia el conjunto de actores estáticos o cuando
+ * cambia el tamaño del destino.
+ *
+ * La detección de cambios (detectChanges) no usa la GPU y puede correr en el hilo de
+ * simulación; la reconstrucción (build) se hace en el hilo que dibuja, comparando versiones.
+ */
+class
+    StaticLayer {
+public:
+    StaticLayer() = default;
+    ~StaticLayer() = default;
+
+    /**
+     * @brief Revisa los actores estáticos e incrementa la versión si algo cambió.
+     * @param actors Actores de la escena.
+     */
+    void
+        detectChanges(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    /**
+     * @brief Detecta cambios y reconstruye la caché con los actores estáticos si es necesario.
+     * @param actors Actores de la escena.
+     * @param targetSize Tamaño del destino donde se compone la capa.
+     */
+    void
+        update(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors,
+               const sf::Vector2u& targetSize);
+
+    /**
+     * @brief Reconstruye la caché si la versión o el tamaño cambiaron.
+     * @param targetSize Tamaño del destino donde se compone la capa.
+     * @param version Versión del contenido estático que se quiere dibujar.
+     * @param fill Función que registra los dibujables estáticos en la cola recibida.
+     */
+    template<typename Fill>
+    void
+        build(const sf::Vector2u& targetSize, unsigned int version, Fill fill);
+
+    /**
+     * @brief Registra el dibujo de la capa cacheada en la cola de render, detrás de todo lo demás.
+     * @param queue Cola de render del frame.
+     */
+    void
+        submit(RenderQueue& queue);
+
+    /**
+     * @brief Fuerza la reconstrucción de la caché.
+     */
+    void
+        invalidate() {
+        ++m_version;
+    }
+
+    /**
+     * @brief Versión actual del contenido estático detectado.
+     */
+    unsigned int
+        getVersion() const {
+        return m_version;
+    }
+
+    /**
+     * @brief Número de veces que se ha reconstruido la caché.
+     */
+    unsigned int
+        getRebuildCount() const {
+        return m_rebuildCount;
+    }
+
+    /**
+     * @brief Número de actores en la capa estática.
+     */
+    unsigned int
+        getActorCount() const {
+        return static_cast<unsigned int>(m_staticActors.size());
+    }
+
+private:
+    /**
+     * @brief Recrea la RenderTexture si el destino cambió de tamaño.
+     * @return true si la caché se recreó y debe redibujarse.
+     */
+    bool
+        ensureSize(const sf::Vector2u& targetSize);
+
+    sf::RenderTexture m_cache;   ///< Textura con los actores estáticos ya dibujados.
+    sf::Sprite m_sprite;         ///< Sprite que compone la caché sobre el destino.
+    RenderQueue m_queue;         ///< Cola usada al reconstruir, respeta capas y texturas.
+    std::vector<Actor*> m_staticActors; ///< Actores estáticos del último detectChanges.
+    unsigned int m_version = 1;         ///< Versión del contenido detectado.
+    unsigned int m_builtVersion = 0;    ///< Versión dibujada en la caché.
+    bool m_hasContent = false;          ///< La última reconstrucción dibujó algo.
+    unsigned int m_rebuildCount = 0;
+};
+
+template<typename Fill>
+inline void
+StaticLayer::build(const sf::Vector2u& targetSize, unsigned int version, Fill fill) {
+    if (targetSize.x == 0 || targetSize.y == 0) {
+        return;
+    }
+    if (!ensureSize(targetSize) && version == m_builtVersion) {
+        return;
+    }
+
+    m_cache.clear(sf::Color::Transparent);
+
+    m_queue.clear();
+    m_queue.setViewBounds(sf::FloatRect(0.0f, 0.0f,
+                                        static_cast<float>(targetSize.x),
+                                        static_cast<float>(targetSize.y)));
+    fill(m_queue);
+    m_queue.sort();
+    m_queue.submit(m_cache);
+
+    m_cache.display();
+    m_hasContent = m_queue.getStats().commands > 0;
+    m_builtVersion = version;
+    ++m_rebuildCount;
+}
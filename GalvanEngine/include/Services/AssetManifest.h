@@ -0,0 +1,130 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/*
+* @enum AssetType
+* @brief Tipo de recurso de una entrada del manifiesto; decide en qué ResourceCache se carga.
+*/
+enum
+    AssetType {
+    ASSET_TEXTURE = 0,
+    ASSET_FONT = 1,
+    ASSET_SOUND = 2,
+    ASSET_SHADER = 3
+};
+
+/*
+* @struct ManifestEntry
+* @brief Recurso que una escena necesita, con los recursos que deben cargarse antes.
+*/
+struct
+    ManifestEntry {
+    AssetType type = ASSET_TEXTURE;
+    std::string name;                       ///< Nombre sin extensión, por ejemplo "Map002".
+    std::string extension;
+    std::vector<std::string> dependencies;  ///< Nombres de entradas del mismo manifiesto.
+    uint32_t level = 0;                     ///< Nivel de dependencias; se calcula en sort.
+};
+
+/*
+* @struct LoadProgress
+* @brief Avance de una carga de manifiesto, pensado para una pantalla de carga.
+*/
+struct
+    LoadProgress {
+    size_t loaded = 0;              ///< Recursos terminados, incluidos los que fallaron.
+    size_t failed = 0;
+    size_t total = 0;
+    float elapsedSeconds = 0.0f;
+    float etaSeconds = 0.0f;        ///< Estimado con el tiempo promedio por recurso.
+    std::string_view lastName;      ///< Último recurso terminado.
+
+    /**
+     * @brief Avance en [0, 1].
+     */
+    float
+        getFraction() const {
+        return total > 0 ? static_cast<float>(loaded) / static_cast<float>(total) : 1.0f;
+    }
+};
+
+/**
+ * @class AssetManifest
+ * @brief Lista de recursos de una escena, cargada de una vez antes de crear los actores.
+ *
+ * Formato de texto, una entrada por línea:
+ *
+ *     # comentario
+ *     texture Map002 png
+ *     shader Water frag : Map002
+ *
+ * Lo que sigue a ':' son dependencias, que se cargan en un nivel anterior. Las entradas
+ * repetidas se cuentan una sola vez. Dentro de cada nivel los recursos se leen y decodifican
+ * en paralelo en el JobSystem.
+ */
+class
+    AssetManifest {
+public:
+    using ProgressCallback = std::function<void(const LoadProgress&)>;
+
+    AssetManifest() = default;
+    ~AssetManifest() = default;
+
+    /**
+     * @brief Lee un manifiesto a través del VirtualFileSystem, así puede ir empaquetado.
+     * @param path Ruta del manifiesto, con extensión.
+     * @param error Recibe la descripción del error si falla.
+     * @return true si el manifiesto se leyó y sus dependencias son válidas.
+     */
+    bool
+        loadFromFile(const std::string& path, std::string& error);
+
+    /**
+     * @brief Agrega las entradas de un texto con el formato del manifiesto.
+     */
+    bool
+        parse(std::string_view text, std::string& error);
+
+    /**
+     * @brief Agrega una entrada; si ya existe una del mismo tipo y nombre solo se suman las dependencias.
+     */
+    void
+        add(AssetType type,
+            std::string_view name,
+            std::string_view extension,
+            const std::vector<std::string>& dependencies = std::vector<std::string>());
+
+    /**
+     * @brief Ordena las entradas por nivel de dependencias.
+     * @param error Recibe la descripción si falta una dependencia o hay un ciclo.
+     * @return true si el orden es válido.
+     */
+    bool
+        sort(std::string& error);
+
+    /**
+     * @brief Carga todas las entradas en los ResourceCache del ResourceManager.
+     * @param progress Se llama cada vez que terminan recursos; puede estar vacío.
+     * @param parallel false para cargar uno por uno en el hilo actual, útil para comparar.
+     * @return Avance final, con el tiempo total y los recursos que fallaron.
+     *
+     * Debe llamarse desde el hilo dueño del ResourceManager y después de sort.
+     */
+    LoadProgress
+        load(const ProgressCallback& progress, bool parallel = true) const;
+
+    const std::vector<ManifestEntry>&
+        getEntries() const {
+        return m_entries;
+    }
+
+    void
+        clear() {
+        m_entries.clear();
+        m_sorted = false;
+    }
+
+private:
+    std::vector<ManifestEntry> m_entries;
+    bool m_sorted = false;
+};
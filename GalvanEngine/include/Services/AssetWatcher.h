@@ -0,0 +1,107 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/*
+* @struct AssetReload
+* @brief Imagen de un archivo modificado, ya decodificada y lista para subirse a la GPU.
+*/
+struct
+    AssetReload {
+    std::string name;                   ///< Nombre del archivo sin extensión, como en el ResourceManager.
+    std::string extension;              ///< Extensión sin punto.
+    std::shared_ptr<sf::Image> image;   ///< Pixeles decodificados fuera del hilo principal.
+};
+
+/**
+ * @class AssetWatcher
+ * @brief Observa carpetas de recursos y decodifica en segundo plano los archivos que cambian.
+ *
+ * En Linux un hilo espera eventos de inotify. Cada archivo modificado se considera estable
+ * cuando pasa el tiempo de debounce sin eventos nuevos; los archivos estables se decodifican
+ * juntos en el mismo hilo y quedan en una lista de recargas listas. El hilo principal toma
+ * unas cuantas por frame con takeReady, así una exportación masiva no detiene un frame.
+ *
+ * En otras plataformas start() no hace nada y avisa por el NotificationService.
+ */
+class
+    AssetWatcher {
+private:
+    AssetWatcher() = default;
+    ~AssetWatcher();
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static AssetWatcher& getInstance() {
+        static AssetWatcher instance;
+        return instance;
+    }
+
+    /**
+     * @brief Empieza a observar una carpeta (no recursiva) y arranca el hilo si hace falta.
+     * @param directory Carpeta con los recursos.
+     * @return true si la carpeta quedó observada.
+     */
+    bool
+        watch(const std::string& directory);
+
+    /**
+     * @brief Detiene el hilo y deja de observar todas las carpetas.
+     */
+    void
+        stop();
+
+    /**
+     * @brief Tiempo sin eventos que debe pasar antes de recargar un archivo.
+     */
+    void
+        setDebounceMs(int debounceMs) {
+        m_debounceMs.store(debounceMs, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Entrega hasta maxCount recargas listas, en el orden en que se decodificaron.
+     * @param out Vector que recibe las recargas; su contenido anterior se descarta.
+     * @param maxCount Máximo de recargas a entregar en esta llamada.
+     */
+    void
+        takeReady(std::vector<AssetReload>& out, size_t maxCount);
+
+    /**
+     * @brief Indica si el hilo de observación está activo.
+     */
+    bool
+        isRunning() const {
+        return m_running.load(std::memory_order_acquire);
+    }
+
+private:
+    /**
+     * @brief Bucle del hilo: lee eventos, aplica debounce y decodifica los archivos estables.
+     */
+    void
+        run();
+
+    /**
+     * @brief Decodifica los archivos indicados y los agrega a las recargas listas.
+     */
+    void
+        decode(const std::vector<std::string>& paths);
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+    std::atomic<int> m_debounceMs{ 200 };
+    int m_inotify = -1;                                 ///< Descriptor de inotify.
+    std::mutex m_directoryMutex;                        ///< Protege m_directories.
+    std::unordered_map<int, std::string> m_directories; ///< Carpeta de cada watch.
+
+    std::mutex m_readyMutex;            ///< Protege m_ready.
+    std::deque<AssetReload> m_ready;    ///< Recargas decodificadas pendientes.
+};
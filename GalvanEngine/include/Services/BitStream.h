@@ -0,0 +1,158 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @class BitWriter
+ * @brief Escribe campos de cualquier número de bits, uno tras otro, sin alinear a bytes.
+ *
+ * Los bits se acumulan en una palabra de 64 bits y se pasan al buffer por bytes, así un
+ * paquete de red solo ocupa los bits que usan sus campos. Los enteros pequeños se escriben
+ * con códigos de Elias gamma: 1 ocupa un bit, 2-3 ocupan tres, 4-7 cinco, etc.
+ */
+class
+    BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& buffer) : m_buffer(buffer) {
+        m_buffer.clear();
+    }
+
+    /**
+     * @brief Escribe los count bits bajos de value; count va de 0 a 32.
+     */
+    void
+        writeBits(uint32_t value, uint32_t count) {
+        if (count == 0) {
+            return;
+        }
+        uint64_t mask = (uint64_t(1) << count) - 1;
+        m_scratch |= (static_cast<uint64_t>(value) & mask) << m_scratchBits;
+        m_scratchBits += count;
+        m_bitCount += count;
+        while (m_scratchBits >= 8) {
+            m_buffer.push_back(static_cast<uint8_t>(m_scratch));
+            m_scratch >>= 8;
+            m_scratchBits -= 8;
+        }
+    }
+
+    void
+        writeBool(bool value) {
+        writeBits(value ? 1 : 0, 1);
+    }
+
+    /**
+     * @brief Entero sin signo con código de Elias gamma sobre value + 1.
+     */
+    void
+        writeVarUnsigned(uint32_t value) {
+        uint64_t coded = static_cast<uint64_t>(value) + 1;
+        uint32_t length = 0;
+        while ((coded >> (length + 1)) != 0) {
+            ++length;
+        }
+        writeBits(0, length);
+        // El bit alto del código marca el fin de los ceros; después van los bits restantes
+        writeBits(1, 1);
+        writeBits(static_cast<uint32_t>(coded), length);
+    }
+
+    /**
+     * @brief Entero con signo en zigzag, así los valores cercanos a cero son cortos.
+     */
+    void
+        writeVarSigned(int32_t value) {
+        writeVarUnsigned((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    /**
+     * @brief Escribe los bits pendientes y deja el paquete completo en el buffer.
+     */
+    void
+        flush() {
+        if (m_scratchBits > 0) {
+            m_buffer.push_back(static_cast<uint8_t>(m_scratch));
+            m_scratch = 0;
+            m_scratchBits = 0;
+        }
+    }
+
+    /**
+     * @brief Bits escritos hasta ahora, incluidos los que siguen en la palabra de trabajo.
+     */
+    size_t
+        getBitCount() const {
+        return m_bitCount;
+    }
+
+private:
+    std::vector<uint8_t>& m_buffer;
+    uint64_t m_scratch = 0;
+    uint32_t m_scratchBits = 0;
+    size_t m_bitCount = 0;
+};
+
+/**
+ * @class BitReader
+ * @brief Lee lo que escribió un BitWriter; leer más allá del final marca el lector como inválido.
+ *
+ * Los datos vienen de la red, así que ninguna lectura confía en los tamaños del paquete:
+ * al agotarse devuelve ceros y isValid pasa a false para descartarlo entero.
+ */
+class
+    BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    uint32_t
+        readBits(uint32_t count) {
+        while (m_scratchBits < count) {
+            if (m_offset >= m_size) {
+                m_valid = false;
+                return 0;
+            }
+            m_scratch |= static_cast<uint64_t>(m_data[m_offset++]) << m_scratchBits;
+            m_scratchBits += 8;
+        }
+        uint32_t value = count == 0 ? 0 : static_cast<uint32_t>(m_scratch & ((uint64_t(1) << count) - 1));
+        m_scratch >>= count;
+        m_scratchBits -= count;
+        return value;
+    }
+
+    bool
+        readBool() {
+        return readBits(1) != 0;
+    }
+
+    uint32_t
+        readVarUnsigned() {
+        uint32_t length = 0;
+        while (m_valid && readBits(1) == 0) {
+            if (++length > 32) {
+                m_valid = false;
+                return 0;
+            }
+        }
+        uint64_t coded = (uint64_t(1) << length) | readBits(length);
+        return static_cast<uint32_t>(coded - 1);
+    }
+
+    int32_t
+        readVarSigned() {
+        uint32_t value = readVarUnsigned();
+        return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    bool
+        isValid() const {
+        return m_valid;
+    }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_offset = 0;
+    uint64_t m_scratch = 0;
+    uint32_t m_scratchBits = 0;
+    bool m_valid = true;
+};
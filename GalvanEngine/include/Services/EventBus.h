@@ -0,0 +1,393 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/*
+* @struct EventSubscription
+* @brief Identificador de una suscripción, para cancelarla.
+*/
+struct
+    EventSubscription {
+    static const uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t type = INVALID;
+    uint32_t id = 0;
+
+    bool
+        isValid() const {
+        return type != INVALID;
+    }
+};
+
+/*
+* @struct EventBusStats
+* @brief Contadores del último dispatch.
+*/
+struct
+    EventBusStats {
+    size_t dispatchedEvents = 0;
+    size_t dispatchedBatches = 0;   ///< Llamadas a suscriptores.
+    size_t droppedEvents = 0;       ///< Acumulado de eventos que no cupieron en su cola.
+    size_t allocatedChunks = 0;     ///< Bloques reservados; deja de crecer al estabilizarse la carga.
+    float dispatchTimeMs = 0.0f;
+};
+
+/**
+ * @class EventQueueBase
+ * @brief Parte no tipada de una cola de eventos, para recorrer todas las colas del bus.
+ */
+class
+    EventQueueBase {
+public:
+    virtual
+        ~EventQueueBase() = default;
+
+    /**
+     * @brief La cola de escritura pasa a ser la de lectura y la anterior de lectura se vacía.
+     */
+    virtual void
+        swap() = 0;
+
+    /**
+     * @brief Entrega la cola de lectura a los suscriptores.
+     */
+    virtual void
+        dispatch(EventBusStats& stats) = 0;
+
+    virtual void
+        unsubscribe(uint32_t id) = 0;
+};
+
+/**
+ * @class EventQueue
+ * @brief Eventos de un tipo en dos búferes por bloques contiguos.
+ *
+ * publish reserva un lugar con un contador atómico y copia el evento a su bloque, sin
+ * candado. Solo se toma un candado al reservar un bloque nuevo, lo que deja de ocurrir en
+ * cuanto los dos búferes alcanzan la carga máxima del juego, porque los bloques se reutilizan.
+ *
+ * @tparam T Evento copiable con memcpy.
+ */
+template<typename T>
+class
+    EventQueue : public EventQueueBase {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "Los eventos deben poder copiarse con memcpy");
+
+    static const size_t CHUNK_SIZE = 4096;  ///< Eventos por bloque; cada bloque es un lote de entrega.
+    static const size_t MAX_CHUNKS = 1024;
+
+    typedef void (*Callback)(void* context, const T* events, size_t count);
+
+    EventQueue() = default;
+
+    ~EventQueue() override {
+        for (Buffer& buffer : m_buffers) {
+            for (auto& chunk : buffer.chunks) {
+                ::operator delete(chunk.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    /**
+     * @brief Copia un evento a la cola de escritura; puede llamarse desde varios hilos a la vez.
+     */
+    void
+        publish(const T& event) {
+        Buffer& buffer = m_buffers[m_write.load(std::memory_order_acquire)];
+        size_t index = buffer.count.fetch_add(1, std::memory_order_relaxed);
+        T* chunk = getChunk(buffer, index / CHUNK_SIZE);
+        if (chunk == nullptr) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::memcpy(chunk + index % CHUNK_SIZE, &event, sizeof(T));
+    }
+
+    /**
+     * @brief Copia varios eventos contiguos con una sola reserva.
+     */
+    void
+        publish(const T* events, size_t count) {
+        Buffer& buffer = m_buffers[m_write.load(std::memory_order_acquire)];
+        size_t index = buffer.count.fetch_add(count, std::memory_order_relaxed);
+        while (count > 0) {
+            size_t offset = index % CHUNK_SIZE;
+            size_t run = std::min(count, CHUNK_SIZE - offset);
+            T* chunk = getChunk(buffer, index / CHUNK_SIZE);
+            if (chunk == nullptr) {
+                m_dropped.fetch_add(count, std::memory_order_relaxed);
+                return;
+            }
+            std::memcpy(chunk + offset, events, run * sizeof(T));
+            events += run;
+            index += run;
+            count -= run;
+        }
+    }
+
+    uint32_t
+        subscribe(Callback callback, void* context) {
+        Subscriber subscriber;
+        subscriber.callback = callback;
+        subscriber.context = context;
+        subscriber.id = m_nextSubscriber++;
+        m_subscribers.push_back(subscriber);
+        return subscriber.id;
+    }
+
+    void
+        unsubscribe(uint32_t id) override {
+        m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                           [id](const Subscriber& subscriber) { return subscriber.id == id; }),
+                            m_subscribers.end());
+    }
+
+    void
+        swap() override {
+        uint32_t read = m_write.load(std::memory_order_relaxed);
+        uint32_t write = read ^ 1u;
+        m_buffers[write].count.store(0, std::memory_order_relaxed);
+        m_write.store(write, std::memory_order_release);
+        m_read = read;
+    }
+
+    void
+        dispatch(EventBusStats& stats) override {
+        Buffer& buffer = m_buffers[m_read];
+        size_t count = std::min(buffer.count.load(std::memory_order_acquire), CHUNK_SIZE * MAX_CHUNKS);
+        stats.droppedEvents += m_dropped.exchange(0, std::memory_order_relaxed);
+        stats.allocatedChunks += m_allocatedChunks.load(std::memory_order_relaxed);
+        if (count == 0) {
+            return;
+        }
+        stats.dispatchedEvents += count;
+        for (const Subscriber& subscriber : m_subscribers) {
+            for (size_t begin = 0; begin < count; begin += CHUNK_SIZE) {
+                const T* chunk = buffer.chunks[begin / CHUNK_SIZE].load(std::memory_order_acquire);
+                subscriber.callback(subscriber.context, chunk, std::min(CHUNK_SIZE, count - begin));
+                ++stats.dispatchedBatches;
+            }
+        }
+    }
+
+private:
+    /*
+    * @struct Buffer
+    * @brief Un lado del doble búfer.
+    */
+    struct
+        Buffer {
+        std::atomic<size_t> count{ 0 };
+        std::atomic<T*> chunks[MAX_CHUNKS] = {};
+    };
+
+    /*
+    * @struct Subscriber
+    * @brief Función libre con su contexto; no se usa std::function.
+    */
+    struct
+        Subscriber {
+        Callback callback = nullptr;
+        void* context = nullptr;
+        uint32_t id = 0;
+    };
+
+    T*
+        getChunk(Buffer& buffer, size_t chunkIndex) {
+        if (chunkIndex >= MAX_CHUNKS) {
+            return nullptr;
+        }
+        T* chunk = buffer.chunks[chunkIndex].load(std::memory_order_acquire);
+        if (chunk != nullptr) {
+            return chunk;
+        }
+        std::lock_guard<std::mutex> lock(m_chunkMutex);
+        chunk = buffer.chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (chunk == nullptr) {
+            chunk = static_cast<T*>(::operator new(CHUNK_SIZE * sizeof(T)));
+            buffer.chunks[chunkIndex].store(chunk, std::memory_order_release);
+            m_allocatedChunks.fetch_add(1, std::memory_order_relaxed);
+        }
+        return chunk;
+    }
+
+    Buffer m_buffers[2];
+    std::atomic<uint32_t> m_write{ 0 };
+    uint32_t m_read = 1;
+    std::atomic<size_t> m_dropped{ 0 };
+    std::mutex m_chunkMutex;
+    std::atomic<size_t> m_allocatedChunks{ 0 };
+    std::vector<Subscriber> m_subscribers;
+    uint32_t m_nextSubscriber = 0;
+};
+
+/**
+ * @class EventBus
+ * @brief Eventos tipados entre sistemas, entregados en lotes en puntos fijos del frame.
+ *
+ * Durante el frame los productores llaman a publish, desde cualquier hilo. En swapBuffers,
+ * que debe llamarse cuando ningún productor está publicando, lo escrito pasa a ser lo que
+ * se entrega; después dispatch llama a cada suscriptor con arreglos contiguos de eventos.
+ * dispatch puede correr en otro hilo mientras los productores ya escriben el frame siguiente.
+ *
+ * Los suscriptores son punteros a función con un contexto; suscribirse y cancelar se hace
+ * desde el hilo de simulación, fuera de dispatch.
+ */
+class
+    EventBus {
+private:
+    EventBus() = default;
+    ~EventBus() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+public:
+    static const uint32_t MAX_EVENT_TYPES = 256;
+
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static EventBus& getInstance() {
+        static EventBus instance;
+        return instance;
+    }
+
+    template<typename T>
+    void
+        publish(const T& event) {
+        getQueue<T>().publish(event);
+    }
+
+    template<typename T>
+    void
+        publish(const T* events, size_t count) {
+        getQueue<T>().publish(events, count);
+    }
+
+    /**
+     * @brief Suscribe una función libre; recibe los eventos en lotes contiguos.
+     */
+    template<typename T>
+    EventSubscription
+        subscribe(void (*callback)(void* context, const T* events, size_t count), void* context = nullptr) {
+        EventSubscription subscription;
+        subscription.type = getTypeId<T>();
+        subscription.id = getQueue<T>().subscribe(callback, context);
+        return subscription;
+    }
+
+    /**
+     * @brief Suscribe un método: subscribe<Evento, Clase, &Clase::metodo>(objeto).
+     */
+    template<typename T, typename C, void (C::*Method)(const T*, size_t)>
+    EventSubscription
+        subscribe(C* instance) {
+        return subscribe<T>([](void* context, const T* events, size_t count) {
+            (static_cast<C*>(context)->*Method)(events, count);
+        }, instance);
+    }
+
+    void
+        unsubscribe(EventSubscription subscription);
+
+    /**
+     * @brief Lo publicado hasta ahora pasa a ser lo que entregará dispatch.
+     */
+    void
+        swapBuffers();
+
+    /**
+     * @brief Entrega a los suscriptores los eventos del último swapBuffers.
+     */
+    void
+        dispatch();
+
+    const EventBusStats&
+        getStats() const {
+        return m_stats;
+    }
+
+    /**
+     * @brief Identificador compacto de un tipo de evento, asignado la primera vez que se usa.
+     */
+    template<typename T>
+    static uint32_t
+        getTypeId() {
+        static const uint32_t id = nextTypeId();
+        return id;
+    }
+
+private:
+    static uint32_t
+        nextTypeId();
+
+    template<typename T>
+    EventQueue<T>&
+        getQueue() {
+        uint32_t type = getTypeId<T>();
+        EventQueueBase* queue = m_queues[type].load(std::memory_order_acquire);
+        if (queue == nullptr) {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            queue = m_queues[type].load(std::memory_order_relaxed);
+            if (queue == nullptr) {
+                m_ownedQueues.push_back(std::make_unique<EventQueue<T>>());
+                queue = m_ownedQueues.back().get();
+                m_queues[type].store(queue, std::memory_order_release);
+            }
+        }
+        return *static_cast<EventQueue<T>*>(queue);
+    }
+
+    std::atomic<EventQueueBase*> m_queues[MAX_EVENT_TYPES] = {};
+    std::vector<std::unique_ptr<EventQueueBase>> m_ownedQueues;
+    std::mutex m_queueMutex;
+    EventBusStats m_stats;
+};
+
+/**
+ * @class EventWriter
+ * @brief Junta eventos en un arreglo local y los publica de N en N con una sola reserva.
+ *
+ * Para sistemas que publican muchos eventos en un ciclo; publicar uno por uno cuesta una
+ * operación atómica por evento. Los pendientes se publican al destruirse el escritor.
+ */
+template<typename T, size_t N = 256>
+class
+    EventWriter {
+public:
+    EventWriter() = default;
+
+    ~EventWriter() {
+        flush();
+    }
+
+    EventWriter(const EventWriter&) = delete;
+    EventWriter& operator=(const EventWriter&) = delete;
+
+    void
+        push(const T& event) {
+        m_events[m_count++] = event;
+        if (m_count == N) {
+            flush();
+        }
+    }
+
+    void
+        flush() {
+        if (m_count > 0) {
+            EventBus::getInstance().publish(m_events, m_count);
+            m_count = 0;
+        }
+    }
+
+private:
+    T m_events[N];
+    size_t m_count = 0;
+};
@@ -0,0 +1,101 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Services/NavigationGrid.h"
+
+/**
+ * @class FlowField
+ * @brief Campo de direcciones hacia una meta compartida, para multitudes.
+ *
+ * Un barrido de Dijkstra desde la meta llena el campo de integración (costo de cada celda
+ * hasta la meta) y de él sale el campo de direcciones: cada celda apunta a su vecina más
+ * barata. Construirlo cuesta O(celdas) una vez; después cada agente solo lee la dirección
+ * de su celda, sin importar cuántos agentes compartan la meta.
+ *
+ * Cuando cambian celdas de la rejilla, repair solo recalcula las celdas afectadas: las que
+ * llegaban a la meta a través de una celda bloqueada y las que pueden mejorar por una
+ * celda liberada.
+ */
+class
+    FlowField {
+public:
+    static const uint8_t NO_DIRECTION = 8;  ///< Meta, celda bloqueada o inalcanzable.
+
+    /**
+     * @brief Construye el campo completo hacia la celda meta.
+     */
+    FlowField(const NavigationGrid& grid, const sf::Vector2i& goal);
+
+    /**
+     * @brief Vuelve a calcular todo el campo, por ejemplo tras cambiar de rejilla.
+     */
+    void
+        rebuild(const NavigationGrid& grid);
+
+    /**
+     * @brief Corrige el campo después de que cambiaron algunas celdas de la rejilla.
+     * @param grid Rejilla con los cambios ya aplicados.
+     * @param changedCells Celdas que pasaron de libres a bloqueadas o al revés.
+     */
+    void
+        repair(const NavigationGrid& grid, const std::vector<sf::Vector2i>& changedCells);
+
+    /**
+     * @brief Dirección unitaria en una posición del mundo; cero en la meta o fuera del campo.
+     */
+    sf::Vector2f
+        sample(const sf::Vector2f& worldPosition) const;
+
+    /**
+     * @brief Costo hasta la meta en celdas; infinito si la celda no llega.
+     */
+    float
+        getCost(const sf::Vector2i& cell) const {
+        return isInside(cell) ? m_cost[static_cast<size_t>(cell.y) * m_width + cell.x] : std::numeric_limits<float>::max();
+    }
+
+    uint8_t
+        getDirection(const sf::Vector2i& cell) const {
+        return isInside(cell) ? m_direction[static_cast<size_t>(cell.y) * m_width + cell.x] : NO_DIRECTION;
+    }
+
+    const sf::Vector2i&
+        getGoal() const {
+        return m_goal;
+    }
+
+    /**
+     * @brief Celdas cuyo costo cambió en el último rebuild o repair.
+     */
+    size_t
+        getLastUpdatedCells() const {
+        return m_lastUpdatedCells;
+    }
+
+private:
+    bool
+        isInside(const sf::Vector2i& cell) const {
+        return cell.x >= 0 && cell.y >= 0 && static_cast<uint32_t>(cell.x) < m_width && static_cast<uint32_t>(cell.y) < m_height;
+    }
+
+    /**
+     * @brief Dijkstra desde las celdas en m_heap; solo baja costos.
+     */
+    void
+        propagate(const NavigationGrid& grid);
+
+    /**
+     * @brief Menor costo que una celda puede obtener de sus vecinas.
+     */
+    float
+        bestNeighborCost(const NavigationGrid& grid, int x, int y, uint8_t& direction) const;
+
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    float m_cellSize = 1.0f;
+    sf::Vector2f m_origin;
+    sf::Vector2i m_goal;
+    std::vector<float> m_cost;              ///< Campo de integración.
+    std::vector<uint8_t> m_direction;       ///< Campo de direcciones, 0 a 7 o NO_DIRECTION.
+    std::vector<std::pair<float, uint32_t>> m_heap;
+    size_t m_lastUpdatedCells = 0;
+};
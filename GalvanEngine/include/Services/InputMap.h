@@ -0,0 +1,240 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include <bitset>
+
+/*
+* @enum InputBindingType
+* @brief Dispositivo del que sale una asignación de acción o de eje.
+*/
+enum
+    InputBindingType {
+    BIND_KEY = 0,               ///< Tecla; code es un sf::Keyboard::Key.
+    BIND_MOUSE_BUTTON = 1,      ///< Botón del ratón; code es un sf::Mouse::Button.
+    BIND_JOYSTICK_BUTTON = 2,   ///< Botón de un joystick; code es el número de botón.
+    BIND_JOYSTICK_AXIS = 3      ///< Eje de un joystick; code es un sf::Joystick::Axis.
+};
+
+/*
+* @struct InputBinding
+* @brief Asignación de una entrada física a una acción o a un eje.
+*
+* Para los ejes con teclas o botones, code es la dirección positiva y negativeCode la negativa.
+*/
+struct
+    InputBinding {
+    InputBindingType type = BIND_KEY;
+    int code = 0;
+    int negativeCode = -1;      ///< Solo ejes; -1 si no hay dirección negativa.
+    uint32_t joystick = 0;
+    float deadZone = 0.15f;     ///< Solo ejes de joystick, en [0, 1].
+};
+
+/*
+* @struct InputSnapshot
+* @brief Estado de las acciones y los ejes en un frame; es un valor pequeño que se copia entero.
+*/
+struct
+    InputSnapshot {
+    static const uint32_t MAX_ACTIONS = 64;
+    static const uint32_t MAX_AXES = 16;
+
+    uint64_t frame = 0;
+    uint64_t held = 0;          ///< Bit por acción: alguna de sus entradas está presionada.
+    uint64_t pressed = 0;       ///< Bit por acción: empezó a presionarse en este frame.
+    uint64_t released = 0;      ///< Bit por acción: se soltó en este frame.
+    float axes[MAX_AXES] = {};  ///< Valor de cada eje en [-1, 1].
+    sf::Vector2i mousePosition;
+    float mouseWheel = 0.0f;    ///< Desplazamiento vertical de la rueda en este frame.
+
+    bool
+        isHeld(uint32_t action) const {
+        return action < MAX_ACTIONS && (held >> action & 1) != 0;
+    }
+
+    bool
+        wasPressed(uint32_t action) const {
+        return action < MAX_ACTIONS && (pressed >> action & 1) != 0;
+    }
+
+    bool
+        wasReleased(uint32_t action) const {
+        return action < MAX_ACTIONS && (released >> action & 1) != 0;
+    }
+
+    float
+        getAxis(uint32_t axis) const {
+        return axis < MAX_AXES ? axes[axis] : 0.0f;
+    }
+};
+
+/**
+ * @class InputMap
+ * @brief Convierte los eventos de entrada del frame en acciones y ejes con nombre.
+ *
+ * El estado de teclas, botones y ejes se lleva solo con los eventos que entrega el
+ * InputRecorder, así que nunca se consulta al sistema operativo y una repetición produce
+ * las mismas acciones. Las asignaciones se leen de un archivo de texto, una por línea:
+ *
+ *     # comentario
+ *     action Jump key Space
+ *     action Jump joybutton 0 1     # botón 0 del joystick 1
+ *     action Fire mouse Left
+ *     axis MoveX keys A D
+ *     axis MoveX joyaxis 0 X 0.2    # joystick 0, eje X, zona muerta 0.2
+ *
+ * update escribe el snapshot del frame y lo publica en un anillo de copias; getSnapshot
+ * lo copia desde cualquier hilo sin bloqueos y sin frenar al hilo de simulación.
+ */
+class
+    InputMap {
+private:
+    InputMap() = default;
+    ~InputMap() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    InputMap(const InputMap&) = delete;
+    InputMap& operator=(const InputMap&) = delete;
+
+public:
+    static const uint32_t INVALID_ID = 0xFFFFFFFF;
+
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static InputMap& getInstance() {
+        static InputMap instance;
+        return instance;
+    }
+
+    /**
+     * @brief Devuelve el id de la acción, creándola si no existía.
+     * @return INVALID_ID si ya hay InputSnapshot::MAX_ACTIONS acciones.
+     */
+    uint32_t
+        registerAction(const std::string& name);
+
+    /**
+     * @brief Devuelve el id del eje, creándolo si no existía.
+     * @return INVALID_ID si ya hay InputSnapshot::MAX_AXES ejes.
+     */
+    uint32_t
+        registerAxis(const std::string& name);
+
+    uint32_t
+        getActionId(const std::string& name) const;
+
+    uint32_t
+        getAxisId(const std::string& name) const;
+
+    /**
+     * @brief Agrega una entrada a la acción; la acción se crea si no existía.
+     */
+    bool
+        bindAction(const std::string& action, const InputBinding& binding, std::string& error);
+
+    /**
+     * @brief Agrega una entrada al eje; gana la de mayor magnitud en cada frame.
+     */
+    bool
+        bindAxis(const std::string& axis, const InputBinding& binding, std::string& error);
+
+    /**
+     * @brief Quita todas las asignaciones; los ids de acciones y ejes se conservan.
+     */
+    void
+        clearBindings();
+
+    /**
+     * @brief Lee asignaciones a través del VirtualFileSystem y las agrega.
+     */
+    bool
+        loadBindings(const std::string& path, std::string& error);
+
+    /**
+     * @brief Agrega las asignaciones de un texto con el formato descrito arriba.
+     */
+    bool
+        parseBindings(std::string_view text, std::string& error);
+
+    /**
+     * @brief Procesa los eventos del frame y publica el snapshot. Solo desde el hilo de simulación.
+     */
+    void
+        update(const std::vector<sf::Event>& events);
+
+    /**
+     * @brief Snapshot del frame actual, sin copia. Solo desde el hilo de simulación.
+     */
+    const InputSnapshot&
+        getCurrent() const {
+        return m_current;
+    }
+
+    /**
+     * @brief Copia del último snapshot publicado; puede llamarse desde cualquier hilo.
+     */
+    InputSnapshot
+        getSnapshot() const;
+
+private:
+    static const uint32_t SLOT_COUNT = 4;
+    static const uint32_t JOYSTICK_BUTTONS = sf::Joystick::Count * sf::Joystick::ButtonCount;
+
+    /**
+     * @brief Asignación de eje ya validada; las de teclas y botones se resuelven en update.
+     */
+    struct
+        AxisBinding {
+        uint32_t axis = 0;
+        InputBinding binding;
+    };
+
+    /**
+     * @brief Acumula el cambio de una entrada física en las acciones que la usan.
+     */
+    void
+        setInput(uint64_t actions, bool down);
+
+    /**
+     * @brief Reconstruye el mapa de acciones presionadas a partir de las entradas presionadas.
+     */
+    void
+        rebuildHeld();
+
+    /**
+     * @brief true si la tecla, el botón o el botón de joystick de la asignación está presionado.
+     */
+    bool
+        isBindingDown(InputBindingType type, uint32_t joystick, int code) const;
+
+    void
+        publish();
+
+    std::vector<std::string> m_actionNames;
+    std::vector<std::string> m_axisNames;
+
+    // Por cada entrada física, las acciones que la usan como máscara de bits
+    uint64_t m_keyActions[sf::Keyboard::KeyCount] = {};
+    uint64_t m_mouseActions[sf::Mouse::ButtonCount] = {};
+    uint64_t m_joystickActions[JOYSTICK_BUTTONS] = {};
+    std::vector<AxisBinding> m_axisBindings;
+
+    // Estado de las entradas físicas, llevado solo con eventos
+    std::bitset<sf::Keyboard::KeyCount> m_keys;
+    std::bitset<sf::Mouse::ButtonCount> m_mouseButtons;
+    std::bitset<JOYSTICK_BUTTONS> m_joystickButtons;
+    float m_joystickAxes[sf::Joystick::Count][sf::Joystick::AxisCount] = {};
+    sf::Vector2i m_mousePosition;
+
+    uint64_t m_tappedEdges = 0;     ///< Acciones que se presionaron en el frame.
+    bool m_heldDirty = false;       ///< Cambiaron entradas o asignaciones; hay que reconstruir held.
+    InputSnapshot m_current;
+
+    // Anillo de snapshots publicados; m_published es el frame de la última copia escrita y
+    // cada copia tiene su secuencia, impar mientras se escribe
+    InputSnapshot m_slots[SLOT_COUNT];
+    std::atomic<uint64_t> m_slotSequences[SLOT_COUNT] = {};
+    std::atomic<uint64_t> m_published{ 0 };
+};
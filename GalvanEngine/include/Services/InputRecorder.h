@@ -0,0 +1,190 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/*
+* @enum InputMode
+* @brief De dónde salen los eventos de entrada que ve la simulación.
+*/
+enum
+    InputMode {
+    INPUT_LIVE = 0,         ///< Eventos del sistema operativo.
+    INPUT_RECORDING = 1,    ///< Eventos del sistema operativo, guardados en el log.
+    INPUT_REPLAYING = 2     ///< Eventos del log; los del sistema operativo se ignoran.
+};
+
+/*
+* @struct InputReplayStats
+* @brief Tiempos de simulación de una grabación o repetición, para comparar sesiones.
+*/
+struct
+    InputReplayStats {
+    uint64_t ticks = 0;
+    size_t events = 0;
+    size_t logBytes = 0;
+    float totalSimMs = 0.0f;
+    float averageSimMs = 0.0f;
+    float p95SimMs = 0.0f;
+    float maxSimMs = 0.0f;
+    uint64_t stateHash = 0;         ///< Hash del mundo al terminar.
+    uint64_t recordedHash = 0;      ///< Hash guardado en el log; solo al repetir.
+    bool hashMatches = false;
+};
+
+/**
+ * @class InputRecorder
+ * @brief Graba los eventos de entrada por tick de simulación y los repite en el mismo tick.
+ *
+ * La simulación no lee los eventos de SFML directamente sino getFrameEvents. Al grabar,
+ * cada tick guarda su deltaTime y sus eventos en un log binario compacto (enteros de
+ * longitud variable); al repetir, beginTick sustituye ambos por los del log, así la
+ * sesión avanza exactamente igual aunque la máquina vaya más lenta o sin ventana. Al
+ * final el log guarda un hash del mundo para comprobar que la repetición coincide.
+ *
+ * Solo debe usarse desde el hilo de simulación.
+ */
+class
+    InputRecorder {
+private:
+    InputRecorder() = default;
+    ~InputRecorder() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+public:
+    static const uint16_t VERSION = 1;
+
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static InputRecorder& getInstance() {
+        static InputRecorder instance;
+        return instance;
+    }
+
+    bool
+        startRecording(const std::string& path, std::string& error);
+
+    /**
+     * @brief Carga el log completo; a partir del siguiente tick los eventos salen de él.
+     */
+    bool
+        startReplay(const std::string& path, std::string& error);
+
+    /**
+     * @brief Termina la grabación o la repetición y calcula las estadísticas.
+     * @param stateHash Hash del mundo en el último tick.
+     */
+    void
+        stop(uint64_t stateHash);
+
+    /**
+     * @brief Recibe un evento del sistema operativo; los que no son de entrada se ignoran.
+     */
+    void
+        submit(const sf::Event& event);
+
+    /**
+     * @brief Fija los eventos del tick; al repetir también reemplaza deltaTime.
+     */
+    void
+        beginTick(float& deltaTime);
+
+    /**
+     * @brief Registra cuánto tardó la simulación en el tick.
+     */
+    void
+        endTick(float simTimeMs);
+
+    /**
+     * @brief Eventos que la simulación debe procesar en el tick actual.
+     */
+    const std::vector<sf::Event>&
+        getFrameEvents() const {
+        return m_frameEvents;
+    }
+
+    InputMode
+        getMode() const {
+        return m_mode;
+    }
+
+    /**
+     * @brief true cuando la repetición ya entregó todos los ticks del log.
+     */
+    bool
+        isReplayFinished() const {
+        return m_mode == INPUT_REPLAYING && m_replayFinished;
+    }
+
+    const InputReplayStats&
+        getStats() const {
+        return m_stats;
+    }
+
+    /**
+     * @brief true si el evento viene de un dispositivo de entrada y se graba.
+     */
+    static bool
+        isInputEvent(const sf::Event& event);
+
+private:
+    /**
+     * @brief Registro de un tick: ticks desde el registro anterior, deltaTime y los eventos.
+     */
+    void
+        writeTick(uint64_t advance, uint64_t deltaMicros);
+
+    bool
+        readTick(uint64_t& tick, float& deltaTime);
+
+    void
+        writeEvent(const sf::Event& event);
+
+    bool
+        readEvent(sf::Event& event);
+
+    void
+        writeVarint(uint64_t value);
+
+    bool
+        readVarint(uint64_t& value);
+
+    void
+        writeSigned(int64_t value) {
+        writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    bool
+        readSigned(int64_t& value);
+
+    void
+        writeFloat(float value);
+
+    bool
+        readFloat(float& value);
+
+    /**
+     * @brief Pasa lo grabado al archivo; se llama cada pocos KB para no perder la sesión.
+     */
+    void
+        flush();
+
+    InputMode m_mode = INPUT_LIVE;
+    std::vector<sf::Event> m_pendingEvents;     ///< Del sistema operativo, desde el último tick.
+    std::vector<sf::Event> m_frameEvents;
+
+    std::ofstream m_file;
+    std::vector<uint8_t> m_buffer;              ///< Al grabar: pendiente de escribir. Al repetir: el log.
+    size_t m_readOffset = 0;
+    uint64_t m_lastTick = 0;                    ///< Ticks desde que empezó la grabación o la repetición.
+    uint64_t m_nextReplayTick = 0;              ///< Tick del siguiente registro del log.
+    float m_nextReplayDelta = 0.0f;
+    bool m_replayFinished = false;
+
+    std::vector<float> m_tickTimes;
+    InputReplayStats m_stats;
+};
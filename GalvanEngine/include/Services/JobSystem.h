@@ -0,0 +1,71 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @class JobSystem
+ * @brief Grupo de hilos de trabajo compartido por los sistemas del motor.
+ *
+ * Se crea un hilo por núcleo disponible menos uno; el hilo que llama a parallelFor
+ * también procesa lotes, así que una llamada anidada desde un trabajo no se bloquea.
+ * Los sistemas deciden si usan el paralelismo; con un solo núcleo todo corre en línea.
+ */
+class
+    JobSystem {
+private:
+    JobSystem();
+    ~JobSystem();
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static JobSystem& getInstance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Encola un trabajo para que lo ejecute algún hilo del grupo.
+     * @param job Trabajo a ejecutar; si no hay hilos de trabajo se ejecuta en línea.
+     */
+    void
+        submit(std::function<void()> job);
+
+    /**
+     * @brief Divide el rango [0, count) en lotes y los procesa en paralelo; regresa al terminar todos.
+     * @param count Número de elementos.
+     * @param minBatch Tamaño mínimo de cada lote, evita repartir trabajo demasiado pequeño.
+     * @param func Función llamada con (inicio, fin) de cada lote.
+     */
+    void
+        parallelFor(size_t count,
+                    size_t minBatch,
+                    const std::function<void(size_t, size_t)>& func);
+
+    /**
+     * @brief Número de hilos de trabajo, sin contar el hilo que llama.
+     */
+    unsigned int
+        getWorkerCount() const {
+        return static_cast<unsigned int>(m_workers.size());
+    }
+
+private:
+    /**
+     * @brief Bucle de cada hilo de trabajo.
+     */
+    void
+        workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;                       ///< Protege m_jobs y m_stopping.
+    std::condition_variable m_condition;      ///< Despierta a los hilos cuando hay trabajo.
+    std::deque<std::function<void()>> m_jobs; ///< Trabajos pendientes.
+    bool m_stopping = false;
+};
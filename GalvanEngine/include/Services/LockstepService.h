@@ -0,0 +1,239 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Services/InputMap.h"
+#include <SFML/Network.hpp>
+
+/*
+* @enum LockstepState
+* @brief Etapa de una sesión de lockstep.
+*/
+enum
+    LockstepState {
+    LOCKSTEP_OFF = 0,
+    LOCKSTEP_CONNECTING = 1,    ///< Esperando al otro jugador o su confirmación.
+    LOCKSTEP_RUNNING = 2,
+    LOCKSTEP_CLOSED = 3         ///< El otro jugador se fue o no respondió a tiempo.
+};
+
+/*
+* @struct LockstepSettings
+* @brief Parámetros de la sesión; los del anfitrión se imponen al unirse el invitado.
+*/
+struct
+    LockstepSettings {
+    float tickRate = 30.0f;         ///< Ticks de simulación por segundo, con deltaTime fijo.
+    uint32_t inputDelay = 4;        ///< Ticks entre que se lee una entrada y que se simula.
+    uint32_t hashInterval = 30;     ///< Cada cuántos ticks se comparan los hashes del mundo.
+    float stallTimeout = 10.0f;     ///< Segundos esperando comandos antes de cerrar la sesión.
+};
+
+/*
+* @struct LockstepStats
+* @brief Avance, esperas, tráfico y desincronizaciones de la sesión.
+*/
+struct
+    LockstepStats {
+    uint64_t tick = 0;              ///< Ticks simulados.
+    uint64_t stalledFrames = 0;     ///< Frames en que tocaba un tick pero faltaban comandos.
+    float stalledSeconds = 0.0f;
+    size_t bytesSent = 0;
+    size_t bytesReceived = 0;
+    float bytesPerSecond = 0.0f;    ///< Enviados, promedio de toda la sesión.
+    uint32_t hashesCompared = 0;
+    bool desynced = false;
+    uint64_t desyncTick = 0;        ///< Primer tick cuyo hash no coincidió.
+};
+
+/**
+ * @class LockstepService
+ * @brief Sincroniza dos simulaciones deterministas intercambiando solo la entrada de cada tick.
+ *
+ * Cada tick tiene deltaTime fijo y solo avanza cuando están los comandos de los dos jugadores.
+ * El comando local de un tick se envía inputDelay ticks antes de simularlo, así la latencia
+ * queda oculta; si aun así falta el del otro jugador, el tick espera sin simular ni hacer
+ * rollback. Un comando es el estado de las acciones y ejes del InputMap, codificado contra
+ * el anterior, por lo que el tráfico no depende de cuántas entidades haya.
+ *
+ * Cada hashInterval ticks los dos lados intercambian WorldSnapshot::computeHash y marcan la
+ * sesión como desincronizada en el primer tick que no coincida.
+ *
+ * Se usa TCP: lockstep necesita cada comando, en orden, y el retraso de entrada absorbe
+ * las retransmisiones. El anfitrión es el jugador 0 y el invitado el 1.
+ */
+class
+    LockstepService {
+private:
+    LockstepService() = default;
+    ~LockstepService() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    LockstepService(const LockstepService&) = delete;
+    LockstepService& operator=(const LockstepService&) = delete;
+
+public:
+    static const uint32_t PLAYER_COUNT = 2;
+
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static LockstepService& getInstance() {
+        static LockstepService instance;
+        return instance;
+    }
+
+    /**
+     * @brief Escucha en el puerto; la sesión empieza cuando se une el invitado.
+     */
+    bool
+        host(unsigned short port, std::string& error);
+
+    /**
+     * @brief Se conecta al anfitrión, esperando como mucho timeoutSeconds.
+     */
+    bool
+        join(const std::string& address, unsigned short port, float timeoutSeconds, std::string& error);
+
+    void
+        stop();
+
+    /**
+     * @brief Procesa la red y decide si este frame simula un tick.
+     * @param localInput Entrada del frame; las pulsaciones entre ticks no se pierden.
+     * @param realDeltaTime Tiempo real del frame; marca el ritmo de los ticks.
+     * @return true si hay que simular un tick con getTickSeconds y getPlayerInput.
+     */
+    bool
+        beginTick(const InputSnapshot& localInput, float realDeltaTime);
+
+    /**
+     * @brief true si el tick en curso debe reportar el hash del mundo en endTick.
+     */
+    bool
+        isHashTick() const {
+        return m_settings.hashInterval > 0 && m_tick % m_settings.hashInterval == 0;
+    }
+
+    /**
+     * @brief Cierra el tick simulado; stateHash solo se usa si isHashTick.
+     */
+    void
+        endTick(uint64_t stateHash);
+
+    /**
+     * @brief Entrada del jugador en el tick en curso, igual en las dos máquinas.
+     */
+    const InputSnapshot&
+        getPlayerInput(uint32_t player) const {
+        return m_playerInputs[player < PLAYER_COUNT ? player : 0];
+    }
+
+    uint32_t
+        getLocalPlayer() const {
+        return m_isHost ? 0 : 1;
+    }
+
+    float
+        getTickSeconds() const {
+        return 1.0f / m_settings.tickRate;
+    }
+
+    bool
+        isActive() const {
+        return m_state == LOCKSTEP_CONNECTING || m_state == LOCKSTEP_RUNNING;
+    }
+
+    LockstepState
+        getState() const {
+        return m_state;
+    }
+
+    void
+        setSettings(const LockstepSettings& settings) {
+        m_settings = settings;
+    }
+
+    const LockstepSettings&
+        getSettings() const {
+        return m_settings;
+    }
+
+    const LockstepStats&
+        getStats() const {
+        return m_stats;
+    }
+
+private:
+    enum
+        MessageType {
+        MESSAGE_HELLO = 0,
+        MESSAGE_START = 1,
+        MESSAGE_COMMAND = 2,
+        MESSAGE_HASH = 3
+    };
+
+    /**
+     * @brief Entrada de un jugador en un tick: acciones presionadas y ejes en [-127, 127].
+     */
+    struct
+        Command {
+        uint64_t held = 0;
+        int8_t axes[InputSnapshot::MAX_AXES] = {};
+    };
+
+    void
+        poll();
+
+    void
+        handleMessage(sf::Packet& packet);
+
+    /**
+     * @brief Empieza el tick 0 con los parámetros ya acordados.
+     */
+    void
+        startSession();
+
+    void
+        queueMessage(sf::Packet& packet);
+
+    void
+        flushOutgoing();
+
+    /**
+     * @brief Envía el comando local para el tick tick + inputDelay, codificado contra el anterior.
+     */
+    void
+        sendLocalCommand(const InputSnapshot& localInput);
+
+    void
+        compareHashes();
+
+    void
+        close();
+
+    LockstepState m_state = LOCKSTEP_OFF;
+    LockstepSettings m_settings;
+    bool m_isHost = false;
+    sf::TcpListener m_listener;
+    sf::TcpSocket m_socket;
+    bool m_peerConnected = false;
+    std::deque<sf::Packet> m_outgoing;
+
+    uint64_t m_tick = 0;
+    uint64_t m_nextLocalTick = 0;               ///< Siguiente tick que espera comando local.
+    float m_accumulator = 0.0f;
+    float m_stallTime = 0.0f;
+    float m_sessionTime = 0.0f;
+    uint64_t m_pendingPressed = 0;              ///< Pulsaciones locales desde el último comando.
+
+    std::deque<Command> m_commands[PLAYER_COUNT];   ///< Del tick en curso en adelante.
+    Command m_lastSent;
+    Command m_lastReceived;
+    InputSnapshot m_playerInputs[PLAYER_COUNT];
+
+    std::deque<std::pair<uint64_t, uint64_t>> m_localHashes;   ///< Tick y hash.
+    std::deque<std::pair<uint64_t, uint64_t>> m_remoteHashes;
+
+    LockstepStats m_stats;
+};
@@ -0,0 +1,173 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+class Tilemap;
+
+/*
+* @enum PathAlgorithm
+* @brief Algoritmo de búsqueda; ambos dan rutas de costo mínimo.
+*/
+enum
+    PathAlgorithm {
+    PATH_ASTAR = 0,     ///< A* con vecindad de 8 celdas.
+    PATH_JPS = 1        ///< Jump Point Search: poda los vecinos simétricos, expande mucho menos en mapas abiertos.
+};
+
+/**
+ * @class NavigationGrid
+ * @brief Rejilla de celdas transitables para la búsqueda de rutas.
+ *
+ * Las celdas se mueven en 8 direcciones; una diagonal solo se permite si las dos celdas
+ * ortogonales que rodea están libres, así que las rutas no cortan esquinas.
+ *
+ * La rejilla se divide en regiones de REGION_SIZE x REGION_SIZE celdas con un contador de
+ * versión cada una. Cambiar una celda solo incrementa la versión de su región, de modo que
+ * una ruta guardada se revisa únicamente si cruza una región que cambió.
+ */
+class
+    NavigationGrid {
+public:
+    static const uint32_t REGION_SIZE = 16;
+    static const uint32_t INVALID_CELL = 0xFFFFFFFFu;
+
+    NavigationGrid() = default;
+
+    /**
+     * @brief Crea una rejilla con todas las celdas libres.
+     * @param width Ancho en celdas.
+     * @param height Alto en celdas.
+     * @param cellSize Tamaño de cada celda en unidades de mundo.
+     * @param origin Esquina superior izquierda de la rejilla en el mundo.
+     */
+    NavigationGrid(uint32_t width, uint32_t height, float cellSize, const sf::Vector2f& origin = sf::Vector2f());
+
+    void
+        setBlocked(uint32_t x, uint32_t y, bool blocked);
+
+    /**
+     * @brief Las celdas fuera de la rejilla cuentan como bloqueadas.
+     */
+    bool
+        isWalkable(int x, int y) const {
+        return x >= 0 && y >= 0 && static_cast<uint32_t>(x) < m_width && static_cast<uint32_t>(y) < m_height &&
+               m_blocked[static_cast<size_t>(y) * m_width + x] == 0;
+    }
+
+    /**
+     * @brief Bloquea las celdas que toca un rectángulo del mundo.
+     */
+    void
+        blockRect(const sf::FloatRect& worldRect);
+
+    /**
+     * @brief Bloquea las celdas cuyo tile, en la capa indicada, está en la lista.
+     *
+     * Cada tile del mapa corresponde a una celda con las mismas coordenadas.
+     */
+    void
+        blockTiles(const Tilemap& tilemap, uint32_t layer, const std::vector<uint16_t>& blockedTiles);
+
+    /**
+     * @brief Bloquea las celdas que cubren los colliders estáticos del PhysicsWorld.
+     */
+    void
+        blockStaticColliders();
+
+    sf::Vector2i
+        worldToCell(const sf::Vector2f& position) const;
+
+    /**
+     * @brief Centro de la celda en coordenadas de mundo.
+     */
+    sf::Vector2f
+        cellToWorld(const sf::Vector2i& cell) const;
+
+    /**
+     * @brief Busca la ruta más corta entre dos celdas.
+     * @param corners Celdas donde la ruta cambia de dirección, incluidos el inicio y la meta.
+     * @param expanded Nodos expandidos, para estadísticas.
+     * @return false si alguna celda está bloqueada o la meta no es alcanzable.
+     *
+     * Es const y usa memoria temporal por hilo, así que varias búsquedas pueden correr a la vez.
+     */
+    bool
+        findPath(const sf::Vector2i& start,
+                 const sf::Vector2i& goal,
+                 PathAlgorithm algorithm,
+                 std::vector<sf::Vector2i>& corners,
+                 uint32_t& expanded) const;
+
+    /**
+     * @brief Comprueba un tramo recto o diagonal entre dos esquinas de una ruta.
+     */
+    bool
+        isSegmentWalkable(const sf::Vector2i& from, const sf::Vector2i& to) const;
+
+    /**
+     * @brief Regiones que recorre una ruta, ordenadas y sin repetir.
+     */
+    void
+        collectRegions(const std::vector<sf::Vector2i>& corners, std::vector<uint32_t>& regions) const;
+
+    uint32_t
+        getRegionVersion(uint32_t region) const {
+        return m_regionVersions[region];
+    }
+
+    uint32_t
+        getWidth() const {
+        return m_width;
+    }
+
+    uint32_t
+        getHeight() const {
+        return m_height;
+    }
+
+    float
+        getCellSize() const {
+        return m_cellSize;
+    }
+
+    const sf::Vector2f&
+        getOrigin() const {
+        return m_origin;
+    }
+
+    uint32_t
+        getCellIndex(const sf::Vector2i& cell) const {
+        return isInside(cell) ? static_cast<uint32_t>(cell.y) * m_width + static_cast<uint32_t>(cell.x) : INVALID_CELL;
+    }
+
+    bool
+        isInside(const sf::Vector2i& cell) const {
+        return cell.x >= 0 && cell.y >= 0 && static_cast<uint32_t>(cell.x) < m_width && static_cast<uint32_t>(cell.y) < m_height;
+    }
+
+private:
+    uint32_t
+        getRegion(int x, int y) const {
+        return (static_cast<uint32_t>(y) / REGION_SIZE) * m_regionsX + static_cast<uint32_t>(x) / REGION_SIZE;
+    }
+
+    bool
+        searchAStar(uint32_t start, uint32_t goal, uint32_t& expanded) const;
+
+    bool
+        searchJps(uint32_t start, uint32_t goal, uint32_t& expanded) const;
+
+    /**
+     * @brief Avanza desde (x, y) en la dirección (dx, dy) hasta un punto de salto.
+     * @return Índice del punto de salto o INVALID_CELL si el camino se cierra.
+     */
+    uint32_t
+        jump(int x, int y, int dx, int dy, int goalX, int goalY) const;
+
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_regionsX = 0;
+    float m_cellSize = 1.0f;
+    sf::Vector2f m_origin;
+    std::vector<uint8_t> m_blocked;
+    std::vector<uint32_t> m_regionVersions;
+};
@@ -0,0 +1,286 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Services/NavigationGrid.h"
+#include "Services/FlowField.h"
+
+/*
+* @enum PathState
+* @brief Estado de una petición de ruta.
+*/
+enum
+    PathState {
+    PATH_INVALID = 0,   ///< Handle liberado o que nunca existió.
+    PATH_PENDING = 1,   ///< En cola; si la ruta se está recalculando, getPath devuelve la anterior.
+    PATH_READY = 2,
+    PATH_FAILED = 3     ///< Inicio o meta bloqueados, o meta inalcanzable.
+};
+
+/*
+* @struct PathHandle
+* @brief Identificador de una petición de ruta; la generación detecta handles liberados.
+*/
+struct
+    PathHandle {
+    static const uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+    uint32_t generation = 0;
+
+    bool
+        isValid() const {
+        return index != INVALID;
+    }
+
+    bool
+        operator==(const PathHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool
+        operator!=(const PathHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+/*
+* @struct NavPath
+* @brief Ruta resuelta; inmutable y compartida entre las peticiones con el mismo inicio y meta.
+*/
+struct
+    NavPath {
+    std::vector<sf::Vector2i> corners;      ///< Celdas donde cambia la dirección.
+    std::vector<sf::Vector2f> waypoints;    ///< Centros de esas celdas; sirven para una PathSpline.
+    std::vector<uint32_t> regions;          ///< Regiones de la rejilla que recorre.
+    float length = 0.0f;                    ///< Longitud en unidades de mundo.
+};
+
+/*
+* @struct NavigationStats
+* @brief Contadores acumulados y del último update.
+*/
+struct
+    NavigationStats {
+    uint64_t requests = 0;
+    uint64_t cacheHits = 0;
+    uint64_t searches = 0;
+    uint64_t failed = 0;
+    uint64_t revalidated = 0;   ///< Rutas que cruzaban una región cambiada y seguían libres.
+    uint64_t invalidated = 0;   ///< Rutas que quedaron bloqueadas y se volvieron a buscar.
+    size_t pending = 0;         ///< Peticiones en cola tras el último update.
+    size_t cachedPaths = 0;
+    uint32_t expandedNodes = 0; ///< Nodos expandidos en el último update.
+    uint64_t flowFieldBuilds = 0;
+    size_t flowCellsUpdated = 0;    ///< Celdas de flow fields corregidas en el último update.
+    float updateTimeMs = 0.0f;
+};
+
+/**
+ * @class NavigationService
+ * @brief Búsqueda de rutas asíncrona sobre una NavigationGrid.
+ *
+ * requestPath solo encola la petición y devuelve un handle. En update se resuelven las
+ * peticiones en cola: primero se consulta un caché LRU indexado por (celda de inicio,
+ * celda meta) y las que faltan se buscan en lotes repartidos en el JobSystem, hasta
+ * agotar el presupuesto de tiempo del frame; el resto espera al siguiente frame.
+ *
+ * Los cambios a la rejilla se aplican al inicio de update. Una ruta guardada guarda la
+ * versión de cada región que cruza; si alguna cambió, solo se revisan sus celdas y se
+ * vuelve a buscar únicamente si quedó bloqueada. Una región que se libera no invalida
+ * nada, así que una ruta puede dejar de ser la más corta pero nunca atraviesa un muro.
+ *
+ * Para muchos agentes con la misma meta, getFlowField entrega un FlowField compartido;
+ * los campos guardados se corrigen de forma incremental con cada cambio a la rejilla.
+ */
+class
+    NavigationService {
+private:
+    NavigationService() = default;
+    ~NavigationService() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    NavigationService(const NavigationService&) = delete;
+    NavigationService& operator=(const NavigationService&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static NavigationService& getInstance() {
+        static NavigationService instance;
+        return instance;
+    }
+
+    /**
+     * @brief Reemplaza la rejilla; vacía el caché y vuelve a encolar las peticiones vivas.
+     */
+    void
+        setGrid(const NavigationGrid& grid);
+
+    const NavigationGrid&
+        getGrid() const {
+        return m_grid;
+    }
+
+    /**
+     * @brief Cambia una celda; se aplica en el siguiente update.
+     */
+    void
+        setBlocked(const sf::Vector2i& cell, bool blocked);
+
+    /**
+     * @brief Encola una ruta entre dos posiciones del mundo.
+     */
+    PathHandle
+        requestPath(const sf::Vector2f& start, const sf::Vector2f& goal);
+
+    PathState
+        getState(PathHandle handle) const;
+
+    /**
+     * @brief Ruta resuelta, o nullptr si todavía no hay ninguna.
+     */
+    std::shared_ptr<const NavPath>
+        getPath(PathHandle handle) const;
+
+    /**
+     * @brief Libera la petición; el handle deja de ser válido.
+     */
+    void
+        release(PathHandle handle);
+
+    /**
+     * @brief Aplica los cambios a la rejilla y resuelve peticiones hasta agotar el presupuesto.
+     */
+    void
+        update();
+
+    /**
+     * @brief Tiempo máximo por frame para buscar rutas, por defecto 2 ms.
+     */
+    void
+        setFrameBudget(float milliseconds) {
+        m_frameBudgetMs = milliseconds;
+    }
+
+    void
+        setCacheCapacity(size_t capacity);
+
+    /**
+     * @brief Flow field hacia la celda de una posición; se construye la primera vez que se pide.
+     *
+     * El campo se actualiza en su lugar en cada update mientras siga en el caché. Si se
+     * desaloja, quien lo retenga conserva una copia que ya no se corrige.
+     */
+    std::shared_ptr<const FlowField>
+        getFlowField(const sf::Vector2f& goal);
+
+    /**
+     * @brief Flow fields guardados, por defecto 8; cada uno ocupa unos 5 bytes por celda.
+     */
+    void
+        setFlowFieldCapacity(size_t capacity);
+
+    void
+        setAlgorithm(PathAlgorithm algorithm) {
+        m_algorithm = algorithm;
+    }
+
+    const NavigationStats&
+        getStats() const {
+        return m_stats;
+    }
+
+private:
+    /*
+    * @struct Request
+    * @brief Petición de ruta de un handle.
+    */
+    struct
+        Request {
+        sf::Vector2i start;
+        sf::Vector2i goal;
+        uint32_t generation = 0;
+        PathState state = PATH_INVALID;
+        bool queued = false;
+        std::shared_ptr<const NavPath> path;
+        std::vector<uint32_t> regionVersions;   ///< Versiones de las regiones de path al entregarla.
+    };
+
+    /*
+    * @struct CacheEntry
+    * @brief Ruta guardada con las versiones de sus regiones al momento de validarla.
+    */
+    struct
+        CacheEntry {
+        std::shared_ptr<const NavPath> path;
+        std::vector<uint32_t> regionVersions;
+        std::list<uint64_t>::iterator lruPosition;
+    };
+
+    /*
+    * @struct Search
+    * @brief Búsqueda pendiente de un lote; varias peticiones pueden compartirla.
+    */
+    struct
+        Search {
+        uint64_t key = 0;
+        sf::Vector2i start;
+        sf::Vector2i goal;
+        std::shared_ptr<NavPath> path;
+        uint32_t expanded = 0;
+    };
+
+    static uint64_t
+        makeKey(uint32_t startCell, uint32_t goalCell) {
+        return (static_cast<uint64_t>(startCell) << 32) | goalCell;
+    }
+
+    /**
+     * @brief Ruta del caché, revisada contra las versiones actuales de la rejilla.
+     */
+    std::shared_ptr<const NavPath>
+        findCached(uint64_t key);
+
+    void
+        storeCached(uint64_t key, const std::shared_ptr<const NavPath>& path);
+
+    /**
+     * @brief true si las regiones de la ruta no cambiaron o sus celdas siguen libres.
+     */
+    bool
+        isStillWalkable(const NavPath& path, std::vector<uint32_t>& regionVersions);
+
+    void
+        enqueue(uint32_t index);
+
+    /**
+     * @brief Entrega una ruta a una petición y guarda las versiones actuales de sus regiones.
+     */
+    void
+        deliver(Request& request, const std::shared_ptr<const NavPath>& path);
+
+    /**
+     * @brief Aplica los cambios pendientes y revisa las rutas entregadas que cruzan regiones cambiadas.
+     */
+    void
+        applyGridChanges();
+
+    NavigationGrid m_grid;
+    std::vector<std::pair<sf::Vector2i, bool>> m_gridChanges;
+    std::vector<Request> m_requests;
+    std::vector<uint32_t> m_freeRequests;
+    std::deque<uint32_t> m_queue;
+
+    std::unordered_map<uint64_t, CacheEntry> m_cache;
+    std::list<uint64_t> m_lru;                  ///< Claves del caché, de la más reciente a la menos reciente.
+    size_t m_cacheCapacity = 4096;
+
+    std::list<std::shared_ptr<FlowField>> m_flowFields;    ///< Del más reciente al menos reciente.
+    size_t m_flowFieldCapacity = 8;
+
+    float m_frameBudgetMs = 2.0f;
+    PathAlgorithm m_algorithm = PATH_JPS;
+    NavigationStats m_stats;
+};
@@ -0,0 +1,179 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+* @enum PackCompression
+* @brief Compresión de una entrada del archivo empaquetado.
+*/
+enum
+    PackCompression {
+    COMPRESSION_NONE = 0,
+    COMPRESSION_LZ4 = 1,   ///< Requiere compilar con GALVAN_PACK_LZ4.
+    COMPRESSION_ZSTD = 2   ///< Requiere compilar con GALVAN_PACK_ZSTD.
+};
+
+/*
+* @struct PackHeader
+* @brief Encabezado al inicio del archivo empaquetado.
+*/
+struct
+    PackHeader {
+    char magic[4];          ///< "GPAK".
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;     ///< Alineación de los datos de cada entrada.
+    uint64_t indexOffset;   ///< Inicio del arreglo de PackEntry, ordenado por hash.
+    uint64_t namesOffset;   ///< Inicio de la tabla de nombres.
+};
+
+/*
+* @struct PackEntry
+* @brief Entrada del índice; el índice se ordena por hash para buscar con búsqueda binaria.
+*/
+struct
+    PackEntry {
+    uint64_t hash;          ///< FNV-1a de la ruta normalizada.
+    uint64_t offset;        ///< Inicio de los datos, alineado a PackHeader::alignment.
+    uint64_t storedSize;    ///< Bytes guardados en el archivo.
+    uint64_t size;          ///< Bytes una vez descomprimidos.
+    uint32_t nameOffset;    ///< Posición del nombre dentro de la tabla de nombres.
+    uint16_t nameLength;
+    uint8_t compression;    ///< Valor de PackCompression.
+    uint8_t reserved;
+};
+
+/*
+* @struct PackInput
+* @brief Archivo de origen que el empaquetador agrega al archivo.
+*/
+struct
+    PackInput {
+    std::string name;       ///< Ruta dentro del archivo, por ejemplo "Textures/Map002.png".
+    std::string sourcePath; ///< Ruta del archivo en disco.
+};
+
+/**
+ * @class PackArchive
+ * @brief Archivo empaquetado de solo lectura, mapeado en memoria.
+ *
+ * El archivo completo se mapea una vez y el descriptor se cierra de inmediato, así que
+ * abrir recursos ya no cuesta una apertura de archivo cada uno. Las entradas sin
+ * compresión se leen directo de la memoria mapeada, sin copias.
+ *
+ * Las rutas se normalizan a minúsculas con '/' como separador; el hash se calcula por
+ * partes (nombre, '.', extensión) para que buscar no construya cadenas temporales.
+ */
+class
+    PackArchive {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t DEFAULT_ALIGNMENT = 64;
+
+    PackArchive() = default;
+    ~PackArchive();
+
+    PackArchive(const PackArchive&) = delete;
+    PackArchive& operator=(const PackArchive&) = delete;
+
+    /**
+     * @brief Mapea un archivo empaquetado y valida su encabezado.
+     * @param path Ruta del archivo.
+     * @param error Recibe la descripción del error si falla.
+     * @return true si el archivo quedó abierto.
+     */
+    bool
+        open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Libera el mapeo del archivo.
+     */
+    void
+        close();
+
+    /**
+     * @brief Busca una entrada por nombre y extensión, o por ruta completa si extension está vacía.
+     * @return La entrada, o nullptr si no existe.
+     */
+    const PackEntry*
+        find(std::string_view name, std::string_view extension = std::string_view()) const;
+
+    /**
+     * @brief Obtiene los datos de una entrada.
+     * @param entry Entrada del índice de este archivo.
+     * @param scratch Buffer donde se descomprime si la entrada está comprimida.
+     * @param data Recibe el inicio de los datos (en el mapeo o en scratch).
+     * @param size Recibe el tamaño de los datos.
+     * @return true si los datos están disponibles.
+     */
+    bool
+        read(const PackEntry& entry,
+             std::vector<uint8_t>& scratch,
+             const uint8_t*& data,
+             size_t& size) const;
+
+    /**
+     * @brief Nombre normalizado de una entrada.
+     */
+    std::string_view
+        getName(const PackEntry& entry) const;
+
+    uint32_t
+        getEntryCount() const {
+        return m_header ? m_header->entryCount : 0;
+    }
+
+    const PackEntry&
+        getEntry(uint32_t index) const {
+        return m_entries[index];
+    }
+
+    bool
+        isOpen() const {
+        return m_base != nullptr;
+    }
+
+    /**
+     * @brief Escribe un archivo empaquetado con las entradas indicadas.
+     * @param inputs Archivos a empaquetar; los nombres repetidos se ignoran.
+     * @param outputPath Ruta del archivo a generar.
+     * @param compression Compresión deseada; una entrada se guarda sin comprimir si no se reduce.
+     * @param error Recibe la descripción del error si falla.
+     * @return true si el archivo se escribió completo.
+     */
+    static bool
+        build(const std::vector<PackInput>& inputs,
+              const std::string& outputPath,
+              PackCompression compression,
+              std::string& error);
+
+    /**
+     * @brief Hash FNV-1a de una ruta normalizada, calculado por partes.
+     */
+    static uint64_t
+        hashPath(std::string_view name, std::string_view extension = std::string_view());
+
+    /**
+     * @brief Normaliza una ruta: minúsculas y '/' como separador.
+     */
+    static std::string
+        normalizePath(std::string_view path);
+
+    /**
+     * @brief Indica si la compresión está disponible en esta compilación.
+     */
+    static bool
+        isCompressionSupported(PackCompression compression);
+
+private:
+    const uint8_t* m_base = nullptr;        ///< Inicio del archivo mapeado.
+    size_t m_size = 0;
+    const PackHeader* m_header = nullptr;
+    const PackEntry* m_entries = nullptr;
+    const char* m_names = nullptr;
+#ifdef _WIN32
+    void* m_mapping = nullptr;              ///< HANDLE del mapeo de Windows.
+#endif
+};
@@ -0,0 +1,358 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include <SFML/Network.hpp>
+
+class Actor;
+class Transform;
+class BitWriter;
+class BitReader;
+
+/*
+* @enum ReplicationMode
+* @brief Papel del proceso en la replicación.
+*/
+enum
+    ReplicationMode {
+    REPLICATION_OFF = 0,
+    REPLICATION_SERVER = 1,     ///< Simula y envía snapshots a los clientes.
+    REPLICATION_CLIENT = 2      ///< Recibe snapshots e interpola entre ellos.
+};
+
+/*
+* @struct ReplicationSettings
+* @brief Cuantización, ritmo de envío y filtros de la replicación.
+*
+* El servidor manda su cuantización al aceptar a un cliente, así que ambos lados siempre
+* decodifican con los mismos parámetros.
+*/
+struct
+    ReplicationSettings {
+    sf::FloatRect worldBounds = sf::FloatRect(-4096.0f, -4096.0f, 8192.0f, 8192.0f);
+    float positionPrecision = 1.0f / 16.0f; ///< En pixeles.
+    uint32_t rotationBits = 10;
+    float maxScale = 16.0f;                 ///< La escala se cuantiza en [-maxScale, maxScale].
+    uint32_t scaleBits = 12;
+    float sendRate = 20.0f;                 ///< Snapshots por segundo a cada cliente.
+    size_t packetBudget = 1200;             ///< Bytes por paquete; menor que la MTU para no fragmentar.
+    float relevanceRadius = 0.0f;           ///< Del cliente: radio de interés; 0 para recibir todo.
+    float interpolationDelay = 0.1f;        ///< Del cliente: segundos detrás del último snapshot.
+    float timeout = 5.0f;                   ///< Segundos sin paquetes antes de soltar al otro lado.
+};
+
+/*
+* @struct ReplicatedTransform
+* @brief Transform de una entidad replicada, ya interpolado en el cliente.
+*/
+struct
+    ReplicatedTransform {
+    uint32_t id = 0;                        ///< Actor::getId del servidor.
+    sf::Vector2f position;
+    float rotation = 0.0f;                  ///< Grados; es el componente x de la rotación del Transform.
+    sf::Vector2f scale;
+};
+
+/*
+* @struct ReplicationPeerStats
+* @brief Ancho de banda con un cliente (en el servidor) o con el servidor (en el cliente).
+*/
+struct
+    ReplicationPeerStats {
+    std::string address;
+    float bytesPerSecond = 0.0f;            ///< Enviados en el servidor, recibidos en el cliente.
+    float packetsPerSecond = 0.0f;
+    float averagePacketBytes = 0.0f;
+    float entitiesPerPacket = 0.0f;         ///< Entidades con cambios por paquete.
+    size_t relevantEntities = 0;            ///< Entidades que el otro lado conoce.
+    size_t pendingEntities = 0;             ///< Cambios que no cupieron en el último paquete.
+    float roundTripMs = 0.0f;               ///< Solo en el servidor.
+};
+
+/**
+ * @class ReplicationService
+ * @brief Replica el Transform de los actores de un servidor a sus clientes por UDP.
+ *
+ * Cada snapshot se codifica bit a bit contra el último snapshot que el cliente confirmó:
+ * solo viajan las entidades que cambiaron, las posiciones como diferencias cuantizadas y
+ * los enteros con códigos de longitud variable. El servidor guarda, por cliente, lo que ese
+ * cliente tendrá al recibir cada paquete, así un paquete perdido solo hace que el siguiente
+ * se codifique contra una base más vieja.
+ *
+ * Cuando los cambios no caben en packetBudget, se envían primero las entidades con mayor
+ * prioridad acumulada, que crece más rápido cerca del centro de interés del cliente; las
+ * que quedan fuera de relevanceRadius se retiran del cliente. El cliente guarda los snapshots
+ * recibidos e interpola entre los dos que rodean interpolationDelay en el pasado.
+ *
+ * Solo debe usarse desde el hilo de simulación.
+ */
+class
+    ReplicationService {
+private:
+    ReplicationService() = default;
+    ~ReplicationService() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    ReplicationService(const ReplicationService&) = delete;
+    ReplicationService& operator=(const ReplicationService&) = delete;
+
+public:
+    static const uint32_t HISTORY_SIZE = 32;
+
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static ReplicationService& getInstance() {
+        static ReplicationService instance;
+        return instance;
+    }
+
+    bool
+        startServer(unsigned short port, std::string& error);
+
+    /**
+     * @brief Empieza a pedir conexión; se reintenta en update hasta que el servidor acepte.
+     */
+    bool
+        connect(const std::string& address, unsigned short port, std::string& error);
+
+    /**
+     * @brief Avisa al otro lado, cierra el socket y olvida todo el estado.
+     */
+    void
+        stop();
+
+    /**
+     * @brief Recibe los paquetes pendientes y, en el servidor, envía los snapshots que tocan.
+     */
+    void
+        update(float deltaTime, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    /**
+     * @brief En el cliente, escribe los transforms interpolados en los actores con el mismo id.
+     */
+    void
+        applyToActors(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    /**
+     * @brief En el cliente, centro del área de interés; se manda con cada confirmación.
+     */
+    void
+        setViewCenter(const sf::Vector2f& center) {
+        m_viewCenter = center;
+    }
+
+    void
+        setSettings(const ReplicationSettings& settings) {
+        m_settings = settings;
+    }
+
+    const ReplicationSettings&
+        getSettings() const {
+        return m_settings;
+    }
+
+    ReplicationMode
+        getMode() const {
+        return m_mode;
+    }
+
+    /**
+     * @brief En el cliente, true después de que el servidor aceptó la conexión.
+     */
+    bool
+        isConnected() const {
+        return m_connected;
+    }
+
+    /**
+     * @brief En el cliente, entidades interpoladas del último update.
+     */
+    const std::vector<ReplicatedTransform>&
+        getInterpolated() const {
+        return m_interpolated;
+    }
+
+    const std::vector<ReplicationPeerStats>&
+        getPeerStats() const {
+        return m_peerStats;
+    }
+
+private:
+    enum
+        PacketType {
+        PACKET_CONNECT = 0,
+        PACKET_ACCEPT = 1,
+        PACKET_SNAPSHOT = 2,
+        PACKET_ACK = 3,
+        PACKET_DISCONNECT = 4
+    };
+
+    /**
+     * @brief Transform cuantizado; es lo que se compara y se codifica.
+     */
+    struct
+        QuantizedEntity {
+        uint32_t id = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t rotation = 0;
+        uint32_t scaleX = 0;
+        uint32_t scaleY = 0;
+    };
+
+    /**
+     * @brief Entidad que cambió respecto a la base del cliente y espera lugar en el paquete.
+     */
+    struct
+        Candidate {
+        size_t index = 0;                       ///< Posición en m_current.
+        const QuantizedEntity* base = nullptr;  ///< La misma entidad en la base, si el cliente la tiene.
+        float priority = 0.0f;
+    };
+
+    /**
+     * @brief Entidades que un cliente tiene después de un paquete, ordenadas por id.
+     */
+    struct
+        View {
+        uint16_t sequence = 0;
+        bool valid = false;
+        float time = 0.0f;      ///< En el servidor: cuándo se envió. En el cliente: tiempo del servidor.
+        std::vector<QuantizedEntity> entities;
+    };
+
+    /**
+     * @brief Contadores de una ventana de un segundo para ReplicationPeerStats.
+     */
+    struct
+        TrafficWindow {
+        size_t bytes = 0;
+        size_t packets = 0;
+        size_t entities = 0;
+        float elapsed = 0.0f;
+    };
+
+    /**
+     * @brief Estado del servidor para un cliente.
+     */
+    struct
+        Client {
+        sf::IpAddress address;
+        unsigned short port = 0;
+        uint16_t nextSequence = 1;
+        bool hasAck = false;
+        uint16_t ackedSequence = 0;
+        View views[HISTORY_SIZE];
+        std::unordered_map<uint32_t, float> priorities;
+        sf::Vector2f viewCenter;
+        float viewRadius = 0.0f;
+        float lastHeard = 0.0f;
+        TrafficWindow traffic;
+        ReplicationPeerStats stats;
+    };
+
+    // Servidor
+    void
+        receiveServer();
+
+    void
+        sendSnapshots(float interval, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    void
+        sendSnapshot(Client& client, float interval);
+
+    void
+        sendAccept(const Client& client);
+
+    // Cliente
+    void
+        receiveClient();
+
+    bool
+        readSnapshot(BitReader& reader);
+
+    void
+        sendPacket(PacketType type);
+
+    void
+        interpolate(float deltaTime);
+
+    /**
+     * @brief Olvida los snapshots recibidos, por ejemplo al perder la conexión.
+     */
+    void
+        clearViews();
+
+    // Codificación
+    void
+        computeQuantization();
+
+    QuantizedEntity
+        quantize(uint32_t id, const Transform& transform) const;
+
+    ReplicatedTransform
+        dequantize(const QuantizedEntity& entity) const;
+
+    static bool
+        isSameState(const QuantizedEntity& a, const QuantizedEntity& b);
+
+    /**
+     * @brief Bits que ocupan los campos de la entidad contra su base, sin contar su id.
+     */
+    size_t
+        measureEntity(const QuantizedEntity& entity, const QuantizedEntity* base) const;
+
+    void
+        writeEntity(BitWriter& writer, const QuantizedEntity& entity, const QuantizedEntity* base) const;
+
+    bool
+        readEntity(BitReader& reader, QuantizedEntity& entity, const QuantizedEntity* base) const;
+
+    void
+        writeHeader(BitWriter& writer, PacketType type) const;
+
+    void
+        sendBuffer(const sf::IpAddress& address, unsigned short port);
+
+    void
+        updateTraffic(TrafficWindow& traffic, ReplicationPeerStats& stats, float deltaTime);
+
+    ReplicationMode m_mode = REPLICATION_OFF;
+    ReplicationSettings m_settings;
+    sf::UdpSocket m_socket;
+    float m_time = 0.0f;
+    std::vector<uint8_t> m_packet;
+    std::vector<uint8_t> m_receiveBuffer;
+
+    // Cuantización derivada de m_settings
+    uint32_t m_positionBits = 0;
+    uint32_t m_positionMax = 0;
+
+    // Servidor
+    std::vector<Client> m_clients;
+    std::vector<QuantizedEntity> m_current;     ///< Estado cuantizado del snapshot en curso.
+    std::vector<uint32_t> m_removed;
+    std::vector<Candidate> m_candidates;
+    std::vector<Candidate> m_selected;
+    float m_sendTimer = 0.0f;
+
+    // Cliente
+    sf::IpAddress m_serverAddress;
+    unsigned short m_serverPort = 0;
+    bool m_connected = false;
+    float m_connectTimer = 0.0f;
+    float m_lastHeard = 0.0f;
+    std::deque<View> m_views;                   ///< Snapshots recibidos, del más viejo al más nuevo.
+    std::vector<View> m_spareViews;
+    float m_renderTime = 0.0f;
+    bool m_hasRenderTime = false;
+    sf::Vector2f m_viewCenter;
+    std::vector<ReplicatedTransform> m_interpolated;
+    std::vector<Actor*> m_actors;
+    std::unordered_map<uint32_t, Transform*> m_transforms;
+    TrafficWindow m_traffic;
+    size_t m_lastEntities = 0;
+
+    std::vector<ReplicationPeerStats> m_peerStats;
+};
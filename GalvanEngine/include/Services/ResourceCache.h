@@ -0,0 +1,584 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Services/VirtualFileSystem.h"
+#include "Services/JobSystem.h"
+#include "Services/NotificationService.h"
+
+/*
+* @struct ResourceStats
+* @brief Contadores de memoria y de uso de un tipo de recurso.
+*/
+struct
+    ResourceStats {
+    size_t residentBytes = 0;   ///< Memoria estimada de los recursos cargados.
+    size_t budgetBytes = 0;     ///< Presupuesto de memoria del tipo de recurso.
+    size_t residentCount = 0;   ///< Recursos cargados.
+    size_t pinnedCount = 0;     ///< Recursos que nunca se desalojan.
+    size_t pendingCount = 0;    ///< Cargas asíncronas sin terminar.
+    uint64_t hits = 0;          ///< Peticiones resueltas con un recurso ya cargado.
+    uint64_t misses = 0;        ///< Peticiones que tuvieron que cargar desde disco.
+    uint64_t evictions = 0;     ///< Recursos liberados por exceder el presupuesto.
+
+    /**
+     * @brief Proporción de aciertos en [0, 1].
+     */
+    float
+        getHitRate() const {
+        uint64_t total = hits + misses;
+        return total > 0 ? static_cast<float>(hits) / static_cast<float>(total) : 0.0f;
+    }
+
+    /**
+     * @brief Acumula los contadores de otro tipo de recurso.
+     */
+    void
+        add(const ResourceStats& other) {
+        residentBytes += other.residentBytes;
+        budgetBytes += other.budgetBytes;
+        residentCount += other.residentCount;
+        pinnedCount += other.pinnedCount;
+        pendingCount += other.pendingCount;
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+    }
+};
+
+/*
+* @enum ResourceState
+* @brief Estado de un recurso dentro de su ResourceCache.
+*/
+enum
+    ResourceState {
+    RESOURCE_UNLOADED = 0,  ///< Conocido pero sin cargar, o desalojado por el presupuesto.
+    RESOURCE_LOADING = 1,   ///< Carga asíncrona en curso.
+    RESOURCE_READY = 2,
+    RESOURCE_FAILED = 3
+};
+
+/*
+* @struct ResourceHandle
+* @brief Identificador tipado de un recurso; un handle de fuente no se confunde con uno de textura.
+*
+* El handle sigue siendo válido aunque el recurso se desaloje: al pedirlo de nuevo se recarga.
+*/
+template<typename T>
+struct
+    ResourceHandle {
+    static const uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+
+    bool
+        isValid() const {
+        return index != INVALID;
+    }
+
+    bool
+        operator==(const ResourceHandle& other) const {
+        return index == other.index;
+    }
+
+    bool
+        operator!=(const ResourceHandle& other) const {
+        return index != other.index;
+    }
+};
+
+/**
+ * @class ResourceCache
+ * @brief Caché genérico de recursos con presupuesto de memoria, desalojo LRU y carga asíncrona.
+ *
+ * Loader define cómo se construye el recurso a partir del archivo leído por el
+ * VirtualFileSystem:
+ * - Staging: datos intermedios producidos por decode.
+ * - KEEP_SOURCE: true si el recurso sigue leyendo el archivo después de crearse.
+ * - decode(file, extension, staging): trabajo de CPU, puede correr en cualquier hilo.
+ * - create(name, extension, staging, file): crea el recurso en el hilo dueño del caché.
+ * - getBytes(resource, file): memoria estimada del recurso.
+ *
+ * La búsqueda por nombre acepta std::string_view y no construye cadenas temporales.
+ * Solo decode corre fuera del hilo dueño; todo lo demás debe llamarse desde ese hilo.
+ */
+template<typename T, typename Loader>
+class
+    ResourceCache {
+public:
+    using Handle = ResourceHandle<T>;
+    using Pointer = EngineUtilities::TSharedPointer<T>;
+    using Staging = typename Loader::Staging;
+
+    /**
+     * @brief Constructor con el presupuesto de memoria del tipo de recurso.
+     */
+    explicit
+        ResourceCache(size_t budgetBytes) : m_async(std::make_shared<AsyncQueue>()) {
+        m_stats.budgetBytes = budgetBytes;
+    }
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    /**
+     * @brief Busca un recurso conocido por nombre.
+     * @return Handle inválido si el nombre nunca se pidió.
+     */
+    Handle
+        find(std::string_view name) const {
+        Handle handle;
+        handle.index = findSlot(name);
+        return handle;
+    }
+
+    /**
+     * @brief Carga un recurso en este momento si no está cargado.
+     * @param name Nombre del recurso, por ejemplo "Map002".
+     * @param extension Extensión sin punto.
+     * @return Handle del recurso; getState indica si la carga falló.
+     */
+    Handle
+        load(std::string_view name, std::string_view extension) {
+        Handle handle;
+        handle.index = findOrCreateSlot(name, extension);
+        Entry& entry = m_entries[handle.index];
+        if (entry.state == RESOURCE_READY) {
+            ++m_stats.hits;
+            touch(entry);
+            return handle;
+        }
+        if (entry.state == RESOURCE_LOADING) {
+            waitFor(handle.index);
+            return handle;
+        }
+        ++m_stats.misses;
+        loadNow(handle.index);
+        return handle;
+    }
+
+    /**
+     * @brief Encola la lectura y decodificación del recurso en el JobSystem.
+     *
+     * El recurso queda listo en la llamada a update que recoja el resultado.
+     */
+    Handle
+        loadAsync(std::string_view name, std::string_view extension) {
+        Handle handle;
+        handle.index = findOrCreateSlot(name, extension);
+        Entry& entry = m_entries[handle.index];
+        if (entry.state == RESOURCE_READY) {
+            ++m_stats.hits;
+            touch(entry);
+            return handle;
+        }
+        if (entry.state == RESOURCE_LOADING) {
+            return handle;
+        }
+
+        ++m_stats.misses;
+        ++m_stats.pendingCount;
+        entry.state = RESOURCE_LOADING;
+
+        // La cola es compartida para que un trabajo tardío no toque un caché ya destruido
+        std::shared_ptr<AsyncQueue> queue = m_async;
+        uint32_t index = handle.index;
+        std::string fileName = entry.name;
+        std::string fileExtension = entry.extension;
+        JobSystem::getInstance().submit([queue, index, fileName, fileExtension]() {
+            auto done = std::make_unique<Completed>();
+            done->index = index;
+            done->decoded = VirtualFileSystem::getInstance().read(fileName, fileExtension, done->file) &&
+                            Loader::decode(done->file, fileExtension, done->staging);
+            {
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                queue->completed.push_back(std::move(done));
+            }
+            queue->ready.notify_all();
+        });
+        return handle;
+    }
+
+    /**
+     * @brief Recurso listo para usar, o nullptr si está cargando, falló o fue desalojado.
+     */
+    T*
+        get(Handle handle) {
+        if (!handle.isValid() || handle.index >= m_entries.size()) {
+            return nullptr;
+        }
+        Entry& entry = m_entries[handle.index];
+        if (entry.state != RESOURCE_READY) {
+            return nullptr;
+        }
+        touch(entry);
+        return entry.resource.get();
+    }
+
+    /**
+     * @brief Obtiene una referencia al recurso, recargándolo si fue desalojado.
+     *
+     * Mientras alguien retenga la referencia el recurso no se desaloja.
+     */
+    Pointer
+        acquire(Handle handle) {
+        if (!handle.isValid() || handle.index >= m_entries.size()) {
+            return Pointer();
+        }
+        Entry& entry = m_entries[handle.index];
+        if (entry.state == RESOURCE_LOADING) {
+            waitFor(handle.index);
+        }
+        else if (entry.state == RESOURCE_UNLOADED) {
+            ++m_stats.misses;
+            loadNow(handle.index);
+        }
+        Entry& loaded = m_entries[handle.index];
+        if (loaded.state != RESOURCE_READY) {
+            return Pointer();
+        }
+        touch(loaded);
+        return loaded.resource;
+    }
+
+    /**
+     * @brief Obtiene una referencia a un recurso conocido por nombre.
+     */
+    Pointer
+        acquire(std::string_view name) {
+        return acquire(find(name));
+    }
+
+    ResourceState
+        getState(Handle handle) const {
+        if (!handle.isValid() || handle.index >= m_entries.size()) {
+            return RESOURCE_UNLOADED;
+        }
+        return m_entries[handle.index].state;
+    }
+
+    /**
+     * @brief Nombre con el que se pidió el recurso.
+     */
+    std::string_view
+        getName(Handle handle) const {
+        if (!handle.isValid() || handle.index >= m_entries.size()) {
+            return std::string_view();
+        }
+        return m_entries[handle.index].name;
+    }
+
+    /**
+     * @brief Evita o permite que un recurso sea desalojado.
+     */
+    void
+        pin(Handle handle, bool pinned) {
+        if (!handle.isValid() || handle.index >= m_entries.size()) {
+            return;
+        }
+        Entry& entry = m_entries[handle.index];
+        if (entry.pinned == pinned) {
+            return;
+        }
+        entry.pinned = pinned;
+        if (pinned) {
+            ++m_stats.pinnedCount;
+        }
+        else {
+            --m_stats.pinnedCount;
+        }
+    }
+
+    void
+        setBudget(size_t bytes) {
+        m_stats.budgetBytes = bytes;
+    }
+
+    /**
+     * @brief Termina las cargas asíncronas listas, registra qué recursos siguen en uso y
+     * desaloja los que excedan el presupuesto.
+     * @param frame Frame que se está simulando; los recursos referenciados quedan marcados con él.
+     * @param oldestFrameInFlight Frame más antiguo que algún hilo todavía puede usar.
+     *
+     * Un recurso solo se desaloja si nadie fuera del caché lo referencia y si su último uso
+     * es anterior a oldestFrameInFlight.
+     */
+    void
+        update(uint64_t frame, uint64_t oldestFrameInFlight) {
+        m_frame = frame;
+        drainCompleted();
+        for (uint32_t index : m_lru) {
+            Entry& entry = m_entries[index];
+            if (isReferenced(entry)) {
+                entry.lastUsedFrame = frame;
+            }
+        }
+        trim(oldestFrameInFlight);
+    }
+
+    /**
+     * @brief Crea los recursos de las cargas asíncronas terminadas, sin desalojar nada.
+     * @param wait true para bloquear hasta que termine al menos una carga pendiente.
+     * @return Cargas terminadas en esta llamada.
+     */
+    size_t
+        poll(bool wait) {
+        if (wait && m_stats.pendingCount > 0) {
+            waitForCompleted();
+        }
+        return drainCompleted();
+    }
+
+    /**
+     * @brief Bloquea hasta que terminen todas las cargas asíncronas pendientes.
+     */
+    void
+        waitForAll() {
+        while (m_stats.pendingCount > 0) {
+            waitForCompleted();
+            drainCompleted();
+        }
+    }
+
+    /**
+     * @brief Prepara el reemplazo en sitio de un recurso cargado cuyo archivo cambió.
+     * @param name Nombre del recurso.
+     * @param extension Extensión del archivo modificado.
+     * @param newBytes Memoria estimada del recurso una vez reemplazado.
+     * @return El recurso a actualizar, o nullptr si no está cargado con esa extensión.
+     *
+     * El recurso se marca como usado en el frame actual para que no se desaloje mientras
+     * el reemplazo está pendiente.
+     */
+    T*
+        beginReload(std::string_view name, std::string_view extension, size_t newBytes) {
+        uint32_t index = findSlot(name);
+        if (index == Handle::INVALID) {
+            return nullptr;
+        }
+        Entry& entry = m_entries[index];
+        if (entry.state != RESOURCE_READY || entry.extension != extension) {
+            return nullptr;
+        }
+        m_stats.residentBytes = m_stats.residentBytes - entry.bytes + newBytes;
+        entry.bytes = newBytes;
+        entry.lastUsedFrame = m_frame;
+        return entry.resource.get();
+    }
+
+    const ResourceStats&
+        getStats() const {
+        return m_stats;
+    }
+
+private:
+    /*
+    * @struct Entry
+    * @brief Recurso conocido con sus datos de contabilidad.
+    */
+    struct
+        Entry {
+        std::string name;
+        std::string extension;
+        uint64_t hash = 0;
+        Pointer resource;
+        FileView source;                        ///< Solo se conserva si Loader::KEEP_SOURCE.
+        size_t bytes = 0;
+        uint64_t lastUsedFrame = 0;             ///< Último frame en que se pidió o referenció.
+        bool pinned = false;
+        ResourceState state = RESOURCE_UNLOADED;
+        std::list<uint32_t>::iterator lruPosition; ///< Posición en m_lru mientras está cargado.
+    };
+
+    /*
+    * @struct Completed
+    * @brief Resultado de una carga asíncrona, esperando a que el hilo dueño cree el recurso.
+    */
+    struct
+        Completed {
+        uint32_t index = 0;
+        bool decoded = false;
+        FileView file;
+        Staging staging;
+    };
+
+    /*
+    * @struct AsyncQueue
+    * @brief Cargas terminadas por el JobSystem.
+    */
+    struct
+        AsyncQueue {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<std::unique_ptr<Completed>> completed;
+    };
+
+    /**
+     * @brief FNV-1a del nombre, para buscar sin construir un std::string.
+     */
+    static uint64_t
+        hashName(std::string_view name) {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : name) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint32_t
+        findSlot(std::string_view name) const {
+        auto range = m_lookup.equal_range(hashName(name));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (m_entries[it->second].name == name) {
+                return it->second;
+            }
+        }
+        return Handle::INVALID;
+    }
+
+    uint32_t
+        findOrCreateSlot(std::string_view name, std::string_view extension) {
+        uint32_t index = findSlot(name);
+        if (index != Handle::INVALID) {
+            Entry& entry = m_entries[index];
+            if (entry.state != RESOURCE_READY && entry.state != RESOURCE_LOADING && entry.extension != extension) {
+                entry.extension.assign(extension.data(), extension.size());
+            }
+            return index;
+        }
+
+        index = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+        Entry& entry = m_entries.back();
+        entry.name.assign(name.data(), name.size());
+        entry.extension.assign(extension.data(), extension.size());
+        entry.hash = hashName(name);
+        m_lookup.emplace(entry.hash, index);
+        return index;
+    }
+
+    /**
+     * @brief Lee y crea el recurso en el hilo actual.
+     */
+    bool
+        loadNow(uint32_t index) {
+        FileView file;
+        Staging staging{};
+        const Entry& entry = m_entries[index];
+        bool decoded = VirtualFileSystem::getInstance().read(entry.name, entry.extension, file) &&
+                       Loader::decode(file, entry.extension, staging);
+        return finish(index, decoded, file, staging);
+    }
+
+    /**
+     * @brief Crea el recurso con los datos decodificados y lo agrega a la contabilidad.
+     */
+    bool
+        finish(uint32_t index, bool decoded, FileView& file, Staging& staging) {
+        Entry& entry = m_entries[index];
+        Pointer resource;
+        if (decoded) {
+            resource = Loader::create(entry.name, entry.extension, staging, file);
+        }
+        if (resource.isNull()) {
+            entry.state = RESOURCE_FAILED;
+            NotificationService::getInstance().addMessage(ConsolErrorType::WARNING,
+                                                          "Resource failed to load: " + entry.name + "." + entry.extension);
+            return false;
+        }
+
+        entry.resource = resource;
+        entry.bytes = Loader::getBytes(*resource, file);
+        if (Loader::KEEP_SOURCE) {
+            entry.source = std::move(file);
+        }
+        entry.state = RESOURCE_READY;
+        entry.lastUsedFrame = m_frame;
+        m_lru.push_front(index);
+        entry.lruPosition = m_lru.begin();
+
+        m_stats.residentBytes += entry.bytes;
+        ++m_stats.residentCount;
+        return true;
+    }
+
+    /**
+     * @brief Crea los recursos de las cargas asíncronas terminadas.
+     */
+    size_t
+        drainCompleted() {
+        {
+            std::lock_guard<std::mutex> lock(m_async->mutex);
+            m_completed.swap(m_async->completed);
+        }
+        for (auto& done : m_completed) {
+            --m_stats.pendingCount;
+            finish(done->index, done->decoded, done->file, done->staging);
+        }
+        size_t count = m_completed.size();
+        m_completed.clear();
+        return count;
+    }
+
+    void
+        waitForCompleted() {
+        std::unique_lock<std::mutex> lock(m_async->mutex);
+        m_async->ready.wait(lock, [this]() { return !m_async->completed.empty(); });
+    }
+
+    /**
+     * @brief Bloquea hasta que termine la carga asíncrona de un recurso.
+     */
+    void
+        waitFor(uint32_t index) {
+        while (m_entries[index].state == RESOURCE_LOADING) {
+            waitForCompleted();
+            drainCompleted();
+        }
+    }
+
+    void
+        touch(Entry& entry) {
+        entry.lastUsedFrame = m_frame;
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+    }
+
+    /**
+     * @brief Indica si alguien además del caché retiene el recurso.
+     */
+    static bool
+        isReferenced(const Entry& entry) {
+        return entry.resource.refCount != nullptr && *entry.resource.refCount > 1;
+    }
+
+    /**
+     * @brief Desaloja desde el final de la lista LRU hasta volver al presupuesto.
+     */
+    void
+        trim(uint64_t oldestFrameInFlight) {
+        auto it = m_lru.end();
+        while (m_stats.residentBytes > m_stats.budgetBytes && it != m_lru.begin()) {
+            --it;
+            Entry& entry = m_entries[*it];
+            if (entry.pinned || isReferenced(entry) || entry.lastUsedFrame >= oldestFrameInFlight) {
+                continue;
+            }
+
+            m_stats.residentBytes -= entry.bytes;
+            --m_stats.residentCount;
+            ++m_stats.evictions;
+            entry.resource.reset();
+            entry.source = FileView();
+            entry.bytes = 0;
+            entry.state = RESOURCE_UNLOADED;
+            it = m_lru.erase(it);
+        }
+    }
+
+    std::vector<Entry> m_entries;                       ///< Recursos conocidos; el índice es el handle.
+    std::unordered_multimap<uint64_t, uint32_t> m_lookup; ///< Hash del nombre -> índice.
+    std::list<uint32_t> m_lru;                          ///< Recursos cargados, del más reciente al menos reciente.
+    std::shared_ptr<AsyncQueue> m_async;
+    std::vector<std::unique_ptr<Completed>> m_completed; ///< Buffer reutilizado por drainCompleted.
+    ResourceStats m_stats;
+    uint64_t m_frame = 0;
+};
@@ -0,0 +1,88 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Texture.h"
+#include "Services/VirtualFileSystem.h"
+
+/*
+* @struct NoStaging
+* @brief Staging vacío para los recursos que se crean directo desde el archivo.
+*/
+struct
+    NoStaging {
+};
+
+/*
+* @struct TextureLoader
+* @brief Decodifica la imagen fuera del hilo principal; la textura de la GPU se crea en create.
+*/
+struct
+    TextureLoader {
+    using Staging = sf::Image;
+    static const bool KEEP_SOURCE = false;
+
+    static bool
+        decode(const FileView& file, std::string_view extension, sf::Image& staging);
+
+    static EngineUtilities::TSharedPointer<Texture>
+        create(const std::string& name, const std::string& extension, sf::Image& staging, FileView& file);
+
+    static size_t
+        getBytes(Texture& texture, const FileView& file);
+};
+
+/*
+* @struct FontLoader
+* @brief sf::Font lee los glifos del archivo bajo demanda, así que el archivo se conserva.
+*/
+struct
+    FontLoader {
+    using Staging = NoStaging;
+    static const bool KEEP_SOURCE = true;
+
+    static bool
+        decode(const FileView& file, std::string_view extension, NoStaging& staging);
+
+    static EngineUtilities::TSharedPointer<sf::Font>
+        create(const std::string& name, const std::string& extension, NoStaging& staging, FileView& file);
+
+    static size_t
+        getBytes(sf::Font& font, const FileView& file);
+};
+
+/*
+* @struct SoundLoader
+* @brief Decodifica las muestras completas fuera del hilo principal.
+*/
+struct
+    SoundLoader {
+    using Staging = std::unique_ptr<sf::SoundBuffer>;
+    static const bool KEEP_SOURCE = false;
+
+    static bool
+        decode(const FileView& file, std::string_view extension, Staging& staging);
+
+    static EngineUtilities::TSharedPointer<sf::SoundBuffer>
+        create(const std::string& name, const std::string& extension, Staging& staging, FileView& file);
+
+    static size_t
+        getBytes(sf::SoundBuffer& sound, const FileView& file);
+};
+
+/*
+* @struct ShaderLoader
+* @brief Compila un shader; el tipo sale de la extensión ("vert", "geom" o "frag").
+*/
+struct
+    ShaderLoader {
+    using Staging = std::string;
+    static const bool KEEP_SOURCE = false;
+
+    static bool
+        decode(const FileView& file, std::string_view extension, std::string& staging);
+
+    static EngineUtilities::TSharedPointer<sf::Shader>
+        create(const std::string& name, const std::string& extension, std::string& staging, FileView& file);
+
+    static size_t
+        getBytes(sf::Shader& shader, const FileView& file);
+};
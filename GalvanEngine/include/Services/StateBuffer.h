@@ -0,0 +1,179 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @class StateWriter
+ * @brief Escribe columnas de datos POD en un búfer contiguo, cada una con su número de elementos.
+ *
+ * Cada campo se rellena a múltiplos de 8 bytes: así toda columna empieza alineada y
+ * WorldSnapshot puede comparar snapshots palabra por palabra.
+ */
+class
+    StateWriter {
+public:
+    static const size_t ALIGNMENT = 8;
+
+    explicit StateWriter(std::vector<uint8_t>& buffer) : m_buffer(buffer) {
+        m_buffer.clear();
+    }
+
+    template<typename T>
+    void
+        writeValue(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Solo se guardan datos POD");
+        append(&value, sizeof(T));
+    }
+
+    /**
+     * @brief Copia una columna completa con un solo memcpy.
+     */
+    template<typename T>
+    void
+        writeColumn(const std::vector<T>& column) {
+        static_assert(std::is_trivially_copyable<T>::value, "Solo se guardan datos POD");
+        uint32_t count = static_cast<uint32_t>(column.size());
+        append(&count, sizeof(count));
+        append(column.data(), column.size() * sizeof(T));
+    }
+
+    /**
+     * @brief Reserva una columna de count elementos para llenarla campo por campo.
+     */
+    template<typename T>
+    T*
+        beginColumn(uint32_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Solo se guardan datos POD");
+        append(&count, sizeof(count));
+        size_t offset = m_buffer.size();
+        size_t bytes = static_cast<size_t>(count) * sizeof(T);
+        m_buffer.resize(offset + ((bytes + StateWriter::ALIGNMENT - 1) & ~(StateWriter::ALIGNMENT - 1)), 0);
+        return reinterpret_cast<T*>(m_buffer.data() + offset);
+    }
+
+private:
+    void
+        append(const void* data, size_t bytes) {
+        size_t offset = m_buffer.size();
+        m_buffer.resize(offset + ((bytes + StateWriter::ALIGNMENT - 1) & ~(StateWriter::ALIGNMENT - 1)), 0);
+        if (bytes > 0) {
+            std::memcpy(m_buffer.data() + offset, data, bytes);
+        }
+    }
+
+    std::vector<uint8_t>& m_buffer;
+};
+
+/**
+ * @class StateReader
+ * @brief Lee las columnas escritas por un StateWriter, en el mismo orden.
+ *
+ * Se usa en dos pasadas: la primera solo comprueba que el snapshot corresponda a la
+ * escena actual (mismos dueños en los mismos lugares) y la segunda copia los datos. Así
+ * un snapshot incompatible no deja la escena restaurada a medias.
+ */
+class
+    StateReader {
+public:
+    StateReader(const std::vector<uint8_t>& buffer, bool applying) : m_buffer(buffer), m_applying(applying) {}
+
+    /**
+     * @brief true en la pasada que copia; en la primera solo se valida.
+     */
+    bool
+        isApplying() const {
+        return m_applying;
+    }
+
+    template<typename T>
+    bool
+        readValue(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Solo se guardan datos POD");
+        const uint8_t* data = take(sizeof(T));
+        if (data == nullptr) {
+            return false;
+        }
+        if (m_applying) {
+            std::memcpy(&value, data, sizeof(T));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Lee una columna; con resize = false falla si su tamaño no coincide con la actual.
+     */
+    template<typename T>
+    bool
+        readColumn(std::vector<T>& column, bool resize = false) {
+        uint32_t count = 0;
+        const T* data = nullptr;
+        if (!takeColumn(count, data) || (!resize && count != column.size())) {
+            return false;
+        }
+        if (m_applying) {
+            column.resize(count);
+            if (count > 0) {
+                std::memcpy(column.data(), data, count * sizeof(T));
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Compara una columna guardada con la actual sin copiarla; sirve para validar dueños.
+     */
+    template<typename T>
+    bool
+        matchColumn(const std::vector<T>& column) {
+        uint32_t count = 0;
+        const T* data = nullptr;
+        return takeColumn(count, data) && count == column.size() &&
+               (count == 0 || std::memcmp(data, column.data(), count * sizeof(T)) == 0);
+    }
+
+    /**
+     * @brief Columna llenada con beginColumn; se lee campo por campo.
+     */
+    template<typename T>
+    const T*
+        readColumnData(uint32_t expectedCount) {
+        uint32_t count = 0;
+        const T* data = nullptr;
+        if (!takeColumn(count, data) || count != expectedCount) {
+            return nullptr;
+        }
+        return data;
+    }
+
+private:
+    template<typename T>
+    bool
+        takeColumn(uint32_t& count, const T*& data) {
+        static_assert(std::is_trivially_copyable<T>::value, "Solo se guardan datos POD");
+        const uint8_t* header = take(sizeof(uint32_t));
+        if (header == nullptr) {
+            return false;
+        }
+        std::memcpy(&count, header, sizeof(count));
+        const uint8_t* bytes = take(static_cast<size_t>(count) * sizeof(T));
+        if (bytes == nullptr) {
+            return false;
+        }
+        data = reinterpret_cast<const T*>(bytes);
+        return true;
+    }
+
+    const uint8_t*
+        take(size_t bytes) {
+        size_t padded = (bytes + StateWriter::ALIGNMENT - 1) & ~(StateWriter::ALIGNMENT - 1);
+        if (m_offset + padded > m_buffer.size()) {
+            return nullptr;
+        }
+        const uint8_t* data = m_buffer.data() + m_offset;
+        m_offset += padded;
+        return data;
+    }
+
+    const std::vector<uint8_t>& m_buffer;
+    size_t m_offset = 0;
+    bool m_applying = false;
+};
@@ -0,0 +1,291 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+/*
+* @enum TimerDispatch
+* @brief Hilo donde se ejecuta el callback de un timer.
+*/
+enum
+    TimerDispatch {
+    TIMER_MAIN_THREAD = 0,  ///< En update, en el orden en que vencieron.
+    TIMER_JOB_SYSTEM = 1    ///< Repartido en el JobSystem; no debe llamar al TimerService.
+};
+
+/*
+* @struct TimerHandle
+* @brief Identificador de un timer; la generación detecta timers ya terminados.
+*/
+struct
+    TimerHandle {
+    static const uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+    uint32_t generation = 0;
+
+    bool
+        isValid() const {
+        return index != INVALID;
+    }
+
+    bool
+        operator==(const TimerHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool
+        operator!=(const TimerHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+/*
+* @struct TimerStats
+* @brief Contadores del TimerService.
+*/
+struct
+    TimerStats {
+    size_t active = 0;
+    size_t firedLastUpdate = 0;
+    size_t heapCallbacks = 0;   ///< Callbacks vivos cuyas capturas no cupieron en el nodo.
+    float updateTimeMs = 0.0f;
+};
+
+/**
+ * @class TimerCallback
+ * @brief Callable guardado dentro del nodo del timer, sin reservar memoria si sus capturas caben.
+ *
+ * Las capturas de hasta INLINE_SIZE bytes se construyen en el propio búfer; las más grandes
+ * se reservan en el heap. Los nodos no se mueven de lugar, así que el callable tampoco.
+ */
+class
+    TimerCallback {
+public:
+    static const size_t INLINE_SIZE = 48;
+
+    TimerCallback() = default;
+
+    ~TimerCallback() {
+        reset();
+    }
+
+    TimerCallback(const TimerCallback&) = delete;
+    TimerCallback& operator=(const TimerCallback&) = delete;
+
+    template<typename F>
+    void
+        assign(F&& function) {
+        using Callable = typename std::decay<F>::type;
+        reset();
+        if (sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t)) {
+            new (m_storage) Callable(std::forward<F>(function));
+            m_invoke = [](void* storage) { (*static_cast<Callable*>(storage))(); };
+            m_destroy = [](void* storage) { static_cast<Callable*>(storage)->~Callable(); };
+            m_heap = false;
+        }
+        else {
+            Callable* callable = new Callable(std::forward<F>(function));
+            std::memcpy(m_storage, &callable, sizeof(callable));
+            m_invoke = [](void* storage) {
+                Callable* pointer;
+                std::memcpy(&pointer, storage, sizeof(pointer));
+                (*pointer)();
+            };
+            m_destroy = [](void* storage) {
+                Callable* pointer;
+                std::memcpy(&pointer, storage, sizeof(pointer));
+                delete pointer;
+            };
+            m_heap = true;
+        }
+    }
+
+    void
+        operator()() {
+        m_invoke(m_storage);
+    }
+
+    void
+        reset() {
+        if (m_destroy != nullptr) {
+            m_destroy(m_storage);
+            m_destroy = nullptr;
+            m_invoke = nullptr;
+        }
+    }
+
+    bool
+        isOnHeap() const {
+        return m_destroy != nullptr && m_heap;
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char m_storage[INLINE_SIZE];
+    void (*m_invoke)(void*) = nullptr;
+    void (*m_destroy)(void*) = nullptr;
+    bool m_heap = false;
+};
+
+/**
+ * @class TimerService
+ * @brief Callbacks diferidos y periódicos sobre una rueda de tiempo jerárquica.
+ *
+ * El tiempo avanza en ticks (1 ms por defecto). Hay cuatro ruedas de 256 ranuras; la
+ * primera cubre los siguientes 256 ticks y cada una cubre 256 veces más que la anterior.
+ * Cada ranura es una lista doblemente enlazada de nodos, así insertar y cancelar cuestan
+ * O(1). Por tick solo se visita una ranura de la primera rueda; cuando esta da la vuelta,
+ * la ranura correspondiente de la rueda siguiente se reparte en las inferiores.
+ *
+ * Los nodos viven en un pool de direcciones estables, así un callback puede programar o
+ * cancelar timers mientras se ejecuta. Solo debe usarse desde el hilo de simulación.
+ */
+class
+    TimerService {
+private:
+    TimerService();
+    ~TimerService() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static TimerService& getInstance() {
+        static TimerService instance;
+        return instance;
+    }
+
+    /**
+     * @brief Ejecuta callback una vez, después de delay segundos.
+     */
+    template<typename F>
+    TimerHandle
+        schedule(float delay, F&& callback, TimerDispatch dispatch = TIMER_MAIN_THREAD) {
+        uint32_t index = allocateNode();
+        m_nodes[index].callback.assign(std::forward<F>(callback));
+        return start(index, toTicks(delay), 0, dispatch);
+    }
+
+    /**
+     * @brief Ejecuta callback cada interval segundos hasta cancelarlo.
+     * @param firstDelay Espera antes de la primera vez; negativo usa interval.
+     */
+    template<typename F>
+    TimerHandle
+        schedulePeriodic(float interval, F&& callback, float firstDelay = -1.0f,
+                         TimerDispatch dispatch = TIMER_MAIN_THREAD) {
+        uint32_t index = allocateNode();
+        m_nodes[index].callback.assign(std::forward<F>(callback));
+        uint64_t period = std::max<uint64_t>(toTicks(interval), 1);
+        return start(index, firstDelay < 0.0f ? period : toTicks(firstDelay), period, dispatch);
+    }
+
+    /**
+     * @brief Cancela el timer; si su callback se está ejecutando, termina pero no se repite.
+     */
+    void
+        cancel(TimerHandle handle);
+
+    bool
+        isActive(TimerHandle handle) const;
+
+    /**
+     * @brief Segundos que faltan para que venza, o -1 si el handle no es válido.
+     */
+    float
+        getRemaining(TimerHandle handle) const;
+
+    /**
+     * @brief Avanza el tiempo y ejecuta los callbacks de los timers que vencieron.
+     * @param deltaTime Tiempo transcurrido desde la última actualización
+     */
+    void
+        update(float deltaTime);
+
+    /**
+     * @brief Duración de un tick en segundos; solo cambia si no hay timers activos.
+     */
+    void
+        setResolution(float seconds);
+
+    const TimerStats&
+        getStats() const {
+        return m_stats;
+    }
+
+private:
+    static const uint32_t INVALID_NODE = 0xFFFFFFFFu;
+    static const uint32_t WHEEL_BITS = 8;
+    static const uint32_t WHEEL_SIZE = 1u << WHEEL_BITS;
+    static const uint32_t WHEEL_MASK = WHEEL_SIZE - 1;
+    static const uint32_t WHEEL_COUNT = 4;
+    static const uint16_t NO_BUCKET = 0xFFFF;
+
+    /*
+    * @struct TimerNode
+    * @brief Timer en el pool; se enlaza en la lista de su ranura.
+    */
+    struct
+        TimerNode {
+        TimerCallback callback;
+        uint64_t expiry = 0;            ///< Tick en que vence.
+        uint64_t period = 0;            ///< Ticks entre repeticiones; 0 si se ejecuta una vez.
+        uint32_t previous = INVALID_NODE;
+        uint32_t next = INVALID_NODE;
+        uint32_t generation = 0;
+        uint16_t bucket = NO_BUCKET;    ///< rueda * WHEEL_SIZE + ranura.
+        uint8_t dispatch = TIMER_MAIN_THREAD;
+        bool active = false;
+        bool running = false;
+        bool cancelled = false;
+    };
+
+    uint32_t
+        allocateNode();
+
+    TimerHandle
+        start(uint32_t index, uint64_t delayTicks, uint64_t period, TimerDispatch dispatch);
+
+    uint64_t
+        toTicks(float seconds) const;
+
+    /**
+     * @brief Enlaza el nodo en la ranura que corresponde a su vencimiento.
+     */
+    void
+        link(uint32_t index);
+
+    void
+        unlink(uint32_t index);
+
+    /**
+     * @brief Reparte la ranura actual de una rueda en las ruedas inferiores.
+     */
+    void
+        cascade(uint32_t wheel);
+
+    /**
+     * @brief Después de ejecutar el callback: vuelve a programar o libera el nodo.
+     */
+    void
+        finish(uint32_t index);
+
+    void
+        release(uint32_t index);
+
+    std::deque<TimerNode> m_nodes;      ///< deque: los nodos no se mueven al crecer.
+    std::vector<uint32_t> m_freeNodes;
+    uint32_t m_buckets[WHEEL_COUNT * WHEEL_SIZE];   ///< Primer nodo de cada ranura.
+
+    uint64_t m_now = 0;                 ///< Tick actual.
+    float m_tickSeconds = 0.001f;
+    float m_accumulator = 0.0f;
+
+    std::vector<uint32_t> m_expired;
+    std::vector<uint32_t> m_expiredJobs;
+    TimerStats m_stats;
+};
@@ -0,0 +1,108 @@
+﻿#pragma once
+#include "Prerequisites.h"
+#include "Services/PackArchive.h"
+
+/*
+* @struct FileView
+* @brief Contenido de un archivo leído por el VirtualFileSystem.
+*
+* Si el archivo viene sin compresión de un paquete, data apunta directo a la memoria
+* mapeada y storage queda vacío; en otro caso data apunta a storage.
+*/
+struct
+    FileView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    std::vector<uint8_t> storage;   ///< Datos descomprimidos o leídos de un archivo suelto.
+};
+
+/*
+* @struct VirtualFileSystemStats
+* @brief Contadores de lecturas del VirtualFileSystem.
+*/
+struct
+    VirtualFileSystemStats {
+    uint64_t packReads = 0;     ///< Lecturas resueltas desde un paquete.
+    uint64_t looseReads = 0;    ///< Lecturas que abrieron un archivo suelto.
+    uint64_t failedReads = 0;   ///< Archivos que no se encontraron.
+};
+
+/**
+ * @class VirtualFileSystem
+ * @brief Resuelve rutas de recursos contra paquetes montados y, si no están, contra el disco.
+ *
+ * Los paquetes montados después tienen prioridad, así un parche puede reemplazar recursos
+ * de un paquete base. Montar y desmontar debe hacerse antes de empezar a cargar recursos;
+ * las lecturas de paquetes solo consultan memoria mapeada y pueden hacerse desde varios hilos.
+ */
+class
+    VirtualFileSystem {
+private:
+    VirtualFileSystem() = default;
+    ~VirtualFileSystem() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+public:
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static VirtualFileSystem& getInstance() {
+        static VirtualFileSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Monta un paquete; sus entradas tienen prioridad sobre los paquetes anteriores.
+     * @param path Ruta del paquete.
+     * @return true si el paquete quedó montado.
+     */
+    bool
+        mount(const std::string& path);
+
+    /**
+     * @brief Desmonta todos los paquetes.
+     */
+    void
+        unmountAll() {
+        m_archives.clear();
+    }
+
+    /**
+     * @brief Lee un recurso por nombre y extensión, por ejemplo ("Map002", "png").
+     * @param name Nombre del recurso.
+     * @param extension Extensión sin punto; vacía si name ya es la ruta completa.
+     * @param out Recibe el contenido.
+     * @return true si el recurso se encontró en un paquete o en disco.
+     */
+    bool
+        read(std::string_view name, std::string_view extension, FileView& out);
+
+    /**
+     * @brief Indica si el recurso existe en algún paquete montado.
+     */
+    bool
+        isPacked(std::string_view name, std::string_view extension) const;
+
+    /**
+     * @brief Contadores de lecturas desde el arranque.
+     */
+    VirtualFileSystemStats
+        getStats() const {
+        VirtualFileSystemStats stats;
+        stats.packReads = m_packReads.load(std::memory_order_relaxed);
+        stats.looseReads = m_looseReads.load(std::memory_order_relaxed);
+        stats.failedReads = m_failedReads.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    std::vector<std::unique_ptr<PackArchive>> m_archives; ///< Paquetes montados, el último gana.
+    std::atomic<uint64_t> m_packReads{ 0 };
+    std::atomic<uint64_t> m_looseReads{ 0 };
+    std::atomic<uint64_t> m_failedReads{ 0 };
+};
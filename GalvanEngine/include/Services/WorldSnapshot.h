@@ -0,0 +1,220 @@
+﻿#pragma once
+#include "Prerequisites.h"
+
+class Actor;
+class Transform;
+
+/*
+* @struct SnapshotStats
+* @brief Tamaño del historial y tiempos de la última captura y restauración.
+*/
+struct
+    SnapshotStats {
+    size_t frames = 0;          ///< Snapshots en el historial.
+    size_t keyframes = 0;
+    size_t rawBytes = 0;        ///< Tamaño sin comprimir de un snapshot.
+    size_t storedBytes = 0;     ///< Memoria usada por todo el historial.
+    float captureTimeMs = 0.0f;
+    float restoreTimeMs = 0.0f;
+};
+
+/**
+ * @class WorldSnapshot
+ * @brief Historial de snapshots del mundo para repeticiones y rollback de red.
+ *
+ * Un snapshot es un búfer contiguo con los Transform de los actores y los arreglos de
+ * PathSystem, SteeringSystem, SpriteAnimationSystem y PhysicsWorld, copiados columna por
+ * columna con memcpy. Cada keyframeInterval capturas se guarda un snapshot completo; los
+ * demás se guardan como la diferencia (XOR) con el anterior, comprimida por rachas de
+ * palabras iguales a cero, que es casi todo lo que no se movió en el frame.
+ *
+ * Se guarda estado, no estructura: restore solo funciona si los actores y componentes
+ * registrados son los mismos que al capturar, y si no lo son falla sin tocar nada. Los
+ * tweens, timers y eventos pendientes no forman parte del snapshot.
+ *
+ * Solo debe usarse desde el hilo de simulación, fuera de los update de los sistemas.
+ */
+class
+    WorldSnapshot {
+private:
+    WorldSnapshot() = default;
+    ~WorldSnapshot() = default;
+
+    /**
+     * @brief Deshabilitar el copiado y la asignación
+     */
+    WorldSnapshot(const WorldSnapshot&) = delete;
+    WorldSnapshot& operator=(const WorldSnapshot&) = delete;
+
+public:
+    static const size_t DEFAULT_HISTORY = 120;
+    static const uint32_t DEFAULT_KEYFRAME_INTERVAL = 8;
+
+    /**
+     * @brief Singleton para tener una instancia única de la clase
+     */
+    static WorldSnapshot& getInstance() {
+        static WorldSnapshot instance;
+        return instance;
+    }
+
+    /**
+     * @brief Guarda el estado actual como el del frame indicado.
+     *
+     * Si frame no es posterior al último capturado, se descartan los snapshots desde
+     * frame en adelante y se vuelve a capturar a partir de ahí.
+     */
+    void
+        capture(uint64_t frame, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    /**
+     * @brief Devuelve el mundo al estado del frame indicado y descarta los snapshots posteriores.
+     * @return false si el frame ya no está en el historial o la escena cambió de estructura.
+     */
+    bool
+        restore(uint64_t frame, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    bool
+        hasFrame(uint64_t frame) const;
+
+    /**
+     * @brief Hash del identificador y el Transform de cada actor, estable entre ejecuciones.
+     *
+     * Todos los sistemas terminan escribiendo en el Transform, así que dos sesiones con el
+     * mismo hash llegaron al mismo estado visible. No depende de direcciones de memoria.
+     */
+    uint64_t
+        computeHash(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    /**
+     * @brief Frame más antiguo que se puede restaurar; 0 si el historial está vacío.
+     */
+    uint64_t
+        getOldestFrame() const {
+        return m_entries.empty() ? 0 : m_entries.front().frame;
+    }
+
+    uint64_t
+        getNewestFrame() const {
+        return m_entries.empty() ? 0 : m_entries.back().frame;
+    }
+
+    /**
+     * @brief Frames que se conservan como mínimo.
+     */
+    void
+        setHistorySize(size_t frames);
+
+    void
+        setKeyframeInterval(uint32_t interval) {
+        m_keyframeInterval = std::max<uint32_t>(interval, 1);
+    }
+
+    void
+        clear();
+
+    const SnapshotStats&
+        getStats() const {
+        return m_stats;
+    }
+
+private:
+    /*
+    * @struct Entry
+    * @brief Snapshot completo o diferencia con el anterior del historial.
+    */
+    struct
+        Entry {
+        uint64_t frame = 0;
+        bool keyframe = false;
+        std::vector<uint8_t> data;
+    };
+
+    /*
+    * @struct TransformState
+    * @brief Los campos de un Transform, copiados a una columna.
+    */
+    struct
+        TransformState {
+        sf::Vector2f position;
+        sf::Vector2f rotation;
+        sf::Vector2f scale;
+    };
+
+    /**
+     * @brief Vuelve a buscar los Transform solo si cambió la lista de actores.
+     */
+    void
+        refreshActors(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors);
+
+    void
+        gather(std::vector<uint8_t>& out);
+
+    /**
+     * @brief Valida el snapshot completo contra la escena y después lo copia.
+     */
+    bool
+        apply(const std::vector<uint8_t>& raw);
+
+    /**
+     * @brief Reconstruye el snapshot completo de una entrada desde su keyframe.
+     */
+    void
+        decode(size_t index, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Escribe en m_encodeBuffer la diferencia entre current y previous.
+     * @return Bytes escritos.
+     *
+     * Formato en palabras de 32 bits: número de palabras de current y después pares
+     * [racha de ceros][cantidad de literales] seguidos de los literales. Una racha de
+     * literales termina en dos ceros seguidos.
+     */
+    size_t
+        encodeDelta(const std::vector<uint8_t>& previous, const std::vector<uint8_t>& current);
+
+    /**
+     * @brief Convierte raw en el snapshot siguiente; solo toca las palabras que cambiaron.
+     */
+    static void
+        applyDelta(const std::vector<uint8_t>& delta, std::vector<uint8_t>& raw);
+
+    /**
+     * @brief Quita las entradas desde frame en adelante y recupera el último snapshot completo.
+     */
+    void
+        truncateFrom(uint64_t frame);
+
+    /**
+     * @brief Quita los grupos de keyframe más antiguos mientras sobren frames.
+     */
+    void
+        trimHistory();
+
+    /**
+     * @brief Cuenta las diferencias guardadas después del último keyframe.
+     */
+    void
+        countSinceKeyframe();
+
+    void
+        recycle(Entry& entry);
+
+    void
+        updateStats();
+
+    std::deque<Entry> m_entries;
+    std::vector<std::vector<uint8_t>> m_spareKeyframes; ///< Búferes de entradas descartadas, para no reservar.
+    std::vector<std::vector<uint8_t>> m_spareDeltas;    ///< Aparte: un delta no debe quedarse con la capacidad de un keyframe.
+    std::vector<uint8_t> m_lastRaw;                     ///< Snapshot completo de la última entrada.
+    std::vector<uint8_t> m_current;
+    std::vector<uint8_t> m_encodeBuffer;                ///< Solo crece, así no se rellena con ceros en cada captura.
+
+    std::vector<Actor*> m_actors;
+    std::vector<Transform*> m_transforms;
+
+    size_t m_historySize = DEFAULT_HISTORY;
+    uint32_t m_keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    uint32_t m_sinceKeyframe = 0;
+    SnapshotStats m_stats;
+};
@@ -1,93 +1,109 @@
 ﻿#pragma once
 #include "Prerequisites.h"
+#include "ECS/Component.h"
+#include "Window.h"
+#include "Texture.h"
 
+/**
+ * @class ShapeFactory
+ * @brief Componente que crea y administra la figura de SFML de un actor.
+ *
+ * La figura se crea según un `ShapeType` (círculo, rectángulo o triángulo) y se
+ * sincroniza con el Transform del actor en cada actualización.
+ */
 class
-	Window {
+    ShapeFactory : public Component {
 public:
-	Window() = default;
-	Window(int width, int height, const std::string& title);
-	~Window();
+    /**
+     * @brief Constructor por defecto, registra el componente como SHAPE.
+     */
+    ShapeFactory() : Component(ComponentType::SHAPE) {}
 
-	/**
-	 * @brief Procesa los eventos de la ventana y actualiza el estado de esta.
-	 */
-	void
-		handleEvents();
+    /**
+     * @brief Destructor, libera la figura creada.
+     */
+    virtual
+        ~ShapeFactory() {
+        SAFE_PTR_RELEASE(m_shape);
+    }
 
-	/**
-	 * @brief Limpia el contenido de la ventana con el color predeterminado.
-	 */
-	void
-		clear();
+    /**
+     * @brief Crea una forma gráfica según el tipo especificado.
+     * @param shapeType Tipo de forma a crear.
+     * @return Puntero a la forma creada, o nullptr si el tipo no se reconoce.
+     */
+    sf::Shape*
+        createShape(ShapeType shapeType);
 
-	/**
-	 * @brief Muestra el contenido de la ventana en la pantalla.
-	 */
-	void
-		display();
+    /**
+     * @brief Método para actualizar el componente, la figura no requiere lógica por frame.
+     * @param deltaTime Tiempo transcurrido desde la última actualización.
+     */
+    void
+        update(float deltaTime) override {}
 
-	/**
-	 * @brief Verifica si la ventana sigue abierta.
-	 * @return true si la ventana está abierta, false en caso contrario.
-	 */
-	bool
-		isOpen() const;
+    /**
+     * @brief Método para renderizar el componente, el dibujo lo realiza el actor.
+     * @param window Contexto del dispositivo para operaciones gráficas.
+     */
+    void
+        render(Window window) override {}
 
-	/**
-	 * @brief Dibuja un objeto sf::Drawable en la ventana.
-	 * @param drawable El objeto a dibujar en la ventana.
-	 */
-	void
-		draw(const sf::Drawable& drawable);
+    /**
+     * @brief Establece la posición de la forma.
+     */
+    void
+        setPosition(float x, float y);
 
-	/**
-	 * @brief Obtiene el objeto interno SFML RenderWindow.
-	 * @return Un puntero al objeto interno SFML RenderWindow.
-	 */
-	sf::RenderWindow*
-		getWindow();
+    /**
+     * @brief Establece la posición de la forma usando un vector.
+     */
+    void
+        setPosition(const sf::Vector2f& position);
 
-	/**
-	 * @brief Inicializa la ventana.
-	 */
-	void
-		init();
+    /**
+     * @brief Establece la rotación de la forma en grados.
+     */
+    void
+        setRotation(float angle);
 
-	/**
-	 * @brief Actualiza la ventana por cada frame.
-	 */
-	void
-		update();
+    /**
+     * @brief Escala la forma en función de un vector de escala.
+     */
+    void
+        setScale(const sf::Vector2f& scl);
 
-	/**
-	 * @brief Realiza el renderizado de la ventana.
-	 */
-	void
-		render();
+    /**
+     * @brief Establece el color de relleno de la forma.
+     */
+    void
+        setFillColor(const sf::Color& color);
 
-	/**
-	 * @brief Destruye la ventana y libera sus recursos.
-	 */
-	void
-		destroy();
+    /**
+     * @brief Asigna la textura de la figura y retiene la textura mientras el componente viva.
+     * @param texture Textura obtenida del ResourceManager.
+     */
+    void
+        setTexture(const EngineUtilities::TSharedPointer<Texture>& texture);
 
-	/**
-	 * @brief Permite renderizar los objetos gráficos a una textura.
-	 */
-	void
-		renderToTexture();
+    /**
+     * @brief Obtiene la figura de SFML creada.
+     */
+    sf::Shape*
+        getShape() {
+        return m_shape;
+    }
 
-	/**
-	 * @brief Muestra el contenido de la ventana en ImGui.
-	 */
-	void
-		showInImGui();
+    /**
+     * @brief Obtiene el tipo de la figura creada.
+     */
+    ShapeType
+        getShapeType() const {
+        return m_shapeType;
+    }
 
 private:
-	sf::RenderWindow* m_window;
-	sf::View m_view;
-public:
-	sf::RenderTexture m_renderTexture; 
-	sf::Time deltaTime;
-	sf::Clock clock;
-};
\ No newline at end of file
+    sf::Shape* m_shape = nullptr;               ///< Figura de SFML.
+    ShapeType m_shapeType = ShapeType::EMPTY;   ///< Tipo de la figura.
+    EngineUtilities::TSharedPointer<Texture> m_texture; ///< Evita que el ResourceManager la desaloje.
+};
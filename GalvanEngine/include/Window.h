@@ -46,6 +46,30 @@ public:
 	void
 		handleEvents();
 
+	/**
+	 * @brief Procesa un evento en ImGui y aplica los cambios de tamaño a la vista y la RenderTexture.
+	 * @param event Evento de SFML a procesar.
+	 */
+	void
+		processEvent(const sf::Event& event);
+
+	/**
+	 * @brief Activa el reenvío de eventos para un hilo de render.
+	 *
+	 * Con el reenvío activo, handleEvents solo atiende el cierre de la ventana y guarda
+	 * el resto de eventos para que el hilo de render los procese con processEvent.
+	 * @param enabled true para reenviar los eventos.
+	 */
+	void
+		setEventForwarding(bool enabled);
+
+	/**
+	 * @brief Entrega los eventos reenviados desde el último llamado.
+	 * @param events Vector que recibe los eventos; su contenido anterior se descarta.
+	 */
+	void
+		takeForwardedEvents(std::vector<sf::Event>& events);
+
 	/**
 	 * @brief Limpia el contenido de la ventana con el color predeterminado.
 	 */
@@ -72,12 +96,29 @@ public:
 	void
 		draw(const sf::Drawable& drawable);
 
+	/**
+	 * @brief Dibuja un objeto con estados de render específicos (textura, blend, shader).
+	 * @param drawable Referencia a un objeto SFML que puede ser dibujado.
+	 * @param states Estados de render que se aplican al dibujo.
+	 */
+	void
+		draw(const sf::Drawable& drawable, const sf::RenderStates& states);
+
 	/**
 	 * @brief Obtiene el objeto interno de SFML `RenderWindow`.
 	 * @return Un puntero al objeto interno `sf::RenderWindow`.
 	 */
 	sf::RenderWindow* getWindow();
 
+	/**
+	 * @brief Tamaño de la RenderTexture donde se dibuja la escena.
+	 *
+	 * Se puede leer desde la simulación mientras el hilo de render recrea la textura al
+	 * cambiar el tamaño de la ventana.
+	 */
+	sf::Vector2u
+		getRenderSize() const;
+
 	/**
 	 * @brief Inicializa recursos y configuraciones de la ventana.
 	 */
@@ -109,4 +150,10 @@ public:
 private:
 	sf::RenderWindow* m_window; /// ventana de SFML para renderizado.
 	sf::View m_view; /// Vista de la ventana para controlar el área de renderizado.
+
+	bool m_forwardEvents = false; /// Los eventos se guardan para el hilo de render.
+	bool m_closeRequested = false; /// Se pidió cerrar la ventana mientras el hilo de render la usa.
+	std::mutex m_eventMutex; /// Protege m_forwardedEvents.
+	std::vector<sf::Event> m_forwardedEvents; /// Eventos pendientes para el hilo de render.
+	std::atomic<uint64_t> m_renderSize{ 0 }; /// Ancho y alto de m_renderTexture, para getRenderSize.
 };
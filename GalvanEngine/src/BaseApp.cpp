@@ -16,42 +16,211 @@ int BaseApp::run() {
     else {
         notifier.addMessage(ConsolErrorType::NORMAL, "All programs were initialized correctly");
     }
+
+    // La grabación o repetición empieza en el primer tick, con la escena ya creada
+    InputRecorder& recorder = InputRecorder::getInstance();
+    std::string inputError;
+    if (!m_replayPath.empty()) {
+        if (!recorder.startReplay(m_replayPath, inputError)) {
+            notifier.addMessage(ConsolErrorType::ERROR, inputError);
+        }
+    }
+    else if (!m_recordPath.empty()) {
+        if (!recorder.startRecording(m_recordPath, inputError)) {
+            notifier.addMessage(ConsolErrorType::ERROR, inputError);
+        }
+    }
+    startReplication();
+    startLockstep();
+    if (m_headless) {
+        return runHeadless();
+    }
     m_GUI.init();
 
+    // Con hilo de render la ventana solo reenvía eventos y el dibujo ocurre en paralelo
+    if (m_useRenderThread) {
+        m_window->setEventForwarding(true);
+        m_renderThread.start(m_window, &m_GUI);
+    }
+
     while (m_window->isOpen()) {
         m_window->handleEvents();
         deltaTime = clock.restart();
         update();
-        render();
+        if (m_useRenderThread) {
+            m_renderThread.waitForConsumer();
+            publishSnapshot();
+        }
+        else {
+            render();
+        }
+
+        // Al terminar la repetición se reportan sus tiempos y la sesión sigue en vivo
+        if (recorder.isReplayFinished()) {
+            finishInputSession();
+        }
     }
+    finishInputSession();
+    ReplicationService::getInstance().stop();
+    finishLockstep();
 
+    m_renderThread.stop();
     cleanup();
     return 0;
 }
 
+void BaseApp::parseArguments(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--record" && i + 1 < argc) {
+            m_recordPath = argv[++i];
+        }
+        else if (argument == "--replay" && i + 1 < argc) {
+            m_replayPath = argv[++i];
+        }
+        else if (argument == "--headless") {
+            m_headless = true;
+        }
+        else if (argument == "--serve" && i + 1 < argc) {
+            m_servePort = static_cast<unsigned short>(std::atoi(argv[++i]));
+        }
+        else if (argument == "--connect" && i + 1 < argc) {
+            std::string target = argv[++i];
+            size_t colon = target.rfind(':');
+            m_connectAddress = target.substr(0, colon);
+            m_connectPort = colon != std::string::npos ? static_cast<unsigned short>(std::atoi(target.c_str() + colon + 1)) : 0;
+        }
+        else if (argument == "--host" && i + 1 < argc) {
+            m_lockstepHostPort = static_cast<unsigned short>(std::atoi(argv[++i]));
+        }
+        else if (argument == "--join" && i + 1 < argc) {
+            std::string target = argv[++i];
+            size_t colon = target.rfind(':');
+            m_lockstepJoinAddress = target.substr(0, colon);
+            m_lockstepJoinPort = colon != std::string::npos ? static_cast<unsigned short>(std::atoi(target.c_str() + colon + 1)) : 0;
+        }
+        else if (argument == "--input-delay" && i + 1 < argc) {
+            m_inputDelay = static_cast<uint32_t>(std::atoi(argv[++i]));
+        }
+        else if (argument == "--duration" && i + 1 < argc) {
+            m_headlessSeconds = static_cast<float>(std::atof(argv[++i]));
+        }
+    }
+
+    // Sin ventana no hay hilo de render ni texturas que recargar
+    if (m_headless) {
+        m_useRenderThread = false;
+        m_hotReload = false;
+    }
+}
+
+int BaseApp::runHeadless() {
+    InputRecorder& recorder = InputRecorder::getInstance();
+    ReplicationService& replication = ReplicationService::getInstance();
+    LockstepService& lockstep = LockstepService::getInstance();
+    if (recorder.getMode() != INPUT_REPLAYING && replication.getMode() == REPLICATION_OFF && !lockstep.isActive()) {
+        std::cout << "--headless needs --replay <log>, --serve <port>, --connect <host:port>, --host <port> or --join <host:port>" << std::endl;
+        cleanup();
+        return 1;
+    }
+
+    // Red sin ventana: frames de 60 Hz en tiempo real durante --duration segundos
+    if (recorder.getMode() != INPUT_REPLAYING) {
+        const sf::Time tick = sf::seconds(1.0f / 60.0f);
+        bool lockstepSession = lockstep.isActive();
+        sf::Clock session;
+        clock.restart();
+        while (session.getElapsedTime().asSeconds() < m_headlessSeconds) {
+            // Si el otro jugador se fue, la sesión de lockstep no puede seguir
+            if (lockstepSession && !lockstep.isActive()) {
+                break;
+            }
+            deltaTime = clock.restart();
+            update();
+            sf::sleep(tick - clock.getElapsedTime());
+        }
+        replication.stop();
+        bool ok = !lockstepSession || finishLockstep();
+        cleanup();
+        return ok ? 0 : 1;
+    }
+
+    // El deltaTime de cada tick lo pone el log
+    while (!recorder.isReplayFinished()) {
+        deltaTime = sf::Time::Zero;
+        update();
+    }
+    finishInputSession();
+
+    bool matches = recorder.getStats().hashMatches;
+    cleanup();
+    return matches ? 0 : 1;
+}
+
 bool BaseApp::initialize() {
     NotificationService& notifier = NotificationService::getInstance();
     ResourceManager& resourceManager = ResourceManager::getInstance();
 
-    m_window = new Window(1280, 720, "ZPK");
-    if (!m_window) {
-        notifier.addMessage(ConsolErrorType::ERROR, "Error on window creation, pointer is null");
-        ERROR("BaseApp", "initialize", "Error on window creation, var is null");
-        return false;
+    // Sin ventana solo se simula, por ejemplo al repetir un log en un benchmark
+    if (!m_headless) {
+        m_window = new Window(1280, 720, "ZPK");
+        if (!m_window) {
+            notifier.addMessage(ConsolErrorType::ERROR, "Error on window creation, pointer is null");
+            ERROR("BaseApp", "initialize", "Error on window creation, var is null");
+            return false;
+        }
+    }
+
+    // Los recursos empaquetados con GalvanPacker tienen prioridad sobre los archivos sueltos
+    if (std::filesystem::exists("Assets.gpak")) {
+        VirtualFileSystem::getInstance().mount("Assets.gpak");
+    }
+
+    // Los recursos de la escena se leen en paralelo antes de crear los actores
+    AssetManifest manifest;
+    std::string manifestError;
+    if (manifest.loadFromFile("Level1.manifest", manifestError)) {
+        // El avance por recurso solo va a la consola sin ventana; con ventana basta el resumen
+        LoadProgress loaded = manifest.load([this](const LoadProgress& progress) {
+            if (!m_headless) {
+                return;
+            }
+            std::cout << "Loading " << static_cast<int>(progress.getFraction() * 100.0f) << "% ("
+                      << progress.lastName << ", ETA " << progress.etaSeconds << " s)" << std::endl;
+        });
+        notifier.addMessage(ConsolErrorType::NORMAL, "Manifest loaded: " + std::to_string(loaded.total) +
+                            " assets in " + std::to_string(loaded.elapsedSeconds) + " s");
+        if (loaded.failed > 0) {
+            notifier.addMessage(ConsolErrorType::WARNING, std::to_string(loaded.failed) + " manifest assets failed to load");
+        }
+    }
+    else {
+        notifier.addMessage(ConsolErrorType::WARNING, manifestError);
+    }
+
+    // Las acciones de juego se asignan a teclas y botones desde un archivo de texto
+    std::string bindingsError;
+    if (!InputMap::getInstance().loadBindings("Input.bindings", bindingsError)) {
+        notifier.addMessage(ConsolErrorType::WARNING, bindingsError);
     }
 
-    // Points for movement
-    points[0] = Vector2(25.0f, 560.0f);  // Esquina superior izquierda
-    points[1] = Vector2(25.0f, 20.0f);   // Esquina inferior izquierda
-    points[2] = Vector2(700.0f, 20.0f);  // Esquina inferior derecha
-    points[3] = Vector2(700.0f, 560.0f); // Esquina superior derecha
-    
+    // Ruta del circuito, compartida por todos los actores que la recorran
+    std::vector<sf::Vector2f> trackPoints = {
+        sf::Vector2f(25.0f, 560.0f),  // Esquina superior izquierda
+        sf::Vector2f(25.0f, 20.0f),   // Esquina inferior izquierda
+        sf::Vector2f(700.0f, 20.0f),  // Esquina inferior derecha
+        sf::Vector2f(700.0f, 560.0f)  // Esquina superior derecha
+    };
+    auto trackPath = std::make_shared<const PathSpline>(trackPoints, true);
+
 
     // Initialize Track Actor
     Track = EngineUtilities::MakeShared<Actor>("Track");
     if (!Track.isNull()) {
         Track->getComponent<ShapeFactory>()->createShape(ShapeType::RECTANGLE);
         Track->getComponent<Transform>()->setTransform(Vector2(0.0f, 0.0f), Vector2(0.0f, 0.0f), Vector2(40.0f, 60.0f));
+        Track->setRenderLayer(RenderLayer::BACKGROUND);
+        Track->setStatic(true);
 
         // Load texture for Track
         if (!resourceManager.loadTexture("Map002", "png")) {
@@ -60,7 +229,7 @@ bool BaseApp::initialize() {
 
         EngineUtilities::TSharedPointer<Texture> trackTexture = resourceManager.getTexture("Map002");
         if (trackTexture) {
-            Track->getComponent<ShapeFactory>()->getShape()->setTexture(&trackTexture->getTexture());
+            Track->getComponent<ShapeFactory>()->setTexture(trackTexture);
         }
 
         m_actors.push_back(Track);
@@ -72,6 +241,11 @@ bool BaseApp::initialize() {
         Circle->getComponent<ShapeFactory>()->createShape(ShapeType::CIRCLE);
         Circle->getComponent<Transform>()->setTransform(Vector2(650.0f, 560.0f), Vector2(0.0f, 0.0f), Vector2(1.0f, 1.0f));
 
+        // El jugador recorre el circuito desde el punto de la ruta más cercano a su posición inicial
+        EngineUtilities::TSharedPointer<Path> path = EngineUtilities::MakeShared<Path>(trackPath, 200.0f);
+        path->setDistance(trackPath->findClosestDistance(sf::Vector2f(650.0f, 560.0f)));
+        Circle->addComponent(path);
+
         // Load texture for Player
         if (!resourceManager.loadTexture("Playa2", "png")) {
             notifier.addMessage(ConsolErrorType::ERROR, "Can't load texture: Rob");
@@ -79,7 +253,7 @@ bool BaseApp::initialize() {
 
         EngineUtilities::TSharedPointer<Texture> playerTexture = resourceManager.getTexture("Playa2");
         if (playerTexture) {
-            Circle->getComponent<ShapeFactory>()->getShape()->setTexture(&playerTexture->getTexture());
+            Circle->getComponent<ShapeFactory>()->setTexture(playerTexture);
         }
 
         m_actors.push_back(Circle);
@@ -98,7 +272,7 @@ bool BaseApp::initialize() {
 
         EngineUtilities::TSharedPointer<Texture> triangleTexture = resourceManager.getTexture("jaua23");
         if (triangleTexture) {
-            Triangle->getComponent<ShapeFactory>()->getShape()->setTexture(&triangleTexture->getTexture());
+            Triangle->getComponent<ShapeFactory>()->setTexture(triangleTexture);
         }
 
         m_actors.push_back(Triangle);
@@ -117,72 +291,438 @@ bool BaseApp::initialize() {
 
         EngineUtilities::TSharedPointer<Texture> squareTexture = resourceManager.getTexture("SquareTexture");
         if (squareTexture) {
-            Square->getComponent<ShapeFactory>()->getShape()->setTexture(&squareTexture->getTexture());
+            Square->getComponent<ShapeFactory>()->setTexture(squareTexture);
         }
 
         m_actors.push_back(Square);  
     }
 
+    // Las texturas se recargan cuando un artista las modifica, sin reiniciar la aplicación
+    if (m_hotReload) {
+        AssetWatcher::getInstance().watch(".");
+    }
+
     return true;
 }
 
 void BaseApp::update() {
-    m_window->update();
+    sf::Clock updateClock;
 
+    if (m_useRenderThread) {
+        applyUiCommands();
+    }
+    else if (m_window != nullptr) {
+        m_window->update();
+    }
+    applyAssetReloads();
+
+    // Los eventos y el deltaTime del tick salen del InputRecorder, que puede estar repitiendo un log
+    InputRecorder& recorder = InputRecorder::getInstance();
+    float tickSeconds = deltaTime.asSeconds();
+    recorder.beginTick(tickSeconds);
+    deltaTime = sf::seconds(tickSeconds);
+    InputMap::getInstance().update(recorder.getFrameEvents());
+
+    // En lockstep la simulación avanza a ticks fijos y solo con la entrada de los dos jugadores;
+    // mientras tanto la ventana sigue respondiendo
+    LockstepService& lockstep = LockstepService::getInstance();
+    bool lockstepTick = false;
+    if (lockstep.isActive()) {
+        lockstepTick = lockstep.beginTick(InputMap::getInstance().getCurrent(), tickSeconds);
+        if (!lockstepTick) {
+            m_simTimeMs = updateClock.getElapsedTime().asMicroseconds() / 1000.0f;
+            recorder.endTick(m_simTimeMs);
+            return;
+        }
+        deltaTime = sf::seconds(lockstep.getTickSeconds());
+    }
+    applyPlayerInput(lockstepTick);
+
+    // Solo cuentan los ticks que simulan; las esperas de lockstep no avanzan el contador
+    uint64_t tick = ++m_simTick;
+
+    // Lo que todavía puede dibujar el render no se reescribe ni se desaloja
+    uint64_t oldestFrameInFlight = m_useRenderThread ? m_renderThread.getDrawingFrame() : tick;
+    ParticleSystem::beginFrame(tick, oldestFrameInFlight);
+
+    TimerService::getInstance().update(deltaTime.asSeconds());
+    NavigationService::getInstance().update();
+    PathSystem::getInstance().update(deltaTime.asSeconds());
+    SteeringSystem::getInstance().update(deltaTime.asSeconds());
+    PhysicsWorld::getInstance().update(deltaTime.asSeconds());
+    TweenSystem::getInstance().update(deltaTime.asSeconds());
+    SpriteAnimationSystem::getInstance().update(deltaTime.asSeconds());
+
+    // Lo que publicaron los sistemas se entrega antes de actualizar a los actores
+    EventBus& eventBus = EventBus::getInstance();
+    eventBus.swapBuffers();
+    eventBus.dispatch();
     for (auto& actor : m_actors) {
         if (!actor.isNull()) {
-            actor->update(m_window->deltaTime.asSeconds());
-            if (actor->getName() == "Player") {
-                updateMovement(m_window->deltaTime.asSeconds(), actor);
+            actor->update(deltaTime.asSeconds());
+        }
+    }
+
+    // El servidor envía el estado ya simulado; el cliente lo reemplaza por el interpolado
+    ReplicationService& replication = ReplicationService::getInstance();
+    replication.update(deltaTime.asSeconds(), m_actors);
+    replication.applyToActors(m_actors);
+    reportReplication(deltaTime.asSeconds());
+
+    // Los recursos sin uso se desalojan solo cuando el render ya no puede usarlos
+    ResourceManager::getInstance().update(tick, oldestFrameInFlight);
+
+    // Los dos lados comparan el hash del mismo tick; el primero distinto marca la desincronización
+    if (lockstepTick) {
+        lockstep.endTick(lockstep.isHashTick() ? WorldSnapshot::getInstance().computeHash(m_actors) : 0);
+        const LockstepStats& lockstepStats = lockstep.getStats();
+        if (lockstepStats.desynced && !m_desyncReported) {
+            m_desyncReported = true;
+            std::string message = "Lockstep desync at tick " + std::to_string(lockstepStats.desyncTick);
+            NotificationService::getInstance().addMessage(ConsolErrorType::ERROR, message);
+            if (m_headless) {
+                std::cout << message << std::endl;
             }
         }
     }
+
+    // Estado del frame ya simulado, para repeticiones y rollback
+    WorldSnapshot::getInstance().capture(tick, m_actors);
+
+    m_simTimeMs = updateClock.getElapsedTime().asMicroseconds() / 1000.0f;
+    recorder.endTick(m_simTimeMs);
 }
 
 void BaseApp::render() {
     NotificationService& notifier = NotificationService::getInstance();
 
     m_window->clear();
+
+    // La capa estática solo se redibuja cuando alguno de sus actores cambia
+    m_staticLayer.update(m_actors, m_window->m_renderTexture.getSize());
+
+    // Los actores se registran en la cola, se ordenan por clave y se dibujan en ese orden
+    m_renderQueue.clear();
+    m_renderQueue.setViewBounds(sf::FloatRect(sf::Vector2f(0.0f, 0.0f),
+                                              sf::Vector2f(m_window->getRenderSize())));
+    m_staticLayer.submit(m_renderQueue);
     for (auto& actor : m_actors) {
-        if (!actor.isNull()) {
-            actor->render(*m_window);
+        if (!actor.isNull() && !actor->isStatic()) {
+            actor->submit(m_renderQueue);
         }
     }
+    m_spriteBatches.clear();
+    SpriteAnimationSystem::getInstance().collectBatches(m_renderQueue.getViewBounds(), m_spriteBatches);
+    for (const RenderBatch& batch : m_spriteBatches) {
+        m_renderQueue.pushBatch(batch);
+    }
+    m_renderQueue.sort();
+    m_renderQueue.submit(*m_window);
 
     m_window->renderToTexture();  // Finalizes rendering to texture
     m_window->showInImGui();      // Displays texture in ImGui
 
     m_GUI.console(notifier.getNotifications());  // Shows the console messages
-    m_GUI.inspector();  // Shows the inspector for debugging
-    m_GUI.hierarchy(m_actors);  // Shows the hierarchy of actors
+    // El editor modifica actores directamente; en lockstep eso desincronizaría la sesión
+    if (!LockstepService::getInstance().isActive()) {
+        m_GUI.inspector();  // Shows the inspector for debugging
+        m_GUI.hierarchy(m_actors);  // Shows the hierarchy of actors
+    }
+    m_GUI.renderStats(m_renderQueue.getStats());  // Shows the render queue stats
+    m_GUI.resourceStats(ResourceManager::getInstance().getTextureStats());  // Shows the texture cache stats
 
     m_window->render();
     m_window->display();
 }
 
 void BaseApp::cleanup() {
-    m_window->destroy();
-    delete m_window;
+    AssetWatcher::getInstance().stop();
+    if (m_window != nullptr) {
+        m_window->destroy();
+        delete m_window;
+        m_window = nullptr;
+    }
 }
 
-void BaseApp::updateMovement(float deltaTime, EngineUtilities::TSharedPointer<Actor> circle) {
-    if (!circle || circle.isNull()) return;
+void BaseApp::publishSnapshot() {
+    NotificationService& notifier = NotificationService::getInstance();
+    RenderSnapshot& snapshot = m_renderThread.getWriteSnapshot();
 
-    auto transform = circle->getComponent<Transform>();
-    if (transform.isNull()) return;
+    // Un frame sin tick nuevo vuelve a publicar el último tick simulado
+    snapshot.frame = m_simTick;
+    snapshot.simTimeMs = m_simTimeMs;
 
-    Vector2 targetPos = points[m_currentPoint];
+    m_staticLayer.detectChanges(m_actors);
+    snapshot.staticVersion = m_staticLayer.getVersion();
 
-    transform->Seek(targetPos, 200.0f, deltaTime, 10.0f);
+    // Los buffers se reutilizan entre frames, así que los vectores conservan su capacidad
+    snapshot.items.clear();
+    snapshot.names.resize(m_actors.size());
+    for (auto& actor : m_actors) {
+        if (actor.isNull()) {
+            continue;
+        }
+        auto transform = actor->getComponent<Transform>();
+        auto shape = actor->getComponent<ShapeFactory>();
+
+        RenderItem item;
+        item.actorId = actor->getId();
+        item.layer = actor->getRenderLayer();
+        item.depth = actor->getRenderDepth();
+        item.isStatic = actor->isStatic();
+        if (transform) {
+            item.position = transform->getPosition();
+            item.rotation = transform->getRotation();
+            item.scale = transform->getScale();
+        }
+        if (shape && shape->getShape() && !actor->getComponent<SpriteAnimator>()) {
+            item.shapeType = shape->getShapeType();
+            item.texture = shape->getShape()->getTexture();
+            item.fillColor = shape->getShape()->getFillColor();
+        }
+
+        snapshot.names[snapshot.items.size()] = actor->getName();
+        snapshot.items.push_back(item);
+    }
+    snapshot.names.resize(snapshot.items.size());
+
+    // Los bloques de Tilemap se construyen aquí; el render solo retiene sus vértices inmutables
+    // Mismos límites que render(): los de la RenderTexture, no los de la ventana
+    sf::FloatRect viewBounds(sf::Vector2f(0.0f, 0.0f), sf::Vector2f(m_window->getRenderSize()));
+    snapshot.batches.clear();
+    for (auto& actor : m_actors) {
+        if (!actor.isNull()) {
+            actor->collectBatches(viewBounds, snapshot.batches);
+        }
+    }
+    SpriteAnimationSystem::getInstance().collectBatches(viewBounds, snapshot.batches);
+
+    snapshot.messages.clear();
+    snapshot.messages.insert(notifier.getNotifications().begin(), notifier.getNotifications().end());
+    snapshot.textureStats = ResourceManager::getInstance().getTextureStats();
+
+    m_renderThread.publishSnapshot();
+}
+
+void BaseApp::applyAssetReloads() {
+    NotificationService& notifier = NotificationService::getInstance();
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+
+    // Pocas por frame: una exportación masiva se reparte en varios frames
+    const size_t maxReloadsPerFrame = 8;
+    AssetWatcher::getInstance().takeReady(m_assetReloads, maxReloadsPerFrame);
+    bool reloaded = false;
+    for (const AssetReload& reload : m_assetReloads) {
+        Texture* texture = resourceManager.beginTextureReload(reload.name, reload.extension,
+                                                              reload.image->getSize());
+        if (texture == nullptr) {
+            continue;
+        }
+        if (m_useRenderThread) {
+            m_renderThread.queueTextureUpload(texture, reload.image);
+        }
+        else {
+            texture->reloadFromImage(*reload.image);
+        }
+        notifier.addMessage(ConsolErrorType::NORMAL, "Texture reloaded: " + reload.name);
+        reloaded = true;
+    }
+
+    // La capa estática guarda los pixeles viejos; la nueva versión se publica con el snapshot
+    // del frame, así el hilo de render la reconstruye después de aplicar las subidas
+    if (reloaded) {
+        m_staticLayer.invalidate();
+    }
+}
+
+void BaseApp::applyUiCommands() {
+    NotificationService& notifier = NotificationService::getInstance();
+
+    m_renderThread.takeCommands(m_uiCommands);
+
+    // Las ediciones no viajan en los comandos de lockstep; aplicarlas desincronizaría la sesión
+    if (!m_uiCommands.empty() && LockstepService::getInstance().isActive()) {
+        notifier.addMessage(ConsolErrorType::WARNING, "Editor changes are disabled during a lockstep session");
+        return;
+    }
+    for (const UiCommand& command : m_uiCommands) {
+        if (command.type == UiCommandType::CREATE_ACTOR) {
+            auto actor = EngineUtilities::MakeShared<Actor>(command.name);
+            if (!actor.isNull()) {
+                actor->getComponent<ShapeFactory>()->createShape(command.shapeType);
+                auto transform = actor->getComponent<Transform>();
+                transform->setPosition(command.position);
+                transform->setRotation(command.rotation);
+                transform->setScale(command.scale);
+                m_actors.push_back(actor);
+
+                notifier.addMessage(ConsolErrorType::NORMAL, "Actor '" + actor->getName() + "' created successfully.");
+            }
+            continue;
+        }
+
+        for (auto& actor : m_actors) {
+            if (actor.isNull() || actor->getId() != command.actorId) {
+                continue;
+            }
+            if (command.type == UiCommandType::SET_TRANSFORM) {
+                auto transform = actor->getComponent<Transform>();
+                transform->setPosition(command.position);
+                transform->setRotation(command.rotation);
+                transform->setScale(command.scale);
+            }
+            else if (command.type == UiCommandType::RENAME_ACTOR) {
+                actor->setName(command.name);
+            }
+            break;
+        }
+    }
+}
 
-    Vector2 currentPos = transform->getPosition();
+void BaseApp::finishInputSession() {
+    InputRecorder& recorder = InputRecorder::getInstance();
+    InputMode mode = recorder.getMode();
+    if (mode == INPUT_LIVE) {
+        return;
+    }
+    recorder.stop(WorldSnapshot::getInstance().computeHash(m_actors));
+
+    const InputReplayStats& stats = recorder.getStats();
+    std::ostringstream report;
+    report << (mode == INPUT_RECORDING ? "Input recorded: " : "Input replayed: ") << stats.ticks << " ticks, "
+           << stats.events << " events, " << stats.logBytes << " bytes; sim avg " << stats.averageSimMs
+           << " ms, p95 " << stats.p95SimMs << " ms, max " << stats.maxSimMs << " ms; state hash "
+           << std::hex << stats.stateHash;
+    if (mode == INPUT_REPLAYING) {
+        report << (stats.hashMatches ? " matches the recording" : " differs from the recording ");
+        if (!stats.hashMatches) {
+            report << stats.recordedHash;
+        }
+    }
+    bool ok = mode == INPUT_RECORDING || stats.hashMatches;
+    NotificationService::getInstance().addMessage(ok ? ConsolErrorType::NORMAL : ConsolErrorType::WARNING, report.str());
+    std::cout << report.str() << std::endl;
+}
 
-    float distanceToTarget = std::sqrt(std::pow(targetPos.x - currentPos.x, 2) + std::pow(targetPos.y - currentPos.y, 2));
+void BaseApp::startReplication() {
+    ReplicationService& replication = ReplicationService::getInstance();
+    std::string error;
+    bool started = true;
+    if (m_servePort != 0) {
+        started = replication.startServer(m_servePort, error);
+    }
+    else if (!m_connectAddress.empty()) {
+        if (m_connectPort == 0) {
+            error = "--connect needs <host:port>";
+            started = false;
+        }
+        else {
+            started = replication.connect(m_connectAddress, m_connectPort, error);
+        }
+    }
+    if (!started) {
+        NotificationService::getInstance().addMessage(ConsolErrorType::ERROR, error);
+        std::cout << error << std::endl;
+    }
+}
 
-    if (distanceToTarget < 10.0f) {
-        m_currentPoint = (m_currentPoint + 1);
-        if (m_currentPoint > 8) {
-            m_currentPoint = 0;
+void BaseApp::reportReplication(float deltaTime) {
+    ReplicationService& replication = ReplicationService::getInstance();
+    if (replication.getMode() == REPLICATION_OFF) {
+        return;
+    }
+    m_replicationReportTimer += deltaTime;
+    if (m_replicationReportTimer < 1.0f) {
+        return;
+    }
+    m_replicationReportTimer = 0.0f;
+
+    for (const ReplicationPeerStats& peer : replication.getPeerStats()) {
+        std::ostringstream report;
+        report << (replication.getMode() == REPLICATION_SERVER ? "Replication to " : "Replication from ") << peer.address
+               << ": " << peer.bytesPerSecond / 1024.0f << " KB/s, " << peer.packetsPerSecond << " packets/s, "
+               << peer.averagePacketBytes << " bytes/packet, " << peer.entitiesPerPacket << " entities/packet, "
+               << peer.relevantEntities << " replicated, " << peer.pendingEntities << " pending, rtt "
+               << peer.roundTripMs << " ms";
+        NotificationService::getInstance().addMessage(ConsolErrorType::NORMAL, report.str());
+        if (m_headless) {
+            std::cout << report.str() << std::endl;
         }
     }
 }
+
+void BaseApp::applyPlayerInput(bool lockstepTick) {
+    InputMap& inputMap = InputMap::getInstance();
+    uint32_t moveX = inputMap.getAxisId("MoveX");
+    uint32_t moveY = inputMap.getAxisId("MoveY");
+    uint32_t boost = inputMap.getActionId("Boost");
+    const float speed = 200.0f;
+
+    EngineUtilities::TSharedPointer<Actor> controlled[LockstepService::PLAYER_COUNT] = { Triangle, Square };
+    LockstepService& lockstep = LockstepService::getInstance();
+    uint32_t players = lockstepTick ? LockstepService::PLAYER_COUNT : 1;
+    for (uint32_t player = 0; player < players; ++player) {
+        const InputSnapshot& input = lockstepTick ? lockstep.getPlayerInput(player) : inputMap.getCurrent();
+        sf::Vector2f move(input.getAxis(moveX), input.getAxis(moveY));
+        if (controlled[player].isNull() || (move.x == 0.0f && move.y == 0.0f)) {
+            continue;
+        }
+        auto transform = controlled[player]->getComponent<Transform>();
+        float scale = input.isHeld(boost) ? 2.0f : 1.0f;
+        transform->setPosition(transform->getPosition() + move * (speed * scale * deltaTime.asSeconds()));
+    }
+}
+
+void BaseApp::startLockstep() {
+    LockstepService& lockstep = LockstepService::getInstance();
+    LockstepSettings settings = lockstep.getSettings();
+    if (m_inputDelay != 0) {
+        settings.inputDelay = m_inputDelay;
+    }
+    lockstep.setSettings(settings);
+
+    std::string error;
+    bool started = true;
+    if (m_lockstepHostPort != 0) {
+        started = lockstep.host(m_lockstepHostPort, error);
+    }
+    else if (!m_lockstepJoinAddress.empty()) {
+        if (m_lockstepJoinPort == 0) {
+            error = "--join needs <host:port>";
+            started = false;
+        }
+        else {
+            started = lockstep.join(m_lockstepJoinAddress, m_lockstepJoinPort, 5.0f, error);
+        }
+    }
+    if (!started) {
+        NotificationService::getInstance().addMessage(ConsolErrorType::ERROR, error);
+        std::cout << error << std::endl;
+    }
+}
+
+bool BaseApp::finishLockstep() {
+    LockstepService& lockstep = LockstepService::getInstance();
+    if (lockstep.getState() == LOCKSTEP_OFF) {
+        return false;
+    }
+    lockstep.stop();
+
+    const LockstepStats& stats = lockstep.getStats();
+    std::ostringstream report;
+    report << "Lockstep player " << lockstep.getLocalPlayer() << ": " << stats.tick << " ticks, input delay "
+           << lockstep.getSettings().inputDelay << " ticks, stalled " << stats.stalledFrames << " frames ("
+           << stats.stalledSeconds * 1000.0f << " ms); sent " << stats.bytesSent << " bytes ("
+           << stats.bytesPerSecond << " B/s), received " << stats.bytesReceived << " bytes; "
+           << stats.hashesCompared << " hashes compared, ";
+    if (stats.desynced) {
+        report << "desync at tick " << stats.desyncTick;
+    }
+    else {
+        report << "all matched";
+    }
+    bool ok = stats.hashesCompared > 0 && !stats.desynced;
+    NotificationService::getInstance().addMessage(ok ? ConsolErrorType::NORMAL : ConsolErrorType::WARNING, report.str());
+    std::cout << report.str() << std::endl;
+    return ok;
+}
@@ -1,8 +1,13 @@
 ﻿#include "Actor.h"
 
+// Contador para asignar identificadores únicos a los actores
+static std::atomic<int> s_nextActorId{ 1 };
+
 Actor::Actor(std::string actorName) {
     // Setup Actor Name 
     m_name = actorName;
+    id = s_nextActorId++;
+    isActive = true;
 
     // Setup Shape 
     EngineUtilities::TSharedPointer<ShapeFactory> shape = EngineUtilities::MakeShared<ShapeFactory>();
@@ -12,7 +17,7 @@ Actor::Actor(std::string actorName) {
     EngineUtilities::TSharedPointer<Transform> transform = EngineUtilities::MakeShared<Transform>();
     addComponent(transform);
 
-    // Setup Sprite Actor
+    // Setup Sprite Actor: se agrega un SpriteAnimator con su SpriteAtlas, que reemplaza a la figura al dibujar
 }
 
 void
@@ -20,12 +25,57 @@ Actor::update(float deltaTime) {
     auto transform = getComponent<Transform>();
     auto shape = getComponent<ShapeFactory>();
 
+    // Los seguidores de ruta, los agentes de steering y los cuerpos rígidos ya avanzaron
+    // en sus sistemas; solo se copia su posición
+    auto path = getComponent<Path>();
+    if (path && transform) {
+        transform->setPosition(path->getPosition());
+    }
+    auto steering = getComponent<Steering>();
+    if (steering && transform) {
+        transform->setPosition(steering->getPosition());
+    }
+    auto rigidBody = getComponent<RigidBody2D>();
+    if (rigidBody && transform) {
+        transform->setPosition(rigidBody->getCollider()->getOrigin());
+        transform->setRotation(sf::Vector2f(rigidBody->getCollider()->getAngle(), 0.0f));
+    }
+
+    // El sprite se dibuja en el lote de su atlas; solo necesita el Transform y el orden de dibujo
+    auto sprite = getComponent<SpriteAnimator>();
+    if (sprite) {
+        if (transform) {
+            sprite->setTransform(transform->getPosition(), transform->getRotation().x, transform->getScale());
+        }
+        sprite->setRenderOrder(m_renderLayer, m_renderDepth);
+    }
+
+    // Las partículas se emiten desde la posición del actor pero viven en coordenadas de mundo
+    auto particles = getComponent<ParticleSystem>();
+    if (particles) {
+        if (transform) {
+            particles->setOrigin(transform->getPosition());
+        }
+        particles->update(deltaTime);
+    }
+
     if (transform && shape) {
-        Vector2 position(transform->getPosition().x, transform->getPosition().y);
-        shape->setPosition(position);
+        // Los actores estáticos solo sincronizan su figura cuando su Transform cambia
+        if (m_isStatic && m_transformSynced &&
+            transform->getPosition() == m_syncedPosition &&
+            transform->getRotation() == m_syncedRotation &&
+            transform->getScale() == m_syncedScale) {
+            return;
+        }
+        m_syncedPosition = transform->getPosition();
+        m_syncedRotation = transform->getRotation();
+        m_syncedScale = transform->getScale();
+        m_transformSynced = true;
+        m_renderDirty = true;
+
+        shape->setPosition(transform->getPosition());
         shape->setRotation(transform->getRotation().x);
-        Vector2 scale(transform->getScale().x, transform->getScale().y);
-        shape->setScale(scale);
+        shape->setScale(transform->getScale());
     }
 }
 
@@ -38,6 +88,44 @@ Actor::render(Window& window) {
     }
 }
 
+void
+Actor::submit(RenderQueue& queue) {
+    auto shape = getComponent<ShapeFactory>();
+    // Los sprites los agrega el SpriteAnimationSystem en lotes por atlas
+    if (shape && shape->getShape() && !getComponent<SpriteAnimator>()) {
+        queue.pushShape(*shape->getShape(), m_renderLayer, m_renderDepth);
+    }
+
+    // Los lotes se guardan en el actor para que sus vértices vivan hasta que la cola dibuje
+    m_batches.clear();
+    collectBatches(queue.getViewBounds(), m_batches);
+    for (const RenderBatch& batch : m_batches) {
+        queue.pushBatch(batch);
+    }
+}
+
+void
+Actor::collectBatches(const sf::FloatRect& viewBounds, std::vector<RenderBatch>& out) {
+    auto particles = getComponent<ParticleSystem>();
+    if (particles) {
+        particles->collectBatches(m_renderLayer, m_renderDepth, out);
+    }
+
+    auto tilemap = getComponent<Tilemap>();
+    if (!tilemap) {
+        return;
+    }
+
+    sf::Transform transform;
+    auto actorTransform = getComponent<Transform>();
+    if (actorTransform) {
+        transform.translate(actorTransform->getPosition());
+        transform.rotate(actorTransform->getRotation().x);
+        transform.scale(actorTransform->getScale());
+    }
+    tilemap->collectVisible(viewBounds, transform, m_renderLayer, m_renderDepth, out);
+}
+
 void
 Actor::destroy() {
 }
@@ -0,0 +1,111 @@
+﻿#include "ECS/Collider.h"
+#include "ECS/PhysicsWorld.h"
+
+ColliderShape
+ColliderShape::circle(float radius, const sf::Vector2f& center) {
+    ColliderShape shape;
+    shape.type = COLLIDER_CIRCLE;
+    shape.radius = radius;
+    shape.center = center;
+    return shape;
+}
+
+ColliderShape
+ColliderShape::box(const sf::Vector2f& size, const sf::Vector2f& offset) {
+    ColliderShape shape;
+    shape.type = COLLIDER_BOX;
+    shape.vertices = { offset,
+                       offset + sf::Vector2f(size.x, 0.0f),
+                       offset + size,
+                       offset + sf::Vector2f(0.0f, size.y) };
+    return shape;
+}
+
+ColliderShape
+ColliderShape::polygon(const std::vector<sf::Vector2f>& points) {
+    ColliderShape shape;
+    shape.type = COLLIDER_POLYGON;
+
+    // Envolvente convexa (monotone chain); así el orden de entrada no importa
+    std::vector<sf::Vector2f> sorted = points;
+    std::sort(sorted.begin(), sorted.end(), [](const sf::Vector2f& a, const sf::Vector2f& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    auto cross = [](const sf::Vector2f& o, const sf::Vector2f& a, const sf::Vector2f& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    };
+    std::vector<sf::Vector2f> hull(sorted.size() * 2);
+    size_t count = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        while (count >= 2 && cross(hull[count - 2], hull[count - 1], sorted[i]) <= 0.0f) {
+            --count;
+        }
+        hull[count++] = sorted[i];
+    }
+    for (size_t i = sorted.size() - 1, lower = count + 1; i > 0; --i) {
+        while (count >= lower && cross(hull[count - 2], hull[count - 1], sorted[i - 1]) <= 0.0f) {
+            --count;
+        }
+        hull[count++] = sorted[i - 1];
+    }
+    hull.resize(count > 1 ? count - 1 : count);
+
+    // Si hay demasiados vértices se conservan algunos repartidos de manera uniforme
+    if (hull.size() > MAX_VERTICES) {
+        std::vector<sf::Vector2f> reduced(MAX_VERTICES);
+        for (uint32_t i = 0; i < MAX_VERTICES; ++i) {
+            reduced[i] = hull[i * hull.size() / MAX_VERTICES];
+        }
+        hull.swap(reduced);
+    }
+    shape.vertices = hull;
+    return shape;
+}
+
+ColliderShape
+ColliderShape::fromShape(ShapeType shapeType, const sf::Shape& shape, const sf::Vector2f& scale) {
+    sf::FloatRect bounds = shape.getLocalBounds();
+    if (shapeType == CIRCLE) {
+        float radius = bounds.width * 0.5f * std::max(scale.x, scale.y);
+        sf::Vector2f center((bounds.left + bounds.width * 0.5f) * scale.x, (bounds.top + bounds.height * 0.5f) * scale.y);
+        return circle(radius, center);
+    }
+    if (shapeType == RECTANGLE) {
+        return box(sf::Vector2f(bounds.width * scale.x, bounds.height * scale.y),
+                   sf::Vector2f(bounds.left * scale.x, bounds.top * scale.y));
+    }
+
+    std::vector<sf::Vector2f> points(shape.getPointCount());
+    for (size_t i = 0; i < points.size(); ++i) {
+        sf::Vector2f point = shape.getPoint(i);
+        points[i] = sf::Vector2f(point.x * scale.x, point.y * scale.y);
+    }
+    return polygon(points);
+}
+
+Collider::Collider(const ColliderShape& shape,
+                   const sf::Vector2f& origin,
+                   float angle,
+                   const PhysicsMaterial& material)
+    : Component(ComponentType::COLLIDER) {
+    m_slot = PhysicsWorld::getInstance().add(this, shape, origin, angle, material);
+}
+
+Collider::~Collider() {
+    PhysicsWorld::getInstance().remove(m_slot);
+}
+
+void
+Collider::setTransform(const sf::Vector2f& origin, float angle) {
+    PhysicsWorld::getInstance().setTransform(m_slot, origin, angle);
+}
+
+sf::Vector2f
+Collider::getOrigin() const {
+    return PhysicsWorld::getInstance().getOrigin(m_slot);
+}
+
+float
+Collider::getAngle() const {
+    return PhysicsWorld::getInstance().getAngle(m_slot);
+}
@@ -0,0 +1,268 @@
+﻿#include "ECS/ParticleSystem.h"
+#include "Services/JobSystem.h"
+#include "Services/ResourceManager.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GALVAN_PARTICLES_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const size_t PARTICLE_BATCH = 16384; ///< Partículas por lote al repartir en el JobSystem.
+
+    /**
+     * @brief Evalúa una curva definida por llaves ordenadas, interpolando linealmente.
+     */
+    template<typename T, typename Lerp>
+    T
+        evaluateKeys(const std::vector<std::pair<float, T>>& keys, float t, const T& fallback, Lerp lerp) {
+        if (keys.empty()) {
+            return fallback;
+        }
+        if (t <= keys.front().first) {
+            return keys.front().second;
+        }
+        for (size_t i = 1; i < keys.size(); ++i) {
+            if (t <= keys[i].first) {
+                float span = keys[i].first - keys[i - 1].first;
+                float f = span > 0.0f ? (t - keys[i - 1].first) / span : 1.0f;
+                return lerp(keys[i - 1].second, keys[i].second, f);
+            }
+        }
+        return keys.back().second;
+    }
+}
+
+void
+ParticleSystem::setSettings(const ParticleEmitterSettings& settings) {
+    m_settings = settings;
+    m_settings.lifetimeMin = std::max(m_settings.lifetimeMin, 0.001f);
+    m_settings.lifetimeMax = std::max(m_settings.lifetimeMax, m_settings.lifetimeMin);
+
+    // Las curvas se hornean en tablas para que el bucle de vértices solo indexe
+    for (uint32_t i = 0; i < CURVE_SAMPLES; ++i) {
+        float t = static_cast<float>(i) / (CURVE_SAMPLES - 1);
+        m_sizeCurve[i] = evaluateKeys(m_settings.sizeKeys, t, 1.0f,
+            [](float a, float b, float f) {
+                return a + (b - a) * f;
+            });
+        m_colorCurve[i] = evaluateKeys(m_settings.colorKeys, t, sf::Color::White,
+            [](const sf::Color& a, const sf::Color& b, float f) {
+                auto mix = [f](sf::Uint8 x, sf::Uint8 y) {
+                    return static_cast<sf::Uint8>(x + (static_cast<int>(y) - x) * f);
+                };
+                return sf::Color(mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b), mix(a.a, b.a));
+            });
+    }
+
+    size_t capacity = m_settings.maxParticles;
+    m_posX.resize(capacity);
+    m_posY.resize(capacity);
+    m_velX.resize(capacity);
+    m_velY.resize(capacity);
+    m_age.resize(capacity);
+    m_invLifetime.resize(capacity);
+    m_alive = std::min<uint32_t>(m_alive, m_settings.maxParticles);
+}
+
+bool
+ParticleSystem::setTexture(const std::string& fileName, const std::string& extension) {
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    NotificationService& notifier = NotificationService::getInstance();
+
+    if (!resourceManager.loadTexture(fileName, extension)) {
+        notifier.addMessage(ConsolErrorType::ERROR, "Can't load particle texture: " + fileName);
+        return false;
+    }
+    m_texture = resourceManager.getTexture(fileName);
+    if (m_texture.isNull()) {
+        m_textureHandle = nullptr;
+        return false;
+    }
+    m_textureHandle = &m_texture->getTexture();
+    m_textureSize = sf::Vector2f(m_textureHandle->getSize());
+    return true;
+}
+
+void
+ParticleSystem::burst(uint32_t count) {
+    spawn(std::min(count, m_settings.maxParticles - m_alive));
+}
+
+void
+ParticleSystem::update(float deltaTime) {
+    sf::Clock clock;
+    JobSystem& jobs = JobSystem::getInstance();
+
+    if (m_emitting) {
+        m_emissionAccumulator += m_settings.emissionRate * deltaTime;
+        uint32_t count = static_cast<uint32_t>(m_emissionAccumulator);
+        m_emissionAccumulator -= static_cast<float>(count);
+        spawn(std::min(count, m_settings.maxParticles - m_alive));
+    }
+
+    if (m_multithreaded) {
+        jobs.parallelFor(m_alive, PARTICLE_BATCH, [this, deltaTime](size_t begin, size_t end) {
+            integrate(begin, end, deltaTime);
+        });
+    }
+    else {
+        integrate(0, m_alive, deltaTime);
+    }
+    removeDead();
+
+    m_mesh = acquireMesh();
+    m_mesh->resize(static_cast<size_t>(m_alive) * 6);
+    if (m_alive > 0) {
+        sf::Vertex* vertices = &(*m_mesh)[0];
+        if (m_multithreaded) {
+            jobs.parallelFor(m_alive, PARTICLE_BATCH, [this, vertices](size_t begin, size_t end) {
+                buildVertices(begin, end, vertices);
+            });
+        }
+        else {
+            buildVertices(0, m_alive, vertices);
+        }
+    }
+
+    m_updateTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+void
+ParticleSystem::collectBatches(uint8_t renderLayer, float depth, std::vector<RenderBatch>& out) const {
+    if (!m_mesh || m_mesh->getVertexCount() == 0) {
+        return;
+    }
+    RenderBatch batch;
+    batch.vertices = m_mesh;
+    batch.texture = m_textureHandle;
+    batch.layer = renderLayer;
+    batch.depth = depth;
+    out.push_back(std::move(batch));
+}
+
+void
+ParticleSystem::spawn(uint32_t count) {
+    const float degToRad = PI / 180.0f;
+    float baseAngle = (m_settings.direction - m_settings.spread * 0.5f) * degToRad;
+    float spread = m_settings.spread * degToRad;
+    float speedRange = m_settings.speedMax - m_settings.speedMin;
+    float lifetimeRange = m_settings.lifetimeMax - m_settings.lifetimeMin;
+
+    for (uint32_t n = 0; n < count; ++n) {
+        uint32_t i = m_alive++;
+        float angle = baseAngle + spread * random01();
+        float speed = m_settings.speedMin + speedRange * random01();
+        float radius = m_settings.spawnRadius * std::sqrt(random01());
+        float offsetAngle = 2.0f * PI * random01();
+
+        m_posX[i] = m_origin.x + radius * std::cos(offsetAngle);
+        m_posY[i] = m_origin.y + radius * std::sin(offsetAngle);
+        m_velX[i] = speed * std::cos(angle);
+        m_velY[i] = speed * std::sin(angle);
+        m_age[i] = 0.0f;
+        m_invLifetime[i] = 1.0f / (m_settings.lifetimeMin + lifetimeRange * random01());
+    }
+}
+
+void
+ParticleSystem::integrate(size_t begin, size_t end, float deltaTime) {
+    float* posX = m_posX.data();
+    float* posY = m_posY.data();
+    float* velX = m_velX.data();
+    float* velY = m_velY.data();
+    float* age = m_age.data();
+    float damping = std::max(0.0f, 1.0f - m_settings.drag * deltaTime);
+    float gravityX = m_settings.gravity.x * deltaTime;
+    float gravityY = m_settings.gravity.y * deltaTime;
+
+    size_t i = begin;
+#ifdef GALVAN_PARTICLES_SSE
+    const __m128 dt4 = _mm_set1_ps(deltaTime);
+    const __m128 damping4 = _mm_set1_ps(damping);
+    const __m128 gravityX4 = _mm_set1_ps(gravityX);
+    const __m128 gravityY4 = _mm_set1_ps(gravityY);
+    for (; i + 4 <= end; i += 4) {
+        __m128 vx = _mm_loadu_ps(velX + i);
+        __m128 vy = _mm_loadu_ps(velY + i);
+        vx = _mm_add_ps(_mm_mul_ps(vx, damping4), gravityX4);
+        vy = _mm_add_ps(_mm_mul_ps(vy, damping4), gravityY4);
+        _mm_storeu_ps(velX + i, vx);
+        _mm_storeu_ps(velY + i, vy);
+        _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, dt4)));
+        _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, dt4)));
+        _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), dt4));
+    }
+#endif
+    for (; i < end; ++i) {
+        velX[i] = velX[i] * damping + gravityX;
+        velY[i] = velY[i] * damping + gravityY;
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        age[i] += deltaTime;
+    }
+}
+
+void
+ParticleSystem::removeDead() {
+    // Eliminación por intercambio: la última partícula viva ocupa el hueco, sin desplazar
+    uint32_t i = 0;
+    while (i < m_alive) {
+        if (m_age[i] * m_invLifetime[i] < 1.0f) {
+            ++i;
+            continue;
+        }
+        uint32_t last = --m_alive;
+        m_posX[i] = m_posX[last];
+        m_posY[i] = m_posY[last];
+        m_velX[i] = m_velX[last];
+        m_velY[i] = m_velY[last];
+        m_age[i] = m_age[last];
+        m_invLifetime[i] = m_invLifetime[last];
+    }
+}
+
+void
+ParticleSystem::buildVertices(size_t begin, size_t end, sf::Vertex* vertices) const {
+    const float curveScale = static_cast<float>(CURVE_SAMPLES - 1);
+    const sf::Vector2f uv0(0.0f, 0.0f);
+    const sf::Vector2f uv1(m_textureSize.x, 0.0f);
+    const sf::Vector2f uv2(0.0f, m_textureSize.y);
+    const sf::Vector2f uv3(m_textureSize.x, m_textureSize.y);
+
+    for (size_t i = begin; i < end; ++i) {
+        float life = std::min(m_age[i] * m_invLifetime[i], 1.0f);
+        uint32_t sample = static_cast<uint32_t>(life * curveScale);
+        float half = m_sizeCurve[sample] * 0.5f;
+        const sf::Color& color = m_colorCurve[sample];
+        float left = m_posX[i] - half;
+        float top = m_posY[i] - half;
+        float right = m_posX[i] + half;
+        float bottom = m_posY[i] + half;
+
+        sf::Vertex* quad = vertices + i * 6;
+        quad[0] = sf::Vertex(sf::Vector2f(left, top), color, uv0);
+        quad[1] = sf::Vertex(sf::Vector2f(right, top), color, uv1);
+        quad[2] = sf::Vertex(sf::Vector2f(left, bottom), color, uv2);
+        quad[3] = quad[2];
+        quad[4] = quad[1];
+        quad[5] = sf::Vertex(sf::Vector2f(right, bottom), color, uv3);
+    }
+}
+
+std::shared_ptr<sf::VertexArray>
+ParticleSystem::acquireMesh() {
+    // Un arreglo generado antes del frame que dibuja el render ya no está en ningún snapshot
+    // que este pueda leer; los más nuevos se dejan intactos aunque el emisor ya no los use
+    for (MeshSlot& slot : m_meshes) {
+        if (slot.frame < m_oldestFrameInFlight) {
+            slot.frame = m_frame;
+            return slot.vertices;
+        }
+    }
+    MeshSlot slot;
+    slot.vertices = std::make_shared<sf::VertexArray>(sf::Triangles);
+    slot.frame = m_frame;
+    m_meshes.push_back(slot);
+    return slot.vertices;
+}
@@ -0,0 +1,158 @@
+﻿#include "ECS/Path.h"
+#include "ECS/PathSystem.h"
+
+namespace {
+    sf::Vector2f
+        catmullRom(const sf::Vector2f& p0,
+                   const sf::Vector2f& p1,
+                   const sf::Vector2f& p2,
+                   const sf::Vector2f& p3,
+                   float t) {
+        float t2 = t * t;
+        float t3 = t2 * t;
+        return 0.5f * ((2.0f * p1) +
+                       (p2 - p0) * t +
+                       (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                       (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+    }
+
+    float
+        length(const sf::Vector2f& v) {
+        return std::sqrt(v.x * v.x + v.y * v.y);
+    }
+}
+
+PathSpline::PathSpline(const std::vector<sf::Vector2f>& waypoints, bool closed, uint32_t samplesPerSegment)
+    : m_waypoints(waypoints),
+      m_samplesPerSegment(std::max<uint32_t>(samplesPerSegment, 1)),
+      m_closed(closed && waypoints.size() > 2) {
+    size_t count = m_waypoints.size();
+    if (count < 2) {
+        m_samples = m_waypoints.empty() ? std::vector<sf::Vector2f>{ sf::Vector2f() } : m_waypoints;
+        m_distances.assign(1, 0.0f);
+        return;
+    }
+
+    auto waypoint = [&](long index) {
+        if (m_closed) {
+            long wrapped = index % static_cast<long>(count);
+            return m_waypoints[static_cast<size_t>(wrapped < 0 ? wrapped + static_cast<long>(count) : wrapped)];
+        }
+        return m_waypoints[static_cast<size_t>(std::clamp(index, 0L, static_cast<long>(count) - 1))];
+    };
+
+    size_t segments = m_closed ? count : count - 1;
+    m_samples.reserve(segments * m_samplesPerSegment + 1);
+    for (size_t segment = 0; segment < segments; ++segment) {
+        long i = static_cast<long>(segment);
+        for (uint32_t k = 0; k < m_samplesPerSegment; ++k) {
+            if (m_samplesPerSegment == 1) {
+                m_samples.push_back(waypoint(i));
+                continue;
+            }
+            float t = static_cast<float>(k) / static_cast<float>(m_samplesPerSegment);
+            m_samples.push_back(catmullRom(waypoint(i - 1), waypoint(i), waypoint(i + 1), waypoint(i + 2), t));
+        }
+    }
+    m_samples.push_back(m_closed ? m_waypoints.front() : m_waypoints.back());
+
+    m_distances.resize(m_samples.size());
+    m_distances[0] = 0.0f;
+    for (size_t i = 1; i < m_samples.size(); ++i) {
+        m_distances[i] = m_distances[i - 1] + length(m_samples[i] - m_samples[i - 1]);
+    }
+    m_length = m_distances.back();
+}
+
+sf::Vector2f
+PathSpline::sample(float distance, uint32_t& segmentHint) const {
+    size_t last = m_samples.size() - 1;
+    if (last == 0) {
+        return m_samples[0];
+    }
+    distance = std::clamp(distance, 0.0f, m_length);
+
+    // Los seguidores avanzan poco por frame: casi siempre basta con caminar una o dos muestras
+    size_t index = segmentHint < last && m_distances[segmentHint] <= distance ? segmentHint : last;
+    for (int steps = 0; index < last && m_distances[index + 1] < distance; ++steps) {
+        if (steps == 4) {
+            index = last;
+            break;
+        }
+        ++index;
+    }
+    if (index >= last) {
+        auto it = std::upper_bound(m_distances.begin(), m_distances.end(), distance);
+        index = std::min(static_cast<size_t>(std::max<std::ptrdiff_t>(it - m_distances.begin() - 1, 0)), last - 1);
+    }
+    segmentHint = static_cast<uint32_t>(index);
+
+    float span = m_distances[index + 1] - m_distances[index];
+    float t = span > 0.0f ? (distance - m_distances[index]) / span : 0.0f;
+    return m_samples[index] + (m_samples[index + 1] - m_samples[index]) * t;
+}
+
+float
+PathSpline::findClosestDistance(const sf::Vector2f& position) const {
+    float bestDistance = 0.0f;
+    float bestSquared = std::numeric_limits<float>::max();
+    for (size_t i = 0; i + 1 < m_samples.size(); ++i) {
+        sf::Vector2f segment = m_samples[i + 1] - m_samples[i];
+        float segmentSquared = segment.x * segment.x + segment.y * segment.y;
+        sf::Vector2f offset = position - m_samples[i];
+        float t = segmentSquared > 0.0f ? (offset.x * segment.x + offset.y * segment.y) / segmentSquared : 0.0f;
+        t = std::clamp(t, 0.0f, 1.0f);
+        sf::Vector2f delta = offset - segment * t;
+        float squared = delta.x * delta.x + delta.y * delta.y;
+        if (squared < bestSquared) {
+            bestSquared = squared;
+            bestDistance = m_distances[i] + (m_distances[i + 1] - m_distances[i]) * t;
+        }
+    }
+    return bestDistance;
+}
+
+Path::Path(std::shared_ptr<const PathSpline> spline, float speed, bool loop)
+    : Component(ComponentType::PATH),
+      m_spline(std::move(spline)) {
+    m_slot = PathSystem::getInstance().add(this, m_spline.get(), speed, loop || m_spline->isClosed());
+}
+
+Path::~Path() {
+    PathSystem::getInstance().remove(m_slot);
+}
+
+void
+Path::setSpeed(float speed) {
+    PathSystem::getInstance().setSpeed(m_slot, speed);
+}
+
+float
+Path::getSpeed() const {
+    return PathSystem::getInstance().getSpeed(m_slot);
+}
+
+void
+Path::setDistance(float distance) {
+    PathSystem::getInstance().setDistance(m_slot, distance);
+}
+
+float
+Path::getDistance() const {
+    return PathSystem::getInstance().getDistance(m_slot);
+}
+
+sf::Vector2f
+Path::getPosition() const {
+    return PathSystem::getInstance().getPosition(m_slot);
+}
+
+uint32_t
+Path::getCurrentWaypoint() const {
+    return PathSystem::getInstance().getWaypoint(m_slot);
+}
+
+bool
+Path::isFinished() const {
+    return PathSystem::getInstance().isFinished(m_slot);
+}
@@ -0,0 +1,146 @@
+﻿#include "ECS/PathSystem.h"
+#include "ECS/Path.h"
+#include "Services/JobSystem.h"
+#include "Services/StateBuffer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GALVAN_PATH_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const size_t PATH_BATCH = 4096; ///< Seguidores por lote al repartir en el JobSystem.
+}
+
+uint32_t
+PathSystem::add(Path* owner, const PathSpline* spline, float speed, bool loop) {
+    uint32_t slot = static_cast<uint32_t>(m_owners.size());
+    m_owners.push_back(owner);
+    m_splines.push_back(spline);
+    m_distances.push_back(0.0f);
+    m_speeds.push_back(speed);
+    m_lengths.push_back(spline->getLength());
+    m_loops.push_back(loop ? 1.0f : 0.0f);
+    m_segments.push_back(0);
+    m_positions.push_back(sf::Vector2f());
+    samplePositions(slot, slot + 1);
+    return slot;
+}
+
+void
+PathSystem::remove(uint32_t slot) {
+    uint32_t last = static_cast<uint32_t>(m_owners.size()) - 1;
+    if (slot != last) {
+        m_owners[slot] = m_owners[last];
+        m_splines[slot] = m_splines[last];
+        m_distances[slot] = m_distances[last];
+        m_speeds[slot] = m_speeds[last];
+        m_lengths[slot] = m_lengths[last];
+        m_loops[slot] = m_loops[last];
+        m_segments[slot] = m_segments[last];
+        m_positions[slot] = m_positions[last];
+        m_owners[slot]->setSlot(slot);
+    }
+    m_owners.pop_back();
+    m_splines.pop_back();
+    m_distances.pop_back();
+    m_speeds.pop_back();
+    m_lengths.pop_back();
+    m_loops.pop_back();
+    m_segments.pop_back();
+    m_positions.pop_back();
+}
+
+void
+PathSystem::update(float deltaTime) {
+    size_t count = m_owners.size();
+    if (count == 0) {
+        return;
+    }
+    JobSystem::getInstance().parallelFor(count, PATH_BATCH, [this, deltaTime](size_t begin, size_t end) {
+        advance(begin, end, deltaTime);
+        samplePositions(begin, end);
+    });
+}
+
+void
+PathSystem::setDistance(uint32_t slot, float distance) {
+    m_distances[slot] = std::clamp(distance, 0.0f, m_lengths[slot]);
+    samplePositions(slot, slot + 1);
+}
+
+uint32_t
+PathSystem::getWaypoint(uint32_t slot) const {
+    return m_splines[slot]->getWaypointForSample(m_segments[slot]);
+}
+
+bool
+PathSystem::isFinished(uint32_t slot) const {
+    if (m_loops[slot] != 0.0f) {
+        return false;
+    }
+    return m_speeds[slot] >= 0.0f ? m_distances[slot] >= m_lengths[slot] : m_distances[slot] <= 0.0f;
+}
+
+void
+PathSystem::advance(size_t begin, size_t end, float deltaTime) {
+    float* distance = m_distances.data();
+    const float* speed = m_speeds.data();
+    const float* length = m_lengths.data();
+    const float* loop = m_loops.data();
+
+    size_t i = begin;
+#ifdef GALVAN_PATH_SSE
+    // Ciclo y tope con máscaras: los seguidores que dan vueltas y los que se detienen
+    // comparten las mismas instrucciones
+    const __m128 dt4 = _mm_set1_ps(deltaTime);
+    const __m128 zero4 = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        __m128 len = _mm_loadu_ps(length + i);
+        __m128 d = _mm_add_ps(_mm_loadu_ps(distance + i), _mm_mul_ps(_mm_loadu_ps(speed + i), dt4));
+        __m128 wrapped = _mm_sub_ps(d, _mm_and_ps(_mm_cmpge_ps(d, len), len));
+        wrapped = _mm_add_ps(wrapped, _mm_and_ps(_mm_cmplt_ps(d, zero4), len));
+        __m128 loopMask = _mm_cmpneq_ps(_mm_loadu_ps(loop + i), zero4);
+        d = _mm_or_ps(_mm_and_ps(loopMask, wrapped), _mm_andnot_ps(loopMask, d));
+        _mm_storeu_ps(distance + i, _mm_min_ps(_mm_max_ps(d, zero4), len));
+    }
+#endif
+    for (; i < end; ++i) {
+        float d = distance[i] + speed[i] * deltaTime;
+        if (loop[i] != 0.0f) {
+            if (d >= length[i]) {
+                d -= length[i];
+            }
+            else if (d < 0.0f) {
+                d += length[i];
+            }
+        }
+        distance[i] = std::min(std::max(d, 0.0f), length[i]);
+    }
+}
+
+void
+PathSystem::samplePositions(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        m_positions[i] = m_splines[i]->sample(m_distances[i], m_segments[i]);
+    }
+}
+
+void
+PathSystem::saveState(StateWriter& writer) {
+    writer.writeColumn(m_owners);
+    writer.writeColumn(m_splines);
+    writer.writeColumn(m_distances);
+    writer.writeColumn(m_speeds);
+    writer.writeColumn(m_loops);
+    writer.writeColumn(m_segments);
+    writer.writeColumn(m_positions);
+}
+
+bool
+PathSystem::loadState(StateReader& reader) {
+    // Las rutas no se copian; cada seguidor debe seguir usando la misma
+    return reader.matchColumn(m_owners) && reader.matchColumn(m_splines) &&
+           reader.readColumn(m_distances) && reader.readColumn(m_speeds) && reader.readColumn(m_loops) &&
+           reader.readColumn(m_segments) && reader.readColumn(m_positions);
+}
@@ -0,0 +1,929 @@
+﻿#include "ECS/PhysicsWorld.h"
+#include "Services/JobSystem.h"
+#include "Services/StateBuffer.h"
+
+namespace {
+    const float LINEAR_SLOP = 0.5f;         ///< Penetración tolerada en unidades de mundo.
+    const float BAUMGARTE = 0.2f;           ///< Fracción de la penetración corregida por paso.
+    const float RESTITUTION_THRESHOLD = 30.0f; ///< Velocidad normal mínima para rebotar.
+    const float EPSILON = 1e-6f;
+    const size_t PAIR_BATCH = 512;          ///< Pares por lote en la fase estrecha.
+    const size_t ISLAND_BATCH = 4;          ///< Islas por lote en el solver.
+    const uint32_t INVALID = 0xFFFFFFFFu;
+
+    inline float
+        dot(const sf::Vector2f& a, const sf::Vector2f& b) {
+        return a.x * b.x + a.y * b.y;
+    }
+
+    inline float
+        cross(const sf::Vector2f& a, const sf::Vector2f& b) {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    /**
+     * @brief Velocidad tangencial de una rotación: w x r.
+     */
+    inline sf::Vector2f
+        cross(float w, const sf::Vector2f& r) {
+        return sf::Vector2f(-w * r.y, w * r.x);
+    }
+
+    inline sf::Vector2f
+        rotate(const sf::Vector2f& v, float c, float s) {
+        return sf::Vector2f(c * v.x - s * v.y, s * v.x + c * v.y);
+    }
+
+    inline float
+        lengthSquared(const sf::Vector2f& v) {
+        return v.x * v.x + v.y * v.y;
+    }
+
+    inline uint64_t
+        pairKey(uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    /**
+     * @brief Primer instante t en [0, 1] en que start + delta * t entra al círculo.
+     */
+    bool
+        rayCircle(const sf::Vector2f& start, const sf::Vector2f& delta, const sf::Vector2f& center, float radius, float& t) {
+        sf::Vector2f m = start - center;
+        float b = dot(m, delta);
+        float c = dot(m, m) - radius * radius;
+        float a = dot(delta, delta);
+        if (b >= 0.0f || a < EPSILON) {
+            return false;
+        }
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) {
+            return false;
+        }
+        t = (-b - std::sqrt(discriminant)) / a;
+        return t >= 0.0f && t <= 1.0f;
+    }
+
+    /**
+     * @brief Recorta el segmento in contra el semiplano dot(normal, p) <= offset.
+     * @return Puntos que quedan, 0 a 2.
+     */
+    int
+        clipSegment(sf::Vector2f out[2], const sf::Vector2f in[2], const sf::Vector2f& normal, float offset) {
+        int count = 0;
+        float distance0 = dot(normal, in[0]) - offset;
+        float distance1 = dot(normal, in[1]) - offset;
+        if (distance0 <= 0.0f) {
+            out[count++] = in[0];
+        }
+        if (distance1 <= 0.0f) {
+            out[count++] = in[1];
+        }
+        if (distance0 * distance1 < 0.0f) {
+            float t = distance0 / (distance0 - distance1);
+            out[count++] = in[0] + (in[1] - in[0]) * t;
+        }
+        return count;
+    }
+
+    /*
+    * @struct BodyState
+    * @brief Lo que cambia de un cuerpo al simular; el resto lo fija su Collider.
+    */
+    struct
+        BodyState {
+        sf::Vector2f position;
+        float angle;
+        sf::Vector2f velocity;
+        float angularVelocity;
+        sf::Vector2f force;
+    };
+}
+
+uint32_t
+PhysicsWorld::add(Collider* owner,
+                  const ColliderShape& shape,
+                  const sf::Vector2f& origin,
+                  float angle,
+                  const PhysicsMaterial& material) {
+    Body body;
+    body.owner = owner;
+    body.friction = material.friction;
+    body.restitution = material.restitution;
+
+    if (shape.type == COLLIDER_CIRCLE || shape.vertices.size() < 3) {
+        body.shape = COLLIDER_CIRCLE;
+        body.radius = shape.radius;
+        body.localCenter = shape.center;
+        body.mass = material.density * 3.14159265f * shape.radius * shape.radius;
+        body.inertia = 0.5f * body.mass * shape.radius * shape.radius;
+        body.coreRadius = shape.radius;
+    }
+    else {
+        body.shape = shape.type;
+        body.vertexCount = static_cast<uint32_t>(std::min<size_t>(shape.vertices.size(), ColliderShape::MAX_VERTICES));
+
+        // Centroide e inercia por triángulos respecto al primer vértice
+        const sf::Vector2f reference = shape.vertices[0];
+        float area = 0.0f;
+        float inertia = 0.0f;
+        sf::Vector2f center;
+        for (uint32_t i = 0; i < body.vertexCount; ++i) {
+            sf::Vector2f e1 = shape.vertices[i] - reference;
+            sf::Vector2f e2 = shape.vertices[(i + 1) % body.vertexCount] - reference;
+            float d = cross(e1, e2);
+            float triangleArea = 0.5f * d;
+            area += triangleArea;
+            center += (e1 + e2) * (triangleArea / 3.0f);
+            float integralX = e1.x * e1.x + e2.x * e1.x + e2.x * e2.x;
+            float integralY = e1.y * e1.y + e2.y * e1.y + e2.y * e2.y;
+            inertia += (0.25f / 3.0f * d) * (integralX + integralY);
+        }
+        area = std::max(area, EPSILON);
+        center /= area;
+        body.localCenter = reference + center;
+        body.mass = material.density * area;
+        body.inertia = std::max(material.density * inertia - body.mass * lengthSquared(center), EPSILON);
+
+        for (uint32_t i = 0; i < body.vertexCount; ++i) {
+            body.localVertices[i] = shape.vertices[i] - body.localCenter;
+        }
+        for (uint32_t i = 0; i < body.vertexCount; ++i) {
+            sf::Vector2f edge = body.localVertices[(i + 1) % body.vertexCount] - body.localVertices[i];
+            float length = std::sqrt(lengthSquared(edge));
+            body.localNormals[i] = length > EPSILON ? sf::Vector2f(edge.y / length, -edge.x / length) : sf::Vector2f(1.0f, 0.0f);
+        }
+        body.coreRadius = std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < body.vertexCount; ++i) {
+            body.coreRadius = std::min(body.coreRadius, -dot(body.localNormals[i], body.localVertices[i]));
+        }
+        body.coreRadius = std::max(body.coreRadius, 0.0f);
+    }
+
+    uint32_t slot = static_cast<uint32_t>(m_bodies.size());
+    m_bodies.push_back(body);
+    m_sortedByMinX.push_back(slot);
+    updateMass(m_bodies[slot]);
+    setTransform(slot, origin, angle);
+    return slot;
+}
+
+void
+PhysicsWorld::remove(uint32_t slot) {
+    uint32_t last = static_cast<uint32_t>(m_bodies.size()) - 1;
+    auto removed = std::find(m_sortedByMinX.begin(), m_sortedByMinX.end(), slot);
+    m_sortedByMinX.erase(removed);
+    if (slot != last) {
+        m_bodies[slot] = m_bodies[last];
+        m_bodies[slot].owner->setSlot(slot);
+        std::replace(m_sortedByMinX.begin(), m_sortedByMinX.end(), last, slot);
+    }
+    m_bodies.pop_back();
+
+    // Los impulsos guardados para el arranque en caliente siguen a los cuerpos, no a los slots
+    std::vector<Contact>& previous = m_previousContacts;
+    previous.erase(std::remove_if(previous.begin(), previous.end(), [slot](const Contact& contact) {
+        return contact.a == slot || contact.b == slot;
+    }), previous.end());
+    if (slot != last) {
+        for (Contact& contact : previous) {
+            contact.a = contact.a == last ? slot : contact.a;
+            contact.b = contact.b == last ? slot : contact.b;
+        }
+        std::sort(previous.begin(), previous.end(), [](const Contact& l, const Contact& r) {
+            return pairKey(l.a, l.b) < pairKey(r.a, r.b);
+        });
+    }
+}
+
+void
+PhysicsWorld::setBodyType(uint32_t slot, BodyType type) {
+    Body& body = m_bodies[slot];
+    body.type = type;
+    if (type == BODY_STATIC) {
+        body.velocity = sf::Vector2f();
+        body.angularVelocity = 0.0f;
+    }
+    updateMass(body);
+}
+
+void
+PhysicsWorld::setTransform(uint32_t slot, const sf::Vector2f& origin, float angle) {
+    Body& body = m_bodies[slot];
+    body.angle = angle * 3.14159265f / 180.0f;
+    body.position = origin + rotate(body.localCenter, std::cos(body.angle), std::sin(body.angle));
+    updateWorldShape(body);
+}
+
+sf::Vector2f
+PhysicsWorld::getOrigin(uint32_t slot) const {
+    const Body& body = m_bodies[slot];
+    return body.position - rotate(body.localCenter, std::cos(body.angle), std::sin(body.angle));
+}
+
+float
+PhysicsWorld::getAngle(uint32_t slot) const {
+    return m_bodies[slot].angle * 180.0f / 3.14159265f;
+}
+
+void
+PhysicsWorld::applyImpulse(uint32_t slot, const sf::Vector2f& impulse, const sf::Vector2f& worldPoint) {
+    Body& body = m_bodies[slot];
+    body.velocity += impulse * body.invMass;
+    body.angularVelocity += body.invInertia * cross(worldPoint - body.position, impulse);
+}
+
+void
+PhysicsWorld::getStaticBounds(std::vector<sf::FloatRect>& bounds) const {
+    for (const Body& body : m_bodies) {
+        if (body.type == BODY_STATIC) {
+            bounds.emplace_back(body.minX, body.minY, body.maxX - body.minX, body.maxY - body.minY);
+        }
+    }
+}
+
+void
+PhysicsWorld::saveState(StateWriter& writer) {
+    uint32_t count = static_cast<uint32_t>(m_bodies.size());
+    // Los cuerpos son AoS: se copian a columnas dentro del propio búfer
+    Collider** owners = writer.beginColumn<Collider*>(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        owners[i] = m_bodies[i].owner;
+    }
+    BodyState* states = writer.beginColumn<BodyState>(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Body& body = m_bodies[i];
+        states[i] = { body.position, body.angle, body.velocity, body.angularVelocity, body.force };
+    }
+    writer.writeValue(m_accumulator);
+    writer.writeValue(m_maxWidth);
+    writer.writeColumn(m_sortedByMinX);
+    writer.writeColumn(m_previousContacts);
+}
+
+bool
+PhysicsWorld::loadState(StateReader& reader) {
+    uint32_t count = static_cast<uint32_t>(m_bodies.size());
+    Collider* const* owners = reader.readColumnData<Collider*>(count);
+    if (owners == nullptr) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (owners[i] != m_bodies[i].owner) {
+            return false;
+        }
+    }
+    const BodyState* states = reader.readColumnData<BodyState>(count);
+    if (states == nullptr || !reader.readValue(m_accumulator) || !reader.readValue(m_maxWidth) ||
+        !reader.readColumn(m_sortedByMinX) || !reader.readColumn(m_previousContacts, true)) {
+        return false;
+    }
+    if (reader.isApplying()) {
+        for (uint32_t i = 0; i < count; ++i) {
+            Body& body = m_bodies[i];
+            body.position = states[i].position;
+            body.angle = states[i].angle;
+            body.velocity = states[i].velocity;
+            body.angularVelocity = states[i].angularVelocity;
+            body.force = states[i].force;
+            updateWorldShape(body);
+        }
+    }
+    return true;
+}
+
+void
+PhysicsWorld::update(float deltaTime) {
+    if (m_bodies.empty()) {
+        m_accumulator = 0.0f;
+        m_stats = PhysicsStats();
+        return;
+    }
+
+    // Un frame muy lento no obliga a simular más pasos de los permitidos
+    m_accumulator += std::min(deltaTime, m_timeStep * static_cast<float>(m_maxStepsPerUpdate));
+    uint32_t steps = 0;
+    while (m_accumulator >= m_timeStep && steps < m_maxStepsPerUpdate) {
+        step(m_timeStep);
+        m_accumulator -= m_timeStep;
+        ++steps;
+    }
+    m_stats.steps = steps;
+}
+
+void
+PhysicsWorld::step(float timeStep) {
+    sf::Clock clock;
+
+    for (Body& body : m_bodies) {
+        if (body.type != BODY_DYNAMIC) {
+            continue;
+        }
+        body.velocity += (m_gravity + body.force * body.invMass) * timeStep;
+        body.force = sf::Vector2f();
+    }
+
+    broadPhase();
+    narrowPhase();
+    buildIslands();
+
+    uint32_t islandCount = static_cast<uint32_t>(m_islandStart.size()) - 1;
+    JobSystem::getInstance().parallelFor(islandCount, ISLAND_BATCH, [this, timeStep](size_t begin, size_t end) {
+        for (size_t island = begin; island < end; ++island) {
+            solveIsland(static_cast<uint32_t>(island), timeStep);
+        }
+    });
+
+    m_previousContacts = m_contacts;
+    std::sort(m_previousContacts.begin(), m_previousContacts.end(), [](const Contact& l, const Contact& r) {
+        return pairKey(l.a, l.b) < pairKey(r.a, r.b);
+    });
+
+    // Primero los cuerpos normales, para que las balas se barran contra su posición final
+    m_bullets.clear();
+    for (uint32_t i = 0; i < m_bodies.size(); ++i) {
+        Body& body = m_bodies[i];
+        if (body.type == BODY_STATIC) {
+            continue;
+        }
+        if (body.bullet && body.type == BODY_DYNAMIC) {
+            m_bullets.push_back(i);
+            continue;
+        }
+        body.position += body.velocity * timeStep;
+        body.angle += body.angularVelocity * timeStep;
+        updateWorldShape(body);
+    }
+
+    m_stats.bulletHits = 0;
+    if (!m_bullets.empty()) {
+        sortByMinX();
+        for (uint32_t bullet : m_bullets) {
+            integrateBullet(bullet, timeStep);
+            // Las balas siguientes barren contra esta en su posición nueva
+            resortBody(bullet);
+        }
+    }
+
+    m_stats.bodies = m_bodies.size();
+    m_stats.pairs = m_pairs.size();
+    m_stats.contacts = m_contacts.size();
+    m_stats.islands = islandCount;
+    m_stats.stepTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+void
+PhysicsWorld::updateWorldShape(Body& body) {
+    if (body.shape == COLLIDER_CIRCLE) {
+        body.minX = body.position.x - body.radius;
+        body.maxX = body.position.x + body.radius;
+        body.minY = body.position.y - body.radius;
+        body.maxY = body.position.y + body.radius;
+        return;
+    }
+
+    float c = std::cos(body.angle);
+    float s = std::sin(body.angle);
+    body.minX = body.minY = std::numeric_limits<float>::max();
+    body.maxX = body.maxY = -std::numeric_limits<float>::max();
+    for (uint32_t i = 0; i < body.vertexCount; ++i) {
+        sf::Vector2f vertex = body.position + rotate(body.localVertices[i], c, s);
+        body.worldVertices[i] = vertex;
+        body.worldNormals[i] = rotate(body.localNormals[i], c, s);
+        body.minX = std::min(body.minX, vertex.x);
+        body.maxX = std::max(body.maxX, vertex.x);
+        body.minY = std::min(body.minY, vertex.y);
+        body.maxY = std::max(body.maxY, vertex.y);
+    }
+}
+
+void
+PhysicsWorld::updateMass(Body& body) {
+    if (body.type == BODY_DYNAMIC && body.mass > 0.0f) {
+        body.invMass = 1.0f / body.mass;
+        body.invInertia = body.inertia > 0.0f ? 1.0f / body.inertia : 0.0f;
+    }
+    else {
+        body.invMass = 0.0f;
+        body.invInertia = 0.0f;
+    }
+}
+
+void
+PhysicsWorld::sortByMinX() {
+    // Insertion sort: entre pasos el orden casi no cambia, así que cuesta casi O(n)
+    std::vector<uint32_t>& sorted = m_sortedByMinX;
+    m_maxWidth = 0.0f;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        uint32_t current = sorted[i];
+        const Body& body = m_bodies[current];
+        m_maxWidth = std::max(m_maxWidth, body.maxX - body.minX);
+        size_t j = i;
+        while (j > 0 && m_bodies[sorted[j - 1]].minX > body.minX) {
+            sorted[j] = sorted[j - 1];
+            --j;
+        }
+        sorted[j] = current;
+    }
+}
+
+void
+PhysicsWorld::resortBody(uint32_t slot) {
+    std::vector<uint32_t>& sorted = m_sortedByMinX;
+    sorted.erase(std::find(sorted.begin(), sorted.end(), slot));
+    const Body& body = m_bodies[slot];
+    auto position = std::lower_bound(sorted.begin(), sorted.end(), body.minX,
+        [this](uint32_t other, float x) { return m_bodies[other].minX < x; });
+    sorted.insert(position, slot);
+    m_maxWidth = std::max(m_maxWidth, body.maxX - body.minX);
+}
+
+void
+PhysicsWorld::broadPhase() {
+    sortByMinX();
+
+    const std::vector<uint32_t>& sorted = m_sortedByMinX;
+    m_pairs.clear();
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const Body& a = m_bodies[sorted[i]];
+        for (size_t j = i + 1; j < sorted.size(); ++j) {
+            const Body& b = m_bodies[sorted[j]];
+            if (b.minX > a.maxX) {
+                break;
+            }
+            if (a.type != BODY_DYNAMIC && b.type != BODY_DYNAMIC) {
+                continue;
+            }
+            if (b.minY > a.maxY || a.minY > b.maxY) {
+                continue;
+            }
+            m_pairs.emplace_back(sorted[i], sorted[j]);
+        }
+    }
+}
+
+void
+PhysicsWorld::narrowPhase() {
+    // Cada par escribe en su propio lugar; después se compactan los que se tocan
+    m_contacts.resize(m_pairs.size());
+    JobSystem::getInstance().parallelFor(m_pairs.size(), PAIR_BATCH, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Contact& contact = m_contacts[i];
+            contact = Contact();
+            if (!collide(m_pairs[i].first, m_pairs[i].second, contact)) {
+                contact.pointCount = 0;
+            }
+        }
+    });
+
+    size_t count = 0;
+    for (size_t i = 0; i < m_contacts.size(); ++i) {
+        if (m_contacts[i].pointCount > 0) {
+            m_contacts[count++] = m_contacts[i];
+        }
+    }
+    m_contacts.resize(count);
+
+    // Recupera los impulsos del paso anterior para los puntos que casi no se movieron
+    const float matchDistanceSquared = 4.0f * LINEAR_SLOP * LINEAR_SLOP;
+    for (Contact& contact : m_contacts) {
+        uint64_t key = pairKey(contact.a, contact.b);
+        auto previous = std::lower_bound(m_previousContacts.begin(), m_previousContacts.end(), key,
+            [](const Contact& c, uint64_t k) { return pairKey(c.a, c.b) < k; });
+        if (previous == m_previousContacts.end() || pairKey(previous->a, previous->b) != key) {
+            continue;
+        }
+        for (uint32_t p = 0; p < contact.pointCount; ++p) {
+            for (uint32_t q = 0; q < previous->pointCount; ++q) {
+                if (lengthSquared(contact.points[p] - previous->points[q]) < matchDistanceSquared) {
+                    contact.normalImpulse[p] = previous->normalImpulse[q];
+                    contact.tangentImpulse[p] = previous->tangentImpulse[q];
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool
+PhysicsWorld::collide(uint32_t a, uint32_t b, Contact& contact) const {
+    const Body& bodyA = m_bodies[a];
+    const Body& bodyB = m_bodies[b];
+    contact.a = a;
+    contact.b = b;
+    contact.friction = std::sqrt(bodyA.friction * bodyB.friction);
+
+    if (bodyA.shape == COLLIDER_CIRCLE && bodyB.shape == COLLIDER_CIRCLE) {
+        sf::Vector2f delta = bodyB.position - bodyA.position;
+        float radius = bodyA.radius + bodyB.radius;
+        float distanceSquared = lengthSquared(delta);
+        if (distanceSquared > radius * radius) {
+            return false;
+        }
+        float distance = std::sqrt(distanceSquared);
+        contact.normal = distance > EPSILON ? delta / distance : sf::Vector2f(1.0f, 0.0f);
+        contact.points[0] = bodyA.position + contact.normal * bodyA.radius;
+        contact.penetration[0] = radius - distance;
+        contact.pointCount = 1;
+        return true;
+    }
+
+    if ((bodyA.shape == COLLIDER_CIRCLE) != (bodyB.shape == COLLIDER_CIRCLE)) {
+        // Polígono contra círculo; la normal se calcula del polígono al círculo
+        bool flipped = bodyA.shape == COLLIDER_CIRCLE;
+        const Body& polygon = flipped ? bodyB : bodyA;
+        const Body& circle = flipped ? bodyA : bodyB;
+
+        uint32_t normalIndex = 0;
+        float separation = -std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < polygon.vertexCount; ++i) {
+            float s = dot(polygon.worldNormals[i], circle.position - polygon.worldVertices[i]);
+            if (s > circle.radius) {
+                return false;
+            }
+            if (s > separation) {
+                separation = s;
+                normalIndex = i;
+            }
+        }
+
+        const sf::Vector2f& v1 = polygon.worldVertices[normalIndex];
+        const sf::Vector2f& v2 = polygon.worldVertices[(normalIndex + 1) % polygon.vertexCount];
+        sf::Vector2f normal = polygon.worldNormals[normalIndex];
+        float penetration = circle.radius - separation;
+        if (separation > EPSILON) {
+            // Fuera del polígono: la región de un vértice usa la dirección hacia el vértice
+            float u1 = dot(circle.position - v1, v2 - v1);
+            float u2 = dot(circle.position - v2, v1 - v2);
+            const sf::Vector2f* vertex = u1 <= 0.0f ? &v1 : (u2 <= 0.0f ? &v2 : nullptr);
+            if (vertex != nullptr) {
+                sf::Vector2f delta = circle.position - *vertex;
+                float distanceSquared = lengthSquared(delta);
+                if (distanceSquared > circle.radius * circle.radius) {
+                    return false;
+                }
+                float distance = std::sqrt(distanceSquared);
+                normal = distance > EPSILON ? delta / distance : normal;
+                penetration = circle.radius - distance;
+            }
+        }
+
+        contact.normal = flipped ? -normal : normal;
+        contact.points[0] = circle.position - normal * circle.radius;
+        contact.penetration[0] = penetration;
+        contact.pointCount = 1;
+        return true;
+    }
+
+    // Polígono contra polígono: eje de separación de cada lado
+    auto findMaxSeparation = [](const Body& poly1, const Body& poly2, uint32_t& edge) {
+        float best = -std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < poly1.vertexCount; ++i) {
+            const sf::Vector2f& normal = poly1.worldNormals[i];
+            float minimum = std::numeric_limits<float>::max();
+            for (uint32_t j = 0; j < poly2.vertexCount; ++j) {
+                minimum = std::min(minimum, dot(normal, poly2.worldVertices[j] - poly1.worldVertices[i]));
+            }
+            if (minimum > best) {
+                best = minimum;
+                edge = i;
+            }
+        }
+        return best;
+    };
+
+    uint32_t edgeA = 0;
+    float separationA = findMaxSeparation(bodyA, bodyB, edgeA);
+    if (separationA > 0.0f) {
+        return false;
+    }
+    uint32_t edgeB = 0;
+    float separationB = findMaxSeparation(bodyB, bodyA, edgeB);
+    if (separationB > 0.0f) {
+        return false;
+    }
+
+    bool flipped = separationB > separationA + 0.1f * LINEAR_SLOP;
+    const Body& reference = flipped ? bodyB : bodyA;
+    const Body& incident = flipped ? bodyA : bodyB;
+    uint32_t referenceEdge = flipped ? edgeB : edgeA;
+    sf::Vector2f referenceNormal = reference.worldNormals[referenceEdge];
+
+    // Arista incidente: la de normal más opuesta a la de referencia
+    uint32_t incidentEdge = 0;
+    float minimumDot = std::numeric_limits<float>::max();
+    for (uint32_t i = 0; i < incident.vertexCount; ++i) {
+        float d = dot(referenceNormal, incident.worldNormals[i]);
+        if (d < minimumDot) {
+            minimumDot = d;
+            incidentEdge = i;
+        }
+    }
+    sf::Vector2f incidentPoints[2] = { incident.worldVertices[incidentEdge],
+                                       incident.worldVertices[(incidentEdge + 1) % incident.vertexCount] };
+
+    const sf::Vector2f& v11 = reference.worldVertices[referenceEdge];
+    const sf::Vector2f& v12 = reference.worldVertices[(referenceEdge + 1) % reference.vertexCount];
+    sf::Vector2f tangent = v12 - v11;
+    tangent /= std::max(std::sqrt(lengthSquared(tangent)), EPSILON);
+
+    sf::Vector2f clip1[2];
+    sf::Vector2f clip2[2];
+    if (clipSegment(clip1, incidentPoints, -tangent, -dot(tangent, v11)) < 2 ||
+        clipSegment(clip2, clip1, tangent, dot(tangent, v12)) < 2) {
+        return false;
+    }
+
+    float frontOffset = dot(referenceNormal, v11);
+    for (int i = 0; i < 2; ++i) {
+        float separation = dot(referenceNormal, clip2[i]) - frontOffset;
+        if (separation <= 0.0f) {
+            contact.points[contact.pointCount] = clip2[i];
+            contact.penetration[contact.pointCount] = -separation;
+            ++contact.pointCount;
+        }
+    }
+    contact.normal = flipped ? -referenceNormal : referenceNormal;
+    return contact.pointCount > 0;
+}
+
+uint32_t
+PhysicsWorld::findRoot(uint32_t body) {
+    while (m_parent[body] != body) {
+        m_parent[body] = m_parent[m_parent[body]];
+        body = m_parent[body];
+    }
+    return body;
+}
+
+void
+PhysicsWorld::buildIslands() {
+    m_parent.resize(m_bodies.size());
+    for (uint32_t i = 0; i < m_parent.size(); ++i) {
+        m_parent[i] = i;
+    }
+
+    // Los cuerpos estáticos y cinemáticos no unen islas: solo se leen al resolver
+    for (const Contact& contact : m_contacts) {
+        if (m_bodies[contact.a].type == BODY_DYNAMIC && m_bodies[contact.b].type == BODY_DYNAMIC) {
+            uint32_t rootA = findRoot(contact.a);
+            uint32_t rootB = findRoot(contact.b);
+            if (rootA != rootB) {
+                m_parent[rootA] = rootB;
+            }
+        }
+    }
+
+    // Índice de isla por raíz y counting sort de los contactos por isla
+    std::vector<uint32_t>& islandOfRoot = m_islandOf;
+    islandOfRoot.assign(m_bodies.size(), INVALID);
+    std::vector<uint32_t> contactIsland(m_contacts.size());
+    uint32_t islandCount = 0;
+    for (size_t i = 0; i < m_contacts.size(); ++i) {
+        const Contact& contact = m_contacts[i];
+        uint32_t body = m_bodies[contact.a].type == BODY_DYNAMIC ? contact.a : contact.b;
+        uint32_t root = findRoot(body);
+        if (islandOfRoot[root] == INVALID) {
+            islandOfRoot[root] = islandCount++;
+        }
+        contactIsland[i] = islandOfRoot[root];
+    }
+
+    m_islandStart.assign(static_cast<size_t>(islandCount) + 1, 0);
+    for (uint32_t island : contactIsland) {
+        ++m_islandStart[island + 1];
+    }
+    for (uint32_t i = 0; i < islandCount; ++i) {
+        m_islandStart[i + 1] += m_islandStart[i];
+    }
+    m_islandContacts.resize(m_contacts.size());
+    std::vector<uint32_t> cursor(m_islandStart.begin(), m_islandStart.end() - 1);
+    for (uint32_t i = 0; i < contactIsland.size(); ++i) {
+        m_islandContacts[cursor[contactIsland[i]]++] = i;
+    }
+}
+
+void
+PhysicsWorld::solveIsland(uint32_t island, float timeStep) {
+    const uint32_t begin = m_islandStart[island];
+    const uint32_t end = m_islandStart[island + 1];
+    const float inverseStep = 1.0f / timeStep;
+
+    // Masas efectivas, corrección de posición y rebote de cada punto
+    for (uint32_t k = begin; k < end; ++k) {
+        Contact& contact = m_contacts[m_islandContacts[k]];
+        const Body& a = m_bodies[contact.a];
+        const Body& b = m_bodies[contact.b];
+        sf::Vector2f tangent(contact.normal.y, -contact.normal.x);
+        float restitution = std::max(a.restitution, b.restitution);
+        for (uint32_t p = 0; p < contact.pointCount; ++p) {
+            sf::Vector2f rA = contact.points[p] - a.position;
+            sf::Vector2f rB = contact.points[p] - b.position;
+            float rnA = cross(rA, contact.normal);
+            float rnB = cross(rB, contact.normal);
+            float normalK = a.invMass + b.invMass + a.invInertia * rnA * rnA + b.invInertia * rnB * rnB;
+            float rtA = cross(rA, tangent);
+            float rtB = cross(rB, tangent);
+            float tangentK = a.invMass + b.invMass + a.invInertia * rtA * rtA + b.invInertia * rtB * rtB;
+            contact.normalMass[p] = normalK > 0.0f ? 1.0f / normalK : 0.0f;
+            contact.tangentMass[p] = tangentK > 0.0f ? 1.0f / tangentK : 0.0f;
+
+            sf::Vector2f relative = b.velocity + cross(b.angularVelocity, rB) - a.velocity - cross(a.angularVelocity, rA);
+            float normalVelocity = dot(relative, contact.normal);
+            contact.bias[p] = BAUMGARTE * inverseStep * std::max(0.0f, contact.penetration[p] - LINEAR_SLOP);
+            if (normalVelocity < -RESTITUTION_THRESHOLD) {
+                contact.bias[p] = std::max(contact.bias[p], -restitution * normalVelocity);
+            }
+        }
+    }
+
+    // Warm starting: se aplica de entrada el impulso que resolvió el contacto el paso anterior
+    for (uint32_t k = begin; k < end; ++k) {
+        Contact& contact = m_contacts[m_islandContacts[k]];
+        Body& a = m_bodies[contact.a];
+        Body& b = m_bodies[contact.b];
+        sf::Vector2f tangent(contact.normal.y, -contact.normal.x);
+        for (uint32_t p = 0; p < contact.pointCount; ++p) {
+            sf::Vector2f impulse = contact.normal * contact.normalImpulse[p] + tangent * contact.tangentImpulse[p];
+            applyContactImpulse(a, b, contact.points[p] - a.position, contact.points[p] - b.position, impulse);
+        }
+    }
+
+    for (uint32_t iteration = 0; iteration < m_iterations; ++iteration) {
+        for (uint32_t k = begin; k < end; ++k) {
+            Contact& contact = m_contacts[m_islandContacts[k]];
+            Body& a = m_bodies[contact.a];
+            Body& b = m_bodies[contact.b];
+            sf::Vector2f tangent(contact.normal.y, -contact.normal.x);
+
+            // Fricción primero, limitada por el impulso normal acumulado
+            for (uint32_t p = 0; p < contact.pointCount; ++p) {
+                sf::Vector2f rA = contact.points[p] - a.position;
+                sf::Vector2f rB = contact.points[p] - b.position;
+                sf::Vector2f relative = b.velocity + cross(b.angularVelocity, rB) - a.velocity - cross(a.angularVelocity, rA);
+                float lambda = -contact.tangentMass[p] * dot(relative, tangent);
+                float maxFriction = contact.friction * contact.normalImpulse[p];
+                float newImpulse = std::clamp(contact.tangentImpulse[p] + lambda, -maxFriction, maxFriction);
+                lambda = newImpulse - contact.tangentImpulse[p];
+                contact.tangentImpulse[p] = newImpulse;
+                applyContactImpulse(a, b, rA, rB, tangent * lambda);
+            }
+
+            // Después el impulso normal, que solo empuja
+            for (uint32_t p = 0; p < contact.pointCount; ++p) {
+                sf::Vector2f rA = contact.points[p] - a.position;
+                sf::Vector2f rB = contact.points[p] - b.position;
+                sf::Vector2f relative = b.velocity + cross(b.angularVelocity, rB) - a.velocity - cross(a.angularVelocity, rA);
+                float lambda = -contact.normalMass[p] * (dot(relative, contact.normal) - contact.bias[p]);
+                float newImpulse = std::max(contact.normalImpulse[p] + lambda, 0.0f);
+                lambda = newImpulse - contact.normalImpulse[p];
+                contact.normalImpulse[p] = newImpulse;
+                applyContactImpulse(a, b, rA, rB, contact.normal * lambda);
+            }
+        }
+    }
+}
+
+void
+PhysicsWorld::applyContactImpulse(Body& a, Body& b, const sf::Vector2f& rA, const sf::Vector2f& rB, const sf::Vector2f& impulse) {
+    // Los cuerpos sin masa inversa se comparten entre islas y solo se leen
+    if (a.invMass > 0.0f) {
+        a.velocity -= impulse * a.invMass;
+        a.angularVelocity -= a.invInertia * cross(rA, impulse);
+    }
+    if (b.invMass > 0.0f) {
+        b.velocity += impulse * b.invMass;
+        b.angularVelocity += b.invInertia * cross(rB, impulse);
+    }
+}
+
+bool
+PhysicsWorld::castCircle(const sf::Vector2f& start,
+                         const sf::Vector2f& end,
+                         float radius,
+                         CastHit& hit,
+                         uint32_t ignoreSlot) const {
+    const float minX = std::min(start.x, end.x) - radius;
+    const float maxX = std::max(start.x, end.x) + radius;
+    const float minY = std::min(start.y, end.y) - radius;
+    const float maxY = std::max(start.y, end.y) + radius;
+    const sf::Vector2f delta = end - start;
+
+    // Ningún AABB que empiece antes de minX - m_maxWidth puede alcanzar la consulta
+    auto first = std::lower_bound(m_sortedByMinX.begin(), m_sortedByMinX.end(), minX - m_maxWidth,
+        [this](uint32_t slot, float x) { return m_bodies[slot].minX < x; });
+
+    bool found = false;
+    hit.fraction = 1.0f;
+    for (auto it = first; it != m_sortedByMinX.end(); ++it) {
+        const Body& body = m_bodies[*it];
+        if (body.minX > maxX) {
+            break;
+        }
+        if (*it == ignoreSlot || body.maxX < minX || body.minY > maxY || body.maxY < minY) {
+            continue;
+        }
+        float fraction = 1.0f;
+        sf::Vector2f normal;
+        if (castAgainst(body, start, delta, radius, fraction, normal) && fraction <= hit.fraction) {
+            found = true;
+            hit.collider = body.owner;
+            hit.slot = *it;
+            hit.fraction = fraction;
+            hit.normal = normal;
+            hit.point = start + delta * fraction - normal * radius;
+        }
+    }
+    return found;
+}
+
+bool
+PhysicsWorld::castAgainst(const Body& body,
+                          const sf::Vector2f& start,
+                          const sf::Vector2f& delta,
+                          float radius,
+                          float& fraction,
+                          sf::Vector2f& normal) const {
+    if (body.shape == COLLIDER_CIRCLE) {
+        float combined = radius + body.radius;
+        if (lengthSquared(start - body.position) < combined * combined ||
+            !rayCircle(start, delta, body.position, combined, fraction)) {
+            return false;
+        }
+        normal = (start + delta * fraction - body.position) / combined;
+        return true;
+    }
+
+    // Si el círculo ya toca al polígono, la fase estrecha discreta se encarga
+    float distanceSquared = std::numeric_limits<float>::max();
+    bool inside = true;
+    for (uint32_t i = 0; i < body.vertexCount; ++i) {
+        const sf::Vector2f& v1 = body.worldVertices[i];
+        const sf::Vector2f& v2 = body.worldVertices[(i + 1) % body.vertexCount];
+        inside = inside && dot(body.worldNormals[i], start - v1) <= 0.0f;
+        sf::Vector2f edge = v2 - v1;
+        float u = std::clamp(dot(start - v1, edge) / std::max(dot(edge, edge), EPSILON), 0.0f, 1.0f);
+        distanceSquared = std::min(distanceSquared, lengthSquared(start - (v1 + edge * u)));
+    }
+    if (inside || distanceSquared < radius * radius) {
+        return false;
+    }
+
+    // Polígono inflado por el radio: caras desplazadas más círculos en los vértices
+    float best = 2.0f;
+    for (uint32_t i = 0; i < body.vertexCount; ++i) {
+        const sf::Vector2f& n = body.worldNormals[i];
+        const sf::Vector2f& v1 = body.worldVertices[i];
+        const sf::Vector2f& v2 = body.worldVertices[(i + 1) % body.vertexCount];
+        float approach = dot(n, delta);
+        if (approach < 0.0f) {
+            float t = (radius - dot(n, start - v1)) / approach;
+            if (t >= 0.0f && t < best) {
+                sf::Vector2f edge = v2 - v1;
+                float u = dot(start + delta * t - v1, edge) / std::max(dot(edge, edge), EPSILON);
+                if (u >= 0.0f && u <= 1.0f) {
+                    best = t;
+                    normal = n;
+                }
+            }
+        }
+        float t = 0.0f;
+        if (rayCircle(start, delta, v1, radius, t) && t < best) {
+            best = t;
+            normal = (start + delta * t - v1) / radius;
+        }
+    }
+    if (best > 1.0f) {
+        return false;
+    }
+    fraction = best;
+    return true;
+}
+
+void
+PhysicsWorld::integrateBullet(uint32_t slot, float timeStep) {
+    Body& body = m_bodies[slot];
+    body.angle += body.angularVelocity * timeStep;
+
+    // El círculo inscrito no gira con el cuerpo, así que basta barrer el centro de masa
+    float remaining = timeStep;
+    for (uint32_t subStep = 0; subStep < m_maxBulletSubSteps && remaining > 0.0f; ++subStep) {
+        sf::Vector2f delta = body.velocity * remaining;
+        CastHit hit;
+        if (lengthSquared(delta) < EPSILON || !castCircle(body.position, body.position + delta, body.coreRadius, hit, slot)) {
+            body.position += delta;
+            break;
+        }
+
+        // Avanza hasta el impacto y quita la velocidad que entra en el otro cuerpo
+        body.position += delta * hit.fraction;
+        remaining *= 1.0f - hit.fraction;
+        float normalVelocity = dot(body.velocity, hit.normal);
+        if (normalVelocity < 0.0f) {
+            float restitution = std::max(body.restitution, m_bodies[hit.slot].restitution);
+            body.velocity -= hit.normal * ((1.0f + restitution) * normalVelocity);
+        }
+        ++m_stats.bulletHits;
+    }
+    updateWorldShape(body);
+}
@@ -0,0 +1,36 @@
+﻿#include "ECS/SpatialGrid.h"
+
+void
+SpatialGrid::build(const float* x, const float* y, size_t count, float cellSize) {
+    m_cellSize = std::max(cellSize, 0.001f);
+    m_inverseCellSize = 1.0f / m_cellSize;
+
+    // Al menos dos cubetas por punto para que las colisiones sean raras
+    uint32_t tableSize = 64;
+    while (tableSize < count * 2) {
+        tableSize <<= 1;
+    }
+    m_tableMask = tableSize - 1;
+
+    m_cellStart.assign(static_cast<size_t>(tableSize) + 1, 0);
+    m_itemBucket.resize(count);
+    m_items.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t bucket = hashCell(toCell(x[i]), toCell(y[i]));
+        m_itemBucket[i] = bucket;
+        ++m_cellStart[bucket + 1];
+    }
+    for (uint32_t i = 0; i < tableSize; ++i) {
+        m_cellStart[i + 1] += m_cellStart[i];
+    }
+
+    // m_cellStart[b] avanza mientras se llena y después se restaura
+    for (size_t i = 0; i < count; ++i) {
+        m_items[m_cellStart[m_itemBucket[i]]++] = static_cast<uint32_t>(i);
+    }
+    for (uint32_t i = tableSize; i > 0; --i) {
+        m_cellStart[i] = m_cellStart[i - 1];
+    }
+    m_cellStart[0] = 0;
+}
@@ -0,0 +1,305 @@
+﻿#include "ECS/SpriteAnimationSystem.h"
+#include "MathUtilities.h"
+#include "Services/StateBuffer.h"
+
+namespace {
+    const float DEGREES_TO_RADIANS = PI / 180.0f;
+}
+
+uint32_t
+SpriteAnimationSystem::add(SpriteAnimator* owner, const SpriteAtlas* atlas) {
+    uint32_t slot = static_cast<uint32_t>(m_owners.size());
+    m_owners.push_back(owner);
+    m_atlases.push_back(atlas);
+    m_clips.push_back(nullptr);
+    m_times.push_back(0.0f);
+    m_steps.push_back(-1);
+    m_speeds.push_back(1.0f);
+    m_playing.push_back(0);
+    m_finished.push_back(0);
+    m_frames.push_back(0);
+    m_sizes.push_back(sf::Vector2f());
+    m_positions.push_back(sf::Vector2f());
+    m_rotations.push_back(0.0f);
+    m_scales.push_back(sf::Vector2f(1.0f, 1.0f));
+    m_colors.push_back(sf::Color::White);
+    m_layers.push_back(RenderLayer::WORLD);
+    m_depths.push_back(0.0f);
+    return slot;
+}
+
+void
+SpriteAnimationSystem::remove(uint32_t slot) {
+    uint32_t last = static_cast<uint32_t>(m_owners.size()) - 1;
+    if (slot != last) {
+        m_owners[slot] = m_owners[last];
+        m_atlases[slot] = m_atlases[last];
+        m_clips[slot] = m_clips[last];
+        m_times[slot] = m_times[last];
+        m_steps[slot] = m_steps[last];
+        m_speeds[slot] = m_speeds[last];
+        m_playing[slot] = m_playing[last];
+        m_finished[slot] = m_finished[last];
+        m_frames[slot] = m_frames[last];
+        m_sizes[slot] = m_sizes[last];
+        m_positions[slot] = m_positions[last];
+        m_rotations[slot] = m_rotations[last];
+        m_scales[slot] = m_scales[last];
+        m_colors[slot] = m_colors[last];
+        m_layers[slot] = m_layers[last];
+        m_depths[slot] = m_depths[last];
+        m_owners[slot]->setSlot(slot);
+    }
+    m_owners.pop_back();
+    m_atlases.pop_back();
+    m_clips.pop_back();
+    m_times.pop_back();
+    m_steps.pop_back();
+    m_speeds.pop_back();
+    m_playing.pop_back();
+    m_finished.pop_back();
+    m_frames.pop_back();
+    m_sizes.pop_back();
+    m_positions.pop_back();
+    m_rotations.pop_back();
+    m_scales.pop_back();
+    m_colors.pop_back();
+    m_layers.pop_back();
+    m_depths.pop_back();
+}
+
+void
+SpriteAnimationSystem::play(uint32_t slot, const AnimationClip* clip, bool restart) {
+    // Un clip sin cuadros no tiene qué mostrar; el slot sigue como estaba
+    if (clip == nullptr || clip->frames.empty()) {
+        return;
+    }
+    if (!restart && m_clips[slot] == clip && !m_finished[slot]) {
+        m_playing[slot] = 1;
+        return;
+    }
+    m_clips[slot] = clip;
+    m_times[slot] = 0.0f;
+    m_steps[slot] = -1;
+    m_playing[slot] = 1;
+    m_finished[slot] = 0;
+    m_frames[slot] = clip->frames.front();
+}
+
+void
+SpriteAnimationSystem::setFrame(uint32_t slot, uint16_t frame) {
+    m_clips[slot] = nullptr;
+    m_playing[slot] = 0;
+    m_finished[slot] = 0;
+    m_frames[slot] = std::min<uint16_t>(frame, static_cast<uint16_t>(m_atlases[slot]->getFrameCount() - 1));
+}
+
+void
+SpriteAnimationSystem::update(float deltaTime) {
+    m_events.clear();
+
+    const size_t count = m_owners.size();
+    for (size_t i = 0; i < count; ++i) {
+        const AnimationClip* clip = m_clips[i];
+        if (!m_playing[i] || clip == nullptr) {
+            continue;
+        }
+
+        m_times[i] += deltaTime * m_speeds[i];
+        int32_t step = static_cast<int32_t>(m_times[i] * clip->framesPerSecond);
+        if (step == m_steps[i]) {
+            continue;
+        }
+
+        const int32_t cycle = getCycleLength(*clip);
+        int32_t target = step;
+        if (clip->playback == CLIP_ONCE) {
+            target = std::min(step, cycle - 1);
+        }
+
+        // Eventos de los cuadros mostrados desde el último update; si se saltó más de un
+        // ciclo completo, cada cuadro cuenta una sola vez
+        if (!clip->events.empty()) {
+            for (int32_t s = std::max(m_steps[i] + 1, target - cycle + 1); s <= target; ++s) {
+                uint16_t index = getClipIndex(*clip, s % cycle);
+                for (const auto& marker : clip->events) {
+                    if (marker.first == index) {
+                        SpriteEvent event;
+                        event.animator = m_owners[i];
+                        event.type = SPRITE_EVENT_MARKER;
+                        event.name = &marker.second;
+                        m_events.push_back(event);
+                    }
+                }
+            }
+        }
+
+        if (clip->playback == CLIP_ONCE) {
+            m_steps[i] = target;
+            if (target == cycle - 1) {
+                m_playing[i] = 0;
+                m_finished[i] = 1;
+                SpriteEvent event;
+                event.animator = m_owners[i];
+                event.type = SPRITE_EVENT_FINISHED;
+                event.name = &clip->name;
+                m_events.push_back(event);
+            }
+        }
+        else {
+            // El tiempo se mantiene dentro del ciclo para no perder precisión
+            int32_t cycles = target / cycle;
+            m_steps[i] = target - cycles * cycle;
+            m_times[i] -= static_cast<float>(cycles * cycle) / clip->framesPerSecond;
+        }
+        m_frames[i] = clip->frames[getClipIndex(*clip, m_steps[i])];
+    }
+}
+
+void
+SpriteAnimationSystem::collectBatches(const sf::FloatRect& viewBounds, std::vector<RenderBatch>& out) {
+    m_keys.clear();
+    m_order.clear();
+    m_atlasIds.clear();
+    m_drawnCount = 0;
+
+    // 1. Sprites visibles con su clave (capa, profundidad, atlas); la profundidad va antes que
+    //    el atlas para respetar el orden de dibujo entre atlas distintos
+    const size_t count = m_owners.size();
+    for (size_t i = 0; i < count; ++i) {
+        const sf::IntRect& frame = m_atlases[i]->getFrame(m_frames[i]);
+        sf::Vector2f size = (m_sizes[i].x > 0.0f && m_sizes[i].y > 0.0f)
+            ? m_sizes[i] : sf::Vector2f(static_cast<float>(frame.width), static_cast<float>(frame.height));
+        float radius = 0.5f * std::sqrt(size.x * size.x * m_scales[i].x * m_scales[i].x +
+                                        size.y * size.y * m_scales[i].y * m_scales[i].y);
+        const sf::Vector2f& position = m_positions[i];
+        if (position.x + radius < viewBounds.left || position.x - radius > viewBounds.left + viewBounds.width ||
+            position.y + radius < viewBounds.top || position.y - radius > viewBounds.top + viewBounds.height) {
+            continue;
+        }
+
+        uint16_t atlasId = m_atlasIds.emplace(m_atlases[i], static_cast<uint16_t>(m_atlasIds.size())).first->second;
+        uint64_t depthBits = RenderQueue::makeKey(0, 0, 0, m_depths[i]) & 0xFFFFFFFFu;
+        m_keys.push_back((static_cast<uint64_t>(m_layers[i]) << 56) | (depthBits << 16) | atlasId);
+        m_order.push_back(static_cast<uint32_t>(i));
+    }
+    if (m_keys.empty()) {
+        return;
+    }
+
+    m_tmpKeys.resize(m_keys.size());
+    m_tmpOrder.resize(m_order.size());
+    RenderQueue::radixSort(m_keys.data(), m_order.data(), m_keys.size(), m_tmpKeys.data(), m_tmpOrder.data());
+
+    // 2. Un arreglo de vértices nuevo por grupo; el anterior puede seguir en un snapshot
+    size_t runStart = 0;
+    while (runStart < m_keys.size()) {
+        size_t runEnd = runStart + 1;
+        while (runEnd < m_keys.size() && m_keys[runEnd] == m_keys[runStart]) {
+            ++runEnd;
+        }
+
+        auto vertices = std::make_shared<sf::VertexArray>(sf::Triangles, (runEnd - runStart) * 6);
+        sf::Vertex* vertex = &(*vertices)[0];
+        for (size_t k = runStart; k < runEnd; ++k) {
+            uint32_t i = m_order[k];
+            const sf::IntRect& frame = m_atlases[i]->getFrame(m_frames[i]);
+            sf::Vector2f size = (m_sizes[i].x > 0.0f && m_sizes[i].y > 0.0f)
+                ? m_sizes[i] : sf::Vector2f(static_cast<float>(frame.width), static_cast<float>(frame.height));
+            float halfX = 0.5f * size.x * m_scales[i].x;
+            float halfY = 0.5f * size.y * m_scales[i].y;
+            float c = 1.0f;
+            float s = 0.0f;
+            if (m_rotations[i] != 0.0f) {
+                float angle = m_rotations[i] * DEGREES_TO_RADIANS;
+                c = std::cos(angle);
+                s = std::sin(angle);
+            }
+            const sf::Vector2f& p = m_positions[i];
+
+            // Esquinas: superior izquierda, superior derecha, inferior derecha, inferior izquierda
+            sf::Vector2f corners[4] = {
+                sf::Vector2f(p.x - halfX * c + halfY * s, p.y - halfX * s - halfY * c),
+                sf::Vector2f(p.x + halfX * c + halfY * s, p.y + halfX * s - halfY * c),
+                sf::Vector2f(p.x + halfX * c - halfY * s, p.y + halfX * s + halfY * c),
+                sf::Vector2f(p.x - halfX * c - halfY * s, p.y - halfX * s + halfY * c)
+            };
+            float left = static_cast<float>(frame.left);
+            float top = static_cast<float>(frame.top);
+            float right = left + static_cast<float>(frame.width);
+            float bottom = top + static_cast<float>(frame.height);
+            sf::Vector2f uvs[4] = {
+                sf::Vector2f(left, top), sf::Vector2f(right, top),
+                sf::Vector2f(right, bottom), sf::Vector2f(left, bottom)
+            };
+
+            const int triangles[6] = { 0, 1, 2, 0, 2, 3 };
+            for (int t = 0; t < 6; ++t) {
+                vertex->position = corners[triangles[t]];
+                vertex->texCoords = uvs[triangles[t]];
+                vertex->color = m_colors[i];
+                ++vertex;
+            }
+        }
+
+        uint32_t first = m_order[runStart];
+        RenderBatch batch;
+        batch.vertices = vertices;
+        batch.texture = m_atlases[first]->getTexture();
+        batch.layer = m_layers[first];
+        batch.depth = m_depths[first];
+        out.push_back(batch);
+
+        m_drawnCount += runEnd - runStart;
+        runStart = runEnd;
+    }
+}
+
+int32_t
+SpriteAnimationSystem::getCycleLength(const AnimationClip& clip) {
+    int32_t frames = static_cast<int32_t>(clip.frames.size());
+    if (clip.playback == CLIP_PING_PONG && frames > 1) {
+        return 2 * frames - 2;
+    }
+    return frames;
+}
+
+uint16_t
+SpriteAnimationSystem::getClipIndex(const AnimationClip& clip, int32_t step) {
+    int32_t frames = static_cast<int32_t>(clip.frames.size());
+    if (clip.playback == CLIP_PING_PONG && step >= frames) {
+        return static_cast<uint16_t>(2 * frames - 2 - step);
+    }
+    return static_cast<uint16_t>(std::min(step, frames - 1));
+}
+
+void
+SpriteAnimationSystem::saveState(StateWriter& writer) {
+    writer.writeColumn(m_owners);
+    writer.writeColumn(m_atlases);
+    writer.writeColumn(m_clips);
+    writer.writeColumn(m_times);
+    writer.writeColumn(m_steps);
+    writer.writeColumn(m_speeds);
+    writer.writeColumn(m_playing);
+    writer.writeColumn(m_finished);
+    writer.writeColumn(m_frames);
+    writer.writeColumn(m_sizes);
+    writer.writeColumn(m_positions);
+    writer.writeColumn(m_rotations);
+    writer.writeColumn(m_scales);
+    writer.writeColumn(m_colors);
+    writer.writeColumn(m_layers);
+    writer.writeColumn(m_depths);
+}
+
+bool
+SpriteAnimationSystem::loadState(StateReader& reader) {
+    // Los clips viven en el atlas, que no se mueve mientras el sprite lo use
+    return reader.matchColumn(m_owners) && reader.matchColumn(m_atlases) && reader.readColumn(m_clips) &&
+           reader.readColumn(m_times) && reader.readColumn(m_steps) && reader.readColumn(m_speeds) &&
+           reader.readColumn(m_playing) && reader.readColumn(m_finished) && reader.readColumn(m_frames) &&
+           reader.readColumn(m_sizes) && reader.readColumn(m_positions) && reader.readColumn(m_rotations) &&
+           reader.readColumn(m_scales) && reader.readColumn(m_colors) && reader.readColumn(m_layers) &&
+           reader.readColumn(m_depths);
+}
@@ -0,0 +1,137 @@
+﻿#include "ECS/SpriteAnimator.h"
+#include "ECS/SpriteAnimationSystem.h"
+#include "Services/ResourceManager.h"
+
+SpriteAtlas::SpriteAtlas(const std::string& textureName, const std::string& extension, const sf::Vector2u& frameSize) {
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    NotificationService& notifier = NotificationService::getInstance();
+
+    if (!resourceManager.loadTexture(textureName, extension)) {
+        notifier.addMessage(ConsolErrorType::ERROR, "Can't load sprite atlas: " + textureName);
+    }
+    // Si no cargó, getTexture entrega la textura por defecto y el atlas sigue siendo usable
+    m_texture = resourceManager.getTexture(textureName);
+    if (m_texture.isNull()) {
+        m_frames.push_back(sf::IntRect());
+        return;
+    }
+
+    sf::Vector2u textureSize = m_texture->getTexture().getSize();
+    if (frameSize.x == 0 || frameSize.y == 0 || frameSize.x > textureSize.x || frameSize.y > textureSize.y) {
+        m_frames.push_back(sf::IntRect(0, 0, static_cast<int>(textureSize.x), static_cast<int>(textureSize.y)));
+        return;
+    }
+    for (uint32_t y = 0; y + frameSize.y <= textureSize.y; y += frameSize.y) {
+        for (uint32_t x = 0; x + frameSize.x <= textureSize.x; x += frameSize.x) {
+            m_frames.push_back(sf::IntRect(static_cast<int>(x), static_cast<int>(y),
+                                           static_cast<int>(frameSize.x), static_cast<int>(frameSize.y)));
+        }
+    }
+}
+
+uint16_t
+SpriteAtlas::addFrame(const sf::IntRect& rect) {
+    m_frames.push_back(rect);
+    return static_cast<uint16_t>(m_frames.size() - 1);
+}
+
+void
+SpriteAtlas::addClip(const AnimationClip& clip) {
+    AnimationClip filtered = clip;
+    filtered.frames.erase(std::remove_if(filtered.frames.begin(), filtered.frames.end(),
+                                         [this](uint16_t frame) { return frame >= m_frames.size(); }),
+                          filtered.frames.end());
+    if (filtered.frames.empty()) {
+        NotificationService::getInstance().addMessage(ConsolErrorType::WARNING, "Animation clip without frames: " + clip.name);
+        return;
+    }
+    filtered.framesPerSecond = std::max(filtered.framesPerSecond, 0.001f);
+
+    for (AnimationClip& existing : m_clips) {
+        if (existing.name == filtered.name) {
+            existing = std::move(filtered);
+            return;
+        }
+    }
+    m_clips.push_back(std::move(filtered));
+}
+
+const AnimationClip*
+SpriteAtlas::findClip(const std::string& name) const {
+    for (const AnimationClip& clip : m_clips) {
+        if (clip.name == name) {
+            return &clip;
+        }
+    }
+    return nullptr;
+}
+
+SpriteAnimator::SpriteAnimator(std::shared_ptr<const SpriteAtlas> atlas)
+    : Component(ComponentType::SPRITE),
+      m_atlas(std::move(atlas)) {
+    m_slot = SpriteAnimationSystem::getInstance().add(this, m_atlas.get());
+}
+
+SpriteAnimator::~SpriteAnimator() {
+    SpriteAnimationSystem::getInstance().remove(m_slot);
+}
+
+bool
+SpriteAnimator::play(const std::string& clipName, bool restart) {
+    const AnimationClip* clip = m_atlas->findClip(clipName);
+    if (clip == nullptr || clip->frames.empty()) {
+        return false;
+    }
+    SpriteAnimationSystem::getInstance().play(m_slot, clip, restart);
+    return true;
+}
+
+void
+SpriteAnimator::pause() {
+    SpriteAnimationSystem::getInstance().setPlaying(m_slot, false);
+}
+
+void
+SpriteAnimator::resume() {
+    SpriteAnimationSystem::getInstance().setPlaying(m_slot, true);
+}
+
+void
+SpriteAnimator::setSpeed(float speed) {
+    SpriteAnimationSystem::getInstance().setSpeed(m_slot, speed);
+}
+
+void
+SpriteAnimator::setFrame(uint16_t frame) {
+    SpriteAnimationSystem::getInstance().setFrame(m_slot, frame);
+}
+
+uint16_t
+SpriteAnimator::getFrame() const {
+    return SpriteAnimationSystem::getInstance().getFrame(m_slot);
+}
+
+bool
+SpriteAnimator::isFinished() const {
+    return SpriteAnimationSystem::getInstance().isFinished(m_slot);
+}
+
+void
+SpriteAnimator::setSize(const sf::Vector2f& size) {
+    SpriteAnimationSystem::getInstance().setSize(m_slot, size);
+}
+
+void
+SpriteAnimator::setColor(const sf::Color& color) {
+    SpriteAnimationSystem::getInstance().setColor(m_slot, color);
+}
+
+void
+SpriteAnimator::setTransform(const sf::Vector2f& position, float rotation, const sf::Vector2f& scale) {
+    SpriteAnimationSystem::getInstance().setTransform(m_slot, position, rotation, scale);
+}
+
+void
+SpriteAnimator::setRenderOrder(uint8_t layer, float depth) {
+    SpriteAnimationSystem::getInstance().setRenderOrder(m_slot, layer, depth);
+}
@@ -0,0 +1,351 @@
+﻿#include "ECS/SteeringSystem.h"
+#include "ECS/Steering.h"
+#include "Services/JobSystem.h"
+#include "Services/StateBuffer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GALVAN_STEERING_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const size_t NEIGHBOR_BATCH = 1024;     ///< Agentes por lote en el paso de vecinos.
+    const size_t INTEGRATE_BATCH = 8192;    ///< Agentes por lote en la integración.
+    const float EPSILON = 1e-5f;
+
+    uint32_t
+        xorshift(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+#ifdef GALVAN_STEERING_SSE
+    inline __m128
+        length4(__m128 x, __m128 y) {
+        return _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+    }
+
+    /**
+     * @brief Fuerza para llevar la velocidad hacia dir * speed, con dir sin normalizar.
+     * Si dir es casi cero la fuerza es cero.
+     */
+    inline void
+        steerToward4(__m128 dirX, __m128 dirY, __m128 speed, __m128 velX, __m128 velY,
+                     __m128 weight, __m128& forceX, __m128& forceY) {
+        const __m128 epsilon = _mm_set1_ps(EPSILON);
+        __m128 length = length4(dirX, dirY);
+        __m128 valid = _mm_cmpgt_ps(length, epsilon);
+        __m128 scale = _mm_div_ps(speed, _mm_max_ps(length, epsilon));
+        __m128 steerX = _mm_sub_ps(_mm_mul_ps(dirX, scale), velX);
+        __m128 steerY = _mm_sub_ps(_mm_mul_ps(dirY, scale), velY);
+        forceX = _mm_add_ps(forceX, _mm_and_ps(valid, _mm_mul_ps(weight, steerX)));
+        forceY = _mm_add_ps(forceY, _mm_and_ps(valid, _mm_mul_ps(weight, steerY)));
+    }
+
+    /**
+     * @brief Escala (x, y) para que su longitud no pase de limit.
+     */
+    inline void
+        truncate4(__m128& x, __m128& y, __m128 limit) {
+        const __m128 epsilon = _mm_set1_ps(EPSILON);
+        __m128 length = length4(x, y);
+        __m128 scale = _mm_min_ps(_mm_set1_ps(1.0f), _mm_div_ps(limit, _mm_max_ps(length, epsilon)));
+        x = _mm_mul_ps(x, scale);
+        y = _mm_mul_ps(y, scale);
+    }
+#endif
+
+    inline void
+        steerToward(float dirX, float dirY, float speed, float velX, float velY,
+                    float weight, float& forceX, float& forceY) {
+        float length = std::sqrt(dirX * dirX + dirY * dirY);
+        if (length <= EPSILON) {
+            return;
+        }
+        float scale = speed / length;
+        forceX += weight * (dirX * scale - velX);
+        forceY += weight * (dirY * scale - velY);
+    }
+
+    inline void
+        truncate(float& x, float& y, float limit) {
+        float length = std::sqrt(x * x + y * y);
+        float scale = std::min(1.0f, limit / std::max(length, EPSILON));
+        x *= scale;
+        y *= scale;
+    }
+}
+
+uint32_t
+SteeringSystem::add(Steering* owner, const sf::Vector2f& position, const SteeringWeights& weights) {
+    uint32_t slot = static_cast<uint32_t>(m_owners.size());
+    m_owners.push_back(owner);
+    m_random.push_back((0x9E3779B9u ^ (slot * 2654435761u)) | 1u);
+    m_flowFields.emplace_back();
+    forEachArray([](std::vector<float>& values) { values.push_back(0.0f); });
+    m_posX[slot] = position.x;
+    m_posY[slot] = position.y;
+    m_targetX[slot] = position.x;
+    m_targetY[slot] = position.y;
+    setWeights(slot, weights);
+    return slot;
+}
+
+void
+SteeringSystem::remove(uint32_t slot) {
+    size_t last = m_owners.size() - 1;
+    if (slot != last) {
+        m_owners[slot] = m_owners[last];
+        m_random[slot] = m_random[last];
+        m_flowFields[slot] = std::move(m_flowFields[last]);
+        forEachArray([slot, last](std::vector<float>& values) { values[slot] = values[last]; });
+        m_owners[slot]->setSlot(slot);
+    }
+    m_owners.pop_back();
+    m_random.pop_back();
+    m_flowFields.pop_back();
+    forEachArray([](std::vector<float>& values) { values.pop_back(); });
+}
+
+void
+SteeringSystem::setWeights(uint32_t slot, const SteeringWeights& weights) {
+    m_seek[slot] = weights.seek;
+    m_flee[slot] = weights.flee;
+    m_arrive[slot] = weights.arrive;
+    m_wander[slot] = weights.wander;
+    m_separation[slot] = weights.separation;
+    m_alignment[slot] = weights.alignment;
+    m_cohesion[slot] = weights.cohesion;
+    m_flow[slot] = weights.flow;
+    m_maxSpeed[slot] = weights.maxSpeed;
+    m_maxForce[slot] = weights.maxForce;
+}
+
+SteeringWeights
+SteeringSystem::getWeights(uint32_t slot) const {
+    SteeringWeights weights;
+    weights.seek = m_seek[slot];
+    weights.flee = m_flee[slot];
+    weights.arrive = m_arrive[slot];
+    weights.wander = m_wander[slot];
+    weights.separation = m_separation[slot];
+    weights.alignment = m_alignment[slot];
+    weights.cohesion = m_cohesion[slot];
+    weights.flow = m_flow[slot];
+    weights.maxSpeed = m_maxSpeed[slot];
+    weights.maxForce = m_maxForce[slot];
+    return weights;
+}
+
+void
+SteeringSystem::update(float deltaTime) {
+    size_t count = m_owners.size();
+    if (count == 0) {
+        return;
+    }
+    sf::Clock clock;
+    JobSystem& jobs = JobSystem::getInstance();
+
+    m_grid.build(m_posX.data(), m_posY.data(), count, m_settings.neighborRadius);
+    jobs.parallelFor(count, NEIGHBOR_BATCH, [this, deltaTime](size_t begin, size_t end) {
+        gatherNeighbors(begin, end, deltaTime);
+    });
+    jobs.parallelFor(count, INTEGRATE_BATCH, [this, deltaTime](size_t begin, size_t end) {
+        integrate(begin, end, deltaTime);
+    });
+
+    m_updateTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+void
+SteeringSystem::gatherNeighbors(size_t begin, size_t end, float deltaTime) {
+    const float neighborSquared = m_settings.neighborRadius * m_settings.neighborRadius;
+    const float separationSquared = m_settings.separationRadius * m_settings.separationRadius;
+    const float* posX = m_posX.data();
+    const float* posY = m_posY.data();
+    const float* velX = m_velX.data();
+    const float* velY = m_velY.data();
+    const uint32_t* order = m_grid.getItems().data();
+
+    for (size_t k = begin; k < end; ++k) {
+        uint32_t i = order[k];
+        float px = posX[i];
+        float py = posY[i];
+
+        // Solo se consulta la rejilla si el agente usa algún comportamiento de grupo
+        float separationX = 0.0f, separationY = 0.0f;
+        float sumVelX = 0.0f, sumVelY = 0.0f;
+        float sumPosX = 0.0f, sumPosY = 0.0f;
+        uint32_t neighbors = 0;
+        if (m_separation[i] != 0.0f || m_alignment[i] != 0.0f || m_cohesion[i] != 0.0f) {
+            m_grid.forEachNear(px, py, [&](uint32_t j) {
+                float dx = px - posX[j];
+                float dy = py - posY[j];
+                float distanceSquared = dx * dx + dy * dy;
+                if (j == i || distanceSquared > neighborSquared || distanceSquared <= EPSILON) {
+                    return;
+                }
+                ++neighbors;
+                sumVelX += velX[j];
+                sumVelY += velY[j];
+                sumPosX += posX[j];
+                sumPosY += posY[j];
+                if (distanceSquared < separationSquared) {
+                    separationX += dx / distanceSquared;
+                    separationY += dy / distanceSquared;
+                }
+            });
+        }
+
+        m_separationX[i] = separationX;
+        m_separationY[i] = separationY;
+        if (neighbors > 0) {
+            float inverse = 1.0f / static_cast<float>(neighbors);
+            m_alignX[i] = sumVelX * inverse - velX[i];
+            m_alignY[i] = sumVelY * inverse - velY[i];
+            m_centerX[i] = sumPosX * inverse - px;
+            m_centerY[i] = sumPosY * inverse - py;
+        }
+        else {
+            m_alignX[i] = m_alignY[i] = m_centerX[i] = m_centerY[i] = 0.0f;
+        }
+
+        if (m_wander[i] != 0.0f) {
+            float jitter = static_cast<float>(xorshift(m_random[i]) & 0xFFFF) / 32767.5f - 1.0f;
+            m_wanderAngle[i] += jitter * m_settings.wanderJitter * deltaTime;
+            float speed = std::sqrt(velX[i] * velX[i] + velY[i] * velY[i]);
+            float headingX = speed > EPSILON ? velX[i] / speed : 1.0f;
+            float headingY = speed > EPSILON ? velY[i] / speed : 0.0f;
+            m_wanderX[i] = headingX * m_settings.wanderDistance + std::cos(m_wanderAngle[i]) * m_settings.wanderRadius;
+            m_wanderY[i] = headingY * m_settings.wanderDistance + std::sin(m_wanderAngle[i]) * m_settings.wanderRadius;
+        }
+        else {
+            m_wanderX[i] = m_wanderY[i] = 0.0f;
+        }
+
+        if (m_flow[i] != 0.0f && m_flowFields[i]) {
+            sf::Vector2f direction = m_flowFields[i]->sample(sf::Vector2f(px, py));
+            m_flowX[i] = direction.x;
+            m_flowY[i] = direction.y;
+        }
+        else {
+            m_flowX[i] = m_flowY[i] = 0.0f;
+        }
+    }
+}
+
+void
+SteeringSystem::integrate(size_t begin, size_t end, float deltaTime) {
+    float* posX = m_posX.data();
+    float* posY = m_posY.data();
+    float* velX = m_velX.data();
+    float* velY = m_velY.data();
+    const float slowingRadius = std::max(m_settings.slowingRadius, EPSILON);
+
+    size_t i = begin;
+#ifdef GALVAN_STEERING_SSE
+    const __m128 dt4 = _mm_set1_ps(deltaTime);
+    const __m128 one4 = _mm_set1_ps(1.0f);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 inverseSlowing4 = _mm_set1_ps(1.0f / slowingRadius);
+    const __m128 panic4 = _mm_set1_ps(m_settings.panicRadius);
+    for (; i + 4 <= end; i += 4) {
+        __m128 px = _mm_loadu_ps(posX + i);
+        __m128 py = _mm_loadu_ps(posY + i);
+        __m128 vx = _mm_loadu_ps(velX + i);
+        __m128 vy = _mm_loadu_ps(velY + i);
+        __m128 maxSpeed = _mm_loadu_ps(m_maxSpeed.data() + i);
+        __m128 fx = zero4;
+        __m128 fy = zero4;
+
+        __m128 toTargetX = _mm_sub_ps(_mm_loadu_ps(m_targetX.data() + i), px);
+        __m128 toTargetY = _mm_sub_ps(_mm_loadu_ps(m_targetY.data() + i), py);
+        __m128 distance = length4(toTargetX, toTargetY);
+
+        steerToward4(toTargetX, toTargetY, maxSpeed, vx, vy, _mm_loadu_ps(m_seek.data() + i), fx, fy);
+
+        __m128 fleeWeight = _mm_and_ps(_mm_cmplt_ps(distance, panic4), _mm_loadu_ps(m_flee.data() + i));
+        steerToward4(_mm_sub_ps(zero4, toTargetX), _mm_sub_ps(zero4, toTargetY), maxSpeed, vx, vy, fleeWeight, fx, fy);
+
+        __m128 arriveSpeed = _mm_mul_ps(maxSpeed, _mm_min_ps(one4, _mm_mul_ps(distance, inverseSlowing4)));
+        steerToward4(toTargetX, toTargetY, arriveSpeed, vx, vy, _mm_loadu_ps(m_arrive.data() + i), fx, fy);
+
+        steerToward4(_mm_loadu_ps(m_wanderX.data() + i), _mm_loadu_ps(m_wanderY.data() + i), maxSpeed, vx, vy,
+                     _mm_loadu_ps(m_wander.data() + i), fx, fy);
+        steerToward4(_mm_loadu_ps(m_separationX.data() + i), _mm_loadu_ps(m_separationY.data() + i), maxSpeed, vx, vy,
+                     _mm_loadu_ps(m_separation.data() + i), fx, fy);
+        steerToward4(_mm_loadu_ps(m_centerX.data() + i), _mm_loadu_ps(m_centerY.data() + i), maxSpeed, vx, vy,
+                     _mm_loadu_ps(m_cohesion.data() + i), fx, fy);
+        steerToward4(_mm_loadu_ps(m_flowX.data() + i), _mm_loadu_ps(m_flowY.data() + i), maxSpeed, vx, vy,
+                     _mm_loadu_ps(m_flow.data() + i), fx, fy);
+
+        __m128 alignment = _mm_loadu_ps(m_alignment.data() + i);
+        fx = _mm_add_ps(fx, _mm_mul_ps(alignment, _mm_loadu_ps(m_alignX.data() + i)));
+        fy = _mm_add_ps(fy, _mm_mul_ps(alignment, _mm_loadu_ps(m_alignY.data() + i)));
+
+        truncate4(fx, fy, _mm_loadu_ps(m_maxForce.data() + i));
+        vx = _mm_add_ps(vx, _mm_mul_ps(fx, dt4));
+        vy = _mm_add_ps(vy, _mm_mul_ps(fy, dt4));
+        truncate4(vx, vy, maxSpeed);
+
+        _mm_storeu_ps(velX + i, vx);
+        _mm_storeu_ps(velY + i, vy);
+        _mm_storeu_ps(posX + i, _mm_add_ps(px, _mm_mul_ps(vx, dt4)));
+        _mm_storeu_ps(posY + i, _mm_add_ps(py, _mm_mul_ps(vy, dt4)));
+    }
+#endif
+    for (; i < end; ++i) {
+        float vx = velX[i];
+        float vy = velY[i];
+        float maxSpeed = m_maxSpeed[i];
+        float fx = 0.0f;
+        float fy = 0.0f;
+
+        float toTargetX = m_targetX[i] - posX[i];
+        float toTargetY = m_targetY[i] - posY[i];
+        float distance = std::sqrt(toTargetX * toTargetX + toTargetY * toTargetY);
+
+        steerToward(toTargetX, toTargetY, maxSpeed, vx, vy, m_seek[i], fx, fy);
+        if (distance < m_settings.panicRadius) {
+            steerToward(-toTargetX, -toTargetY, maxSpeed, vx, vy, m_flee[i], fx, fy);
+        }
+        steerToward(toTargetX, toTargetY, maxSpeed * std::min(1.0f, distance / slowingRadius), vx, vy, m_arrive[i], fx, fy);
+        steerToward(m_wanderX[i], m_wanderY[i], maxSpeed, vx, vy, m_wander[i], fx, fy);
+        steerToward(m_separationX[i], m_separationY[i], maxSpeed, vx, vy, m_separation[i], fx, fy);
+        steerToward(m_centerX[i], m_centerY[i], maxSpeed, vx, vy, m_cohesion[i], fx, fy);
+        steerToward(m_flowX[i], m_flowY[i], maxSpeed, vx, vy, m_flow[i], fx, fy);
+        fx += m_alignment[i] * m_alignX[i];
+        fy += m_alignment[i] * m_alignY[i];
+
+        truncate(fx, fy, m_maxForce[i]);
+        vx += fx * deltaTime;
+        vy += fy * deltaTime;
+        truncate(vx, vy, maxSpeed);
+
+        velX[i] = vx;
+        velY[i] = vy;
+        posX[i] += vx * deltaTime;
+        posY[i] += vy * deltaTime;
+    }
+}
+
+void
+SteeringSystem::saveState(StateWriter& writer) {
+    writer.writeColumn(m_owners);
+    writer.writeColumn(m_random);
+    forEachStateArray([&writer](std::vector<float>& column) { writer.writeColumn(column); });
+}
+
+bool
+SteeringSystem::loadState(StateReader& reader) {
+    if (!reader.matchColumn(m_owners) || !reader.readColumn(m_random)) {
+        return false;
+    }
+    bool matches = true;
+    forEachStateArray([&reader, &matches](std::vector<float>& column) {
+        matches = matches && reader.readColumn(column);
+    });
+    return matches;
+}
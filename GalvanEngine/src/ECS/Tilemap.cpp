@@ -0,0 +1,242 @@
+﻿#include "ECS/Tilemap.h"
+#include "Services/ResourceManager.h"
+
+Tilemap::Tilemap(uint32_t width, uint32_t height) : Component(ComponentType::TILEMAP) {
+    resize(width, height);
+    addLayer();
+}
+
+void
+Tilemap::resize(uint32_t width, uint32_t height) {
+    m_width = width;
+    m_height = height;
+    m_chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    m_chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    for (Layer& layer : m_layers) {
+        layer.tiles.assign(static_cast<size_t>(width) * height, EMPTY_TILE);
+        layer.chunks.assign(static_cast<size_t>(m_chunksX) * m_chunksY, Chunk());
+    }
+    m_cachedChunks = 0;
+}
+
+bool
+Tilemap::setTileset(const std::string& fileName,
+                    const std::string& extension,
+                    uint32_t tileWidth,
+                    uint32_t tileHeight) {
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    NotificationService& notifier = NotificationService::getInstance();
+
+    if (tileWidth == 0 || tileHeight == 0) {
+        notifier.addMessage(ConsolErrorType::ERROR, "Invalid tile size for tileset: " + fileName);
+        return false;
+    }
+    if (!resourceManager.loadTexture(fileName, extension)) {
+        notifier.addMessage(ConsolErrorType::ERROR, "Can't load tileset: " + fileName);
+        return false;
+    }
+
+    m_tileset = resourceManager.getTexture(fileName);
+    if (m_tileset.isNull()) {
+        m_tilesetTexture = nullptr;
+        return false;
+    }
+    m_tilesetTexture = &m_tileset->getTexture();
+    m_tileWidth = tileWidth;
+    m_tileHeight = tileHeight;
+    m_tilesetColumns = std::max(1u, m_tilesetTexture->getSize().x / tileWidth);
+
+    // Las coordenadas de textura dependen del tileset, toda la geometría queda obsoleta
+    invalidateChunks();
+    return true;
+}
+
+uint32_t
+Tilemap::addLayer() {
+    Layer layer;
+    layer.tiles.assign(static_cast<size_t>(m_width) * m_height, EMPTY_TILE);
+    layer.chunks.resize(static_cast<size_t>(m_chunksX) * m_chunksY);
+    m_layers.push_back(std::move(layer));
+    return static_cast<uint32_t>(m_layers.size() - 1);
+}
+
+void
+Tilemap::setTile(uint32_t layer, uint32_t x, uint32_t y, uint16_t tile) {
+    if (layer >= m_layers.size() || x >= m_width || y >= m_height) {
+        return;
+    }
+    uint16_t& current = m_layers[layer].tiles[static_cast<size_t>(y) * m_width + x];
+    if (current == tile) {
+        return;
+    }
+    current = tile;
+    m_layers[layer].chunks[(y / CHUNK_SIZE) * m_chunksX + (x / CHUNK_SIZE)].dirty = true;
+}
+
+uint16_t
+Tilemap::getTile(uint32_t layer, uint32_t x, uint32_t y) const {
+    if (layer >= m_layers.size() || x >= m_width || y >= m_height) {
+        return EMPTY_TILE;
+    }
+    return m_layers[layer].tiles[static_cast<size_t>(y) * m_width + x];
+}
+
+void
+Tilemap::fill(uint32_t layer, uint16_t tile) {
+    if (layer >= m_layers.size()) {
+        return;
+    }
+    std::fill(m_layers[layer].tiles.begin(), m_layers[layer].tiles.end(), tile);
+    for (Chunk& chunk : m_layers[layer].chunks) {
+        chunk.dirty = true;
+    }
+}
+
+void
+Tilemap::collectVisible(const sf::FloatRect& viewBounds,
+                        const sf::Transform& transform,
+                        uint8_t renderLayer,
+                        float depth,
+                        std::vector<RenderBatch>& out) {
+    ++m_frame;
+    if (m_tilesetTexture == nullptr || m_chunksX == 0 || m_chunksY == 0) {
+        return;
+    }
+
+    // Lleva el área visible al espacio local del mapa y la convierte en un rango de bloques
+    sf::FloatRect local = transform.getInverse().transformRect(viewBounds);
+    float chunkWidth = static_cast<float>(m_tileWidth * CHUNK_SIZE);
+    float chunkHeight = static_cast<float>(m_tileHeight * CHUNK_SIZE);
+    int firstX = static_cast<int>(std::floor(local.left / chunkWidth));
+    int firstY = static_cast<int>(std::floor(local.top / chunkHeight));
+    int lastX = static_cast<int>(std::floor((local.left + local.width) / chunkWidth));
+    int lastY = static_cast<int>(std::floor((local.top + local.height) / chunkHeight));
+
+    firstX = std::max(firstX, 0);
+    firstY = std::max(firstY, 0);
+    lastX = std::min(lastX, static_cast<int>(m_chunksX) - 1);
+    lastY = std::min(lastY, static_cast<int>(m_chunksY) - 1);
+    if (firstX > lastX || firstY > lastY) {
+        return;
+    }
+
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        Layer& layer = m_layers[l];
+        for (int cy = firstY; cy <= lastY; ++cy) {
+            for (int cx = firstX; cx <= lastX; ++cx) {
+                Chunk& chunk = layer.chunks[static_cast<size_t>(cy) * m_chunksX + cx];
+                if (chunk.dirty || !chunk.vertices) {
+                    buildChunk(layer, static_cast<uint32_t>(cx), static_cast<uint32_t>(cy), chunk);
+                }
+                chunk.lastUsedFrame = m_frame;
+                if (chunk.vertices->getVertexCount() == 0) {
+                    continue;
+                }
+
+                RenderBatch batch;
+                batch.vertices = chunk.vertices;
+                batch.texture = m_tilesetTexture;
+                batch.transform = transform;
+                batch.layer = renderLayer;
+                batch.depth = depth + static_cast<float>(l);
+                out.push_back(std::move(batch));
+            }
+        }
+    }
+
+    evictChunks();
+}
+
+void
+Tilemap::buildChunk(const Layer& layer, uint32_t chunkX, uint32_t chunkY, Chunk& chunk) {
+    uint32_t beginX = chunkX * CHUNK_SIZE;
+    uint32_t beginY = chunkY * CHUNK_SIZE;
+    uint32_t endX = std::min(beginX + CHUNK_SIZE, m_width);
+    uint32_t endY = std::min(beginY + CHUNK_SIZE, m_height);
+
+    size_t tileCount = 0;
+    for (uint32_t y = beginY; y < endY; ++y) {
+        const uint16_t* row = &layer.tiles[static_cast<size_t>(y) * m_width];
+        for (uint32_t x = beginX; x < endX; ++x) {
+            tileCount += row[x] != EMPTY_TILE;
+        }
+    }
+
+    // Siempre se crea un arreglo nuevo; el anterior sigue vivo mientras un snapshot lo use
+    auto vertices = std::make_shared<sf::VertexArray>(sf::Triangles, tileCount * 6);
+    float tileWidth = static_cast<float>(m_tileWidth);
+    float tileHeight = static_cast<float>(m_tileHeight);
+    size_t v = 0;
+    for (uint32_t y = beginY; y < endY; ++y) {
+        const uint16_t* row = &layer.tiles[static_cast<size_t>(y) * m_width];
+        for (uint32_t x = beginX; x < endX; ++x) {
+            uint16_t tile = row[x];
+            if (tile == EMPTY_TILE) {
+                continue;
+            }
+            uint32_t index = static_cast<uint32_t>(tile) - 1;
+            float u = static_cast<float>((index % m_tilesetColumns) * m_tileWidth);
+            float t = static_cast<float>((index / m_tilesetColumns) * m_tileHeight);
+            float px = x * tileWidth;
+            float py = y * tileHeight;
+
+            sf::Vertex* quad = &(*vertices)[v];
+            quad[0] = sf::Vertex(sf::Vector2f(px, py), sf::Vector2f(u, t));
+            quad[1] = sf::Vertex(sf::Vector2f(px + tileWidth, py), sf::Vector2f(u + tileWidth, t));
+            quad[2] = sf::Vertex(sf::Vector2f(px, py + tileHeight), sf::Vector2f(u, t + tileHeight));
+            quad[3] = quad[2];
+            quad[4] = quad[1];
+            quad[5] = sf::Vertex(sf::Vector2f(px + tileWidth, py + tileHeight),
+                                 sf::Vector2f(u + tileWidth, t + tileHeight));
+            v += 6;
+        }
+    }
+
+    if (!chunk.vertices) {
+        ++m_cachedChunks;
+    }
+    chunk.vertices = std::move(vertices);
+    chunk.dirty = false;
+    ++m_chunkRebuilds;
+}
+
+void
+Tilemap::evictChunks() {
+    if (m_cachedChunks <= m_maxCachedChunks) {
+        return;
+    }
+
+    // Libera los bloques más antiguos hasta volver a tres cuartos del límite, así la
+    // búsqueda no se repite cada frame al desplazar la cámara
+    std::vector<Chunk*> candidates;
+    candidates.reserve(m_cachedChunks);
+    for (Layer& layer : m_layers) {
+        for (Chunk& chunk : layer.chunks) {
+            if (chunk.vertices && chunk.lastUsedFrame != m_frame) {
+                candidates.push_back(&chunk);
+            }
+        }
+    }
+
+    uint32_t target = m_maxCachedChunks - m_maxCachedChunks / 4;
+    size_t toRemove = std::min<size_t>(candidates.size(), m_cachedChunks - target);
+    std::nth_element(candidates.begin(), candidates.begin() + toRemove, candidates.end(),
+        [](const Chunk* a, const Chunk* b) {
+            return a->lastUsedFrame < b->lastUsedFrame;
+        });
+    for (size_t i = 0; i < toRemove; ++i) {
+        candidates[i]->vertices.reset();
+        candidates[i]->dirty = true;
+    }
+    m_cachedChunks -= static_cast<uint32_t>(toRemove);
+}
+
+void
+Tilemap::invalidateChunks() {
+    for (Layer& layer : m_layers) {
+        for (Chunk& chunk : layer.chunks) {
+            chunk.dirty = true;
+        }
+    }
+}
@@ -0,0 +1,369 @@
+﻿#include "ECS/TweenSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GALVAN_TWEEN_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const float HALF_PI = 0.5f * PI;
+    const float MIN_DURATION = 1e-4f;
+
+    inline uint8_t
+        toChannel(float value) {
+        return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value + 0.5f)));
+    }
+}
+
+TweenHandle
+TweenSystem::tweenPosition(EngineUtilities::TSharedPointer<Transform> target,
+                           const sf::Vector2f& to,
+                           float duration,
+                           EaseType ease) {
+    if (target.isNull()) {
+        return TweenHandle();
+    }
+    sf::Vector2f from = target->getPosition();
+    const float fromValues[CHANNELS] = { from.x, from.y, 0.0f, 0.0f };
+    const float toValues[CHANNELS] = { to.x, to.y, 0.0f, 0.0f };
+    TweenHandle handle = add(TWEEN_POSITION, fromValues, toValues, duration, ease);
+    m_transforms.back() = target;
+    return handle;
+}
+
+TweenHandle
+TweenSystem::tweenRotation(EngineUtilities::TSharedPointer<Transform> target,
+                           const sf::Vector2f& to,
+                           float duration,
+                           EaseType ease) {
+    if (target.isNull()) {
+        return TweenHandle();
+    }
+    sf::Vector2f from = target->getRotation();
+    const float fromValues[CHANNELS] = { from.x, from.y, 0.0f, 0.0f };
+    const float toValues[CHANNELS] = { to.x, to.y, 0.0f, 0.0f };
+    TweenHandle handle = add(TWEEN_ROTATION, fromValues, toValues, duration, ease);
+    m_transforms.back() = target;
+    return handle;
+}
+
+TweenHandle
+TweenSystem::tweenScale(EngineUtilities::TSharedPointer<Transform> target,
+                        const sf::Vector2f& to,
+                        float duration,
+                        EaseType ease) {
+    if (target.isNull()) {
+        return TweenHandle();
+    }
+    sf::Vector2f from = target->getScale();
+    const float fromValues[CHANNELS] = { from.x, from.y, 0.0f, 0.0f };
+    const float toValues[CHANNELS] = { to.x, to.y, 0.0f, 0.0f };
+    TweenHandle handle = add(TWEEN_SCALE, fromValues, toValues, duration, ease);
+    m_transforms.back() = target;
+    return handle;
+}
+
+TweenHandle
+TweenSystem::tweenFillColor(EngineUtilities::TSharedPointer<ShapeFactory> target,
+                            const sf::Color& to,
+                            float duration,
+                            EaseType ease) {
+    if (target.isNull() || target->getShape() == nullptr) {
+        return TweenHandle();
+    }
+    sf::Color from = target->getShape()->getFillColor();
+    const float fromValues[CHANNELS] = { static_cast<float>(from.r), static_cast<float>(from.g),
+                                         static_cast<float>(from.b), static_cast<float>(from.a) };
+    const float toValues[CHANNELS] = { static_cast<float>(to.r), static_cast<float>(to.g),
+                                       static_cast<float>(to.b), static_cast<float>(to.a) };
+    TweenHandle handle = add(TWEEN_FILL_COLOR, fromValues, toValues, duration, ease);
+    m_shapes.back() = target;
+    return handle;
+}
+
+void
+TweenSystem::setLoop(TweenHandle handle, TweenLoop loop, uint32_t count) {
+    if (!isActive(handle)) {
+        return;
+    }
+    uint32_t slot = m_handles[handle.index].slot;
+    m_loop[slot] = static_cast<uint8_t>(loop);
+    m_loopCount[slot] = count;
+}
+
+void
+TweenSystem::setDelay(TweenHandle handle, float seconds) {
+    if (!isActive(handle)) {
+        return;
+    }
+    uint32_t slot = m_handles[handle.index].slot;
+    m_delay[slot] = std::max(0.0f, seconds);
+}
+
+void
+TweenSystem::setOnComplete(TweenHandle handle, std::function<void(TweenHandle)> callback) {
+    if (!isActive(handle)) {
+        return;
+    }
+    m_callbacks[m_handles[handle.index].slot] = std::move(callback);
+}
+
+void
+TweenSystem::cancel(TweenHandle handle) {
+    if (!isActive(handle)) {
+        return;
+    }
+    removeSlot(m_handles[handle.index].slot);
+}
+
+void
+TweenSystem::update(float deltaTime) {
+    sf::Clock clock;
+    m_completed.clear();
+
+    advance(deltaTime);
+    interpolate();
+    apply();
+
+    // De atrás hacia adelante, así el swap-remove no mueve un tween terminado que falte por quitar
+    for (auto it = m_finishedSlots.rbegin(); it != m_finishedSlots.rend(); ++it) {
+        uint32_t slot = *it;
+        TweenEvent event;
+        event.handle.index = m_handleOfSlot[slot];
+        event.handle.generation = m_handles[event.handle.index].generation;
+        event.property = static_cast<TweenProperty>(m_property[slot]);
+        m_completed.push_back(event);
+        if (m_callbacks[slot]) {
+            m_pendingCallbacks.emplace_back(event.handle, std::move(m_callbacks[slot]));
+        }
+        removeSlot(slot);
+    }
+    m_finishedSlots.clear();
+
+    for (auto& pending : m_pendingCallbacks) {
+        pending.second(pending.first);
+    }
+    m_pendingCallbacks.clear();
+
+    m_updateTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+float
+TweenSystem::ease(EaseType type, float t) {
+    switch (type) {
+    case EASE_IN_QUAD:
+        return t * t;
+    case EASE_OUT_QUAD:
+        return t * (2.0f - t);
+    case EASE_IN_OUT_QUAD:
+        return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * (1.0f - t) * (1.0f - t);
+    case EASE_IN_CUBIC:
+        return t * t * t;
+    case EASE_OUT_CUBIC: {
+        float u = 1.0f - t;
+        return 1.0f - u * u * u;
+    }
+    case EASE_IN_OUT_CUBIC: {
+        float u = 1.0f - t;
+        return t < 0.5f ? 4.0f * t * t * t : 1.0f - 4.0f * u * u * u;
+    }
+    case EASE_IN_SINE:
+        return 1.0f - std::cos(t * HALF_PI);
+    case EASE_OUT_SINE:
+        return std::sin(t * HALF_PI);
+    case EASE_IN_OUT_SINE:
+        return 0.5f - 0.5f * std::cos(t * PI);
+    case EASE_OUT_BACK: {
+        const float overshoot = 1.70158f;
+        float u = t - 1.0f;
+        return 1.0f + u * u * ((overshoot + 1.0f) * u + overshoot);
+    }
+    case EASE_OUT_BOUNCE: {
+        const float n = 7.5625f;
+        const float d = 2.75f;
+        if (t < 1.0f / d) {
+            return n * t * t;
+        }
+        if (t < 2.0f / d) {
+            t -= 1.5f / d;
+            return n * t * t + 0.75f;
+        }
+        if (t < 2.5f / d) {
+            t -= 2.25f / d;
+            return n * t * t + 0.9375f;
+        }
+        t -= 2.625f / d;
+        return n * t * t + 0.984375f;
+    }
+    case EASE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+TweenHandle
+TweenSystem::add(TweenProperty property, const float from[CHANNELS], const float to[CHANNELS], float duration, EaseType ease) {
+    uint32_t index;
+    if (!m_freeHandles.empty()) {
+        index = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(m_handles.size());
+        m_handles.emplace_back();
+    }
+    uint32_t slot = static_cast<uint32_t>(m_handleOfSlot.size());
+    m_handles[index].slot = slot;
+
+    m_handleOfSlot.push_back(index);
+    m_transforms.emplace_back();
+    m_shapes.emplace_back();
+    m_callbacks.emplace_back();
+    for (uint32_t c = 0; c < CHANNELS; ++c) {
+        m_from[c].push_back(from[c]);
+        m_delta[c].push_back(to[c] - from[c]);
+        m_value[c].push_back(from[c]);
+    }
+    m_time.push_back(0.0f);
+    m_delay.push_back(0.0f);
+    m_inverseDuration.push_back(1.0f / std::max(duration, MIN_DURATION));
+    m_eased.push_back(0.0f);
+    m_loopCount.push_back(0);
+    m_ease.push_back(static_cast<uint8_t>(ease));
+    m_property.push_back(static_cast<uint8_t>(property));
+    m_loop.push_back(TWEEN_ONCE);
+
+    TweenHandle handle;
+    handle.index = index;
+    handle.generation = m_handles[index].generation;
+    return handle;
+}
+
+void
+TweenSystem::removeSlot(uint32_t slot) {
+    uint32_t last = static_cast<uint32_t>(m_handleOfSlot.size() - 1);
+    uint32_t index = m_handleOfSlot[slot];
+    m_handles[index].slot = INVALID_SLOT;
+    ++m_handles[index].generation;
+    m_freeHandles.push_back(index);
+
+    if (slot != last) {
+        m_handleOfSlot[slot] = m_handleOfSlot[last];
+        m_handles[m_handleOfSlot[slot]].slot = slot;
+        m_transforms[slot] = m_transforms[last];
+        m_shapes[slot] = m_shapes[last];
+        m_callbacks[slot] = std::move(m_callbacks[last]);
+        for (uint32_t c = 0; c < CHANNELS; ++c) {
+            m_from[c][slot] = m_from[c][last];
+            m_delta[c][slot] = m_delta[c][last];
+            m_value[c][slot] = m_value[c][last];
+        }
+        m_time[slot] = m_time[last];
+        m_delay[slot] = m_delay[last];
+        m_inverseDuration[slot] = m_inverseDuration[last];
+        m_eased[slot] = m_eased[last];
+        m_loopCount[slot] = m_loopCount[last];
+        m_ease[slot] = m_ease[last];
+        m_property[slot] = m_property[last];
+        m_loop[slot] = m_loop[last];
+    }
+
+    m_handleOfSlot.pop_back();
+    m_transforms.pop_back();
+    m_shapes.pop_back();
+    m_callbacks.pop_back();
+    for (uint32_t c = 0; c < CHANNELS; ++c) {
+        m_from[c].pop_back();
+        m_delta[c].pop_back();
+        m_value[c].pop_back();
+    }
+    m_time.pop_back();
+    m_delay.pop_back();
+    m_inverseDuration.pop_back();
+    m_eased.pop_back();
+    m_loopCount.pop_back();
+    m_ease.pop_back();
+    m_property.pop_back();
+    m_loop.pop_back();
+}
+
+void
+TweenSystem::advance(float deltaTime) {
+    const size_t count = m_handleOfSlot.size();
+    for (size_t i = 0; i < count; ++i) {
+        m_time[i] += deltaTime;
+        float local = m_time[i] - m_delay[i];
+        if (local < 0.0f) {
+            m_eased[i] = 0.0f;
+            continue;
+        }
+
+        float cycles = local * m_inverseDuration[i];
+        float t = cycles;
+        if (cycles >= 1.0f) {
+            uint32_t completed = static_cast<uint32_t>(cycles);
+            if (m_loop[i] == TWEEN_ONCE || (m_loopCount[i] != 0 && completed >= m_loopCount[i])) {
+                // Termina exactamente en el valor final del último ciclo
+                uint32_t lastCycle = m_loop[i] == TWEEN_ONCE ? 1 : m_loopCount[i];
+                t = (m_loop[i] == TWEEN_PING_PONG && (lastCycle & 1) == 0) ? 0.0f : 1.0f;
+                m_finishedSlots.push_back(static_cast<uint32_t>(i));
+            }
+            else {
+                t = cycles - static_cast<float>(completed);
+                if (m_loop[i] == TWEEN_PING_PONG && (completed & 1) != 0) {
+                    t = 1.0f - t;
+                }
+            }
+        }
+        m_eased[i] = ease(static_cast<EaseType>(m_ease[i]), t);
+    }
+}
+
+void
+TweenSystem::interpolate() {
+    const size_t count = m_handleOfSlot.size();
+    const float* eased = m_eased.data();
+    for (uint32_t c = 0; c < CHANNELS; ++c) {
+        const float* from = m_from[c].data();
+        const float* delta = m_delta[c].data();
+        float* value = m_value[c].data();
+        size_t i = 0;
+#ifdef GALVAN_TWEEN_SSE
+        for (; i + 4 <= count; i += 4) {
+            __m128 result = _mm_add_ps(_mm_loadu_ps(from + i), _mm_mul_ps(_mm_loadu_ps(delta + i), _mm_loadu_ps(eased + i)));
+            _mm_storeu_ps(value + i, result);
+        }
+#endif
+        for (; i < count; ++i) {
+            value[i] = from[i] + delta[i] * eased[i];
+        }
+    }
+}
+
+void
+TweenSystem::apply() {
+    const size_t count = m_handleOfSlot.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (m_time[i] < m_delay[i]) {
+            continue;
+        }
+        sf::Vector2f value(m_value[0][i], m_value[1][i]);
+        switch (m_property[i]) {
+        case TWEEN_POSITION:
+            m_transforms[i]->setPosition(value);
+            break;
+        case TWEEN_ROTATION:
+            m_transforms[i]->setRotation(value);
+            break;
+        case TWEEN_SCALE:
+            m_transforms[i]->setScale(value);
+            break;
+        case TWEEN_FILL_COLOR:
+            m_shapes[i]->setFillColor(sf::Color(toChannel(m_value[0][i]), toChannel(m_value[1][i]),
+                                                toChannel(m_value[2][i]), toChannel(m_value[3][i])));
+            break;
+        default:
+            break;
+        }
+    }
+}
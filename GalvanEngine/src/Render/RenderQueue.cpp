@@ -0,0 +1,172 @@
+﻿#include "Render/RenderQueue.h"
+#include "Window.h"
+
+uint64_t
+RenderQueue::makeKey(uint8_t layer, uint16_t textureId, uint8_t material, float depth) {
+    // Convierte el float a un entero cuyo orden sin signo coincide con el orden del float
+    uint32_t depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    depthBits = (depthBits & 0x80000000u) ? ~depthBits : (depthBits | 0x80000000u);
+
+    return (static_cast<uint64_t>(layer) << 56) |
+           (static_cast<uint64_t>(textureId) << 40) |
+           (static_cast<uint64_t>(material) << 32) |
+           static_cast<uint64_t>(depthBits);
+}
+
+uint16_t
+RenderQueue::getTextureId(const sf::Texture* texture) {
+    if (texture == nullptr) {
+        return 0;
+    }
+
+    auto it = m_textureIds.find(texture);
+    if (it != m_textureIds.end()) {
+        return it->second;
+    }
+
+    // Los identificadores empiezan en 1; al agotar los 16 bits se comparte el último
+    uint16_t id = static_cast<uint16_t>(std::min<size_t>(m_textureIds.size() + 1, 0xFFFF));
+    m_textureIds[texture] = id;
+    return id;
+}
+
+void
+RenderQueue::clear() {
+    m_commands.clear();
+    m_keys.clear();
+    m_payload.clear();
+}
+
+void
+RenderQueue::push(uint64_t key, const sf::Drawable& drawable, const sf::RenderStates& states) {
+    m_payload.push_back(static_cast<uint32_t>(m_commands.size()));
+    m_keys.push_back(key);
+    m_commands.push_back({ &drawable, states });
+}
+
+void
+RenderQueue::pushShape(const sf::Shape& shape, uint8_t layer, float depth, uint8_t material) {
+    push(makeKey(layer, getTextureId(shape.getTexture()), material, depth), shape);
+}
+
+void
+RenderQueue::pushBatch(const RenderBatch& batch, uint8_t material) {
+    if (!batch.vertices || batch.vertices->getVertexCount() == 0) {
+        return;
+    }
+    sf::RenderStates states(batch.transform);
+    states.texture = batch.texture;
+    push(makeKey(batch.layer, getTextureId(batch.texture), material, batch.depth), *batch.vertices, states);
+}
+
+void
+RenderQueue::sort() {
+    sf::Clock sortClock;
+    size_t count = m_keys.size();
+
+    // Conteo de cambios de estado con el orden de inserción, antes de ordenar
+    m_stats.stateChangesUnsorted = countStateChanges(m_keys.data(), count);
+
+    if (m_tmpKeys.size() < count) {
+        m_tmpKeys.resize(count);
+        m_tmpPayload.resize(count);
+    }
+    radixSort(m_keys.data(), m_payload.data(), count, m_tmpKeys.data(), m_tmpPayload.data());
+
+    m_stats.commands = static_cast<unsigned int>(count);
+    m_stats.stateChanges = countStateChanges(m_keys.data(), count);
+    m_stats.stateChangesAvoided = m_stats.stateChangesUnsorted > m_stats.stateChanges ?
+                                  m_stats.stateChangesUnsorted - m_stats.stateChanges : 0;
+    m_stats.sortTimeMs = sortClock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+void
+RenderQueue::submit(Window& window) {
+    for (uint32_t index : m_payload) {
+        const Command& command = m_commands[index];
+        window.draw(*command.drawable, command.states);
+    }
+}
+
+void
+RenderQueue::submit(sf::RenderTarget& target) {
+    for (uint32_t index : m_payload) {
+        const Command& command = m_commands[index];
+        target.draw(*command.drawable, command.states);
+    }
+}
+
+void
+RenderQueue::radixSort(uint64_t* keys,
+                       uint32_t* payload,
+                       size_t count,
+                       uint64_t* tmpKeys,
+                       uint32_t* tmpPayload) {
+    if (count < 2) {
+        return;
+    }
+
+    // Histogramas de los 8 bytes en un solo recorrido
+    uint32_t histograms[8][256] = {};
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = keys[i];
+        for (int pass = 0; pass < 8; ++pass) {
+            ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    uint64_t* srcKeys = keys;
+    uint32_t* srcPayload = payload;
+    uint64_t* dstKeys = tmpKeys;
+    uint32_t* dstPayload = tmpPayload;
+
+    for (int pass = 0; pass < 8; ++pass) {
+        uint32_t* histogram = histograms[pass];
+        int shift = pass * 8;
+
+        // Si todas las claves comparten este byte el pase no cambia nada
+        if (histogram[(srcKeys[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t dst = histogram[(srcKeys[i] >> shift) & 0xFF]++;
+            dstKeys[dst] = srcKeys[i];
+            dstPayload[dst] = srcPayload[i];
+        }
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcPayload, dstPayload);
+    }
+
+    // Con un número impar de pases el resultado quedó en los buffers temporales
+    if (srcKeys != keys) {
+        std::memcpy(keys, srcKeys, count * sizeof(uint64_t));
+        std::memcpy(payload, srcPayload, count * sizeof(uint32_t));
+    }
+}
+
+unsigned int
+RenderQueue::countStateChanges(const uint64_t* keys, size_t count) {
+    // Solo la textura y el material implican un cambio de estado en la GPU
+    const uint64_t stateMask = 0x00FFFFFF00000000ull;
+
+    unsigned int changes = 0;
+    uint64_t lastState = ~0ull;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t state = keys[i] & stateMask;
+        if (state != lastState) {
+            ++changes;
+            lastState = state;
+        }
+    }
+    return changes;
+}
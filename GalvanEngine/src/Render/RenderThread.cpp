@@ -0,0 +1,193 @@
+﻿#include "Render/RenderThread.h"
+#include "Window.h"
+#include "UserInterface.h"
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void
+RenderThread::start(Window* window, UserInterface* gui) {
+    if (m_running.load(std::memory_order_acquire) || window == nullptr || gui == nullptr) {
+        return;
+    }
+    m_window = window;
+    m_gui = gui;
+
+    // El contexto de OpenGL solo puede estar activo en un hilo a la vez
+    m_window->getWindow()->setActive(false);
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+void
+RenderThread::stop() {
+    if (!m_running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_window->getWindow()->setActive(true);
+}
+
+void
+RenderThread::waitForConsumer() {
+    while (m_running.load(std::memory_order_acquire) && m_snapshots.hasPending()) {
+        sf::sleep(sf::microseconds(500));
+    }
+}
+
+void
+RenderThread::queueTextureUpload(Texture* texture, const std::shared_ptr<sf::Image>& image) {
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    m_uploads.emplace_back(texture, image);
+}
+
+void
+RenderThread::takeCommands(std::vector<UiCommand>& commands) {
+    commands.clear();
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    commands.swap(m_commands);
+}
+
+void
+RenderThread::run() {
+    m_window->getWindow()->setActive(true);
+    sf::Clock frameClock;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        frameClock.restart();
+
+        // Si la simulación no publicó nada nuevo se vuelve a dibujar el último snapshot
+        m_snapshots.acquire();
+        const RenderSnapshot& snapshot = m_snapshots.getReadBuffer();
+
+        // Las subidas se aplican antes de anunciar el frame; así ninguna textura con una
+        // subida pendiente puede desalojarse
+        applyTextureUploads();
+        m_drawingFrame.store(snapshot.frame, std::memory_order_release);
+
+        m_window->takeForwardedEvents(m_events);
+        for (const sf::Event& event : m_events) {
+            m_window->processEvent(event);
+        }
+
+        m_window->update();
+        m_window->clear();
+        drawScene(snapshot);
+        m_window->renderToTexture();
+        m_window->showInImGui();
+
+        m_frameCommands.clear();
+        m_gui->console(snapshot.messages);
+        m_gui->hierarchy(snapshot, m_frameCommands);
+        m_gui->inspector(snapshot, m_frameCommands);
+        m_gui->renderStats(m_queue.getStats());
+        m_gui->resourceStats(snapshot.textureStats);
+
+        m_window->render();
+        m_window->display();
+
+        if (!m_frameCommands.empty()) {
+            std::lock_guard<std::mutex> lock(m_commandMutex);
+            m_commands.insert(m_commands.end(), m_frameCommands.begin(), m_frameCommands.end());
+        }
+
+        m_renderTimeMs.store(frameClock.getElapsedTime().asMicroseconds() / 1000.0f,
+                             std::memory_order_relaxed);
+    }
+
+    m_window->getWindow()->setActive(false);
+}
+
+void
+RenderThread::applyTextureUploads() {
+    m_frameUploads.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        m_frameUploads.swap(m_uploads);
+    }
+    for (auto& upload : m_frameUploads) {
+        upload.first->reloadFromImage(*upload.second);
+    }
+    m_frameUploads.clear();
+}
+
+void
+RenderThread::drawScene(const RenderSnapshot& snapshot) {
+    ++m_drawnFrames;
+
+    // Sincroniza las figuras del lado de render; los elementos sin figura quedan en nullptr
+    std::vector<sf::Shape*>& shapes = m_itemShapes;
+    shapes.resize(snapshot.items.size());
+    for (size_t i = 0; i < snapshot.items.size(); ++i) {
+        shapes[i] = syncShape(snapshot.items[i]);
+    }
+
+    m_staticLayer.build(m_window->m_renderTexture.getSize(), snapshot.staticVersion,
+        [&](RenderQueue& queue) {
+            for (size_t i = 0; i < snapshot.items.size(); ++i) {
+                const RenderItem& item = snapshot.items[i];
+                if (item.isStatic && shapes[i]) {
+                    queue.pushShape(*shapes[i], item.layer, item.depth);
+                }
+            }
+        });
+
+    m_queue.clear();
+    m_staticLayer.submit(m_queue);
+    for (size_t i = 0; i < snapshot.items.size(); ++i) {
+        const RenderItem& item = snapshot.items[i];
+        if (!item.isStatic && shapes[i]) {
+            m_queue.pushShape(*shapes[i], item.layer, item.depth);
+        }
+    }
+    for (const RenderBatch& batch : snapshot.batches) {
+        m_queue.pushBatch(batch);
+    }
+    m_queue.sort();
+    m_queue.submit(*m_window);
+
+    // Libera las figuras de actores que ya no están en la escena
+    if (m_shapes.size() > snapshot.items.size()) {
+        for (auto it = m_shapes.begin(); it != m_shapes.end();) {
+            if (it->second.lastFrame != m_drawnFrames) {
+                it = m_shapes.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+}
+
+sf::Shape*
+RenderThread::syncShape(const RenderItem& item) {
+    if (item.shapeType == ShapeType::EMPTY) {
+        return nullptr;
+    }
+
+    ShapeSlot& slot = m_shapes[item.actorId];
+    slot.lastFrame = m_drawnFrames;
+    if (slot.shape.isNull()) {
+        slot.shape = EngineUtilities::MakeShared<ShapeFactory>();
+    }
+    if (slot.shape->getShape() == nullptr || slot.shape->getShapeType() != item.shapeType) {
+        slot.shape->createShape(static_cast<ShapeType>(item.shapeType));
+    }
+
+    sf::Shape* shape = slot.shape->getShape();
+    if (shape == nullptr) {
+        return nullptr;
+    }
+    shape->setPosition(item.position);
+    shape->setRotation(item.rotation.x);
+    shape->setScale(item.scale);
+    if (shape->getTexture() != item.texture) {
+        shape->setTexture(item.texture);
+    }
+    shape->setFillColor(item.fillColor);
+    return shape;
+}
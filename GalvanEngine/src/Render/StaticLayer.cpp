@@ -0,0 +1,67 @@
+﻿#include "Render/StaticLayer.h"
+#include "Actor.h"
+
+void
+StaticLayer::detectChanges(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    bool changed = false;
+
+    // Detectar cambios en el conjunto de actores estáticos o en alguno de ellos
+    size_t index = 0;
+    for (auto& actor : actors) {
+        if (actor.isNull() || !actor->isStatic()) {
+            continue;
+        }
+        if (index >= m_staticActors.size() || m_staticActors[index] != actor.get()) {
+            m_staticActors.resize(index);
+            m_staticActors.push_back(actor.get());
+            changed = true;
+        }
+        if (actor->consumeRenderDirty()) {
+            changed = true;
+        }
+        ++index;
+    }
+    if (index != m_staticActors.size()) {
+        m_staticActors.resize(index);
+        changed = true;
+    }
+
+    if (changed) {
+        ++m_version;
+    }
+}
+
+void
+StaticLayer::update(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors,
+                    const sf::Vector2u& targetSize) {
+    detectChanges(actors);
+    build(targetSize, m_version, [this](RenderQueue& queue) {
+        for (Actor* actor : m_staticActors) {
+            actor->submit(queue);
+        }
+    });
+}
+
+void
+StaticLayer::submit(RenderQueue& queue) {
+    if (!m_hasContent) {
+        return;
+    }
+    queue.push(RenderQueue::makeKey(RenderLayer::BACKGROUND,
+                                    queue.getTextureId(&m_cache.getTexture()),
+                                    0,
+                                    -std::numeric_limits<float>::max()),
+               m_sprite);
+}
+
+bool
+StaticLayer::ensureSize(const sf::Vector2u& targetSize) {
+    if (m_cache.getSize() == targetSize) {
+        return false;
+    }
+    if (!m_cache.create(targetSize.x, targetSize.y)) {
+        ERROR("StaticLayer", "ensureSize", "CHECK RENDERTEXTURE CREATION");
+    }
+    m_sprite.setTexture(m_cache.getTexture(), true);
+    return true;
+}
@@ -0,0 +1,337 @@
+﻿#include "Services/AssetManifest.h"
+#include "Services/VirtualFileSystem.h"
+#include "ResourceManager.h"
+
+namespace {
+    /*
+    * @struct PendingAsset
+    * @brief Entrada del manifiesto cuya carga todavía no se contó.
+    */
+    struct
+        PendingAsset {
+        const ManifestEntry* entry = nullptr;
+        uint32_t handle = 0;
+    };
+
+    template<typename Cache>
+    uint32_t
+        startLoad(Cache& cache, const ManifestEntry& entry, bool parallel) {
+        typename Cache::Handle handle = parallel ? cache.loadAsync(entry.name, entry.extension)
+                                                 : cache.load(entry.name, entry.extension);
+        return handle.index;
+    }
+
+    template<typename Cache>
+    ResourceState
+        getState(Cache& cache, uint32_t index) {
+        typename Cache::Handle handle;
+        handle.index = index;
+        return cache.getState(handle);
+    }
+
+    uint32_t
+        startLoad(ResourceManager& resourceManager, const ManifestEntry& entry, bool parallel) {
+        switch (entry.type) {
+        case ASSET_FONT:
+            return startLoad(resourceManager.getFonts(), entry, parallel);
+        case ASSET_SOUND:
+            return startLoad(resourceManager.getSounds(), entry, parallel);
+        case ASSET_SHADER:
+            return startLoad(resourceManager.getShaders(), entry, parallel);
+        default:
+            return startLoad(resourceManager.getTextures(), entry, parallel);
+        }
+    }
+
+    ResourceState
+        getState(ResourceManager& resourceManager, const PendingAsset& pending) {
+        switch (pending.entry->type) {
+        case ASSET_FONT:
+            return getState(resourceManager.getFonts(), pending.handle);
+        case ASSET_SOUND:
+            return getState(resourceManager.getSounds(), pending.handle);
+        case ASSET_SHADER:
+            return getState(resourceManager.getShaders(), pending.handle);
+        default:
+            return getState(resourceManager.getTextures(), pending.handle);
+        }
+    }
+
+    /**
+     * @brief Recoge las cargas terminadas de todos los caches.
+     * @param wait true para bloquear hasta que termine al menos una si no había ninguna lista.
+     */
+    void
+        pollCaches(ResourceManager& resourceManager, bool wait) {
+        size_t finished = resourceManager.getTextures().poll(false) +
+                          resourceManager.getFonts().poll(false) +
+                          resourceManager.getSounds().poll(false) +
+                          resourceManager.getShaders().poll(false);
+        if (finished > 0 || !wait) {
+            return;
+        }
+        if (resourceManager.getTextures().getStats().pendingCount > 0) {
+            resourceManager.getTextures().poll(true);
+        }
+        else if (resourceManager.getFonts().getStats().pendingCount > 0) {
+            resourceManager.getFonts().poll(true);
+        }
+        else if (resourceManager.getSounds().getStats().pendingCount > 0) {
+            resourceManager.getSounds().poll(true);
+        }
+        else if (resourceManager.getShaders().getStats().pendingCount > 0) {
+            resourceManager.getShaders().poll(true);
+        }
+    }
+
+    bool
+        parseType(std::string_view token, AssetType& type) {
+        if (token == "texture") {
+            type = ASSET_TEXTURE;
+        }
+        else if (token == "font") {
+            type = ASSET_FONT;
+        }
+        else if (token == "sound") {
+            type = ASSET_SOUND;
+        }
+        else if (token == "shader") {
+            type = ASSET_SHADER;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Separa una línea en palabras sin copiar el texto.
+     */
+    void
+        splitWords(std::string_view line, std::vector<std::string_view>& words) {
+        words.clear();
+        size_t position = 0;
+        while (position < line.size()) {
+            while (position < line.size() && std::isspace(static_cast<unsigned char>(line[position]))) {
+                ++position;
+            }
+            size_t start = position;
+            while (position < line.size() && !std::isspace(static_cast<unsigned char>(line[position]))) {
+                ++position;
+            }
+            if (position > start) {
+                words.push_back(line.substr(start, position - start));
+            }
+        }
+    }
+}
+
+bool
+AssetManifest::loadFromFile(const std::string& path, std::string& error) {
+    FileView file;
+    if (!VirtualFileSystem::getInstance().read(path, std::string_view(), file)) {
+        error = "Can't open manifest: " + path;
+        return false;
+    }
+    std::string_view text(reinterpret_cast<const char*>(file.data), file.size);
+    return parse(text, error) && sort(error);
+}
+
+bool
+AssetManifest::parse(std::string_view text, std::string& error) {
+    std::vector<std::string_view> words;
+    std::vector<std::string> dependencies;
+    size_t lineNumber = 0;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(position, end - position);
+        position = end + 1;
+        ++lineNumber;
+
+        size_t comment = line.find('#');
+        if (comment != std::string_view::npos) {
+            line = line.substr(0, comment);
+        }
+        splitWords(line, words);
+        if (words.empty()) {
+            continue;
+        }
+
+        AssetType type;
+        if (words.size() < 3 || !parseType(words[0], type)) {
+            error = "Manifest line " + std::to_string(lineNumber) + ": expected '<type> <name> <extension>'";
+            return false;
+        }
+        dependencies.clear();
+        if (words.size() > 3) {
+            if (words[3] != ":") {
+                error = "Manifest line " + std::to_string(lineNumber) + ": dependencies must follow ':'";
+                return false;
+            }
+            for (size_t i = 4; i < words.size(); ++i) {
+                dependencies.emplace_back(words[i]);
+            }
+        }
+        add(type, words[1], words[2], dependencies);
+    }
+    return true;
+}
+
+void
+AssetManifest::add(AssetType type,
+                   std::string_view name,
+                   std::string_view extension,
+                   const std::vector<std::string>& dependencies) {
+    m_sorted = false;
+    for (ManifestEntry& entry : m_entries) {
+        if (entry.type == type && entry.name == name) {
+            for (const std::string& dependency : dependencies) {
+                if (std::find(entry.dependencies.begin(), entry.dependencies.end(), dependency) == entry.dependencies.end()) {
+                    entry.dependencies.push_back(dependency);
+                }
+            }
+            return;
+        }
+    }
+
+    ManifestEntry entry;
+    entry.type = type;
+    entry.name.assign(name.data(), name.size());
+    entry.extension.assign(extension.data(), extension.size());
+    entry.dependencies = dependencies;
+    m_entries.push_back(entry);
+}
+
+bool
+AssetManifest::sort(std::string& error) {
+    if (m_sorted) {
+        return true;
+    }
+
+    std::unordered_multimap<std::string, size_t> byName;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        byName.emplace(m_entries[i].name, i);
+    }
+
+    // Kahn: el nivel de una entrada es uno más que el de su dependencia más profunda
+    std::vector<std::vector<size_t>> dependents(m_entries.size());
+    std::vector<size_t> remaining(m_entries.size(), 0);
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        m_entries[i].level = 0;
+        for (const std::string& dependency : m_entries[i].dependencies) {
+            auto range = byName.equal_range(dependency);
+            if (range.first == range.second) {
+                error = "Manifest entry '" + m_entries[i].name + "' depends on unknown asset '" + dependency + "'";
+                return false;
+            }
+            for (auto it = range.first; it != range.second; ++it) {
+                dependents[it->second].push_back(i);
+                ++remaining[i];
+            }
+        }
+    }
+
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (remaining[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    size_t visited = 0;
+    while (!ready.empty()) {
+        size_t current = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (size_t dependent : dependents[current]) {
+            m_entries[dependent].level = std::max(m_entries[dependent].level, m_entries[current].level + 1);
+            if (--remaining[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+    if (visited != m_entries.size()) {
+        error = "Manifest has a dependency cycle";
+        return false;
+    }
+
+    std::stable_sort(m_entries.begin(), m_entries.end(),
+                     [](const ManifestEntry& a, const ManifestEntry& b) { return a.level < b.level; });
+    m_sorted = true;
+    return true;
+}
+
+LoadProgress
+AssetManifest::load(const ProgressCallback& progress, bool parallel) const {
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    sf::Clock clock;
+
+    LoadProgress state;
+    state.total = m_entries.size();
+
+    auto report = [&](const ManifestEntry& entry, ResourceState result) {
+        ++state.loaded;
+        if (result != RESOURCE_READY) {
+            ++state.failed;
+        }
+        state.lastName = entry.name;
+        state.elapsedSeconds = clock.getElapsedTime().asSeconds();
+        state.etaSeconds = state.elapsedSeconds / static_cast<float>(state.loaded) *
+                           static_cast<float>(state.total - state.loaded);
+        if (progress) {
+            progress(state);
+        }
+    };
+
+    std::vector<PendingAsset> pending;
+    size_t levelBegin = 0;
+    while (levelBegin < m_entries.size()) {
+        size_t levelEnd = levelBegin;
+        while (levelEnd < m_entries.size() && m_entries[levelEnd].level == m_entries[levelBegin].level) {
+            ++levelEnd;
+        }
+
+        if (!parallel) {
+            for (size_t i = levelBegin; i < levelEnd; ++i) {
+                PendingAsset asset;
+                asset.entry = &m_entries[i];
+                asset.handle = startLoad(resourceManager, m_entries[i], false);
+                report(m_entries[i], getState(resourceManager, asset));
+            }
+            levelBegin = levelEnd;
+            continue;
+        }
+
+        // Todo el nivel se encola de una vez; el siguiente nivel espera a que termine
+        pending.clear();
+        for (size_t i = levelBegin; i < levelEnd; ++i) {
+            PendingAsset asset;
+            asset.entry = &m_entries[i];
+            asset.handle = startLoad(resourceManager, m_entries[i], true);
+            pending.push_back(asset);
+        }
+        bool first = true;
+        while (!pending.empty()) {
+            pollCaches(resourceManager, !first);
+            first = false;
+            for (size_t i = 0; i < pending.size();) {
+                ResourceState result = getState(resourceManager, pending[i]);
+                if (result == RESOURCE_LOADING) {
+                    ++i;
+                    continue;
+                }
+                report(*pending[i].entry, result);
+                pending[i] = pending.back();
+                pending.pop_back();
+            }
+        }
+        levelBegin = levelEnd;
+    }
+
+    state.elapsedSeconds = clock.getElapsedTime().asSeconds();
+    state.etaSeconds = 0.0f;
+    return state;
+}
@@ -0,0 +1,170 @@
+﻿#include "Services/AssetWatcher.h"
+#include "Services/NotificationService.h"
+#include <cctype>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    /**
+     * @brief Indica si la extensión corresponde a una imagen que SFML puede decodificar.
+     */
+    bool
+        isImageExtension(std::string extension) {
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+        return extension == "png" || extension == "jpg" || extension == "jpeg" ||
+               extension == "bmp" || extension == "tga";
+    }
+}
+
+AssetWatcher::~AssetWatcher() {
+    stop();
+}
+
+bool
+AssetWatcher::watch(const std::string& directory) {
+    NotificationService& notifier = NotificationService::getInstance();
+
+#ifdef __linux__
+    if (m_inotify < 0) {
+        m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotify < 0) {
+            notifier.addMessage(ConsolErrorType::ERROR, "Can't initialize inotify for hot reload");
+            return false;
+        }
+    }
+
+    int wd = inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        notifier.addMessage(ConsolErrorType::ERROR, "Can't watch directory: " + directory);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_directoryMutex);
+        m_directories[wd] = directory;
+    }
+
+    if (!m_running.exchange(true, std::memory_order_acq_rel)) {
+        m_thread = std::thread(&AssetWatcher::run, this);
+    }
+    return true;
+#else
+    notifier.addMessage(ConsolErrorType::WARNING, "Hot reload is only available on Linux: " + directory);
+    return false;
+#endif
+}
+
+void
+AssetWatcher::stop() {
+    if (m_running.exchange(false, std::memory_order_acq_rel) && m_thread.joinable()) {
+        m_thread.join();
+    }
+#ifdef __linux__
+    if (m_inotify >= 0) {
+        close(m_inotify);
+        m_inotify = -1;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(m_directoryMutex);
+    m_directories.clear();
+}
+
+void
+AssetWatcher::takeReady(std::vector<AssetReload>& out, size_t maxCount) {
+    out.clear();
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    while (!m_ready.empty() && out.size() < maxCount) {
+        out.push_back(std::move(m_ready.front()));
+        m_ready.pop_front();
+    }
+}
+
+void
+AssetWatcher::run() {
+#ifdef __linux__
+    using Clock = std::chrono::steady_clock;
+
+    // Último evento de cada archivo; un archivo se recarga cuando deja de cambiar
+    std::unordered_map<std::string, Clock::time_point> pending;
+    std::vector<std::string> settled;
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    while (m_running.load(std::memory_order_acquire)) {
+        pollfd descriptor{ m_inotify, POLLIN, 0 };
+        int timeoutMs = pending.empty() ? 100 : 20;
+        if (poll(&descriptor, 1, timeoutMs) > 0 && (descriptor.revents & POLLIN)) {
+            ssize_t length;
+            while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0) {
+                Clock::time_point now = Clock::now();
+                std::lock_guard<std::mutex> lock(m_directoryMutex);
+                for (char* p = buffer; p < buffer + length;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+
+                    auto directory = m_directories.find(event->wd);
+                    if (event->len == 0 || directory == m_directories.end()) {
+                        continue;
+                    }
+                    std::string fileName(event->name);
+                    size_t dot = fileName.find_last_of('.');
+                    if (dot == std::string::npos || !isImageExtension(fileName.substr(dot + 1))) {
+                        continue;
+                    }
+                    std::string path = directory->second == "." ? fileName : directory->second + "/" + fileName;
+                    pending[path] = now;
+                }
+            }
+        }
+
+        Clock::time_point now = Clock::now();
+        std::chrono::milliseconds debounce(m_debounceMs.load(std::memory_order_relaxed));
+        settled.clear();
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (now - it->second >= debounce) {
+                settled.push_back(it->first);
+                it = pending.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        if (!settled.empty()) {
+            decode(settled);
+        }
+    }
+#endif
+}
+
+void
+AssetWatcher::decode(const std::vector<std::string>& paths) {
+    std::vector<AssetReload> decoded;
+    decoded.reserve(paths.size());
+
+    for (const std::string& path : paths) {
+        // El nombre conserva la carpeta, igual que los nombres que recibe el ResourceManager
+        size_t dot = path.find_last_of('.');
+
+        AssetReload reload;
+        reload.name = path.substr(0, dot);
+        reload.extension = path.substr(dot + 1);
+        reload.image = std::make_shared<sf::Image>();
+
+        // Un archivo a medio escribir falla aquí y se recargará con su siguiente evento
+        if (reload.image->loadFromFile(path)) {
+            decoded.push_back(std::move(reload));
+        }
+    }
+
+    // Todo el lote se publica de una vez para que el hilo principal lo reparta en frames
+    std::lock_guard<std::mutex> lock(m_readyMutex);
+    for (AssetReload& reload : decoded) {
+        m_ready.push_back(std::move(reload));
+    }
+}
@@ -0,0 +1,53 @@
+﻿#include "Services/EventBus.h"
+
+namespace {
+    std::atomic<uint32_t> s_typeCount{ 0 };
+}
+
+void
+EventBus::unsubscribe(EventSubscription subscription) {
+    if (!subscription.isValid() || subscription.type >= MAX_EVENT_TYPES) {
+        return;
+    }
+    EventQueueBase* queue = m_queues[subscription.type].load(std::memory_order_acquire);
+    if (queue != nullptr) {
+        queue->unsubscribe(subscription.id);
+    }
+}
+
+void
+EventBus::swapBuffers() {
+    uint32_t count = std::min(s_typeCount.load(std::memory_order_acquire), MAX_EVENT_TYPES);
+    for (uint32_t type = 0; type < count; ++type) {
+        EventQueueBase* queue = m_queues[type].load(std::memory_order_acquire);
+        if (queue != nullptr) {
+            queue->swap();
+        }
+    }
+}
+
+void
+EventBus::dispatch() {
+    sf::Clock clock;
+    size_t dropped = m_stats.droppedEvents;
+    m_stats = EventBusStats();
+    m_stats.droppedEvents = dropped;
+
+    uint32_t count = std::min(s_typeCount.load(std::memory_order_acquire), MAX_EVENT_TYPES);
+    for (uint32_t type = 0; type < count; ++type) {
+        EventQueueBase* queue = m_queues[type].load(std::memory_order_acquire);
+        if (queue != nullptr) {
+            queue->dispatch(m_stats);
+        }
+    }
+    m_stats.dispatchTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+uint32_t
+EventBus::nextTypeId() {
+    uint32_t id = s_typeCount.fetch_add(1, std::memory_order_acq_rel);
+    if (id >= MAX_EVENT_TYPES) {
+        throw std::out_of_range("EventBus: demasiados tipos de evento");
+    }
+    return id;
+}
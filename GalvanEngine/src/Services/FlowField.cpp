@@ -0,0 +1,191 @@
+﻿#include "Services/FlowField.h"
+
+namespace {
+    // Direcciones en sentido horario empezando por +X; las impares son diagonales
+    const int DIRECTION_X[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    const int DIRECTION_Y[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+    const float STEP_COST[8] = { 1.0f, 1.41421356f, 1.0f, 1.41421356f, 1.0f, 1.41421356f, 1.0f, 1.41421356f };
+    const float INVERSE_SQRT2 = 0.70710678f;
+    const sf::Vector2f UNIT_DIRECTION[9] = {
+        sf::Vector2f(1.0f, 0.0f), sf::Vector2f(INVERSE_SQRT2, INVERSE_SQRT2),
+        sf::Vector2f(0.0f, 1.0f), sf::Vector2f(-INVERSE_SQRT2, INVERSE_SQRT2),
+        sf::Vector2f(-1.0f, 0.0f), sf::Vector2f(-INVERSE_SQRT2, -INVERSE_SQRT2),
+        sf::Vector2f(0.0f, -1.0f), sf::Vector2f(INVERSE_SQRT2, -INVERSE_SQRT2),
+        sf::Vector2f(0.0f, 0.0f)
+    };
+    const float UNREACHABLE = std::numeric_limits<float>::max();
+    const float COST_EPSILON = 1e-4f;
+
+    /**
+     * @brief Mismo criterio que la NavigationGrid: las diagonales no cortan esquinas.
+     */
+    inline bool
+        canStep(const NavigationGrid& grid, int x, int y, int direction) {
+        int dx = DIRECTION_X[direction];
+        int dy = DIRECTION_Y[direction];
+        return grid.isWalkable(x + dx, y + dy) &&
+               ((direction & 1) == 0 || (grid.isWalkable(x + dx, y) && grid.isWalkable(x, y + dy)));
+    }
+}
+
+FlowField::FlowField(const NavigationGrid& grid, const sf::Vector2i& goal) : m_goal(goal) {
+    rebuild(grid);
+}
+
+void
+FlowField::rebuild(const NavigationGrid& grid) {
+    m_width = grid.getWidth();
+    m_height = grid.getHeight();
+    m_cellSize = grid.getCellSize();
+    m_origin = grid.getOrigin();
+    m_cost.assign(static_cast<size_t>(m_width) * m_height, UNREACHABLE);
+    m_direction.assign(m_cost.size(), NO_DIRECTION);
+    m_lastUpdatedCells = 0;
+    m_heap.clear();
+
+    if (grid.isWalkable(m_goal.x, m_goal.y)) {
+        uint32_t goal = static_cast<uint32_t>(m_goal.y) * m_width + static_cast<uint32_t>(m_goal.x);
+        m_cost[goal] = 0.0f;
+        m_heap.emplace_back(0.0f, goal);
+        propagate(grid);
+    }
+}
+
+void
+FlowField::repair(const NavigationGrid& grid, const std::vector<sf::Vector2i>& changedCells) {
+    m_lastUpdatedCells = 0;
+    m_heap.clear();
+
+    // 1. Las celdas que llegaban a la meta por una celda ahora bloqueada pierden su costo.
+    //    También las vecinas cuya diagonal rodeaba esa celda, que ya no es válida.
+    std::vector<uint32_t> invalid;
+    std::vector<uint8_t> marked(m_cost.size(), 0);
+    auto markInvalid = [&](uint32_t cell) {
+        if (!marked[cell]) {
+            marked[cell] = 1;
+            invalid.push_back(cell);
+        }
+    };
+    for (const sf::Vector2i& cell : changedCells) {
+        if (!isInside(cell) || grid.isWalkable(cell.x, cell.y)) {
+            continue;
+        }
+        markInvalid(static_cast<uint32_t>(cell.y) * m_width + static_cast<uint32_t>(cell.x));
+        for (int d = 0; d < 8; d += 2) {
+            sf::Vector2i neighbor(cell.x + DIRECTION_X[d], cell.y + DIRECTION_Y[d]);
+            uint8_t direction = getDirection(neighbor);
+            if (direction == NO_DIRECTION || (direction & 1) == 0) {
+                continue;
+            }
+            bool cutsCorner = (neighbor.x + DIRECTION_X[direction] == cell.x && neighbor.y == cell.y) ||
+                              (neighbor.x == cell.x && neighbor.y + DIRECTION_Y[direction] == cell.y);
+            if (cutsCorner) {
+                markInvalid(static_cast<uint32_t>(neighbor.y) * m_width + static_cast<uint32_t>(neighbor.x));
+            }
+        }
+    }
+    // Los descendientes en el árbol de direcciones dependían de esas celdas
+    for (size_t i = 0; i < invalid.size(); ++i) {
+        int x = static_cast<int>(invalid[i] % m_width);
+        int y = static_cast<int>(invalid[i] / m_width);
+        for (int d = 0; d < 8; ++d) {
+            sf::Vector2i neighbor(x + DIRECTION_X[d], y + DIRECTION_Y[d]);
+            uint8_t direction = getDirection(neighbor);
+            if (direction != NO_DIRECTION && direction == (d + 4) % 8) {
+                markInvalid(static_cast<uint32_t>(neighbor.y) * m_width + static_cast<uint32_t>(neighbor.x));
+            }
+        }
+    }
+    for (uint32_t cell : invalid) {
+        m_cost[cell] = UNREACHABLE;
+        m_direction[cell] = NO_DIRECTION;
+    }
+
+    // 2. Se vuelven a sembrar desde sus vecinas las celdas invalidadas, las cambiadas y las
+    //    vecinas de estas, que pueden ganar una diagonal al liberarse una celda
+    auto seed = [&](int x, int y) {
+        if (!grid.isWalkable(x, y)) {
+            return;
+        }
+        uint32_t cell = static_cast<uint32_t>(y) * m_width + static_cast<uint32_t>(x);
+        uint8_t direction = NO_DIRECTION;
+        float cost = (x == m_goal.x && y == m_goal.y) ? 0.0f : bestNeighborCost(grid, x, y, direction);
+        if (cost < m_cost[cell] - COST_EPSILON) {
+            m_cost[cell] = cost;
+            m_direction[cell] = direction;
+            m_heap.emplace_back(cost, cell);
+            ++m_lastUpdatedCells;
+        }
+    };
+    for (uint32_t cell : invalid) {
+        seed(static_cast<int>(cell % m_width), static_cast<int>(cell / m_width));
+    }
+    for (const sf::Vector2i& cell : changedCells) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (isInside(sf::Vector2i(cell.x + dx, cell.y + dy))) {
+                    seed(cell.x + dx, cell.y + dy);
+                }
+            }
+        }
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<float, uint32_t>>());
+
+    // 3. Dijkstra desde las semillas; solo toca las celdas cuyo costo baja
+    propagate(grid);
+}
+
+sf::Vector2f
+FlowField::sample(const sf::Vector2f& worldPosition) const {
+    sf::Vector2i cell(static_cast<int>(std::floor((worldPosition.x - m_origin.x) / m_cellSize)),
+                      static_cast<int>(std::floor((worldPosition.y - m_origin.y) / m_cellSize)));
+    return UNIT_DIRECTION[getDirection(cell)];
+}
+
+void
+FlowField::propagate(const NavigationGrid& grid) {
+    const std::greater<std::pair<float, uint32_t>> compare;
+    while (!m_heap.empty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), compare);
+        float cost = m_heap.back().first;
+        uint32_t cell = m_heap.back().second;
+        m_heap.pop_back();
+        if (cost > m_cost[cell]) {
+            continue;
+        }
+
+        int x = static_cast<int>(cell % m_width);
+        int y = static_cast<int>(cell / m_width);
+        for (int d = 0; d < 8; ++d) {
+            if (!canStep(grid, x, y, d)) {
+                continue;
+            }
+            uint32_t next = static_cast<uint32_t>(y + DIRECTION_Y[d]) * m_width + static_cast<uint32_t>(x + DIRECTION_X[d]);
+            float nextCost = cost + STEP_COST[d];
+            if (nextCost < m_cost[next] - COST_EPSILON) {
+                m_cost[next] = nextCost;
+                m_direction[next] = static_cast<uint8_t>((d + 4) % 8);
+                m_heap.emplace_back(nextCost, next);
+                std::push_heap(m_heap.begin(), m_heap.end(), compare);
+                ++m_lastUpdatedCells;
+            }
+        }
+    }
+}
+
+float
+FlowField::bestNeighborCost(const NavigationGrid& grid, int x, int y, uint8_t& direction) const {
+    float best = UNREACHABLE;
+    direction = NO_DIRECTION;
+    for (int d = 0; d < 8; ++d) {
+        if (!canStep(grid, x, y, d)) {
+            continue;
+        }
+        float neighborCost = m_cost[static_cast<size_t>(y + DIRECTION_Y[d]) * m_width + (x + DIRECTION_X[d])];
+        if (neighborCost != UNREACHABLE && neighborCost + STEP_COST[d] < best) {
+            best = neighborCost + STEP_COST[d];
+            direction = static_cast<uint8_t>(d);
+        }
+    }
+    return best;
+}
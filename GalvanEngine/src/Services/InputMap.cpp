@@ -0,0 +1,481 @@
+﻿#include "Services/InputMap.h"
+#include "Services/VirtualFileSystem.h"
+
+namespace {
+    // Nombres en el orden de sf::Keyboard::Key, que empieza en A = 0
+    const char* const KEY_NAMES[] = {
+        "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M",
+        "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z",
+        "Num0", "Num1", "Num2", "Num3", "Num4", "Num5", "Num6", "Num7", "Num8", "Num9",
+        "Escape", "LControl", "LShift", "LAlt", "LSystem", "RControl", "RShift", "RAlt", "RSystem", "Menu",
+        "LBracket", "RBracket", "Semicolon", "Comma", "Period", "Apostrophe", "Slash", "Backslash",
+        "Grave", "Equal", "Hyphen", "Space", "Enter", "Backspace", "Tab", "PageUp", "PageDown",
+        "End", "Home", "Insert", "Delete", "Add", "Subtract", "Multiply", "Divide",
+        "Left", "Right", "Up", "Down",
+        "Numpad0", "Numpad1", "Numpad2", "Numpad3", "Numpad4", "Numpad5", "Numpad6", "Numpad7", "Numpad8", "Numpad9",
+        "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12", "F13", "F14", "F15",
+        "Pause"
+    };
+    static_assert(sizeof(KEY_NAMES) / sizeof(KEY_NAMES[0]) == sf::Keyboard::KeyCount, "KEY_NAMES out of date");
+
+    const char* const MOUSE_NAMES[] = { "Left", "Right", "Middle", "XButton1", "XButton2" };
+    static_assert(sizeof(MOUSE_NAMES) / sizeof(MOUSE_NAMES[0]) == sf::Mouse::ButtonCount, "MOUSE_NAMES out of date");
+
+    const char* const AXIS_NAMES[] = { "X", "Y", "Z", "R", "U", "V", "PovX", "PovY" };
+    static_assert(sizeof(AXIS_NAMES) / sizeof(AXIS_NAMES[0]) == sf::Joystick::AxisCount, "AXIS_NAMES out of date");
+
+    template<size_t N>
+    int
+        findName(const char* const (&names)[N], std::string_view name) {
+        for (size_t i = 0; i < N; ++i) {
+            if (name == names[i]) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool
+        parseNumber(std::string_view token, float& value) {
+        std::string text(token);
+        char* end = nullptr;
+        value = std::strtof(text.c_str(), &end);
+        return end != nullptr && *end == '\0' && !text.empty();
+    }
+
+    /**
+     * @brief Separa una línea en palabras sin copiar el texto.
+     */
+    void
+        splitWords(std::string_view line, std::vector<std::string_view>& words) {
+        words.clear();
+        size_t position = 0;
+        while (position < line.size()) {
+            while (position < line.size() && std::isspace(static_cast<unsigned char>(line[position]))) {
+                ++position;
+            }
+            size_t start = position;
+            while (position < line.size() && !std::isspace(static_cast<unsigned char>(line[position]))) {
+                ++position;
+            }
+            if (position > start) {
+                words.push_back(line.substr(start, position - start));
+            }
+        }
+    }
+
+    /**
+     * @brief Lleva un eje de joystick a [-1, 1] quitando la zona muerta.
+     */
+    float
+        applyDeadZone(float value, float deadZone) {
+        float magnitude = std::fabs(value);
+        if (magnitude <= deadZone) {
+            return 0.0f;
+        }
+        float scaled = std::min((magnitude - deadZone) / (1.0f - deadZone), 1.0f);
+        return value < 0.0f ? -scaled : scaled;
+    }
+}
+
+uint32_t
+InputMap::registerAction(const std::string& name) {
+    uint32_t id = getActionId(name);
+    if (id != INVALID_ID || m_actionNames.size() >= InputSnapshot::MAX_ACTIONS) {
+        return id;
+    }
+    m_actionNames.push_back(name);
+    return static_cast<uint32_t>(m_actionNames.size() - 1);
+}
+
+uint32_t
+InputMap::registerAxis(const std::string& name) {
+    uint32_t id = getAxisId(name);
+    if (id != INVALID_ID || m_axisNames.size() >= InputSnapshot::MAX_AXES) {
+        return id;
+    }
+    m_axisNames.push_back(name);
+    return static_cast<uint32_t>(m_axisNames.size() - 1);
+}
+
+uint32_t
+InputMap::getActionId(const std::string& name) const {
+    auto found = std::find(m_actionNames.begin(), m_actionNames.end(), name);
+    return found != m_actionNames.end() ? static_cast<uint32_t>(found - m_actionNames.begin()) : INVALID_ID;
+}
+
+uint32_t
+InputMap::getAxisId(const std::string& name) const {
+    auto found = std::find(m_axisNames.begin(), m_axisNames.end(), name);
+    return found != m_axisNames.end() ? static_cast<uint32_t>(found - m_axisNames.begin()) : INVALID_ID;
+}
+
+bool
+InputMap::bindAction(const std::string& action, const InputBinding& binding, std::string& error) {
+    uint64_t* target = nullptr;
+    switch (binding.type) {
+    case BIND_KEY:
+        if (binding.code >= 0 && binding.code < sf::Keyboard::KeyCount) {
+            target = &m_keyActions[binding.code];
+        }
+        break;
+    case BIND_MOUSE_BUTTON:
+        if (binding.code >= 0 && binding.code < sf::Mouse::ButtonCount) {
+            target = &m_mouseActions[binding.code];
+        }
+        break;
+    case BIND_JOYSTICK_BUTTON:
+        if (binding.code >= 0 && binding.code < static_cast<int>(sf::Joystick::ButtonCount) &&
+            binding.joystick < sf::Joystick::Count) {
+            target = &m_joystickActions[binding.joystick * sf::Joystick::ButtonCount + binding.code];
+        }
+        break;
+    default:
+        error = "Action '" + action + "' can't be bound to a joystick axis";
+        return false;
+    }
+    if (target == nullptr) {
+        error = "Invalid input code for action '" + action + "'";
+        return false;
+    }
+
+    uint32_t id = registerAction(action);
+    if (id == INVALID_ID) {
+        error = "Too many input actions; the limit is " + std::to_string(InputSnapshot::MAX_ACTIONS);
+        return false;
+    }
+    *target |= uint64_t(1) << id;
+    m_heldDirty = true;
+    return true;
+}
+
+bool
+InputMap::bindAxis(const std::string& axis, const InputBinding& binding, std::string& error) {
+    bool valid = false;
+    switch (binding.type) {
+    case BIND_KEY:
+        valid = binding.code < sf::Keyboard::KeyCount && binding.negativeCode < sf::Keyboard::KeyCount;
+        break;
+    case BIND_MOUSE_BUTTON:
+        valid = binding.code < sf::Mouse::ButtonCount && binding.negativeCode < sf::Mouse::ButtonCount;
+        break;
+    case BIND_JOYSTICK_BUTTON:
+        valid = binding.code < static_cast<int>(sf::Joystick::ButtonCount) &&
+                binding.negativeCode < static_cast<int>(sf::Joystick::ButtonCount);
+        break;
+    case BIND_JOYSTICK_AXIS:
+        valid = binding.code < sf::Joystick::AxisCount && binding.deadZone >= 0.0f && binding.deadZone < 1.0f;
+        break;
+    }
+    if (!valid || binding.code < 0 || binding.negativeCode < -1 || binding.joystick >= sf::Joystick::Count) {
+        error = "Invalid input code for axis '" + axis + "'";
+        return false;
+    }
+
+    uint32_t id = registerAxis(axis);
+    if (id == INVALID_ID) {
+        error = "Too many input axes; the limit is " + std::to_string(InputSnapshot::MAX_AXES);
+        return false;
+    }
+    AxisBinding axisBinding;
+    axisBinding.axis = id;
+    axisBinding.binding = binding;
+    m_axisBindings.push_back(axisBinding);
+    return true;
+}
+
+void
+InputMap::clearBindings() {
+    std::fill(std::begin(m_keyActions), std::end(m_keyActions), 0);
+    std::fill(std::begin(m_mouseActions), std::end(m_mouseActions), 0);
+    std::fill(std::begin(m_joystickActions), std::end(m_joystickActions), 0);
+    m_axisBindings.clear();
+    m_heldDirty = true;
+}
+
+bool
+InputMap::loadBindings(const std::string& path, std::string& error) {
+    FileView file;
+    if (!VirtualFileSystem::getInstance().read(path, std::string_view(), file)) {
+        error = "Can't open input bindings: " + path;
+        return false;
+    }
+    std::string_view text(reinterpret_cast<const char*>(file.data), file.size);
+    return parseBindings(text, error);
+}
+
+bool
+InputMap::parseBindings(std::string_view text, std::string& error) {
+    std::vector<std::string_view> words;
+    size_t lineNumber = 0;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(position, end - position);
+        position = end + 1;
+        ++lineNumber;
+
+        size_t comment = line.find('#');
+        if (comment != std::string_view::npos) {
+            line = line.substr(0, comment);
+        }
+        splitWords(line, words);
+        if (words.empty()) {
+            continue;
+        }
+
+        std::string prefix = "Input bindings line " + std::to_string(lineNumber) + ": ";
+        if (words.size() < 4 || (words[0] != "action" && words[0] != "axis")) {
+            error = prefix + "expected 'action|axis <name> <device> ...'";
+            return false;
+        }
+        bool isAction = words[0] == "action";
+        std::string name(words[1]);
+        std::string_view device = words[2];
+        InputBinding binding;
+        float number = 0.0f;
+        bool parsed = false;
+
+        if (isAction && device == "key" && words.size() == 4) {
+            binding.type = BIND_KEY;
+            binding.code = findName(KEY_NAMES, words[3]);
+            parsed = binding.code >= 0;
+        }
+        else if (isAction && device == "mouse" && words.size() == 4) {
+            binding.type = BIND_MOUSE_BUTTON;
+            binding.code = findName(MOUSE_NAMES, words[3]);
+            parsed = binding.code >= 0;
+        }
+        else if (isAction && device == "joybutton" && words.size() <= 5) {
+            binding.type = BIND_JOYSTICK_BUTTON;
+            parsed = parseNumber(words[3], number);
+            binding.code = static_cast<int>(number);
+            if (parsed && words.size() == 5) {
+                parsed = parseNumber(words[4], number);
+                binding.joystick = static_cast<uint32_t>(number);
+            }
+        }
+        else if (!isAction && device == "keys" && words.size() == 5) {
+            binding.type = BIND_KEY;
+            binding.negativeCode = findName(KEY_NAMES, words[3]);
+            binding.code = findName(KEY_NAMES, words[4]);
+            parsed = binding.code >= 0 && binding.negativeCode >= 0;
+        }
+        else if (!isAction && device == "joyaxis" && words.size() >= 5 && words.size() <= 6) {
+            binding.type = BIND_JOYSTICK_AXIS;
+            parsed = parseNumber(words[3], number);
+            binding.joystick = static_cast<uint32_t>(number);
+            binding.code = findName(AXIS_NAMES, words[4]);
+            parsed = parsed && binding.code >= 0;
+            if (parsed && words.size() == 6) {
+                parsed = parseNumber(words[5], binding.deadZone);
+            }
+        }
+        if (!parsed) {
+            error = prefix + "unknown device or input name";
+            return false;
+        }
+
+        std::string bindError;
+        if (!(isAction ? bindAction(name, binding, bindError) : bindAxis(name, binding, bindError))) {
+            error = prefix + bindError;
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+InputMap::update(const std::vector<sf::Event>& events) {
+    uint64_t previousHeld = m_current.held;
+    m_tappedEdges = 0;
+    m_current.mouseWheel = 0.0f;
+
+    for (const sf::Event& event : events) {
+        switch (event.type) {
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+            if (event.key.code >= 0 && event.key.code < sf::Keyboard::KeyCount) {
+                bool down = event.type == sf::Event::KeyPressed;
+                if (m_keys[event.key.code] != down) {
+                    m_keys[event.key.code] = down;
+                    setInput(m_keyActions[event.key.code], down);
+                }
+            }
+            break;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            if (event.mouseButton.button >= 0 && event.mouseButton.button < sf::Mouse::ButtonCount) {
+                bool down = event.type == sf::Event::MouseButtonPressed;
+                if (m_mouseButtons[event.mouseButton.button] != down) {
+                    m_mouseButtons[event.mouseButton.button] = down;
+                    setInput(m_mouseActions[event.mouseButton.button], down);
+                }
+                m_mousePosition = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            }
+            break;
+        case sf::Event::JoystickButtonPressed:
+        case sf::Event::JoystickButtonReleased:
+            if (event.joystickButton.joystickId < sf::Joystick::Count &&
+                event.joystickButton.button < sf::Joystick::ButtonCount) {
+                bool down = event.type == sf::Event::JoystickButtonPressed;
+                size_t index = event.joystickButton.joystickId * sf::Joystick::ButtonCount + event.joystickButton.button;
+                if (m_joystickButtons[index] != down) {
+                    m_joystickButtons[index] = down;
+                    setInput(m_joystickActions[index], down);
+                }
+            }
+            break;
+        case sf::Event::JoystickMoved:
+            if (event.joystickMove.joystickId < sf::Joystick::Count) {
+                m_joystickAxes[event.joystickMove.joystickId][event.joystickMove.axis] = event.joystickMove.position / 100.0f;
+            }
+            break;
+        case sf::Event::JoystickDisconnected:
+            if (event.joystickConnect.joystickId < sf::Joystick::Count) {
+                uint32_t joystick = event.joystickConnect.joystickId;
+                for (uint32_t button = 0; button < sf::Joystick::ButtonCount; ++button) {
+                    m_joystickButtons[joystick * sf::Joystick::ButtonCount + button] = false;
+                }
+                std::fill(std::begin(m_joystickAxes[joystick]), std::end(m_joystickAxes[joystick]), 0.0f);
+                m_heldDirty = true;
+            }
+            break;
+        case sf::Event::MouseMoved:
+            m_mousePosition = sf::Vector2i(event.mouseMove.x, event.mouseMove.y);
+            break;
+        case sf::Event::MouseWheelScrolled:
+            if (event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+                m_current.mouseWheel += event.mouseWheelScroll.delta;
+            }
+            break;
+        case sf::Event::LostFocus:
+            // Los eventos de soltar no llegan sin foco; todo lo presionado se suelta aquí
+            m_keys.reset();
+            m_mouseButtons.reset();
+            m_joystickButtons.reset();
+            m_heldDirty = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (m_heldDirty) {
+        rebuildHeld();
+        m_heldDirty = false;
+    }
+
+    // Una acción presionada y soltada dentro del mismo frame cuenta como presionada y soltada
+    uint64_t held = m_current.held;
+    uint64_t tapped = m_tappedEdges & ~previousHeld;
+    m_current.pressed = tapped;
+    m_current.released = (previousHeld & ~held) | (tapped & ~held);
+
+    std::fill(std::begin(m_current.axes), std::end(m_current.axes), 0.0f);
+    for (const AxisBinding& axisBinding : m_axisBindings) {
+        const InputBinding& binding = axisBinding.binding;
+        float value = 0.0f;
+        if (binding.type == BIND_JOYSTICK_AXIS) {
+            value = applyDeadZone(m_joystickAxes[binding.joystick][binding.code], binding.deadZone);
+        }
+        else {
+            value = (isBindingDown(binding.type, binding.joystick, binding.code) ? 1.0f : 0.0f) -
+                    (isBindingDown(binding.type, binding.joystick, binding.negativeCode) ? 1.0f : 0.0f);
+        }
+        float& current = m_current.axes[axisBinding.axis];
+        if (std::fabs(value) > std::fabs(current)) {
+            current = value;
+        }
+    }
+
+    m_current.mousePosition = m_mousePosition;
+    ++m_current.frame;
+    publish();
+}
+
+InputSnapshot
+InputMap::getSnapshot() const {
+    for (;;) {
+        uint64_t frame = m_published.load(std::memory_order_acquire);
+        const std::atomic<uint64_t>& sequence = m_slotSequences[frame % SLOT_COUNT];
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        InputSnapshot snapshot = m_slots[frame % SLOT_COUNT];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Si la secuencia no cambió, nadie escribió la copia mientras se leía
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            return snapshot;
+        }
+    }
+}
+
+void
+InputMap::setInput(uint64_t actions, bool down) {
+    if (down) {
+        m_tappedEdges |= actions;
+    }
+    // Otra entrada puede mantener la acción presionada; se resuelve al final del frame
+    if (actions != 0) {
+        m_heldDirty = true;
+    }
+}
+
+void
+InputMap::rebuildHeld() {
+    uint64_t held = 0;
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        if (m_keys[i]) {
+            held |= m_keyActions[i];
+        }
+    }
+    for (size_t i = 0; i < m_mouseButtons.size(); ++i) {
+        if (m_mouseButtons[i]) {
+            held |= m_mouseActions[i];
+        }
+    }
+    if (m_joystickButtons.any()) {
+        for (size_t i = 0; i < m_joystickButtons.size(); ++i) {
+            if (m_joystickButtons[i]) {
+                held |= m_joystickActions[i];
+            }
+        }
+    }
+    m_current.held = held;
+}
+
+bool
+InputMap::isBindingDown(InputBindingType type, uint32_t joystick, int code) const {
+    if (code < 0) {
+        return false;
+    }
+    switch (type) {
+    case BIND_KEY:
+        return m_keys[code];
+    case BIND_MOUSE_BUTTON:
+        return m_mouseButtons[code];
+    case BIND_JOYSTICK_BUTTON:
+        return m_joystickButtons[joystick * sf::Joystick::ButtonCount + code];
+    default:
+        return false;
+    }
+}
+
+void
+InputMap::publish() {
+    uint64_t frame = m_current.frame;
+    std::atomic<uint64_t>& sequence = m_slotSequences[frame % SLOT_COUNT];
+    uint64_t version = sequence.load(std::memory_order_relaxed);
+
+    // Seqlock: la secuencia impar queda visible antes que cualquier byte de la copia nueva
+    sequence.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_slots[frame % SLOT_COUNT] = m_current;
+    sequence.store(version + 2, std::memory_order_release);
+    m_published.store(frame, std::memory_order_release);
+}
@@ -0,0 +1,433 @@
+﻿#include "Services/InputRecorder.h"
+
+namespace {
+    const size_t FLUSH_BYTES = 64 * 1024;
+    const size_t HEADER_SIZE = 8;           ///< "GINP", versión y dos bytes reservados.
+    const uint64_t END_OF_LOG = 0;          ///< Avance de tick que marca el final del log.
+    const uint8_t MOD_ALT = 1;
+    const uint8_t MOD_CONTROL = 2;
+    const uint8_t MOD_SHIFT = 4;
+    const uint8_t MOD_SYSTEM = 8;
+}
+
+bool
+InputRecorder::startRecording(const std::string& path, std::string& error) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        error = "Can't create input log: " + path;
+        return false;
+    }
+    m_buffer.clear();
+    const uint8_t header[HEADER_SIZE] = { 'G', 'I', 'N', 'P',
+                                          static_cast<uint8_t>(VERSION & 0xFF), static_cast<uint8_t>(VERSION >> 8), 0, 0 };
+    m_buffer.insert(m_buffer.end(), header, header + HEADER_SIZE);
+
+    m_mode = INPUT_RECORDING;
+    m_lastTick = 0;
+    m_tickTimes.clear();
+    m_stats = InputReplayStats();
+    return true;
+}
+
+bool
+InputRecorder::startReplay(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        error = "Can't open input log: " + path;
+        return false;
+    }
+    m_buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size());
+    if (m_buffer.size() < HEADER_SIZE || std::memcmp(m_buffer.data(), "GINP", 4) != 0) {
+        error = "Not an input log: " + path;
+        return false;
+    }
+    uint16_t version = static_cast<uint16_t>(m_buffer[4] | (m_buffer[5] << 8));
+    if (version != VERSION) {
+        error = "Unsupported input log version " + std::to_string(version) + ": " + path;
+        return false;
+    }
+
+    m_mode = INPUT_REPLAYING;
+    m_readOffset = HEADER_SIZE;
+    m_lastTick = 0;
+    m_tickTimes.clear();
+    m_stats = InputReplayStats();
+    m_stats.logBytes = m_buffer.size();
+    m_nextReplayTick = 0;
+    m_replayFinished = !readTick(m_nextReplayTick, m_nextReplayDelta);
+    return true;
+}
+
+void
+InputRecorder::stop(uint64_t stateHash) {
+    if (m_mode == INPUT_LIVE) {
+        return;
+    }
+    if (m_mode == INPUT_RECORDING) {
+        writeVarint(END_OF_LOG);
+        writeVarint(m_lastTick);
+        for (int byte = 0; byte < 8; ++byte) {
+            m_buffer.push_back(static_cast<uint8_t>(stateHash >> (byte * 8)));
+        }
+        m_stats.logBytes += m_buffer.size();
+        flush();
+        m_file.close();
+    }
+    m_stats.stateHash = stateHash;
+    m_stats.hashMatches = m_mode == INPUT_REPLAYING && m_replayFinished && m_stats.recordedHash == stateHash;
+
+    m_stats.ticks = m_tickTimes.size();
+    if (!m_tickTimes.empty()) {
+        m_stats.averageSimMs = m_stats.totalSimMs / static_cast<float>(m_tickTimes.size());
+        m_stats.maxSimMs = *std::max_element(m_tickTimes.begin(), m_tickTimes.end());
+        auto p95 = m_tickTimes.begin() + static_cast<ptrdiff_t>(m_tickTimes.size() * 95 / 100);
+        std::nth_element(m_tickTimes.begin(), p95, m_tickTimes.end());
+        m_stats.p95SimMs = *p95;
+    }
+    m_mode = INPUT_LIVE;
+    m_buffer.clear();
+}
+
+void
+InputRecorder::submit(const sf::Event& event) {
+    // Al repetir, la entrada real no debe llegar a la simulación
+    if (m_mode != INPUT_REPLAYING && isInputEvent(event)) {
+        m_pendingEvents.push_back(event);
+    }
+}
+
+void
+InputRecorder::beginTick(float& deltaTime) {
+    m_frameEvents.clear();
+    if (m_mode != INPUT_REPLAYING) {
+        m_frameEvents.swap(m_pendingEvents);
+        if (m_mode == INPUT_RECORDING) {
+            // El log guarda microsegundos; la sesión grabada usa el mismo valor que leerá la repetición
+            uint64_t micros = static_cast<uint64_t>(std::llround(std::max(0.0f, deltaTime) * 1000000.0f));
+            deltaTime = static_cast<float>(micros) / 1000000.0f;
+            ++m_lastTick;
+            writeTick(1, micros);
+        }
+        return;
+    }
+
+    m_pendingEvents.clear();
+    if (m_replayFinished) {
+        return;
+    }
+    ++m_lastTick;
+    if (m_nextReplayTick > m_lastTick) {
+        return;
+    }
+    deltaTime = m_nextReplayDelta;
+    uint64_t count = 0;
+    if (readVarint(count)) {
+        for (uint64_t i = 0; i < count; ++i) {
+            sf::Event event{};
+            if (!readEvent(event)) {
+                break;
+            }
+            m_frameEvents.push_back(event);
+        }
+    }
+    m_stats.events += m_frameEvents.size();
+    m_replayFinished = !readTick(m_nextReplayTick, m_nextReplayDelta);
+}
+
+void
+InputRecorder::endTick(float simTimeMs) {
+    if (m_mode == INPUT_LIVE) {
+        return;
+    }
+    m_tickTimes.push_back(simTimeMs);
+    m_stats.totalSimMs += simTimeMs;
+}
+
+bool
+InputRecorder::isInputEvent(const sf::Event& event) {
+    switch (event.type) {
+    case sf::Event::LostFocus:
+    case sf::Event::GainedFocus:
+    case sf::Event::TextEntered:
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased:
+    case sf::Event::MouseWheelScrolled:
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+    case sf::Event::MouseMoved:
+    case sf::Event::MouseEntered:
+    case sf::Event::MouseLeft:
+    case sf::Event::JoystickButtonPressed:
+    case sf::Event::JoystickButtonReleased:
+    case sf::Event::JoystickMoved:
+    case sf::Event::JoystickConnected:
+    case sf::Event::JoystickDisconnected:
+    case sf::Event::TouchBegan:
+    case sf::Event::TouchMoved:
+    case sf::Event::TouchEnded:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void
+InputRecorder::writeTick(uint64_t advance, uint64_t deltaMicros) {
+    writeVarint(advance);
+    writeVarint(deltaMicros);
+    writeVarint(m_frameEvents.size());
+    for (const sf::Event& event : m_frameEvents) {
+        writeEvent(event);
+    }
+    m_stats.events += m_frameEvents.size();
+    if (m_buffer.size() >= FLUSH_BYTES) {
+        m_stats.logBytes += m_buffer.size();
+        flush();
+    }
+}
+
+bool
+InputRecorder::readTick(uint64_t& tick, float& deltaTime) {
+    uint64_t advance = 0;
+    uint64_t micros = 0;
+    if (!readVarint(advance)) {
+        return false;
+    }
+    if (advance == END_OF_LOG) {
+        uint64_t ticks = 0;
+        readVarint(ticks);
+        if (m_readOffset + 8 <= m_buffer.size()) {
+            m_stats.recordedHash = 0;
+            for (int byte = 0; byte < 8; ++byte) {
+                m_stats.recordedHash |= static_cast<uint64_t>(m_buffer[m_readOffset++]) << (byte * 8);
+            }
+        }
+        return false;
+    }
+    if (!readVarint(micros)) {
+        return false;
+    }
+    tick += advance;
+    deltaTime = static_cast<float>(micros) / 1000000.0f;
+    return true;
+}
+
+void
+InputRecorder::writeEvent(const sf::Event& event) {
+    m_buffer.push_back(static_cast<uint8_t>(event.type));
+    switch (event.type) {
+    case sf::Event::TextEntered:
+        writeVarint(event.text.unicode);
+        break;
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased:
+        writeSigned(event.key.code);
+        writeSigned(event.key.scancode);
+        m_buffer.push_back(static_cast<uint8_t>((event.key.alt ? MOD_ALT : 0) | (event.key.control ? MOD_CONTROL : 0) |
+                                                (event.key.shift ? MOD_SHIFT : 0) | (event.key.system ? MOD_SYSTEM : 0)));
+        break;
+    case sf::Event::MouseWheelScrolled:
+        m_buffer.push_back(static_cast<uint8_t>(event.mouseWheelScroll.wheel));
+        writeFloat(event.mouseWheelScroll.delta);
+        writeSigned(event.mouseWheelScroll.x);
+        writeSigned(event.mouseWheelScroll.y);
+        break;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+        m_buffer.push_back(static_cast<uint8_t>(event.mouseButton.button));
+        writeSigned(event.mouseButton.x);
+        writeSigned(event.mouseButton.y);
+        break;
+    case sf::Event::MouseMoved:
+        writeSigned(event.mouseMove.x);
+        writeSigned(event.mouseMove.y);
+        break;
+    case sf::Event::JoystickButtonPressed:
+    case sf::Event::JoystickButtonReleased:
+        writeVarint(event.joystickButton.joystickId);
+        writeVarint(event.joystickButton.button);
+        break;
+    case sf::Event::JoystickMoved:
+        writeVarint(event.joystickMove.joystickId);
+        m_buffer.push_back(static_cast<uint8_t>(event.joystickMove.axis));
+        writeFloat(event.joystickMove.position);
+        break;
+    case sf::Event::JoystickConnected:
+    case sf::Event::JoystickDisconnected:
+        writeVarint(event.joystickConnect.joystickId);
+        break;
+    case sf::Event::TouchBegan:
+    case sf::Event::TouchMoved:
+    case sf::Event::TouchEnded:
+        writeVarint(event.touch.finger);
+        writeSigned(event.touch.x);
+        writeSigned(event.touch.y);
+        break;
+    default:
+        break;
+    }
+}
+
+bool
+InputRecorder::readEvent(sf::Event& event) {
+    if (m_readOffset >= m_buffer.size()) {
+        return false;
+    }
+    event.type = static_cast<sf::Event::EventType>(m_buffer[m_readOffset++]);
+    uint64_t a = 0, b = 0;
+    int64_t x = 0, y = 0;
+    switch (event.type) {
+    case sf::Event::TextEntered:
+        if (!readVarint(a)) {
+            return false;
+        }
+        event.text.unicode = static_cast<sf::Uint32>(a);
+        return true;
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased: {
+        if (!readSigned(x) || !readSigned(y) || m_readOffset >= m_buffer.size()) {
+            return false;
+        }
+        uint8_t modifiers = m_buffer[m_readOffset++];
+        event.key.code = static_cast<sf::Keyboard::Key>(x);
+        event.key.scancode = static_cast<sf::Keyboard::Scancode>(y);
+        event.key.alt = (modifiers & MOD_ALT) != 0;
+        event.key.control = (modifiers & MOD_CONTROL) != 0;
+        event.key.shift = (modifiers & MOD_SHIFT) != 0;
+        event.key.system = (modifiers & MOD_SYSTEM) != 0;
+        return true;
+    }
+    case sf::Event::MouseWheelScrolled:
+        if (m_readOffset >= m_buffer.size()) {
+            return false;
+        }
+        event.mouseWheelScroll.wheel = static_cast<sf::Mouse::Wheel>(m_buffer[m_readOffset++]);
+        if (!readFloat(event.mouseWheelScroll.delta) || !readSigned(x) || !readSigned(y)) {
+            return false;
+        }
+        event.mouseWheelScroll.x = static_cast<int>(x);
+        event.mouseWheelScroll.y = static_cast<int>(y);
+        return true;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+        if (m_readOffset >= m_buffer.size()) {
+            return false;
+        }
+        event.mouseButton.button = static_cast<sf::Mouse::Button>(m_buffer[m_readOffset++]);
+        if (!readSigned(x) || !readSigned(y)) {
+            return false;
+        }
+        event.mouseButton.x = static_cast<int>(x);
+        event.mouseButton.y = static_cast<int>(y);
+        return true;
+    case sf::Event::MouseMoved:
+        if (!readSigned(x) || !readSigned(y)) {
+            return false;
+        }
+        event.mouseMove.x = static_cast<int>(x);
+        event.mouseMove.y = static_cast<int>(y);
+        return true;
+    case sf::Event::JoystickButtonPressed:
+    case sf::Event::JoystickButtonReleased:
+        if (!readVarint(a) || !readVarint(b)) {
+            return false;
+        }
+        event.joystickButton.joystickId = static_cast<unsigned int>(a);
+        event.joystickButton.button = static_cast<unsigned int>(b);
+        return true;
+    case sf::Event::JoystickMoved:
+        if (!readVarint(a) || m_readOffset >= m_buffer.size()) {
+            return false;
+        }
+        event.joystickMove.joystickId = static_cast<unsigned int>(a);
+        event.joystickMove.axis = static_cast<sf::Joystick::Axis>(m_buffer[m_readOffset++]);
+        return readFloat(event.joystickMove.position);
+    case sf::Event::JoystickConnected:
+    case sf::Event::JoystickDisconnected:
+        if (!readVarint(a)) {
+            return false;
+        }
+        event.joystickConnect.joystickId = static_cast<unsigned int>(a);
+        return true;
+    case sf::Event::TouchBegan:
+    case sf::Event::TouchMoved:
+    case sf::Event::TouchEnded:
+        if (!readVarint(a) || !readSigned(x) || !readSigned(y)) {
+            return false;
+        }
+        event.touch.finger = static_cast<unsigned int>(a);
+        event.touch.x = static_cast<int>(x);
+        event.touch.y = static_cast<int>(y);
+        return true;
+    default:
+        return isInputEvent(event);
+    }
+}
+
+void
+InputRecorder::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        m_buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+bool
+InputRecorder::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (m_readOffset >= m_buffer.size()) {
+            return false;
+        }
+        uint8_t byte = m_buffer[m_readOffset++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+InputRecorder::readSigned(int64_t& value) {
+    uint64_t encoded = 0;
+    if (!readVarint(encoded)) {
+        return false;
+    }
+    value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+    return true;
+}
+
+void
+InputRecorder::writeFloat(float value) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int byte = 0; byte < 4; ++byte) {
+        m_buffer.push_back(static_cast<uint8_t>(bits >> (byte * 8)));
+    }
+}
+
+bool
+InputRecorder::readFloat(float& value) {
+    if (m_readOffset + 4 > m_buffer.size()) {
+        return false;
+    }
+    uint32_t bits = 0;
+    for (int byte = 0; byte < 4; ++byte) {
+        bits |= static_cast<uint32_t>(m_buffer[m_readOffset++]) << (byte * 8);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+void
+InputRecorder::flush() {
+    if (m_file && !m_buffer.empty()) {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+        m_file.flush();
+    }
+    m_buffer.clear();
+}
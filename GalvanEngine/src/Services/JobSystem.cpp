@@ -0,0 +1,129 @@
+﻿#include "Services/JobSystem.h"
+
+namespace {
+    /*
+    * @struct ParallelJob
+    * @brief Estado compartido de una llamada a parallelFor.
+    */
+    struct
+        ParallelJob {
+        std::atomic<size_t> next{ 0 };   ///< Siguiente lote por tomar.
+        std::atomic<size_t> done{ 0 };   ///< Lotes terminados.
+        size_t count = 0;
+        size_t batchSize = 0;
+        size_t batches = 0;
+        const std::function<void(size_t, size_t)>* func = nullptr;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    void
+        runBatches(ParallelJob& job) {
+        for (;;) {
+            size_t batch = job.next.fetch_add(1, std::memory_order_relaxed);
+            if (batch >= job.batches) {
+                return;
+            }
+            size_t begin = batch * job.batchSize;
+            size_t end = std::min(begin + job.batchSize, job.count);
+            (*job.func)(begin, end);
+
+            if (job.done.fetch_add(1, std::memory_order_acq_rel) + 1 == job.batches) {
+                std::lock_guard<std::mutex> lock(job.mutex);
+                job.finished.notify_all();
+            }
+        }
+    }
+}
+
+JobSystem::JobSystem() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    unsigned int workers = cores > 1 ? cores - 1 : 0;
+    for (unsigned int i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void
+JobSystem::submit(std::function<void()> job) {
+    if (m_workers.empty()) {
+        job();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void
+JobSystem::parallelFor(size_t count,
+                       size_t minBatch,
+                       const std::function<void(size_t, size_t)>& func) {
+    if (count == 0) {
+        return;
+    }
+    minBatch = std::max<size_t>(minBatch, 1);
+    if (m_workers.empty() || count <= minBatch) {
+        func(0, count);
+        return;
+    }
+
+    // Algunos lotes más que hilos para repartir mejor cuando un lote tarda más que otro
+    size_t maxBatches = (m_workers.size() + 1) * 4;
+    size_t batches = std::min((count + minBatch - 1) / minBatch, maxBatches);
+
+    auto job = std::make_shared<ParallelJob>();
+    job->count = count;
+    job->batchSize = (count + batches - 1) / batches;
+    job->batches = (count + job->batchSize - 1) / job->batchSize;
+    job->func = &func;
+
+    // Un ayudante que llega tarde solo encuentra next >= batches y nunca toca func
+    size_t helpers = std::min<size_t>(m_workers.size(), job->batches - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([job]() {
+            runBatches(*job);
+        });
+    }
+
+    runBatches(*job);
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job]() {
+        return job->done.load(std::memory_order_acquire) == job->batches;
+    });
+}
+
+void
+JobSystem::workerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() {
+                return m_stopping || !m_jobs.empty();
+            });
+            if (m_stopping && m_jobs.empty()) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
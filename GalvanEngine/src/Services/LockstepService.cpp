@@ -0,0 +1,369 @@
+﻿#include "Services/LockstepService.h"
+
+namespace {
+    const sf::Uint32 PROTOCOL_MAGIC = 0x474C434B;
+    const sf::Uint16 PROTOCOL_VERSION = 1;
+    const uint32_t MAX_INPUT_DELAY = 120;
+    const float MAX_CATCH_UP_TICKS = 4.0f;
+    const sf::Uint8 COMMAND_HELD = 1;
+    const sf::Uint8 COMMAND_AXES = 2;
+
+    /**
+     * @brief Bytes que ocupa el paquete en el stream, contando el tamaño que antepone sf::Packet.
+     */
+    size_t
+        wireSize(const sf::Packet& packet) {
+        return packet.getDataSize() + sizeof(sf::Uint32);
+    }
+}
+
+bool
+LockstepService::host(unsigned short port, std::string& error) {
+    stop();
+    if (m_listener.listen(port) != sf::Socket::Done) {
+        error = "Lockstep could not listen on port " + std::to_string(port);
+        return false;
+    }
+    m_listener.setBlocking(false);
+    m_isHost = true;
+    m_stats = LockstepStats();
+    m_state = LOCKSTEP_CONNECTING;
+    return true;
+}
+
+bool
+LockstepService::join(const std::string& address, unsigned short port, float timeoutSeconds, std::string& error) {
+    stop();
+    sf::IpAddress ip(address);
+    if (ip == sf::IpAddress::None) {
+        error = "Lockstep host address is not valid: " + address;
+        return false;
+    }
+    m_socket.setBlocking(true);
+    if (m_socket.connect(ip, port, sf::seconds(timeoutSeconds)) != sf::Socket::Done) {
+        error = "Lockstep could not connect to " + address + ":" + std::to_string(port);
+        return false;
+    }
+    m_socket.setBlocking(false);
+    m_peerConnected = true;
+    m_isHost = false;
+    m_stats = LockstepStats();
+    m_state = LOCKSTEP_CONNECTING;
+
+    // El anfitrión responde con sus parámetros y ahí empieza la sesión
+    sf::Packet hello;
+    hello << static_cast<sf::Uint8>(MESSAGE_HELLO) << PROTOCOL_MAGIC << PROTOCOL_VERSION;
+    queueMessage(hello);
+    flushOutgoing();
+    return true;
+}
+
+void
+LockstepService::stop() {
+    if (m_state == LOCKSTEP_RUNNING) {
+        flushOutgoing();
+    }
+    close();
+    m_state = LOCKSTEP_OFF;
+}
+
+bool
+LockstepService::beginTick(const InputSnapshot& localInput, float realDeltaTime) {
+    if (!isActive()) {
+        return false;
+    }
+    m_pendingPressed |= localInput.pressed;
+    poll();
+    if (m_state != LOCKSTEP_RUNNING) {
+        return false;
+    }
+
+    float tickSeconds = getTickSeconds();
+    m_sessionTime += realDeltaTime;
+    m_accumulator = std::min(m_accumulator + realDeltaTime, tickSeconds * MAX_CATCH_UP_TICKS);
+    if (m_accumulator < tickSeconds) {
+        return false;
+    }
+
+    // El comando local va inputDelay ticks adelante; se envía una sola vez por tick
+    if (m_nextLocalTick <= m_tick + m_settings.inputDelay) {
+        sendLocalCommand(localInput);
+        flushOutgoing();
+    }
+
+    uint32_t remote = 1 - getLocalPlayer();
+    if (m_tick >= m_settings.inputDelay && m_commands[remote].empty()) {
+        // Sin rollback: el tick espera y el tiempo de espera no se recupera después
+        ++m_stats.stalledFrames;
+        m_stats.stalledSeconds += realDeltaTime;
+        m_stallTime += realDeltaTime;
+        m_accumulator = tickSeconds;
+        if (m_stallTime > m_settings.stallTimeout) {
+            close();
+        }
+        return false;
+    }
+    m_stallTime = 0.0f;
+    m_accumulator -= tickSeconds;
+
+    // Los primeros inputDelay ticks no tienen comandos: los dos lados los simulan vacíos
+    for (uint32_t player = 0; player < PLAYER_COUNT; ++player) {
+        Command command = m_tick < m_settings.inputDelay ? Command() : m_commands[player].front();
+        InputSnapshot& input = m_playerInputs[player];
+        uint64_t previous = input.held;
+        input = InputSnapshot();
+        input.frame = m_tick;
+        input.held = command.held;
+        input.pressed = command.held & ~previous;
+        input.released = previous & ~command.held;
+        for (uint32_t axis = 0; axis < InputSnapshot::MAX_AXES; ++axis) {
+            input.axes[axis] = command.axes[axis] / 127.0f;
+        }
+    }
+    return true;
+}
+
+void
+LockstepService::endTick(uint64_t stateHash) {
+    if (m_state != LOCKSTEP_RUNNING) {
+        return;
+    }
+    if (isHashTick()) {
+        sf::Packet packet;
+        packet << static_cast<sf::Uint8>(MESSAGE_HASH)
+               << static_cast<sf::Uint32>(m_tick) << static_cast<sf::Uint32>(m_tick >> 32)
+               << static_cast<sf::Uint32>(stateHash) << static_cast<sf::Uint32>(stateHash >> 32);
+        queueMessage(packet);
+        m_localHashes.push_back(std::make_pair(m_tick, stateHash));
+        compareHashes();
+    }
+    if (m_tick >= m_settings.inputDelay) {
+        for (uint32_t player = 0; player < PLAYER_COUNT; ++player) {
+            m_commands[player].pop_front();
+        }
+    }
+    ++m_tick;
+    m_stats.tick = m_tick;
+    m_stats.bytesPerSecond = m_sessionTime > 0.0f ? m_stats.bytesSent / m_sessionTime : 0.0f;
+    flushOutgoing();
+}
+
+void
+LockstepService::poll() {
+    if (!m_peerConnected) {
+        if (m_listener.accept(m_socket) != sf::Socket::Done) {
+            return;
+        }
+        // Solo hay un invitado; el puerto se libera para no aceptar a nadie más
+        m_socket.setBlocking(false);
+        m_listener.close();
+        m_peerConnected = true;
+    }
+
+    sf::Packet packet;
+    while (isActive()) {
+        sf::Socket::Status status = m_socket.receive(packet);
+        if (status == sf::Socket::Done) {
+            m_stats.bytesReceived += wireSize(packet);
+            handleMessage(packet);
+        }
+        else if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            close();
+        }
+        else {
+            break;
+        }
+    }
+    flushOutgoing();
+}
+
+void
+LockstepService::handleMessage(sf::Packet& packet) {
+    sf::Uint8 type = 0;
+    if (!(packet >> type)) {
+        return;
+    }
+
+    if (type == MESSAGE_HELLO && m_isHost && m_state == LOCKSTEP_CONNECTING) {
+        sf::Uint32 magic = 0;
+        sf::Uint16 version = 0;
+        if (!(packet >> magic >> version) || magic != PROTOCOL_MAGIC || version != PROTOCOL_VERSION) {
+            close();
+            return;
+        }
+        sf::Packet start;
+        start << static_cast<sf::Uint8>(MESSAGE_START) << static_cast<sf::Uint32>(m_settings.inputDelay)
+              << m_settings.tickRate << static_cast<sf::Uint32>(m_settings.hashInterval);
+        queueMessage(start);
+        startSession();
+    }
+    else if (type == MESSAGE_START && !m_isHost && m_state == LOCKSTEP_CONNECTING) {
+        sf::Uint32 inputDelay = 0;
+        float tickRate = 0.0f;
+        sf::Uint32 hashInterval = 0;
+        if (!(packet >> inputDelay >> tickRate >> hashInterval) || inputDelay > MAX_INPUT_DELAY || !(tickRate > 0.0f)) {
+            close();
+            return;
+        }
+        m_settings.inputDelay = inputDelay;
+        m_settings.tickRate = tickRate;
+        m_settings.hashInterval = hashInterval;
+        startSession();
+    }
+    else if (type == MESSAGE_COMMAND && m_state == LOCKSTEP_RUNNING) {
+        // Los campos que no vienen son iguales a los del comando anterior
+        Command command = m_lastReceived;
+        sf::Uint8 flags = 0;
+        packet >> flags;
+        if (flags & COMMAND_HELD) {
+            sf::Uint32 low = 0;
+            sf::Uint32 high = 0;
+            packet >> low >> high;
+            command.held = static_cast<uint64_t>(high) << 32 | low;
+        }
+        if (flags & COMMAND_AXES) {
+            sf::Uint16 changed = 0;
+            packet >> changed;
+            for (uint32_t axis = 0; axis < InputSnapshot::MAX_AXES; ++axis) {
+                if (changed >> axis & 1) {
+                    sf::Int8 value = 0;
+                    packet >> value;
+                    command.axes[axis] = value;
+                }
+            }
+        }
+        if (!packet) {
+            close();
+            return;
+        }
+        m_lastReceived = command;
+        m_commands[1 - getLocalPlayer()].push_back(command);
+    }
+    else if (type == MESSAGE_HASH && m_state == LOCKSTEP_RUNNING) {
+        sf::Uint32 tickLow = 0;
+        sf::Uint32 tickHigh = 0;
+        sf::Uint32 hashLow = 0;
+        sf::Uint32 hashHigh = 0;
+        if (!(packet >> tickLow >> tickHigh >> hashLow >> hashHigh)) {
+            close();
+            return;
+        }
+        m_remoteHashes.push_back(std::make_pair(static_cast<uint64_t>(tickHigh) << 32 | tickLow,
+                                                static_cast<uint64_t>(hashHigh) << 32 | hashLow));
+        compareHashes();
+    }
+}
+
+void
+LockstepService::startSession() {
+    m_state = LOCKSTEP_RUNNING;
+    m_tick = 0;
+    m_nextLocalTick = m_settings.inputDelay;
+    m_accumulator = 0.0f;
+    m_stallTime = 0.0f;
+    m_sessionTime = 0.0f;
+    m_pendingPressed = 0;
+    for (uint32_t player = 0; player < PLAYER_COUNT; ++player) {
+        m_commands[player].clear();
+        m_playerInputs[player] = InputSnapshot();
+    }
+    m_lastSent = Command();
+    m_lastReceived = Command();
+    m_localHashes.clear();
+    m_remoteHashes.clear();
+}
+
+void
+LockstepService::queueMessage(sf::Packet& packet) {
+    m_stats.bytesSent += wireSize(packet);
+    m_outgoing.push_back(packet);
+}
+
+void
+LockstepService::flushOutgoing() {
+    while (m_peerConnected && !m_outgoing.empty()) {
+        // Con el socket no bloqueante un envío parcial se continúa con el mismo paquete
+        sf::Socket::Status status = m_socket.send(m_outgoing.front());
+        if (status == sf::Socket::Done) {
+            m_outgoing.pop_front();
+        }
+        else if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            close();
+        }
+        else {
+            break;
+        }
+    }
+}
+
+void
+LockstepService::sendLocalCommand(const InputSnapshot& localInput) {
+    // Una pulsación más corta que un tick se envía como presionada durante ese tick
+    Command command;
+    command.held = localInput.held | m_pendingPressed;
+    m_pendingPressed = 0;
+    sf::Uint16 changedAxes = 0;
+    for (uint32_t axis = 0; axis < InputSnapshot::MAX_AXES; ++axis) {
+        float value = std::min(std::max(localInput.axes[axis], -1.0f), 1.0f);
+        command.axes[axis] = static_cast<int8_t>(std::lround(value * 127.0f));
+        if (command.axes[axis] != m_lastSent.axes[axis]) {
+            changedAxes |= static_cast<sf::Uint16>(1u << axis);
+        }
+    }
+
+    sf::Uint8 flags = 0;
+    flags |= command.held != m_lastSent.held ? COMMAND_HELD : 0;
+    flags |= changedAxes != 0 ? COMMAND_AXES : 0;
+    sf::Packet packet;
+    packet << static_cast<sf::Uint8>(MESSAGE_COMMAND) << flags;
+    if (flags & COMMAND_HELD) {
+        packet << static_cast<sf::Uint32>(command.held) << static_cast<sf::Uint32>(command.held >> 32);
+    }
+    if (flags & COMMAND_AXES) {
+        packet << changedAxes;
+        for (uint32_t axis = 0; axis < InputSnapshot::MAX_AXES; ++axis) {
+            if (changedAxes >> axis & 1) {
+                packet << static_cast<sf::Int8>(command.axes[axis]);
+            }
+        }
+    }
+    queueMessage(packet);
+
+    m_commands[getLocalPlayer()].push_back(command);
+    m_lastSent = command;
+    ++m_nextLocalTick;
+}
+
+void
+LockstepService::compareHashes() {
+    while (!m_localHashes.empty() && !m_remoteHashes.empty()) {
+        const std::pair<uint64_t, uint64_t>& local = m_localHashes.front();
+        const std::pair<uint64_t, uint64_t>& remote = m_remoteHashes.front();
+        if (local.first < remote.first) {
+            m_localHashes.pop_front();
+            continue;
+        }
+        if (remote.first < local.first) {
+            m_remoteHashes.pop_front();
+            continue;
+        }
+        ++m_stats.hashesCompared;
+        if (local.second != remote.second && !m_stats.desynced) {
+            m_stats.desynced = true;
+            m_stats.desyncTick = local.first;
+        }
+        m_localHashes.pop_front();
+        m_remoteHashes.pop_front();
+    }
+}
+
+void
+LockstepService::close() {
+    m_socket.disconnect();
+    m_listener.close();
+    m_peerConnected = false;
+    m_outgoing.clear();
+    if (m_state != LOCKSTEP_OFF) {
+        m_state = LOCKSTEP_CLOSED;
+    }
+}
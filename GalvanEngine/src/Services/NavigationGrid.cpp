@@ -0,0 +1,425 @@
+﻿#include "Services/NavigationGrid.h"
+#include "ECS/Tilemap.h"
+#include "ECS/PhysicsWorld.h"
+
+namespace {
+    const float DIAGONAL_COST = 1.41421356f;
+
+    /*
+    * @struct SearchScratch
+    * @brief Memoria de una búsqueda, reutilizada entre búsquedas del mismo hilo.
+    *
+    * En lugar de limpiar los arreglos en cada búsqueda se marca cada celda con la generación
+    * en que se tocó; una celda con otra generación cuenta como no visitada.
+    */
+    struct
+        SearchScratch {
+        std::vector<float> cost;
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> stamp;
+        std::vector<uint8_t> closed;
+        std::vector<std::pair<float, uint32_t>> heap;
+        uint32_t generation = 0;
+
+        void
+            begin(size_t cellCount) {
+            if (stamp.size() < cellCount) {
+                cost.resize(cellCount);
+                parent.resize(cellCount);
+                stamp.resize(cellCount, 0);
+                closed.resize(cellCount);
+            }
+            if (++generation == 0) {
+                std::fill(stamp.begin(), stamp.end(), 0);
+                generation = 1;
+            }
+            heap.clear();
+        }
+
+        /**
+         * @brief Inicializa la celda la primera vez que la búsqueda la toca.
+         */
+        void
+            touch(uint32_t cell) {
+            if (stamp[cell] != generation) {
+                stamp[cell] = generation;
+                cost[cell] = std::numeric_limits<float>::max();
+                closed[cell] = 0;
+            }
+        }
+
+        void
+            push(float priority, uint32_t cell) {
+            heap.emplace_back(priority, cell);
+            std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<float, uint32_t>>());
+        }
+
+        uint32_t
+            pop() {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<float, uint32_t>>());
+            uint32_t cell = heap.back().second;
+            heap.pop_back();
+            return cell;
+        }
+    };
+
+    thread_local SearchScratch t_scratch;
+
+    /**
+     * @brief Distancia con movimientos rectos y diagonales, sin obstáculos.
+     */
+    inline float
+        octile(int dx, int dy) {
+        dx = std::abs(dx);
+        dy = std::abs(dy);
+        return static_cast<float>(dx + dy) + (DIAGONAL_COST - 2.0f) * static_cast<float>(std::min(dx, dy));
+    }
+
+    inline int
+        sign(int value) {
+        return (value > 0) - (value < 0);
+    }
+}
+
+NavigationGrid::NavigationGrid(uint32_t width, uint32_t height, float cellSize, const sf::Vector2f& origin)
+    : m_width(width),
+      m_height(height),
+      m_regionsX((width + REGION_SIZE - 1) / REGION_SIZE),
+      m_cellSize(cellSize),
+      m_origin(origin),
+      m_blocked(static_cast<size_t>(width) * height, 0) {
+    uint32_t regionsY = (height + REGION_SIZE - 1) / REGION_SIZE;
+    m_regionVersions.assign(static_cast<size_t>(m_regionsX) * regionsY, 0);
+}
+
+void
+NavigationGrid::setBlocked(uint32_t x, uint32_t y, bool blocked) {
+    if (x >= m_width || y >= m_height) {
+        return;
+    }
+    uint8_t& cell = m_blocked[static_cast<size_t>(y) * m_width + x];
+    if (cell != static_cast<uint8_t>(blocked)) {
+        cell = static_cast<uint8_t>(blocked);
+        ++m_regionVersions[getRegion(static_cast<int>(x), static_cast<int>(y))];
+    }
+}
+
+void
+NavigationGrid::blockRect(const sf::FloatRect& worldRect) {
+    sf::Vector2i first = worldToCell(sf::Vector2f(worldRect.left, worldRect.top));
+    sf::Vector2i last = worldToCell(sf::Vector2f(worldRect.left + worldRect.width, worldRect.top + worldRect.height));
+    first.x = std::max(first.x, 0);
+    first.y = std::max(first.y, 0);
+    last.x = std::min(last.x, static_cast<int>(m_width) - 1);
+    last.y = std::min(last.y, static_cast<int>(m_height) - 1);
+    for (int y = first.y; y <= last.y; ++y) {
+        for (int x = first.x; x <= last.x; ++x) {
+            setBlocked(static_cast<uint32_t>(x), static_cast<uint32_t>(y), true);
+        }
+    }
+}
+
+void
+NavigationGrid::blockTiles(const Tilemap& tilemap, uint32_t layer, const std::vector<uint16_t>& blockedTiles) {
+    uint32_t width = std::min(m_width, tilemap.getWidth());
+    uint32_t height = std::min(m_height, tilemap.getHeight());
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint16_t tile = tilemap.getTile(layer, x, y);
+            if (std::find(blockedTiles.begin(), blockedTiles.end(), tile) != blockedTiles.end()) {
+                setBlocked(x, y, true);
+            }
+        }
+    }
+}
+
+void
+NavigationGrid::blockStaticColliders() {
+    std::vector<sf::FloatRect> bounds;
+    PhysicsWorld::getInstance().getStaticBounds(bounds);
+    for (const sf::FloatRect& rect : bounds) {
+        blockRect(rect);
+    }
+}
+
+sf::Vector2i
+NavigationGrid::worldToCell(const sf::Vector2f& position) const {
+    return sf::Vector2i(static_cast<int>(std::floor((position.x - m_origin.x) / m_cellSize)),
+                        static_cast<int>(std::floor((position.y - m_origin.y) / m_cellSize)));
+}
+
+sf::Vector2f
+NavigationGrid::cellToWorld(const sf::Vector2i& cell) const {
+    return sf::Vector2f(m_origin.x + (static_cast<float>(cell.x) + 0.5f) * m_cellSize,
+                        m_origin.y + (static_cast<float>(cell.y) + 0.5f) * m_cellSize);
+}
+
+bool
+NavigationGrid::findPath(const sf::Vector2i& start,
+                         const sf::Vector2i& goal,
+                         PathAlgorithm algorithm,
+                         std::vector<sf::Vector2i>& corners,
+                         uint32_t& expanded) const {
+    corners.clear();
+    expanded = 0;
+    if (!isWalkable(start.x, start.y) || !isWalkable(goal.x, goal.y)) {
+        return false;
+    }
+    if (start == goal) {
+        corners.push_back(start);
+        return true;
+    }
+
+    uint32_t startIndex = getCellIndex(start);
+    uint32_t goalIndex = getCellIndex(goal);
+    bool found = algorithm == PATH_JPS ? searchJps(startIndex, goalIndex, expanded)
+                                       : searchAStar(startIndex, goalIndex, expanded);
+    if (!found) {
+        return false;
+    }
+
+    // Recorre los padres desde la meta y deja solo las celdas donde cambia la dirección
+    const SearchScratch& scratch = t_scratch;
+    std::vector<sf::Vector2i> nodes;
+    for (uint32_t cell = goalIndex; cell != startIndex; cell = scratch.parent[cell]) {
+        nodes.emplace_back(static_cast<int>(cell % m_width), static_cast<int>(cell / m_width));
+    }
+    nodes.push_back(start);
+    std::reverse(nodes.begin(), nodes.end());
+
+    corners.push_back(nodes.front());
+    for (size_t i = 1; i + 1 < nodes.size(); ++i) {
+        sf::Vector2i in(sign(nodes[i].x - nodes[i - 1].x), sign(nodes[i].y - nodes[i - 1].y));
+        sf::Vector2i out(sign(nodes[i + 1].x - nodes[i].x), sign(nodes[i + 1].y - nodes[i].y));
+        if (in != out) {
+            corners.push_back(nodes[i]);
+        }
+    }
+    corners.push_back(nodes.back());
+    return true;
+}
+
+bool
+NavigationGrid::searchAStar(uint32_t start, uint32_t goal, uint32_t& expanded) const {
+    SearchScratch& scratch = t_scratch;
+    scratch.begin(m_blocked.size());
+    const int goalX = static_cast<int>(goal % m_width);
+    const int goalY = static_cast<int>(goal / m_width);
+
+    scratch.touch(start);
+    scratch.cost[start] = 0.0f;
+    scratch.push(0.0f, start);
+    while (!scratch.heap.empty()) {
+        uint32_t cell = scratch.pop();
+        if (scratch.closed[cell]) {
+            continue;
+        }
+        scratch.closed[cell] = 1;
+        ++expanded;
+        if (cell == goal) {
+            return true;
+        }
+
+        const int x = static_cast<int>(cell % m_width);
+        const int y = static_cast<int>(cell / m_width);
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if ((dx == 0 && dy == 0) || !isWalkable(x + dx, y + dy)) {
+                    continue;
+                }
+                bool diagonal = dx != 0 && dy != 0;
+                if (diagonal && (!isWalkable(x + dx, y) || !isWalkable(x, y + dy))) {
+                    continue;
+                }
+                uint32_t next = static_cast<uint32_t>(y + dy) * m_width + static_cast<uint32_t>(x + dx);
+                scratch.touch(next);
+                float cost = scratch.cost[cell] + (diagonal ? DIAGONAL_COST : 1.0f);
+                if (!scratch.closed[next] && cost < scratch.cost[next]) {
+                    scratch.cost[next] = cost;
+                    scratch.parent[next] = cell;
+                    scratch.push(cost + octile(goalX - (x + dx), goalY - (y + dy)), next);
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool
+NavigationGrid::searchJps(uint32_t start, uint32_t goal, uint32_t& expanded) const {
+    SearchScratch& scratch = t_scratch;
+    scratch.begin(m_blocked.size());
+    const int goalX = static_cast<int>(goal % m_width);
+    const int goalY = static_cast<int>(goal / m_width);
+
+    scratch.touch(start);
+    scratch.cost[start] = 0.0f;
+    scratch.parent[start] = start;
+    scratch.push(0.0f, start);
+
+    sf::Vector2i directions[8];
+    while (!scratch.heap.empty()) {
+        uint32_t cell = scratch.pop();
+        if (scratch.closed[cell]) {
+            continue;
+        }
+        scratch.closed[cell] = 1;
+        ++expanded;
+        if (cell == goal) {
+            return true;
+        }
+
+        const int x = static_cast<int>(cell % m_width);
+        const int y = static_cast<int>(cell / m_width);
+        int count = 0;
+        if (cell == start) {
+            // Sin padre se prueban los 8 vecinos
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx != 0 || dy != 0) {
+                        directions[count++] = sf::Vector2i(dx, dy);
+                    }
+                }
+            }
+        }
+        else {
+            // Vecinos naturales y forzados según la dirección de llegada
+            const int px = static_cast<int>(scratch.parent[cell] % m_width);
+            const int py = static_cast<int>(scratch.parent[cell] / m_width);
+            const int dx = sign(x - px);
+            const int dy = sign(y - py);
+            if (dx != 0 && dy != 0) {
+                directions[count++] = sf::Vector2i(0, dy);
+                directions[count++] = sf::Vector2i(dx, 0);
+                directions[count++] = sf::Vector2i(dx, dy);
+            }
+            else if (dx != 0) {
+                directions[count++] = sf::Vector2i(dx, 0);
+                directions[count++] = sf::Vector2i(dx, 1);
+                directions[count++] = sf::Vector2i(dx, -1);
+                directions[count++] = sf::Vector2i(0, 1);
+                directions[count++] = sf::Vector2i(0, -1);
+            }
+            else {
+                directions[count++] = sf::Vector2i(0, dy);
+                directions[count++] = sf::Vector2i(1, dy);
+                directions[count++] = sf::Vector2i(-1, dy);
+                directions[count++] = sf::Vector2i(1, 0);
+                directions[count++] = sf::Vector2i(-1, 0);
+            }
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const int dx = directions[i].x;
+            const int dy = directions[i].y;
+            if (!isWalkable(x + dx, y + dy) ||
+                (dx != 0 && dy != 0 && (!isWalkable(x + dx, y) || !isWalkable(x, y + dy)))) {
+                continue;
+            }
+            uint32_t jumpPoint = jump(x + dx, y + dy, dx, dy, goalX, goalY);
+            if (jumpPoint == INVALID_CELL) {
+                continue;
+            }
+            const int jx = static_cast<int>(jumpPoint % m_width);
+            const int jy = static_cast<int>(jumpPoint / m_width);
+            scratch.touch(jumpPoint);
+            float cost = scratch.cost[cell] + octile(jx - x, jy - y);
+            if (!scratch.closed[jumpPoint] && cost < scratch.cost[jumpPoint]) {
+                scratch.cost[jumpPoint] = cost;
+                scratch.parent[jumpPoint] = cell;
+                scratch.push(cost + octile(goalX - jx, goalY - jy), jumpPoint);
+            }
+        }
+    }
+    return false;
+}
+
+uint32_t
+NavigationGrid::jump(int x, int y, int dx, int dy, int goalX, int goalY) const {
+    while (true) {
+        if (!isWalkable(x, y)) {
+            return INVALID_CELL;
+        }
+        uint32_t cell = static_cast<uint32_t>(y) * m_width + static_cast<uint32_t>(x);
+        if (x == goalX && y == goalY) {
+            return cell;
+        }
+
+        if (dx != 0 && dy != 0) {
+            // Una diagonal se detiene donde alguno de sus barridos rectos encuentra algo
+            if (jump(x + dx, y, dx, 0, goalX, goalY) != INVALID_CELL ||
+                jump(x, y + dy, 0, dy, goalX, goalY) != INVALID_CELL) {
+                return cell;
+            }
+        }
+        else if (dx != 0) {
+            if ((isWalkable(x, y - 1) && !isWalkable(x - dx, y - 1)) ||
+                (isWalkable(x, y + 1) && !isWalkable(x - dx, y + 1))) {
+                return cell;
+            }
+        }
+        else {
+            if ((isWalkable(x - 1, y) && !isWalkable(x - 1, y - dy)) ||
+                (isWalkable(x + 1, y) && !isWalkable(x + 1, y - dy))) {
+                return cell;
+            }
+        }
+
+        // Sin cortar esquinas: la diagonal necesita libres las dos celdas ortogonales
+        if (!isWalkable(x + dx, y) || !isWalkable(x, y + dy)) {
+            return INVALID_CELL;
+        }
+        x += dx;
+        y += dy;
+    }
+}
+
+bool
+NavigationGrid::isSegmentWalkable(const sf::Vector2i& from, const sf::Vector2i& to) const {
+    int x = from.x;
+    int y = from.y;
+    if (!isWalkable(x, y)) {
+        return false;
+    }
+    while (x != to.x || y != to.y) {
+        int dx = sign(to.x - x);
+        int dy = sign(to.y - y);
+        if (dx != 0 && dy != 0 && (!isWalkable(x + dx, y) || !isWalkable(x, y + dy))) {
+            return false;
+        }
+        x += dx;
+        y += dy;
+        if (!isWalkable(x, y)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+NavigationGrid::collectRegions(const std::vector<sf::Vector2i>& corners, std::vector<uint32_t>& regions) const {
+    regions.clear();
+    for (size_t i = 0; i < corners.size(); ++i) {
+        int x = corners[i].x;
+        int y = corners[i].y;
+        regions.push_back(getRegion(x, y));
+        if (i + 1 == corners.size()) {
+            break;
+        }
+        const sf::Vector2i& to = corners[i + 1];
+        while (x != to.x || y != to.y) {
+            int dx = sign(to.x - x);
+            int dy = sign(to.y - y);
+            if (dx != 0 && dy != 0) {
+                // Las celdas ortogonales también deciden si la diagonal sigue siendo válida
+                regions.push_back(getRegion(x + dx, y));
+                regions.push_back(getRegion(x, y + dy));
+            }
+            x += dx;
+            y += dy;
+            regions.push_back(getRegion(x, y));
+        }
+    }
+    std::sort(regions.begin(), regions.end());
+    regions.erase(std::unique(regions.begin(), regions.end()), regions.end());
+}
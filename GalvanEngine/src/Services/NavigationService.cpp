@@ -0,0 +1,347 @@
+﻿#include "Services/NavigationService.h"
+#include "Services/JobSystem.h"
+
+void
+NavigationService::setGrid(const NavigationGrid& grid) {
+    m_grid = grid;
+    m_gridChanges.clear();
+    m_cache.clear();
+    m_lru.clear();
+    for (auto& field : m_flowFields) {
+        field->rebuild(m_grid);
+    }
+
+    // Las rutas entregadas se calcularon sobre otra rejilla
+    for (uint32_t i = 0; i < m_requests.size(); ++i) {
+        Request& request = m_requests[i];
+        if (request.state != PATH_INVALID) {
+            request.state = PATH_PENDING;
+            enqueue(i);
+        }
+    }
+}
+
+void
+NavigationService::setBlocked(const sf::Vector2i& cell, bool blocked) {
+    m_gridChanges.emplace_back(cell, blocked);
+}
+
+PathHandle
+NavigationService::requestPath(const sf::Vector2f& start, const sf::Vector2f& goal) {
+    uint32_t index;
+    if (!m_freeRequests.empty()) {
+        index = m_freeRequests.back();
+        m_freeRequests.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(m_requests.size());
+        m_requests.emplace_back();
+    }
+
+    Request& request = m_requests[index];
+    request.start = m_grid.worldToCell(start);
+    request.goal = m_grid.worldToCell(goal);
+    request.state = PATH_PENDING;
+    request.path.reset();
+    enqueue(index);
+    ++m_stats.requests;
+
+    PathHandle handle;
+    handle.index = index;
+    handle.generation = request.generation;
+    return handle;
+}
+
+PathState
+NavigationService::getState(PathHandle handle) const {
+    if (handle.index >= m_requests.size() || m_requests[handle.index].generation != handle.generation) {
+        return PATH_INVALID;
+    }
+    return m_requests[handle.index].state;
+}
+
+std::shared_ptr<const NavPath>
+NavigationService::getPath(PathHandle handle) const {
+    if (handle.index >= m_requests.size() || m_requests[handle.index].generation != handle.generation) {
+        return nullptr;
+    }
+    return m_requests[handle.index].path;
+}
+
+void
+NavigationService::release(PathHandle handle) {
+    if (getState(handle) == PATH_INVALID) {
+        return;
+    }
+    Request& request = m_requests[handle.index];
+    request.state = PATH_INVALID;
+    request.path.reset();
+    ++request.generation;
+    m_freeRequests.push_back(handle.index);
+}
+
+void
+NavigationService::setCacheCapacity(size_t capacity) {
+    m_cacheCapacity = capacity;
+    while (m_cache.size() > m_cacheCapacity) {
+        m_cache.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+}
+
+std::shared_ptr<const FlowField>
+NavigationService::getFlowField(const sf::Vector2f& goal) {
+    sf::Vector2i cell = m_grid.worldToCell(goal);
+    for (auto it = m_flowFields.begin(); it != m_flowFields.end(); ++it) {
+        if ((*it)->getGoal() == cell) {
+            m_flowFields.splice(m_flowFields.begin(), m_flowFields, it);
+            return m_flowFields.front();
+        }
+    }
+
+    m_flowFields.push_front(std::make_shared<FlowField>(m_grid, cell));
+    ++m_stats.flowFieldBuilds;
+    if (m_flowFields.size() > m_flowFieldCapacity) {
+        m_flowFields.pop_back();
+    }
+    return m_flowFields.front();
+}
+
+void
+NavigationService::setFlowFieldCapacity(size_t capacity) {
+    m_flowFieldCapacity = std::max<size_t>(capacity, 1);
+    while (m_flowFields.size() > m_flowFieldCapacity) {
+        m_flowFields.pop_back();
+    }
+}
+
+void
+NavigationService::update() {
+    sf::Clock clock;
+    m_stats.flowCellsUpdated = 0;
+    applyGridChanges();
+    m_stats.expandedNodes = 0;
+
+    JobSystem& jobs = JobSystem::getInstance();
+    const size_t batchSize = std::max<size_t>(16, (jobs.getWorkerCount() + 1) * 8);
+    std::vector<uint32_t> batch;
+    std::vector<Search> searches;
+    std::unordered_map<uint64_t, size_t> searchOfKey;
+
+    // Siempre se procesa al menos un lote para que la cola avance aunque el presupuesto sea mínimo
+    do {
+        batch.clear();
+        searches.clear();
+        searchOfKey.clear();
+
+        while (batch.size() < batchSize && !m_queue.empty()) {
+            uint32_t index = m_queue.front();
+            m_queue.pop_front();
+            Request& request = m_requests[index];
+            request.queued = false;
+            if (request.state != PATH_PENDING) {
+                continue;
+            }
+
+            uint32_t startCell = m_grid.getCellIndex(request.start);
+            uint32_t goalCell = m_grid.getCellIndex(request.goal);
+            if (startCell == NavigationGrid::INVALID_CELL || goalCell == NavigationGrid::INVALID_CELL) {
+                request.state = PATH_FAILED;
+                request.path.reset();
+                ++m_stats.failed;
+                continue;
+            }
+
+            uint64_t key = makeKey(startCell, goalCell);
+            std::shared_ptr<const NavPath> cached = findCached(key);
+            if (cached) {
+                deliver(request, cached);
+                ++m_stats.cacheHits;
+                continue;
+            }
+
+            // Peticiones repetidas dentro del lote comparten la misma búsqueda
+            if (searchOfKey.emplace(key, searches.size()).second) {
+                Search search;
+                search.key = key;
+                search.start = request.start;
+                search.goal = request.goal;
+                searches.push_back(search);
+            }
+            batch.push_back(index);
+        }
+
+        if (searches.empty()) {
+            continue;
+        }
+
+        jobs.parallelFor(searches.size(), 1, [this, &searches](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Search& search = searches[i];
+                std::vector<sf::Vector2i> corners;
+                if (!m_grid.findPath(search.start, search.goal, m_algorithm, corners, search.expanded)) {
+                    continue;
+                }
+                auto path = std::make_shared<NavPath>();
+                path->corners = std::move(corners);
+                path->waypoints.reserve(path->corners.size());
+                for (size_t c = 0; c < path->corners.size(); ++c) {
+                    path->waypoints.push_back(m_grid.cellToWorld(path->corners[c]));
+                    if (c > 0) {
+                        sf::Vector2f delta = path->waypoints[c] - path->waypoints[c - 1];
+                        path->length += std::sqrt(delta.x * delta.x + delta.y * delta.y);
+                    }
+                }
+                m_grid.collectRegions(path->corners, path->regions);
+                search.path = path;
+            }
+        });
+
+        m_stats.searches += searches.size();
+        for (const Search& search : searches) {
+            m_stats.expandedNodes += search.expanded;
+            if (search.path) {
+                storeCached(search.key, search.path);
+            }
+        }
+        for (uint32_t index : batch) {
+            Request& request = m_requests[index];
+            uint64_t key = makeKey(m_grid.getCellIndex(request.start), m_grid.getCellIndex(request.goal));
+            const Search& search = searches[searchOfKey[key]];
+            if (search.path) {
+                deliver(request, search.path);
+            }
+            else {
+                request.state = PATH_FAILED;
+                request.path.reset();
+                ++m_stats.failed;
+            }
+        }
+    } while (!m_queue.empty() && clock.getElapsedTime().asMicroseconds() < static_cast<int64_t>(m_frameBudgetMs * 1000.0f));
+
+    m_stats.pending = m_queue.size();
+    m_stats.cachedPaths = m_cache.size();
+    m_stats.updateTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+std::shared_ptr<const NavPath>
+NavigationService::findCached(uint64_t key) {
+    auto it = m_cache.find(key);
+    if (it == m_cache.end()) {
+        return nullptr;
+    }
+    CacheEntry& entry = it->second;
+    if (!isStillWalkable(*entry.path, entry.regionVersions)) {
+        m_lru.erase(entry.lruPosition);
+        m_cache.erase(it);
+        ++m_stats.invalidated;
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+    return entry.path;
+}
+
+void
+NavigationService::storeCached(uint64_t key, const std::shared_ptr<const NavPath>& path) {
+    if (m_cacheCapacity == 0) {
+        return;
+    }
+    auto inserted = m_cache.emplace(key, CacheEntry());
+    CacheEntry& entry = inserted.first->second;
+    if (inserted.second) {
+        m_lru.push_front(key);
+        entry.lruPosition = m_lru.begin();
+    }
+    else {
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+    }
+    entry.path = path;
+    entry.regionVersions.resize(path->regions.size());
+    for (size_t i = 0; i < path->regions.size(); ++i) {
+        entry.regionVersions[i] = m_grid.getRegionVersion(path->regions[i]);
+    }
+
+    while (m_cache.size() > m_cacheCapacity) {
+        m_cache.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+}
+
+bool
+NavigationService::isStillWalkable(const NavPath& path, std::vector<uint32_t>& regionVersions) {
+    bool changed = false;
+    for (size_t i = 0; i < path.regions.size() && !changed; ++i) {
+        changed = m_grid.getRegionVersion(path.regions[i]) != regionVersions[i];
+    }
+    if (!changed) {
+        return true;
+    }
+
+    for (size_t i = 0; i + 1 < path.corners.size(); ++i) {
+        if (!m_grid.isSegmentWalkable(path.corners[i], path.corners[i + 1])) {
+            return false;
+        }
+    }
+    if (path.corners.size() == 1 && !m_grid.isWalkable(path.corners[0].x, path.corners[0].y)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < path.regions.size(); ++i) {
+        regionVersions[i] = m_grid.getRegionVersion(path.regions[i]);
+    }
+    ++m_stats.revalidated;
+    return true;
+}
+
+void
+NavigationService::enqueue(uint32_t index) {
+    Request& request = m_requests[index];
+    if (!request.queued) {
+        request.queued = true;
+        m_queue.push_back(index);
+    }
+}
+
+void
+NavigationService::deliver(Request& request, const std::shared_ptr<const NavPath>& path) {
+    request.path = path;
+    request.state = PATH_READY;
+    request.regionVersions.resize(path->regions.size());
+    for (size_t i = 0; i < path->regions.size(); ++i) {
+        request.regionVersions[i] = m_grid.getRegionVersion(path->regions[i]);
+    }
+}
+
+void
+NavigationService::applyGridChanges() {
+    if (m_gridChanges.empty()) {
+        return;
+    }
+    std::vector<sf::Vector2i> changedCells;
+    for (const auto& change : m_gridChanges) {
+        const sf::Vector2i& cell = change.first;
+        if (m_grid.isInside(cell) && m_grid.isWalkable(cell.x, cell.y) == change.second) {
+            m_grid.setBlocked(static_cast<uint32_t>(cell.x), static_cast<uint32_t>(cell.y), change.second);
+            changedCells.push_back(cell);
+        }
+    }
+    m_gridChanges.clear();
+    if (changedCells.empty()) {
+        return;
+    }
+
+    for (auto& field : m_flowFields) {
+        field->repair(m_grid, changedCells);
+        m_stats.flowCellsUpdated += field->getLastUpdatedCells();
+    }
+
+    // Las rutas del caché se revisan al consultarlas; las ya entregadas se revisan aquí
+    for (uint32_t i = 0; i < m_requests.size(); ++i) {
+        Request& request = m_requests[i];
+        if (request.state == PATH_READY && !isStillWalkable(*request.path, request.regionVersions)) {
+            request.state = PATH_PENDING;
+            enqueue(i);
+            ++m_stats.invalidated;
+        }
+    }
+}
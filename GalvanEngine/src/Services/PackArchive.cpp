@@ -0,0 +1,448 @@
+﻿#include "Services/PackArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef GALVAN_PACK_LZ4
+#include <lz4.h>
+#endif
+#ifdef GALVAN_PACK_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    /**
+     * @brief Carácter de ruta normalizado: minúscula y '/' como separador.
+     */
+    inline char
+        normalizeChar(char c) {
+        if (c == '\\') {
+            return '/';
+        }
+        if (c >= 'A' && c <= 'Z') {
+            return static_cast<char>(c - 'A' + 'a');
+        }
+        return c;
+    }
+
+    inline uint64_t
+        hashAppend(uint64_t hash, std::string_view text) {
+        for (char c : text) {
+            hash ^= static_cast<uint8_t>(normalizeChar(c));
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Compara un nombre guardado con nombre + '.' + extensión sin construir la cadena.
+     */
+    bool
+        matchesName(std::string_view stored, std::string_view name, std::string_view extension) {
+        size_t expected = name.size() + (extension.empty() ? 0 : extension.size() + 1);
+        if (stored.size() != expected) {
+            return false;
+        }
+        for (size_t i = 0; i < name.size(); ++i) {
+            if (stored[i] != normalizeChar(name[i])) {
+                return false;
+            }
+        }
+        if (extension.empty()) {
+            return true;
+        }
+        if (stored[name.size()] != '.') {
+            return false;
+        }
+        for (size_t i = 0; i < extension.size(); ++i) {
+            if (stored[name.size() + 1 + i] != normalizeChar(extension[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief true si [offset, offset + length) cabe en size bytes, sin desbordar la suma.
+     */
+    inline bool
+        fitsIn(uint64_t offset, uint64_t length, uint64_t size) {
+        return offset <= size && length <= size - offset;
+    }
+
+    /**
+     * @brief Comprime data; devuelve false si la compresión no está disponible o falla.
+     */
+    bool
+        compress(PackCompression compression, const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+        (void)data;
+        (void)out;
+        switch (compression) {
+#ifdef GALVAN_PACK_LZ4
+        case COMPRESSION_LZ4: {
+            out.resize(LZ4_compressBound(static_cast<int>(data.size())));
+            int written = LZ4_compress_default(reinterpret_cast<const char*>(data.data()),
+                                               reinterpret_cast<char*>(out.data()),
+                                               static_cast<int>(data.size()),
+                                               static_cast<int>(out.size()));
+            if (written <= 0) {
+                return false;
+            }
+            out.resize(written);
+            return true;
+        }
+#endif
+#ifdef GALVAN_PACK_ZSTD
+        case COMPRESSION_ZSTD: {
+            out.resize(ZSTD_compressBound(data.size()));
+            size_t written = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), 19);
+            if (ZSTD_isError(written)) {
+                return false;
+            }
+            out.resize(written);
+            return true;
+        }
+#endif
+        default:
+            return false;
+        }
+    }
+}
+
+PackArchive::~PackArchive() {
+    close();
+}
+
+bool
+PackArchive::open(const std::string& path, std::string& error) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Can't open pack: " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // El mapeo mantiene el archivo abierto; el descriptor ya no se necesita
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        error = "Can't map pack: " + path;
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        error = "Can't map pack: " + path;
+        return false;
+    }
+    m_mapping = mapping;
+    m_base = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Can't open pack: " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        error = "Can't read pack size: " + path;
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // El mapeo mantiene el archivo abierto; el descriptor ya no se necesita
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        error = "Can't map pack: " + path;
+        return false;
+    }
+    m_base = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+
+    // Validar que el encabezado, el índice y la tabla de nombres estén dentro del archivo
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(m_base);
+    if (m_size < sizeof(PackHeader) || std::memcmp(header->magic, "GPAK", 4) != 0 ||
+        header->version != VERSION ||
+        !fitsIn(header->indexOffset, static_cast<uint64_t>(header->entryCount) * sizeof(PackEntry), m_size) ||
+        header->namesOffset > m_size) {
+        close();
+        error = "Invalid pack: " + path;
+        return false;
+    }
+
+    // Cada entrada se valida una vez aquí; read y getName confían en el índice después
+    const PackEntry* entries = reinterpret_cast<const PackEntry*>(m_base + header->indexOffset);
+    uint64_t namesSize = m_size - header->namesOffset;
+    for (uint32_t i = 0; i < header->entryCount; ++i) {
+        const PackEntry& entry = entries[i];
+        if (!fitsIn(entry.offset, entry.storedSize, m_size) ||
+            !fitsIn(entry.nameOffset, entry.nameLength, namesSize) ||
+            (entry.compression == COMPRESSION_NONE && entry.size != entry.storedSize)) {
+            close();
+            error = "Invalid pack entry " + std::to_string(i) + ": " + path;
+            return false;
+        }
+    }
+    m_header = header;
+    m_entries = entries;
+    m_names = reinterpret_cast<const char*>(m_base + header->namesOffset);
+    return true;
+}
+
+void
+PackArchive::close() {
+    if (m_base == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_base);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    m_mapping = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(m_base), m_size);
+#endif
+    m_base = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_names = nullptr;
+}
+
+const PackEntry*
+PackArchive::find(std::string_view name, std::string_view extension) const {
+    if (m_header == nullptr) {
+        return nullptr;
+    }
+    uint64_t hash = hashPath(name, extension);
+    const PackEntry* begin = m_entries;
+    const PackEntry* end = m_entries + m_header->entryCount;
+    const PackEntry* it = std::lower_bound(begin, end, hash,
+        [](const PackEntry& entry, uint64_t value) {
+            return entry.hash < value;
+        });
+
+    // Las colisiones quedan contiguas; se confirma comparando el nombre
+    for (; it != end && it->hash == hash; ++it) {
+        if (matchesName(getName(*it), name, extension)) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+bool
+PackArchive::read(const PackEntry& entry,
+                  std::vector<uint8_t>& scratch,
+                  const uint8_t*& data,
+                  size_t& size) const {
+    (void)scratch; // Solo se usa con las compresiones habilitadas en la compilación
+    if (m_base == nullptr || !fitsIn(entry.offset, entry.storedSize, m_size)) {
+        return false;
+    }
+    const uint8_t* stored = m_base + entry.offset;
+
+    switch (entry.compression) {
+    case COMPRESSION_NONE:
+        data = stored;
+        size = static_cast<size_t>(entry.storedSize);
+        return true;
+#ifdef GALVAN_PACK_LZ4
+    case COMPRESSION_LZ4: {
+        scratch.resize(static_cast<size_t>(entry.size));
+        int written = LZ4_decompress_safe(reinterpret_cast<const char*>(stored),
+                                          reinterpret_cast<char*>(scratch.data()),
+                                          static_cast<int>(entry.storedSize),
+                                          static_cast<int>(entry.size));
+        if (written != static_cast<int>(entry.size)) {
+            return false;
+        }
+        data = scratch.data();
+        size = scratch.size();
+        return true;
+    }
+#endif
+#ifdef GALVAN_PACK_ZSTD
+    case COMPRESSION_ZSTD: {
+        scratch.resize(static_cast<size_t>(entry.size));
+        size_t written = ZSTD_decompress(scratch.data(), scratch.size(), stored,
+                                         static_cast<size_t>(entry.storedSize));
+        if (ZSTD_isError(written) || written != entry.size) {
+            return false;
+        }
+        data = scratch.data();
+        size = scratch.size();
+        return true;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+std::string_view
+PackArchive::getName(const PackEntry& entry) const {
+    return std::string_view(m_names + entry.nameOffset, entry.nameLength);
+}
+
+bool
+PackArchive::build(const std::vector<PackInput>& inputs,
+                   const std::string& outputPath,
+                   PackCompression compression,
+                   std::string& error) {
+    if (compression != COMPRESSION_NONE && !isCompressionSupported(compression)) {
+        error = "Compression not available in this build";
+        return false;
+    }
+
+    // Índice ordenado por hash; los nombres repetidos se descartan
+    struct Pending {
+        PackEntry entry;
+        std::string name;
+        const PackInput* input;
+    };
+    std::vector<Pending> pending;
+    pending.reserve(inputs.size());
+    for (const PackInput& input : inputs) {
+        Pending item{};
+        item.name = normalizePath(input.name);
+        if (item.name.size() > 0xFFFF) {
+            error = "Name too long: " + input.name;
+            return false;
+        }
+        item.entry.hash = hashPath(item.name);
+        item.input = &input;
+        pending.push_back(std::move(item));
+    }
+    std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+        return a.entry.hash != b.entry.hash ? a.entry.hash < b.entry.hash : a.name < b.name;
+    });
+    pending.erase(std::unique(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+        return a.name == b.name;
+    }), pending.end());
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "Can't create pack: " + outputPath;
+        return false;
+    }
+
+    PackHeader header{};
+    std::memcpy(header.magic, "GPAK", 4);
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(pending.size());
+    header.alignment = DEFAULT_ALIGNMENT;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t position = sizeof(header);
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> packed;
+    std::string names;
+    const char padding[DEFAULT_ALIGNMENT] = {};
+
+    for (Pending& item : pending) {
+        std::ifstream file(item.input->sourcePath, std::ios::binary | std::ios::ate);
+        if (!file) {
+            error = "Can't read: " + item.input->sourcePath;
+            return false;
+        }
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        // Cada entrada inicia alineada para poder leerla directo desde el mapeo
+        uint64_t aligned = (position + DEFAULT_ALIGNMENT - 1) / DEFAULT_ALIGNMENT * DEFAULT_ALIGNMENT;
+        out.write(padding, static_cast<std::streamsize>(aligned - position));
+        position = aligned;
+
+        const std::vector<uint8_t>* stored = &data;
+        item.entry.compression = COMPRESSION_NONE;
+        if (compression != COMPRESSION_NONE && compress(compression, data, packed) && packed.size() < data.size()) {
+            stored = &packed;
+            item.entry.compression = static_cast<uint8_t>(compression);
+        }
+
+        out.write(reinterpret_cast<const char*>(stored->data()), static_cast<std::streamsize>(stored->size()));
+        item.entry.offset = position;
+        item.entry.storedSize = stored->size();
+        item.entry.size = data.size();
+        item.entry.nameOffset = static_cast<uint32_t>(names.size());
+        item.entry.nameLength = static_cast<uint16_t>(item.name.size());
+        names += item.name;
+        position += stored->size();
+    }
+
+    uint64_t aligned = (position + alignof(PackEntry) - 1) / alignof(PackEntry) * alignof(PackEntry);
+    out.write(padding, static_cast<std::streamsize>(aligned - position));
+    header.indexOffset = aligned;
+    for (const Pending& item : pending) {
+        out.write(reinterpret_cast<const char*>(&item.entry), sizeof(PackEntry));
+    }
+    header.namesOffset = header.indexOffset + pending.size() * sizeof(PackEntry);
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) {
+        error = "Can't write pack: " + outputPath;
+        return false;
+    }
+    return true;
+}
+
+uint64_t
+PackArchive::hashPath(std::string_view name, std::string_view extension) {
+    uint64_t hash = hashAppend(FNV_OFFSET, name);
+    if (!extension.empty()) {
+        hash = hashAppend(hash, ".");
+        hash = hashAppend(hash, extension);
+    }
+    return hash;
+}
+
+std::string
+PackArchive::normalizePath(std::string_view path) {
+    std::string normalized(path);
+    for (char& c : normalized) {
+        c = normalizeChar(c);
+    }
+    return normalized;
+}
+
+bool
+PackArchive::isCompressionSupported(PackCompression compression) {
+    switch (compression) {
+    case COMPRESSION_NONE:
+        return true;
+#ifdef GALVAN_PACK_LZ4
+    case COMPRESSION_LZ4:
+        return true;
+#endif
+#ifdef GALVAN_PACK_ZSTD
+    case COMPRESSION_ZSTD:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
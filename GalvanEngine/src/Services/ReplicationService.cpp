@@ -0,0 +1,838 @@
+﻿#include "Services/ReplicationService.h"
+#include "Services/BitStream.h"
+#include "Actor.h"
+
+namespace {
+    const uint32_t PROTOCOL_MAGIC = 0x4752;
+    const uint32_t MAGIC_BITS = 16;
+    const uint32_t TYPE_BITS = 3;
+    const uint32_t SEQUENCE_BITS = 16;
+    const uint32_t TIME_BITS = 32;
+    const float CONNECT_RETRY = 0.5f;
+    const size_t MAX_CLIENTS = 32;
+
+    /**
+     * @brief true si la secuencia a es posterior a b, contando con que el contador da la vuelta.
+     */
+    bool
+        isNewer(uint16_t a, uint16_t b) {
+        return static_cast<int16_t>(static_cast<uint16_t>(a - b)) > 0;
+    }
+
+    size_t
+        varUnsignedBits(uint32_t value) {
+        uint64_t coded = static_cast<uint64_t>(value) + 1;
+        size_t length = 0;
+        while ((coded >> (length + 1)) != 0) {
+            ++length;
+        }
+        return length * 2 + 1;
+    }
+
+    size_t
+        varSignedBits(int32_t value) {
+        return varUnsignedBits((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    void
+        writeFloat(BitWriter& writer, float value) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writer.writeBits(bits, 32);
+    }
+
+    float
+        readFloat(BitReader& reader) {
+        uint32_t bits = reader.readBits(32);
+        float value = 0.0f;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint32_t
+        quantizeUnit(float unit, uint32_t maxValue) {
+        unit = std::min(std::max(unit, 0.0f), 1.0f);
+        return static_cast<uint32_t>(std::lround(unit * static_cast<float>(maxValue)));
+    }
+}
+
+bool
+ReplicationService::startServer(unsigned short port, std::string& error) {
+    stop();
+    if (m_socket.bind(port) != sf::Socket::Done) {
+        error = "Can't bind replication port " + std::to_string(port);
+        return false;
+    }
+    m_socket.setBlocking(false);
+    computeQuantization();
+    m_mode = REPLICATION_SERVER;
+    return true;
+}
+
+bool
+ReplicationService::connect(const std::string& address, unsigned short port, std::string& error) {
+    stop();
+    sf::IpAddress server(address);
+    if (server == sf::IpAddress::None) {
+        error = "Can't resolve replication server: " + address;
+        return false;
+    }
+    if (m_socket.bind(sf::Socket::AnyPort) != sf::Socket::Done) {
+        error = "Can't open a UDP socket for replication";
+        return false;
+    }
+    m_socket.setBlocking(false);
+    computeQuantization();
+    m_mode = REPLICATION_CLIENT;
+    m_serverAddress = server;
+    m_serverPort = port;
+    m_peerStats.assign(1, ReplicationPeerStats());
+    m_peerStats[0].address = server.toString() + ":" + std::to_string(port);
+    sendPacket(PACKET_CONNECT);
+    return true;
+}
+
+void
+ReplicationService::stop() {
+    if (m_mode == REPLICATION_SERVER) {
+        for (const Client& client : m_clients) {
+            BitWriter writer(m_packet);
+            writeHeader(writer, PACKET_DISCONNECT);
+            writer.flush();
+            sendBuffer(client.address, client.port);
+        }
+    }
+    else if (m_mode == REPLICATION_CLIENT) {
+        sendPacket(PACKET_DISCONNECT);
+    }
+    m_socket.unbind();
+
+    m_mode = REPLICATION_OFF;
+    m_time = 0.0f;
+    m_clients.clear();
+    m_sendTimer = 0.0f;
+    m_connected = false;
+    m_connectTimer = 0.0f;
+    m_lastHeard = 0.0f;
+    clearViews();
+    m_actors.clear();
+    m_transforms.clear();
+    m_traffic = TrafficWindow();
+    m_peerStats.clear();
+}
+
+void
+ReplicationService::update(float deltaTime, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    if (m_mode == REPLICATION_OFF) {
+        return;
+    }
+    m_time += deltaTime;
+
+    if (m_mode == REPLICATION_SERVER) {
+        receiveServer();
+        m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+                                       [this](const Client& client) { return m_time - client.lastHeard > m_settings.timeout; }),
+                        m_clients.end());
+
+        // Un frame largo no manda una ráfaga de snapshots; como mucho se atrasa uno
+        float interval = 1.0f / std::max(m_settings.sendRate, 1.0f);
+        m_sendTimer += deltaTime;
+        if (m_sendTimer >= interval) {
+            m_sendTimer = std::min(m_sendTimer - interval, interval);
+            if (!m_clients.empty()) {
+                sendSnapshots(interval, actors);
+            }
+        }
+
+        m_peerStats.resize(m_clients.size());
+        for (size_t i = 0; i < m_clients.size(); ++i) {
+            updateTraffic(m_clients[i].traffic, m_clients[i].stats, deltaTime);
+            m_peerStats[i] = m_clients[i].stats;
+        }
+        return;
+    }
+
+    receiveClient();
+    if (!m_connected) {
+        m_connectTimer += deltaTime;
+        if (m_connectTimer >= CONNECT_RETRY) {
+            m_connectTimer = 0.0f;
+            sendPacket(PACKET_CONNECT);
+        }
+    }
+    else if (m_time - m_lastHeard > m_settings.timeout) {
+        // El servidor dejó de responder; se vuelve a pedir conexión
+        m_connected = false;
+        clearViews();
+    }
+    interpolate(deltaTime);
+
+    m_peerStats[0].relevantEntities = m_views.empty() ? 0 : m_views.back().entities.size();
+    updateTraffic(m_traffic, m_peerStats[0], deltaTime);
+}
+
+void
+ReplicationService::applyToActors(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    if (m_mode != REPLICATION_CLIENT) {
+        return;
+    }
+
+    bool changed = actors.size() != m_actors.size();
+    for (size_t i = 0; !changed && i < actors.size(); ++i) {
+        changed = actors[i].get() != m_actors[i];
+    }
+    if (changed) {
+        // getComponent recorre los componentes del actor; solo se hace cuando cambia la escena
+        m_actors.resize(actors.size());
+        m_transforms.clear();
+        for (size_t i = 0; i < actors.size(); ++i) {
+            m_actors[i] = actors[i].get();
+            Transform* transform = m_actors[i] != nullptr ? actors[i]->getComponent<Transform>().get() : nullptr;
+            if (transform != nullptr) {
+                m_transforms[m_actors[i]->getId()] = transform;
+            }
+        }
+    }
+
+    for (const ReplicatedTransform& replicated : m_interpolated) {
+        auto found = m_transforms.find(replicated.id);
+        if (found == m_transforms.end()) {
+            continue;
+        }
+        Transform* transform = found->second;
+        transform->setPosition(replicated.position);
+        transform->setRotation(sf::Vector2f(replicated.rotation, transform->getRotation().y));
+        transform->setScale(replicated.scale);
+    }
+}
+
+void
+ReplicationService::receiveServer() {
+    m_receiveBuffer.resize(sf::UdpSocket::MaxDatagramSize);
+    std::size_t received = 0;
+    sf::IpAddress sender;
+    unsigned short port = 0;
+    while (m_socket.receive(m_receiveBuffer.data(), m_receiveBuffer.size(), received, sender, port) == sf::Socket::Done) {
+        BitReader reader(m_receiveBuffer.data(), received);
+        if (reader.readBits(MAGIC_BITS) != PROTOCOL_MAGIC) {
+            continue;
+        }
+        uint32_t type = reader.readBits(TYPE_BITS);
+        auto client = std::find_if(m_clients.begin(), m_clients.end(), [&](const Client& candidate) {
+            return candidate.address == sender && candidate.port == port;
+        });
+
+        if (type == PACKET_CONNECT) {
+            if (client == m_clients.end()) {
+                if (m_clients.size() >= MAX_CLIENTS) {
+                    continue;
+                }
+                m_clients.emplace_back();
+                client = m_clients.end() - 1;
+                client->address = sender;
+                client->port = port;
+                client->stats.address = sender.toString() + ":" + std::to_string(port);
+            }
+            client->lastHeard = m_time;
+            // La confirmación puede perderse; se repite con cada petición
+            sendAccept(*client);
+            continue;
+        }
+        if (client == m_clients.end()) {
+            continue;
+        }
+
+        if (type == PACKET_DISCONNECT) {
+            m_clients.erase(client);
+            continue;
+        }
+        if (type != PACKET_ACK) {
+            continue;
+        }
+        uint16_t sequence = static_cast<uint16_t>(reader.readBits(SEQUENCE_BITS));
+        sf::Vector2f center;
+        center.x = readFloat(reader);
+        center.y = readFloat(reader);
+        float radius = readFloat(reader);
+        if (!reader.isValid()) {
+            continue;
+        }
+
+        client->lastHeard = m_time;
+        client->viewCenter = center;
+        client->viewRadius = std::isfinite(radius) ? std::max(radius, 0.0f) : 0.0f;
+        const View& view = client->views[sequence % HISTORY_SIZE];
+        if (view.valid && view.sequence == sequence && (!client->hasAck || isNewer(sequence, client->ackedSequence))) {
+            client->hasAck = true;
+            client->ackedSequence = sequence;
+            float roundTrip = (m_time - view.time) * 1000.0f;
+            float& average = client->stats.roundTripMs;
+            average = average > 0.0f ? average + (roundTrip - average) * 0.1f : roundTrip;
+        }
+    }
+}
+
+void
+ReplicationService::sendSnapshots(float interval, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    // El estado se cuantiza una vez por snapshot y se comparte entre todos los clientes
+    m_current.clear();
+    for (auto& actor : actors) {
+        if (actor.isNull()) {
+            continue;
+        }
+        auto transform = actor->getComponent<Transform>();
+        if (transform) {
+            m_current.push_back(quantize(actor->getId(), *transform));
+        }
+    }
+    auto byId = [](const QuantizedEntity& a, const QuantizedEntity& b) { return a.id < b.id; };
+    if (!std::is_sorted(m_current.begin(), m_current.end(), byId)) {
+        std::sort(m_current.begin(), m_current.end(), byId);
+    }
+
+    for (Client& client : m_clients) {
+        sendSnapshot(client, interval);
+    }
+}
+
+void
+ReplicationService::sendSnapshot(Client& client, float interval) {
+    uint16_t sequence = client.nextSequence++;
+    View& view = client.views[sequence % HISTORY_SIZE];
+
+    // La base es lo que el cliente tiene según su última confirmación
+    const View* baseline = nullptr;
+    if (client.hasAck) {
+        const View& acked = client.views[client.ackedSequence % HISTORY_SIZE];
+        if (acked.valid && acked.sequence == client.ackedSequence && &acked != &view) {
+            baseline = &acked;
+        }
+    }
+    static const std::vector<QuantizedEntity> empty;
+    const std::vector<QuantizedEntity>& base = baseline != nullptr ? baseline->entities : empty;
+
+    float radius = client.viewRadius;
+    m_removed.clear();
+    m_candidates.clear();
+    size_t b = 0;
+    for (size_t i = 0; i < m_current.size(); ++i) {
+        const QuantizedEntity& entity = m_current[i];
+        while (b < base.size() && base[b].id < entity.id) {
+            m_removed.push_back(base[b++].id);
+        }
+        const QuantizedEntity* prior = b < base.size() && base[b].id == entity.id ? &base[b++] : nullptr;
+
+        float weight = 1.0f;
+        if (radius > 0.0f) {
+            ReplicatedTransform position = dequantize(entity);
+            sf::Vector2f offset = position.position - client.viewCenter;
+            float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+            if (distance > radius) {
+                if (prior != nullptr) {
+                    m_removed.push_back(entity.id);
+                }
+                client.priorities.erase(entity.id);
+                continue;
+            }
+            // Lo cercano al centro de interés se actualiza más seguido
+            weight += 4.0f * (1.0f - distance / radius);
+        }
+        if (prior != nullptr && isSameState(*prior, entity)) {
+            continue;
+        }
+
+        float& priority = client.priorities[entity.id];
+        priority += interval * weight;
+        Candidate candidate;
+        candidate.index = i;
+        candidate.base = prior;
+        // Lo que el cliente todavía no tiene va primero
+        candidate.priority = prior != nullptr ? priority : priority + 1000.0f;
+        m_candidates.push_back(candidate);
+    }
+    while (b < base.size()) {
+        m_removed.push_back(base[b++].id);
+    }
+    for (uint32_t id : m_removed) {
+        client.priorities.erase(id);
+    }
+
+    // Las entidades entran por prioridad mientras quepan en el presupuesto del paquete
+    size_t usedBits = MAGIC_BITS + TYPE_BITS + SEQUENCE_BITS + TIME_BITS + 1 + (baseline != nullptr ? SEQUENCE_BITS : 0);
+    usedBits += varUnsignedBits(static_cast<uint32_t>(m_removed.size())) + varUnsignedBits(static_cast<uint32_t>(m_candidates.size()));
+    uint32_t next = 0;
+    for (uint32_t id : m_removed) {
+        usedBits += varUnsignedBits(id - next);
+        next = id + 1;
+    }
+    size_t budgetBits = m_settings.packetBudget * 8;
+    std::sort(m_candidates.begin(), m_candidates.end(),
+              [](const Candidate& a, const Candidate& c) { return a.priority > c.priority; });
+
+    // m_selected se mantiene ordenado por id, así se conoce el costo exacto de cada diferencia de id
+    m_selected.clear();
+    for (const Candidate& candidate : m_candidates) {
+        const QuantizedEntity& entity = m_current[candidate.index];
+        auto position = std::lower_bound(m_selected.begin(), m_selected.end(), candidate.index,
+                                         [](const Candidate& selected, size_t index) { return selected.index < index; });
+        uint32_t previous = position == m_selected.begin() ? 0 : m_current[(position - 1)->index].id + 1;
+        size_t bits = measureEntity(entity, candidate.base) + varUnsignedBits(entity.id - previous);
+        if (position != m_selected.end()) {
+            uint32_t following = m_current[position->index].id;
+            bits += varUnsignedBits(following - entity.id - 1);
+            bits -= varUnsignedBits(following - previous);
+        }
+        if (usedBits + bits > budgetBits) {
+            continue;
+        }
+        usedBits += bits;
+        m_selected.insert(position, candidate);
+        client.priorities[entity.id] = 0.0f;
+    }
+
+    BitWriter writer(m_packet);
+    writeHeader(writer, PACKET_SNAPSHOT);
+    writer.writeBits(sequence, SEQUENCE_BITS);
+    writer.writeBits(static_cast<uint32_t>(m_time * 1000.0f), TIME_BITS);
+    writer.writeBool(baseline != nullptr);
+    if (baseline != nullptr) {
+        writer.writeBits(baseline->sequence, SEQUENCE_BITS);
+    }
+    writer.writeVarUnsigned(static_cast<uint32_t>(m_removed.size()));
+    next = 0;
+    for (uint32_t id : m_removed) {
+        writer.writeVarUnsigned(id - next);
+        next = id + 1;
+    }
+    writer.writeVarUnsigned(static_cast<uint32_t>(m_selected.size()));
+    next = 0;
+    for (const Candidate& candidate : m_selected) {
+        const QuantizedEntity& entity = m_current[candidate.index];
+        writer.writeVarUnsigned(entity.id - next);
+        next = entity.id + 1;
+        writeEntity(writer, entity, candidate.base);
+    }
+    writer.flush();
+
+    // Lo que el cliente tendrá al recibir este paquete: la base, sin lo retirado y con lo enviado
+    std::vector<QuantizedEntity> entities;
+    entities.swap(view.entities);
+    entities.clear();
+    size_t s = 0;
+    size_t r = 0;
+    b = 0;
+    while (b < base.size() || s < m_selected.size()) {
+        if (s < m_selected.size() && (b == base.size() || m_current[m_selected[s].index].id <= base[b].id)) {
+            const QuantizedEntity& entity = m_current[m_selected[s].index];
+            if (b < base.size() && base[b].id == entity.id) {
+                ++b;
+            }
+            entities.push_back(entity);
+            ++s;
+            continue;
+        }
+        while (r < m_removed.size() && m_removed[r] < base[b].id) {
+            ++r;
+        }
+        if (r == m_removed.size() || m_removed[r] != base[b].id) {
+            entities.push_back(base[b]);
+        }
+        ++b;
+    }
+    view.entities.swap(entities);
+    view.sequence = sequence;
+    view.valid = true;
+    view.time = m_time;
+
+    sendBuffer(client.address, client.port);
+    client.traffic.bytes += m_packet.size();
+    client.traffic.packets += 1;
+    client.traffic.entities += m_selected.size();
+    client.stats.relevantEntities = view.entities.size();
+    client.stats.pendingEntities = m_candidates.size() - m_selected.size();
+}
+
+void
+ReplicationService::sendAccept(const Client& client) {
+    BitWriter writer(m_packet);
+    writeHeader(writer, PACKET_ACCEPT);
+    writeFloat(writer, m_settings.worldBounds.left);
+    writeFloat(writer, m_settings.worldBounds.top);
+    writeFloat(writer, m_settings.worldBounds.width);
+    writeFloat(writer, m_settings.worldBounds.height);
+    writeFloat(writer, m_settings.positionPrecision);
+    writeFloat(writer, m_settings.maxScale);
+    writer.writeBits(m_settings.rotationBits, 5);
+    writer.writeBits(m_settings.scaleBits, 5);
+    writer.flush();
+    sendBuffer(client.address, client.port);
+}
+
+void
+ReplicationService::receiveClient() {
+    m_receiveBuffer.resize(sf::UdpSocket::MaxDatagramSize);
+    std::size_t received = 0;
+    sf::IpAddress sender;
+    unsigned short port = 0;
+    while (m_socket.receive(m_receiveBuffer.data(), m_receiveBuffer.size(), received, sender, port) == sf::Socket::Done) {
+        if (sender != m_serverAddress || port != m_serverPort) {
+            continue;
+        }
+        BitReader reader(m_receiveBuffer.data(), received);
+        if (reader.readBits(MAGIC_BITS) != PROTOCOL_MAGIC) {
+            continue;
+        }
+        uint32_t type = reader.readBits(TYPE_BITS);
+        m_traffic.bytes += received;
+        m_traffic.packets += 1;
+
+        if (type == PACKET_ACCEPT) {
+            ReplicationSettings settings = m_settings;
+            settings.worldBounds.left = readFloat(reader);
+            settings.worldBounds.top = readFloat(reader);
+            settings.worldBounds.width = readFloat(reader);
+            settings.worldBounds.height = readFloat(reader);
+            settings.positionPrecision = readFloat(reader);
+            settings.maxScale = readFloat(reader);
+            settings.rotationBits = reader.readBits(5);
+            settings.scaleBits = reader.readBits(5);
+            if (!reader.isValid() || !(settings.positionPrecision > 0.0f) || !(settings.maxScale > 0.0f)) {
+                continue;
+            }
+            m_lastHeard = m_time;
+            if (!m_connected) {
+                m_settings = settings;
+                computeQuantization();
+                clearViews();
+                m_connected = true;
+            }
+        }
+        else if (type == PACKET_SNAPSHOT && m_connected) {
+            if (readSnapshot(reader)) {
+                m_lastHeard = m_time;
+            }
+        }
+        else if (type == PACKET_DISCONNECT) {
+            m_connected = false;
+            m_connectTimer = 0.0f;
+            clearViews();
+        }
+    }
+}
+
+bool
+ReplicationService::readSnapshot(BitReader& reader) {
+    uint16_t sequence = static_cast<uint16_t>(reader.readBits(SEQUENCE_BITS));
+    float time = static_cast<float>(reader.readBits(TIME_BITS)) / 1000.0f;
+    bool hasBaseline = reader.readBool();
+    uint16_t baselineSequence = hasBaseline ? static_cast<uint16_t>(reader.readBits(SEQUENCE_BITS)) : 0;
+    if (!reader.isValid() || (!m_views.empty() && !isNewer(sequence, m_views.back().sequence))) {
+        // Repetido o atrasado: el siguiente ya lo trae
+        return false;
+    }
+
+    const View* baseline = nullptr;
+    if (hasBaseline) {
+        for (const View& candidate : m_views) {
+            if (candidate.sequence == baselineSequence) {
+                baseline = &candidate;
+            }
+        }
+        if (baseline == nullptr) {
+            return false;
+        }
+    }
+    static const std::vector<QuantizedEntity> empty;
+    const std::vector<QuantizedEntity>& base = baseline != nullptr ? baseline->entities : empty;
+
+    m_removed.clear();
+    uint32_t removedCount = reader.readVarUnsigned();
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < removedCount && reader.isValid(); ++i) {
+        uint32_t id = next + reader.readVarUnsigned();
+        m_removed.push_back(id);
+        next = id + 1;
+    }
+
+    View view;
+    if (!m_spareViews.empty()) {
+        view = std::move(m_spareViews.back());
+        m_spareViews.pop_back();
+    }
+    view.entities.clear();
+
+    size_t b = 0;
+    size_t r = 0;
+    auto copyBase = [&](const QuantizedEntity& entity) {
+        while (r < m_removed.size() && m_removed[r] < entity.id) {
+            ++r;
+        }
+        if (r == m_removed.size() || m_removed[r] != entity.id) {
+            view.entities.push_back(entity);
+        }
+    };
+    uint32_t count = reader.readVarUnsigned();
+    next = 0;
+    bool valid = reader.isValid();
+    for (uint32_t i = 0; i < count && valid; ++i) {
+        QuantizedEntity entity;
+        entity.id = next + reader.readVarUnsigned();
+        next = entity.id + 1;
+        while (b < base.size() && base[b].id < entity.id) {
+            copyBase(base[b++]);
+        }
+        const QuantizedEntity* prior = b < base.size() && base[b].id == entity.id ? &base[b++] : nullptr;
+        valid = readEntity(reader, entity, prior) && reader.isValid();
+        view.entities.push_back(entity);
+    }
+    while (valid && b < base.size()) {
+        copyBase(base[b++]);
+    }
+    if (!valid) {
+        m_spareViews.push_back(std::move(view));
+        return false;
+    }
+
+    view.sequence = sequence;
+    view.valid = true;
+    view.time = time;
+    m_views.push_back(std::move(view));
+    while (m_views.size() > HISTORY_SIZE) {
+        m_spareViews.push_back(std::move(m_views.front()));
+        m_views.pop_front();
+    }
+    m_traffic.entities += count;
+    sendPacket(PACKET_ACK);
+    return true;
+}
+
+void
+ReplicationService::sendPacket(PacketType type) {
+    BitWriter writer(m_packet);
+    writeHeader(writer, type);
+    if (type == PACKET_ACK) {
+        writer.writeBits(m_views.back().sequence, SEQUENCE_BITS);
+        writeFloat(writer, m_viewCenter.x);
+        writeFloat(writer, m_viewCenter.y);
+        writeFloat(writer, m_settings.relevanceRadius);
+    }
+    writer.flush();
+    sendBuffer(m_serverAddress, m_serverPort);
+}
+
+void
+ReplicationService::interpolate(float deltaTime) {
+    m_interpolated.clear();
+    if (m_views.empty()) {
+        return;
+    }
+
+    // El reloj de render va interpolationDelay detrás del servidor y se corrige poco a poco
+    float target = m_views.back().time - m_settings.interpolationDelay;
+    if (!m_hasRenderTime || std::fabs(m_renderTime - target) > 0.25f) {
+        m_renderTime = target;
+        m_hasRenderTime = true;
+    }
+    else {
+        m_renderTime += deltaTime;
+        m_renderTime += (target - m_renderTime) * 0.05f;
+    }
+
+    size_t next = 0;
+    while (next < m_views.size() && m_views[next].time <= m_renderTime) {
+        ++next;
+    }
+    const View& from = m_views[next == 0 ? 0 : next - 1];
+    const View& to = m_views[next == m_views.size() ? m_views.size() - 1 : next];
+    float span = to.time - from.time;
+    float alpha = span > 0.0f ? std::min(std::max((m_renderTime - from.time) / span, 0.0f), 1.0f) : 1.0f;
+
+    // Las entidades del snapshot más nuevo mandan; las que también están en el anterior se interpolan
+    size_t f = 0;
+    for (const QuantizedEntity& entity : to.entities) {
+        ReplicatedTransform current = dequantize(entity);
+        while (f < from.entities.size() && from.entities[f].id < entity.id) {
+            ++f;
+        }
+        if (f < from.entities.size() && from.entities[f].id == entity.id) {
+            ReplicatedTransform previous = dequantize(from.entities[f]);
+            float turn = current.rotation - previous.rotation;
+            turn -= 360.0f * std::floor((turn + 180.0f) / 360.0f);
+            current.position = previous.position + (current.position - previous.position) * alpha;
+            current.rotation = previous.rotation + turn * alpha;
+            current.scale = previous.scale + (current.scale - previous.scale) * alpha;
+        }
+        m_interpolated.push_back(current);
+    }
+}
+
+void
+ReplicationService::clearViews() {
+    while (!m_views.empty()) {
+        m_spareViews.push_back(std::move(m_views.back()));
+        m_views.pop_back();
+    }
+    m_hasRenderTime = false;
+    m_interpolated.clear();
+}
+
+void
+ReplicationService::computeQuantization() {
+    m_settings.rotationBits = std::min<uint32_t>(std::max<uint32_t>(m_settings.rotationBits, 4), 16);
+    m_settings.scaleBits = std::min<uint32_t>(std::max<uint32_t>(m_settings.scaleBits, 4), 16);
+    float span = std::max(m_settings.worldBounds.width, m_settings.worldBounds.height) / m_settings.positionPrecision;
+    m_positionBits = 1;
+    while (m_positionBits < 30 && static_cast<float>((1u << m_positionBits) - 1) < span) {
+        ++m_positionBits;
+    }
+    m_positionMax = (1u << m_positionBits) - 1;
+}
+
+ReplicationService::QuantizedEntity
+ReplicationService::quantize(uint32_t id, const Transform& transform) const {
+    // getPosition y compañía no son const en Transform
+    Transform& source = const_cast<Transform&>(transform);
+    const sf::Vector2f& position = source.getPosition();
+    const sf::FloatRect& bounds = m_settings.worldBounds;
+    float precision = m_settings.positionPrecision;
+
+    QuantizedEntity entity;
+    entity.id = id;
+    entity.x = quantizeUnit((position.x - bounds.left) / precision / static_cast<float>(m_positionMax), m_positionMax);
+    entity.y = quantizeUnit((position.y - bounds.top) / precision / static_cast<float>(m_positionMax), m_positionMax);
+
+    uint32_t rotationSteps = 1u << m_settings.rotationBits;
+    float turns = source.getRotation().x / 360.0f;
+    turns -= std::floor(turns);
+    entity.rotation = static_cast<uint32_t>(std::lround(turns * static_cast<float>(rotationSteps))) & (rotationSteps - 1);
+
+    uint32_t scaleMax = (1u << m_settings.scaleBits) - 1;
+    float range = 2.0f * m_settings.maxScale;
+    entity.scaleX = quantizeUnit((source.getScale().x + m_settings.maxScale) / range, scaleMax);
+    entity.scaleY = quantizeUnit((source.getScale().y + m_settings.maxScale) / range, scaleMax);
+    return entity;
+}
+
+ReplicatedTransform
+ReplicationService::dequantize(const QuantizedEntity& entity) const {
+    float precision = m_settings.positionPrecision;
+    float scaleStep = 2.0f * m_settings.maxScale / static_cast<float>((1u << m_settings.scaleBits) - 1);
+
+    ReplicatedTransform transform;
+    transform.id = entity.id;
+    transform.position.x = m_settings.worldBounds.left + static_cast<float>(entity.x) * precision;
+    transform.position.y = m_settings.worldBounds.top + static_cast<float>(entity.y) * precision;
+    transform.rotation = static_cast<float>(entity.rotation) * 360.0f / static_cast<float>(1u << m_settings.rotationBits);
+    transform.scale.x = static_cast<float>(entity.scaleX) * scaleStep - m_settings.maxScale;
+    transform.scale.y = static_cast<float>(entity.scaleY) * scaleStep - m_settings.maxScale;
+    return transform;
+}
+
+bool
+ReplicationService::isSameState(const QuantizedEntity& a, const QuantizedEntity& b) {
+    return a.x == b.x && a.y == b.y && a.rotation == b.rotation && a.scaleX == b.scaleX && a.scaleY == b.scaleY;
+}
+
+size_t
+ReplicationService::measureEntity(const QuantizedEntity& entity, const QuantizedEntity* base) const {
+    if (base == nullptr) {
+        return 2 * m_positionBits + m_settings.rotationBits + 2 * m_settings.scaleBits;
+    }
+    size_t bits = 3;
+    if (entity.x != base->x || entity.y != base->y) {
+        bits += varSignedBits(static_cast<int32_t>(entity.x - base->x)) + varSignedBits(static_cast<int32_t>(entity.y - base->y));
+    }
+    if (entity.rotation != base->rotation) {
+        bits += m_settings.rotationBits;
+    }
+    if (entity.scaleX != base->scaleX || entity.scaleY != base->scaleY) {
+        bits += 2 * m_settings.scaleBits;
+    }
+    return bits;
+}
+
+void
+ReplicationService::writeEntity(BitWriter& writer, const QuantizedEntity& entity, const QuantizedEntity* base) const {
+    if (base == nullptr) {
+        writer.writeBits(entity.x, m_positionBits);
+        writer.writeBits(entity.y, m_positionBits);
+        writer.writeBits(entity.rotation, m_settings.rotationBits);
+        writer.writeBits(entity.scaleX, m_settings.scaleBits);
+        writer.writeBits(entity.scaleY, m_settings.scaleBits);
+        return;
+    }
+
+    // Contra la base: un bit por grupo de campos y la posición como diferencia
+    bool moved = entity.x != base->x || entity.y != base->y;
+    writer.writeBool(moved);
+    if (moved) {
+        writer.writeVarSigned(static_cast<int32_t>(entity.x - base->x));
+        writer.writeVarSigned(static_cast<int32_t>(entity.y - base->y));
+    }
+    bool rotated = entity.rotation != base->rotation;
+    writer.writeBool(rotated);
+    if (rotated) {
+        writer.writeBits(entity.rotation, m_settings.rotationBits);
+    }
+    bool scaled = entity.scaleX != base->scaleX || entity.scaleY != base->scaleY;
+    writer.writeBool(scaled);
+    if (scaled) {
+        writer.writeBits(entity.scaleX, m_settings.scaleBits);
+        writer.writeBits(entity.scaleY, m_settings.scaleBits);
+    }
+}
+
+bool
+ReplicationService::readEntity(BitReader& reader, QuantizedEntity& entity, const QuantizedEntity* base) const {
+    if (base == nullptr) {
+        entity.x = reader.readBits(m_positionBits);
+        entity.y = reader.readBits(m_positionBits);
+        entity.rotation = reader.readBits(m_settings.rotationBits);
+        entity.scaleX = reader.readBits(m_settings.scaleBits);
+        entity.scaleY = reader.readBits(m_settings.scaleBits);
+        return true;
+    }
+
+    entity.x = base->x;
+    entity.y = base->y;
+    entity.rotation = base->rotation;
+    entity.scaleX = base->scaleX;
+    entity.scaleY = base->scaleY;
+    if (reader.readBool()) {
+        entity.x = base->x + static_cast<uint32_t>(reader.readVarSigned());
+        entity.y = base->y + static_cast<uint32_t>(reader.readVarSigned());
+    }
+    if (reader.readBool()) {
+        entity.rotation = reader.readBits(m_settings.rotationBits);
+    }
+    if (reader.readBool()) {
+        entity.scaleX = reader.readBits(m_settings.scaleBits);
+        entity.scaleY = reader.readBits(m_settings.scaleBits);
+    }
+    return entity.x <= m_positionMax && entity.y <= m_positionMax;
+}
+
+void
+ReplicationService::writeHeader(BitWriter& writer, PacketType type) const {
+    writer.writeBits(PROTOCOL_MAGIC, MAGIC_BITS);
+    writer.writeBits(type, TYPE_BITS);
+}
+
+void
+ReplicationService::sendBuffer(const sf::IpAddress& address, unsigned short port) {
+    // Sin bloqueo un envío puede fallar si el buffer del sistema está lleno; cuenta como pérdida
+    m_socket.send(m_packet.data(), m_packet.size(), address, port);
+}
+
+void
+ReplicationService::updateTraffic(TrafficWindow& traffic, ReplicationPeerStats& stats, float deltaTime) {
+    traffic.elapsed += deltaTime;
+    if (traffic.elapsed < 1.0f) {
+        return;
+    }
+    stats.bytesPerSecond = static_cast<float>(traffic.bytes) / traffic.elapsed;
+    stats.packetsPerSecond = static_cast<float>(traffic.packets) / traffic.elapsed;
+    stats.averagePacketBytes = traffic.packets > 0 ? static_cast<float>(traffic.bytes) / static_cast<float>(traffic.packets) : 0.0f;
+    stats.entitiesPerPacket = traffic.packets > 0 ? static_cast<float>(traffic.entities) / static_cast<float>(traffic.packets) : 0.0f;
+    traffic = TrafficWindow();
+}
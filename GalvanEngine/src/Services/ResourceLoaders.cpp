@@ -0,0 +1,108 @@
+﻿#include "Services/ResourceLoaders.h"
+
+bool
+TextureLoader::decode(const FileView& file, std::string_view extension, sf::Image& staging) {
+    (void)extension;
+    return staging.loadFromMemory(file.data, file.size);
+}
+
+EngineUtilities::TSharedPointer<Texture>
+TextureLoader::create(const std::string& name, const std::string& extension, sf::Image& staging, FileView& file) {
+    (void)file;
+    EngineUtilities::TSharedPointer<Texture> texture(new Texture(name, extension, staging));
+    if (texture->getTexture().getSize().x == 0) {
+        return EngineUtilities::TSharedPointer<Texture>();
+    }
+    return texture;
+}
+
+size_t
+TextureLoader::getBytes(Texture& texture, const FileView& file) {
+    (void)file;
+    sf::Vector2u size = texture.getTexture().getSize();
+    return static_cast<size_t>(size.x) * size.y * 4;
+}
+
+bool
+FontLoader::decode(const FileView& file, std::string_view extension, NoStaging& staging) {
+    (void)extension;
+    (void)staging;
+    return file.size > 0;
+}
+
+EngineUtilities::TSharedPointer<sf::Font>
+FontLoader::create(const std::string& name, const std::string& extension, NoStaging& staging, FileView& file) {
+    (void)name;
+    (void)extension;
+    (void)staging;
+    // El caché conserva file mientras la fuente esté cargada (KEEP_SOURCE)
+    EngineUtilities::TSharedPointer<sf::Font> font = EngineUtilities::MakeShared<sf::Font>();
+    if (!font->loadFromMemory(file.data, file.size)) {
+        return EngineUtilities::TSharedPointer<sf::Font>();
+    }
+    return font;
+}
+
+size_t
+FontLoader::getBytes(sf::Font& font, const FileView& file) {
+    (void)font;
+    return file.size;
+}
+
+bool
+SoundLoader::decode(const FileView& file, std::string_view extension, Staging& staging) {
+    (void)extension;
+    staging = std::make_unique<sf::SoundBuffer>();
+    return staging->loadFromMemory(file.data, file.size);
+}
+
+EngineUtilities::TSharedPointer<sf::SoundBuffer>
+SoundLoader::create(const std::string& name, const std::string& extension, Staging& staging, FileView& file) {
+    (void)name;
+    (void)extension;
+    (void)file;
+    // Las muestras ya decodificadas pasan al recurso sin copiarse
+    return EngineUtilities::TSharedPointer<sf::SoundBuffer>(staging.release());
+}
+
+size_t
+SoundLoader::getBytes(sf::SoundBuffer& sound, const FileView& file) {
+    (void)file;
+    return static_cast<size_t>(sound.getSampleCount()) * sizeof(sf::Int16);
+}
+
+bool
+ShaderLoader::decode(const FileView& file, std::string_view extension, std::string& staging) {
+    (void)extension;
+    staging.assign(reinterpret_cast<const char*>(file.data), file.size);
+    return !staging.empty();
+}
+
+EngineUtilities::TSharedPointer<sf::Shader>
+ShaderLoader::create(const std::string& name, const std::string& extension, std::string& staging, FileView& file) {
+    (void)name;
+    (void)file;
+    if (!sf::Shader::isAvailable()) {
+        return EngineUtilities::TSharedPointer<sf::Shader>();
+    }
+
+    sf::Shader::Type type = sf::Shader::Fragment;
+    if (extension == "vert") {
+        type = sf::Shader::Vertex;
+    }
+    else if (extension == "geom") {
+        type = sf::Shader::Geometry;
+    }
+
+    EngineUtilities::TSharedPointer<sf::Shader> shader = EngineUtilities::MakeShared<sf::Shader>();
+    if (!shader->loadFromMemory(staging, type)) {
+        return EngineUtilities::TSharedPointer<sf::Shader>();
+    }
+    return shader;
+}
+
+size_t
+ShaderLoader::getBytes(sf::Shader& shader, const FileView& file) {
+    (void)shader;
+    return file.size;
+}
@@ -0,0 +1,252 @@
+﻿#include "Services/TimerService.h"
+#include "Services/JobSystem.h"
+
+namespace {
+    const size_t JOB_BATCH = 64;    ///< Callbacks por lote al repartir en el JobSystem.
+}
+
+TimerService::TimerService() {
+    std::fill(std::begin(m_buckets), std::end(m_buckets), INVALID_NODE);
+}
+
+void
+TimerService::cancel(TimerHandle handle) {
+    if (!isActive(handle)) {
+        return;
+    }
+    TimerNode& node = m_nodes[handle.index];
+    if (node.running) {
+        node.cancelled = true;
+        return;
+    }
+    unlink(handle.index);
+    release(handle.index);
+}
+
+bool
+TimerService::isActive(TimerHandle handle) const {
+    return handle.index < m_nodes.size() && m_nodes[handle.index].generation == handle.generation &&
+           m_nodes[handle.index].active && !m_nodes[handle.index].cancelled;
+}
+
+float
+TimerService::getRemaining(TimerHandle handle) const {
+    if (!isActive(handle)) {
+        return -1.0f;
+    }
+    const TimerNode& node = m_nodes[handle.index];
+    uint64_t ticks = node.expiry > m_now ? node.expiry - m_now : 0;
+    return std::max(0.0f, static_cast<float>(ticks) * m_tickSeconds - m_accumulator);
+}
+
+void
+TimerService::update(float deltaTime) {
+    sf::Clock clock;
+    m_accumulator += deltaTime;
+    uint64_t ticks = static_cast<uint64_t>(m_accumulator / m_tickSeconds);
+    m_accumulator -= static_cast<float>(ticks) * m_tickSeconds;
+
+    // Sin timers no hay ranuras que visitar
+    if (m_stats.active == 0) {
+        m_now += ticks;
+        ticks = 0;
+    }
+
+    for (uint64_t tick = 0; tick < ticks; ++tick) {
+        ++m_now;
+        uint32_t slot = static_cast<uint32_t>(m_now & WHEEL_MASK);
+        if (slot == 0) {
+            for (uint32_t wheel = 1; wheel < WHEEL_COUNT; ++wheel) {
+                cascade(wheel);
+                if (((m_now >> (wheel * WHEEL_BITS)) & WHEEL_MASK) != 0) {
+                    break;
+                }
+            }
+        }
+
+        uint32_t index = m_buckets[slot];
+        m_buckets[slot] = INVALID_NODE;
+        while (index != INVALID_NODE) {
+            TimerNode& node = m_nodes[index];
+            uint32_t next = node.next;
+            node.previous = INVALID_NODE;
+            node.next = INVALID_NODE;
+            node.bucket = NO_BUCKET;
+            node.running = true;
+            (node.dispatch == TIMER_JOB_SYSTEM ? m_expiredJobs : m_expired).push_back(index);
+            index = next;
+        }
+    }
+
+    m_stats.firedLastUpdate = 0;
+
+    // Los callbacks del hilo principal pueden programar o cancelar otros timers
+    for (size_t i = 0; i < m_expired.size(); ++i) {
+        uint32_t index = m_expired[i];
+        if (!m_nodes[index].cancelled) {
+            m_nodes[index].callback();
+            ++m_stats.firedLastUpdate;
+        }
+        finish(index);
+    }
+    m_expired.clear();
+
+    if (!m_expiredJobs.empty()) {
+        JobSystem::getInstance().parallelFor(m_expiredJobs.size(), JOB_BATCH, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                TimerNode& node = m_nodes[m_expiredJobs[i]];
+                if (!node.cancelled) {
+                    node.callback();
+                }
+            }
+        });
+        for (uint32_t index : m_expiredJobs) {
+            if (!m_nodes[index].cancelled) {
+                ++m_stats.firedLastUpdate;
+            }
+            finish(index);
+        }
+        m_expiredJobs.clear();
+    }
+
+    m_stats.updateTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+void
+TimerService::setResolution(float seconds) {
+    if (m_stats.active == 0 && seconds > 0.0f) {
+        m_tickSeconds = seconds;
+        m_accumulator = 0.0f;
+    }
+}
+
+uint32_t
+TimerService::allocateNode() {
+    if (!m_freeNodes.empty()) {
+        uint32_t index = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        return index;
+    }
+    m_nodes.emplace_back();
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+TimerHandle
+TimerService::start(uint32_t index, uint64_t delayTicks, uint64_t period, TimerDispatch dispatch) {
+    TimerNode& node = m_nodes[index];
+    node.expiry = m_now + std::max<uint64_t>(delayTicks, 1);
+    node.period = period;
+    node.dispatch = static_cast<uint8_t>(dispatch);
+    node.active = true;
+    node.running = false;
+    node.cancelled = false;
+    link(index);
+
+    ++m_stats.active;
+    if (node.callback.isOnHeap()) {
+        ++m_stats.heapCallbacks;
+    }
+
+    TimerHandle handle;
+    handle.index = index;
+    handle.generation = node.generation;
+    return handle;
+}
+
+uint64_t
+TimerService::toTicks(float seconds) const {
+    if (seconds <= 0.0f) {
+        return 0;
+    }
+    // Redondea hacia arriba: un timer nunca vence antes de su tiempo
+    return static_cast<uint64_t>(std::ceil(seconds / m_tickSeconds - 1e-4f));
+}
+
+void
+TimerService::link(uint32_t index) {
+    TimerNode& node = m_nodes[index];
+    const uint64_t horizon = (static_cast<uint64_t>(1) << (WHEEL_BITS * WHEEL_COUNT)) - 1;
+    uint64_t delta = node.expiry > m_now ? node.expiry - m_now : 0;
+    if (delta > horizon) {
+        node.expiry = m_now + horizon;
+        delta = horizon;
+    }
+
+    uint32_t wheel = 0;
+    while (wheel + 1 < WHEEL_COUNT && delta >= (static_cast<uint64_t>(1) << (WHEEL_BITS * (wheel + 1)))) {
+        ++wheel;
+    }
+    // Un timer ya vencido va a la ranura que se está procesando
+    uint64_t expiry = std::max(node.expiry, m_now);
+    uint32_t slot = static_cast<uint32_t>((expiry >> (WHEEL_BITS * wheel)) & WHEEL_MASK);
+    uint16_t bucket = static_cast<uint16_t>(wheel * WHEEL_SIZE + slot);
+
+    node.bucket = bucket;
+    node.previous = INVALID_NODE;
+    node.next = m_buckets[bucket];
+    if (node.next != INVALID_NODE) {
+        m_nodes[node.next].previous = index;
+    }
+    m_buckets[bucket] = index;
+}
+
+void
+TimerService::unlink(uint32_t index) {
+    TimerNode& node = m_nodes[index];
+    if (node.bucket == NO_BUCKET) {
+        return;
+    }
+    if (node.previous != INVALID_NODE) {
+        m_nodes[node.previous].next = node.next;
+    }
+    else {
+        m_buckets[node.bucket] = node.next;
+    }
+    if (node.next != INVALID_NODE) {
+        m_nodes[node.next].previous = node.previous;
+    }
+    node.previous = INVALID_NODE;
+    node.next = INVALID_NODE;
+    node.bucket = NO_BUCKET;
+}
+
+void
+TimerService::cascade(uint32_t wheel) {
+    uint32_t slot = static_cast<uint32_t>((m_now >> (wheel * WHEEL_BITS)) & WHEEL_MASK);
+    uint32_t bucket = wheel * WHEEL_SIZE + slot;
+    uint32_t index = m_buckets[bucket];
+    m_buckets[bucket] = INVALID_NODE;
+    while (index != INVALID_NODE) {
+        uint32_t next = m_nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+void
+TimerService::finish(uint32_t index) {
+    TimerNode& node = m_nodes[index];
+    node.running = false;
+    if (node.cancelled || node.period == 0) {
+        release(index);
+        return;
+    }
+    // Sin deriva: la siguiente vez cuenta desde el vencimiento anterior, no desde ahora
+    node.expiry = std::max(node.expiry + node.period, m_now + 1);
+    link(index);
+}
+
+void
+TimerService::release(uint32_t index) {
+    TimerNode& node = m_nodes[index];
+    if (node.callback.isOnHeap()) {
+        --m_stats.heapCallbacks;
+    }
+    node.callback.reset();
+    node.active = false;
+    node.cancelled = false;
+    node.running = false;
+    ++node.generation;
+    m_freeNodes.push_back(index);
+    --m_stats.active;
+}
@@ -0,0 +1,64 @@
+﻿#include "Services/VirtualFileSystem.h"
+#include "Services/NotificationService.h"
+
+bool
+VirtualFileSystem::mount(const std::string& path) {
+    NotificationService& notifier = NotificationService::getInstance();
+
+    auto archive = std::make_unique<PackArchive>();
+    std::string error;
+    if (!archive->open(path, error)) {
+        notifier.addMessage(ConsolErrorType::ERROR, error);
+        return false;
+    }
+    notifier.addMessage(ConsolErrorType::NORMAL,
+                        "Pack mounted: " + path + " (" + std::to_string(archive->getEntryCount()) + " entries)");
+    m_archives.push_back(std::move(archive));
+    return true;
+}
+
+bool
+VirtualFileSystem::read(std::string_view name, std::string_view extension, FileView& out) {
+    out.data = nullptr;
+    out.size = 0;
+
+    for (auto it = m_archives.rbegin(); it != m_archives.rend(); ++it) {
+        const PackEntry* entry = (*it)->find(name, extension);
+        if (entry == nullptr) {
+            continue;
+        }
+        if ((*it)->read(*entry, out.storage, out.data, out.size)) {
+            m_packReads.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Respaldo: archivo suelto en disco, como antes de existir los paquetes
+    std::string path(name);
+    if (!extension.empty()) {
+        path += '.';
+        path.append(extension.data(), extension.size());
+    }
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        m_failedReads.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    out.storage.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(out.storage.data()), static_cast<std::streamsize>(out.storage.size()));
+    out.data = out.storage.data();
+    out.size = out.storage.size();
+    m_looseReads.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool
+VirtualFileSystem::isPacked(std::string_view name, std::string_view extension) const {
+    for (const auto& archive : m_archives) {
+        if (archive->find(name, extension) != nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,346 @@
+﻿#include "Services/WorldSnapshot.h"
+#include "Services/StateBuffer.h"
+#include "ECS/PathSystem.h"
+#include "ECS/SteeringSystem.h"
+#include "ECS/SpriteAnimationSystem.h"
+#include "ECS/PhysicsWorld.h"
+#include "Actor.h"
+
+void
+WorldSnapshot::capture(uint64_t frame, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    sf::Clock clock;
+    if (!m_entries.empty() && frame <= m_entries.back().frame) {
+        truncateFrom(frame);
+    }
+
+    refreshActors(actors);
+    gather(m_current);
+
+    Entry entry;
+    entry.frame = frame;
+    entry.keyframe = m_entries.empty() || m_sinceKeyframe + 1 >= m_keyframeInterval;
+    std::vector<std::vector<uint8_t>>& spares = entry.keyframe ? m_spareKeyframes : m_spareDeltas;
+    if (!spares.empty()) {
+        entry.data = std::move(spares.back());
+        spares.pop_back();
+    }
+    if (entry.keyframe) {
+        entry.data.assign(m_current.begin(), m_current.end());
+        m_sinceKeyframe = 0;
+    }
+    else {
+        size_t bytes = encodeDelta(m_lastRaw, m_current);
+        entry.data.assign(m_encodeBuffer.begin(), m_encodeBuffer.begin() + bytes);
+        ++m_sinceKeyframe;
+    }
+    m_entries.push_back(std::move(entry));
+    m_lastRaw.swap(m_current);
+    trimHistory();
+
+    updateStats();
+    m_stats.captureTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+}
+
+bool
+WorldSnapshot::restore(uint64_t frame, std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    sf::Clock clock;
+    auto found = std::lower_bound(m_entries.begin(), m_entries.end(), frame,
+                                  [](const Entry& entry, uint64_t value) { return entry.frame < value; });
+    if (found == m_entries.end() || found->frame != frame) {
+        return false;
+    }
+    size_t index = static_cast<size_t>(found - m_entries.begin());
+
+    refreshActors(actors);
+    decode(index, m_current);
+    if (!apply(m_current)) {
+        return false;
+    }
+
+    // Lo que venía después ya no ocurrió; se volverá a capturar al resimular
+    while (m_entries.size() > index + 1) {
+        recycle(m_entries.back());
+        m_entries.pop_back();
+    }
+    m_lastRaw.swap(m_current);
+    countSinceKeyframe();
+
+    updateStats();
+    m_stats.restoreTimeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+    return true;
+}
+
+bool
+WorldSnapshot::hasFrame(uint64_t frame) const {
+    auto found = std::lower_bound(m_entries.begin(), m_entries.end(), frame,
+                                  [](const Entry& entry, uint64_t value) { return entry.frame < value; });
+    return found != m_entries.end() && found->frame == frame;
+}
+
+uint64_t
+WorldSnapshot::computeHash(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    refreshActors(actors);
+    // FNV-1a de 64 bits sobre palabras de 32 bits
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint32_t word) {
+        hash = (hash ^ word) * 1099511628211ull;
+    };
+    for (size_t i = 0; i < m_actors.size(); ++i) {
+        if (m_actors[i] == nullptr) {
+            continue;
+        }
+        mix(static_cast<uint32_t>(m_actors[i]->getId()));
+        if (m_transforms[i] != nullptr) {
+            TransformState state = { m_transforms[i]->getPosition(), m_transforms[i]->getRotation(), m_transforms[i]->getScale() };
+            uint32_t words[sizeof(TransformState) / sizeof(uint32_t)];
+            std::memcpy(words, &state, sizeof(state));
+            for (uint32_t word : words) {
+                mix(word);
+            }
+        }
+    }
+    return hash;
+}
+
+void
+WorldSnapshot::setHistorySize(size_t frames) {
+    m_historySize = std::max<size_t>(frames, 1);
+    trimHistory();
+    updateStats();
+}
+
+void
+WorldSnapshot::clear() {
+    for (Entry& entry : m_entries) {
+        recycle(entry);
+    }
+    m_entries.clear();
+    m_lastRaw.clear();
+    m_sinceKeyframe = 0;
+    updateStats();
+}
+
+void
+WorldSnapshot::refreshActors(std::vector<EngineUtilities::TSharedPointer<Actor>>& actors) {
+    bool changed = actors.size() != m_actors.size();
+    for (size_t i = 0; !changed && i < actors.size(); ++i) {
+        changed = actors[i].get() != m_actors[i];
+    }
+    if (!changed) {
+        return;
+    }
+
+    // getComponent recorre los componentes del actor; solo se hace cuando cambia la escena
+    m_actors.resize(actors.size());
+    m_transforms.resize(actors.size());
+    for (size_t i = 0; i < actors.size(); ++i) {
+        m_actors[i] = actors[i].get();
+        m_transforms[i] = m_actors[i] != nullptr ? actors[i]->getComponent<Transform>().get() : nullptr;
+    }
+}
+
+void
+WorldSnapshot::gather(std::vector<uint8_t>& out) {
+    StateWriter writer(out);
+    writer.writeColumn(m_actors);
+
+    uint32_t count = static_cast<uint32_t>(m_transforms.size());
+    TransformState* transforms = writer.beginColumn<TransformState>(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        Transform* transform = m_transforms[i];
+        if (transform != nullptr) {
+            transforms[i] = { transform->getPosition(), transform->getRotation(), transform->getScale() };
+        }
+    }
+
+    PathSystem::getInstance().saveState(writer);
+    SteeringSystem::getInstance().saveState(writer);
+    SpriteAnimationSystem::getInstance().saveState(writer);
+    PhysicsWorld::getInstance().saveState(writer);
+}
+
+bool
+WorldSnapshot::apply(const std::vector<uint8_t>& raw) {
+    uint32_t count = static_cast<uint32_t>(m_transforms.size());
+    for (int pass = 0; pass < 2; ++pass) {
+        StateReader reader(raw, pass == 1);
+        if (!reader.matchColumn(m_actors)) {
+            return false;
+        }
+        const TransformState* transforms = reader.readColumnData<TransformState>(count);
+        if (transforms == nullptr) {
+            return false;
+        }
+        if (reader.isApplying()) {
+            for (uint32_t i = 0; i < count; ++i) {
+                Transform* transform = m_transforms[i];
+                if (transform != nullptr) {
+                    transform->setPosition(transforms[i].position);
+                    transform->setRotation(transforms[i].rotation);
+                    transform->setScale(transforms[i].scale);
+                }
+            }
+        }
+        if (!PathSystem::getInstance().loadState(reader) ||
+            !SteeringSystem::getInstance().loadState(reader) ||
+            !SpriteAnimationSystem::getInstance().loadState(reader) ||
+            !PhysicsWorld::getInstance().loadState(reader)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+WorldSnapshot::decode(size_t index, std::vector<uint8_t>& out) {
+    size_t keyframe = index;
+    while (!m_entries[keyframe].keyframe) {
+        --keyframe;
+    }
+    out.assign(m_entries[keyframe].data.begin(), m_entries[keyframe].data.end());
+    for (size_t i = keyframe + 1; i <= index; ++i) {
+        applyDelta(m_entries[i].data, out);
+    }
+}
+
+size_t
+WorldSnapshot::encodeDelta(const std::vector<uint8_t>& previous, const std::vector<uint8_t>& current) {
+    const uint32_t* before = reinterpret_cast<const uint32_t*>(previous.data());
+    const uint32_t* after = reinterpret_cast<const uint32_t*>(current.data());
+    size_t previousCount = previous.size() / sizeof(uint32_t);
+    size_t count = current.size() / sizeof(uint32_t);
+    size_t common = std::min(count, previousCount);
+    auto difference = [&](size_t i) { return i < previousCount ? after[i] ^ before[i] : after[i]; };
+
+    // Peor caso: una palabra distinta cada tres, que cuesta su racha, su cantidad y el literal
+    size_t capacity = (count + 6) * sizeof(uint32_t);
+    if (m_encodeBuffer.size() < capacity) {
+        m_encodeBuffer.resize(capacity);
+    }
+    uint32_t* words = reinterpret_cast<uint32_t*>(m_encodeBuffer.data());
+    size_t written = 0;
+    words[written++] = static_cast<uint32_t>(count);
+
+    size_t i = 0;
+    while (i < count) {
+        size_t zeroStart = i;
+        while (i < common && after[i] == before[i]) {
+            ++i;
+        }
+        // Pasado el final del snapshot anterior la diferencia es la palabra misma; la pasada se
+        // detiene en una palabra distinta de cero, así cada pasada avanza i
+        if (i >= common) {
+            while (i < count && after[i] == 0) {
+                ++i;
+            }
+        }
+
+        // Una pasada escribe a lo sumo su encabezado y las palabras que quedan
+        size_t needed = (written + 2 + (count - i)) * sizeof(uint32_t);
+        if (m_encodeBuffer.size() < needed) {
+            m_encodeBuffer.resize(needed);
+            words = reinterpret_cast<uint32_t*>(m_encodeBuffer.data());
+        }
+        size_t header = written;
+        written += 2;
+        size_t literalStart = i;
+        uint32_t value = i < count ? difference(i) : 0;
+        while (i < count) {
+            uint32_t next = i + 1 < count ? difference(i + 1) : 0;
+            if (value == 0 && next == 0) {
+                break;
+            }
+            words[written++] = value;
+            value = next;
+            ++i;
+        }
+        words[header] = static_cast<uint32_t>(literalStart - zeroStart);
+        words[header + 1] = static_cast<uint32_t>(i - literalStart);
+    }
+    return written * sizeof(uint32_t);
+}
+
+void
+WorldSnapshot::applyDelta(const std::vector<uint8_t>& delta, std::vector<uint8_t>& raw) {
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(delta.data());
+    size_t wordCount = delta.size() / sizeof(uint32_t);
+    if (wordCount == 0) {
+        return;
+    }
+    // Las palabras nuevas empiezan en cero, igual que al codificar
+    size_t count = words[0];
+    raw.resize(count * sizeof(uint32_t), 0);
+    uint32_t* after = reinterpret_cast<uint32_t*>(raw.data());
+
+    size_t read = 1;
+    size_t i = 0;
+    while (read + 2 <= wordCount) {
+        i += words[read++];
+        size_t literals = words[read++];
+        if (i + literals > count || read + literals > wordCount) {
+            break;
+        }
+        for (size_t j = 0; j < literals; ++j) {
+            after[i++] ^= words[read++];
+        }
+    }
+}
+
+void
+WorldSnapshot::truncateFrom(uint64_t frame) {
+    while (!m_entries.empty() && m_entries.back().frame >= frame) {
+        recycle(m_entries.back());
+        m_entries.pop_back();
+    }
+    if (m_entries.empty()) {
+        m_lastRaw.clear();
+    }
+    else {
+        decode(m_entries.size() - 1, m_lastRaw);
+    }
+    countSinceKeyframe();
+}
+
+void
+WorldSnapshot::trimHistory() {
+    // La entrada más antigua siempre es un keyframe; se quita junto con sus diferencias
+    while (!m_entries.empty()) {
+        size_t group = 1;
+        while (group < m_entries.size() && !m_entries[group].keyframe) {
+            ++group;
+        }
+        if (group == m_entries.size() || m_entries.size() - group < m_historySize) {
+            break;
+        }
+        for (size_t i = 0; i < group; ++i) {
+            recycle(m_entries.front());
+            m_entries.pop_front();
+        }
+    }
+}
+
+void
+WorldSnapshot::countSinceKeyframe() {
+    m_sinceKeyframe = 0;
+    for (size_t i = m_entries.size(); i > 0 && !m_entries[i - 1].keyframe; --i) {
+        ++m_sinceKeyframe;
+    }
+}
+
+void
+WorldSnapshot::recycle(Entry& entry) {
+    entry.data.clear();
+    (entry.keyframe ? m_spareKeyframes : m_spareDeltas).push_back(std::move(entry.data));
+}
+
+void
+WorldSnapshot::updateStats() {
+    m_stats.frames = m_entries.size();
+    m_stats.keyframes = 0;
+    m_stats.storedBytes = 0;
+    for (const Entry& entry : m_entries) {
+        m_stats.keyframes += entry.keyframe ? 1 : 0;
+        m_stats.storedBytes += entry.data.capacity();
+    }
+    m_stats.rawBytes = m_lastRaw.size();
+}
@@ -11,6 +11,8 @@
  * @return Puntero a la forma creada (`sf::Shape*`), o `nullptr` si el tipo es `NONE` o no se reconoce.
  */
 sf::Shape* ShapeFactory::createShape(ShapeType shapeType) {
+    // Libera la figura anterior si el componente ya tenía una
+    SAFE_PTR_RELEASE(m_shape);
     m_shapeType = shapeType;
     switch (shapeType) {
     case NONE: // No crea ninguna forma
@@ -97,3 +99,15 @@ ShapeFactory::setPosition(const sf::Vector2f& position) {
         m_shape->setPosition(position);
     }
 }
+
+/**
+ * @brief Asigna la textura de la figura y conserva una referencia a ella.
+ * @param texture Textura obtenida del ResourceManager.
+ */
+void
+ShapeFactory::setTexture(const EngineUtilities::TSharedPointer<Texture>& texture) {
+    m_texture = texture;
+    if (m_shape) {
+        m_shape->setTexture(texture ? &texture->getTexture() : nullptr);
+    }
+}
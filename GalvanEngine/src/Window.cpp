@@ -1,4 +1,5 @@
 ﻿#include "Window.h"
+#include "Services/InputRecorder.h"
 
 /*
  * @brief Constructor de la clase Window
@@ -23,6 +24,8 @@ Window::Window(int width, int height, const std::string& title) {
     if (!m_renderTexture.create(width, height)) {
         ERROR("Window", "RenderTexture", "CHECK CREATION");
     }
+    sf::Vector2u renderSize = m_renderTexture.getSize();
+    m_renderSize.store((static_cast<uint64_t>(renderSize.x) << 32) | renderSize.y, std::memory_order_release);
 }
 
 Window::~Window() {
@@ -37,28 +40,66 @@ void
 Window::handleEvents() {
     sf::Event event;
     while (m_window->pollEvent(event)) {
-        // Procesar los inputs de IMGUI
-        ImGui::SFML::ProcessEvent(event);
-        switch (event.type) {
-        case sf::Event::Closed:
-            m_window->close();
-            break;
-            // Manejar el evento de redimensionar
-        case sf::Event::Resized:
-            unsigned int width = event.size.width;
-            unsigned int height = event.size.height;
-
-            m_view = m_window->getView();
-            m_view.setSize(static_cast<float>(width), static_cast<float>(height));
-            m_window->setView(m_view);
+        // La entrada de la simulación pasa por el InputRecorder, que la graba o la reemplaza
+        InputRecorder::getInstance().submit(event);
+
+        if (m_forwardEvents) {
+            // El hilo de render usa la ventana: solo se marca el cierre y se reenvía lo demás
+            if (event.type == sf::Event::Closed) {
+                m_closeRequested = true;
+            }
+            else {
+                std::lock_guard<std::mutex> lock(m_eventMutex);
+                m_forwardedEvents.push_back(event);
+            }
+            continue;
+        }
 
-            // Actualizar RenderTexture si la ventana cambia de tamaño
-            m_renderTexture.create(width, height);
+        if (event.type == sf::Event::Closed) {
+            m_window->close();
             break;
         }
+        processEvent(event);
     }
 }
 
+/*
+ * @brief Procesa un evento en ImGui y maneja el cambio de tamaño de la ventana
+ * @param event Evento de SFML a procesar
+ */
+void
+Window::processEvent(const sf::Event& event) {
+    // Procesar los inputs de IMGUI
+    ImGui::SFML::ProcessEvent(event);
+
+    // Manejar el evento de redimensionar
+    if (event.type == sf::Event::Resized) {
+        unsigned int width = event.size.width;
+        unsigned int height = event.size.height;
+
+        m_view = m_window->getView();
+        m_view.setSize(static_cast<float>(width), static_cast<float>(height));
+        m_window->setView(m_view);
+
+        // Actualizar RenderTexture si la ventana cambia de tamaño
+        m_renderTexture.create(width, height);
+        sf::Vector2u renderSize = m_renderTexture.getSize();
+        m_renderSize.store((static_cast<uint64_t>(renderSize.x) << 32) | renderSize.y, std::memory_order_release);
+    }
+}
+
+void
+Window::setEventForwarding(bool enabled) {
+    m_forwardEvents = enabled;
+}
+
+void
+Window::takeForwardedEvents(std::vector<sf::Event>& events) {
+    events.clear();
+    std::lock_guard<std::mutex> lock(m_eventMutex);
+    events.swap(m_forwardedEvents);
+}
+
 /*
  * @brief Limpia la ventana, preparándola para el siguiente ciclo de renderizado
  */
@@ -92,7 +133,7 @@ Window::display() {
 bool
 Window::isOpen() const {
     if (m_window != nullptr) {
-        return m_window->isOpen();
+        return m_window->isOpen() && !m_closeRequested;
     }
     else {
         ERROR("Window", "isOpen", "CHECK FOR WINDOW POINTER DATA");
@@ -119,6 +160,24 @@ Window::draw(const sf::Drawable& drawable) {
     }
 }
 
+/*
+ * @brief Dibuja un objeto en la RenderTexture con estados de render específicos
+ * @param drawable Objeto SFML que se va a dibujar
+ * @param states Estados de render (textura, blend, shader) del dibujo
+ */
+void
+Window::draw(const sf::Drawable& drawable, const sf::RenderStates& states) {
+    if (m_renderTexture.getSize().x > 0 && m_renderTexture.getSize().y > 0) {
+        m_renderTexture.draw(drawable, states);
+    }
+}
+
+sf::Vector2u
+Window::getRenderSize() const {
+    uint64_t size = m_renderSize.load(std::memory_order_acquire);
+    return sf::Vector2u(static_cast<unsigned int>(size >> 32), static_cast<unsigned int>(size & 0xFFFFFFFFu));
+}
+
 sf::RenderWindow*
 Window::getWindow() {
     if (m_window != nullptr) {
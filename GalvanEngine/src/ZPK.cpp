@@ -1,7 +1,8 @@
 #include "BaseApp.h"
 
 int
-main() {
+main(int argc, char* argv[]) {
     BaseApp app;
+    app.parseArguments(argc, argv);
     return app.run();
 }
@@ -0,0 +1,66 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Services/PackArchive.h"
+
+/**
+ * @brief Empaqueta todos los archivos de una carpeta en un archivo .gpak.
+ *
+ * Uso: GalvanPacker <salida.gpak> <carpeta> [--lz4 | --zstd]
+ * Los nombres dentro del paquete son las rutas relativas a la carpeta, por ejemplo
+ * "Map002.png", que el VirtualFileSystem busca como ("Map002", "png").
+ */
+int
+main(int argc, char** argv) {
+	if (argc < 3) {
+		std::cout << "Usage: GalvanPacker <output.gpak> <input directory> [--lz4 | --zstd]" << std::endl;
+		return 1;
+	}
+
+	std::string outputPath = argv[1];
+	std::filesystem::path inputDirectory = argv[2];
+	PackCompression compression = COMPRESSION_NONE;
+	for (int i = 3; i < argc; ++i) {
+		std::string option = argv[i];
+		if (option == "--lz4") {
+			compression = COMPRESSION_LZ4;
+		}
+		else if (option == "--zstd") {
+			compression = COMPRESSION_ZSTD;
+		}
+		else {
+			std::cout << "Unknown option: " << option << std::endl;
+			return 1;
+		}
+	}
+	if (!PackArchive::isCompressionSupported(compression)) {
+		std::cout << "Compression not available, rebuild with GALVAN_PACK_LZ4 or GALVAN_PACK_ZSTD" << std::endl;
+		return 1;
+	}
+
+	std::error_code errorCode;
+	std::vector<PackInput> inputs;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(inputDirectory, errorCode)) {
+		if (!entry.is_regular_file()) {
+			continue;
+		}
+		PackInput input;
+		input.name = std::filesystem::relative(entry.path(), inputDirectory).generic_string();
+		input.sourcePath = entry.path().string();
+		inputs.push_back(input);
+	}
+	if (errorCode) {
+		std::cout << "Can't read directory: " << inputDirectory.string() << std::endl;
+		return 1;
+	}
+
+	std::string error;
+	if (!PackArchive::build(inputs, outputPath, compression, error)) {
+		std::cout << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "Packed " << inputs.size() << " files into " << outputPath << std::endl;
+	return 0;
+}